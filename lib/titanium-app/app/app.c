@@ -15,6 +15,7 @@
 
 #include "app.h"
 
+#include "stddef.h"
 #include "string.h"
 
 #include "driver/gpio.h"
@@ -36,6 +37,45 @@
 #include "app/sd_card_manager/sd_card_manager.h"
 #include "app/sensor_manager/sensor_manager.h"
 
+/**
+ * @brief Message buffer size for command responses.
+ *
+ * Sized for a worst-case response to a full window of commands on each of the
+ * two command queues, plus the command each is executing, so an admitted
+ * command always finds room for its response. Error responses to rejected commands are header-only
+ * and wait up to 100 ms for the publisher to make room.
+ */
+#define RESPONSE_COMMAND_BUFFER_SIZE                                     \
+    (2 * (COMMAND_MANAGER_MAXIMUM_OUTSTANDING + 1) *                     \
+     (sizeof(command_response_st) + QUEUE_MANAGER_MESSAGE_OVERHEAD))
+
+/**
+ * @brief Message buffer size for each command topic.
+ *
+ * Sized for a full window of single commands plus one full calibration
+ * batch, so a batch never inflates the room taken by small commands.
+ */
+#define COMMAND_BUFFER_SIZE                                                             \
+    ((COMMAND_MANAGER_MAXIMUM_OUTSTANDING *                                             \
+      (offsetof(command_st, command_u) + sizeof(cmd_get_system_info_st) +               \
+       QUEUE_MANAGER_MESSAGE_OVERHEAD)) +                                               \
+     (sizeof(command_st) + QUEUE_MANAGER_MESSAGE_OVERHEAD))
+
+/**
+ * @brief Message buffer size for health reports.
+ *
+ * Health reports are produced slowly, so room for two full reports is enough.
+ */
+#define HEALTH_REPORT_BUFFER_SIZE (2 * (sizeof(health_report_st) + QUEUE_MANAGER_MESSAGE_OVERHEAD))
+
+/**
+ * @brief Message buffer size for historical data chunks.
+ *
+ * The SD card task reads the log only while a full chunk fits, so this
+ * buffer bounds how far the stream runs ahead of the publisher.
+ */
+#define HISTORY_CHUNK_BUFFER_SIZE (SD_CARD_HISTORY_QUEUED_CHUNKS * (SD_CARD_HISTORY_CHUNK_SIZE + QUEUE_MANAGER_MESSAGE_OVERHEAD))
+
 /**
  * @brief Array of constant MQTT topic info structures.
  *
@@ -48,6 +88,8 @@ static const mqtt_topic_info_st mqtt_topic_infos[] = {
         .mqtt_data_direction = PUBLISH,
         .queue_length        = 10,
         .queue_item_size     = sizeof(device_report_st),
+        .publish_budget      = {.max_messages = 10},
+        .priority            = MQTT_PRIORITY_BULK,
         .data_type           = DATA_TYPE_SENSOR_REPORT,
         .message_type        = MESSAGE_TYPE_TARGET,
     },
@@ -55,8 +97,9 @@ static const mqtt_topic_info_st mqtt_topic_infos[] = {
         .topic               = "all/command",
         .qos                 = QOS_0,
         .mqtt_data_direction = SUBSCRIBE,
-        .queue_length        = 10,
+        .queue_length        = COMMAND_MANAGER_MAXIMUM_OUTSTANDING,
         .queue_item_size     = sizeof(command_st),
+        .queue_buffer_size   = COMMAND_BUFFER_SIZE,
         .data_type           = DATA_TYPE_COMMAND,
         .message_type        = MESSAGE_TYPE_BROADCAST,
     },
@@ -64,8 +107,9 @@ static const mqtt_topic_info_st mqtt_topic_infos[] = {
         .topic               = "command",
         .qos                 = QOS_0,
         .mqtt_data_direction = SUBSCRIBE,
-        .queue_length        = 10,
+        .queue_length        = COMMAND_MANAGER_MAXIMUM_OUTSTANDING,
         .queue_item_size     = sizeof(command_st),
+        .queue_buffer_size   = COMMAND_BUFFER_SIZE,
         .data_type           = DATA_TYPE_COMMAND,
         .message_type        = MESSAGE_TYPE_TARGET,
     },
@@ -73,8 +117,10 @@ static const mqtt_topic_info_st mqtt_topic_infos[] = {
         .topic               = "command",
         .qos                 = QOS_0,
         .mqtt_data_direction = PUBLISH,
-        .queue_length        = 10,
+        .queue_length        = 2 * (COMMAND_MANAGER_MAXIMUM_OUTSTANDING + 1),
         .queue_item_size     = sizeof(command_response_st),
+        .queue_buffer_size   = RESPONSE_COMMAND_BUFFER_SIZE,
+        .priority            = MQTT_PRIORITY_INTERACTIVE,
         .data_type           = DATA_TYPE_COMMAND_RESPONSE,
         .message_type        = MESSAGE_TYPE_TARGET,
     },
@@ -84,9 +130,24 @@ static const mqtt_topic_info_st mqtt_topic_infos[] = {
         .mqtt_data_direction = PUBLISH,
         .queue_length        = 10,
         .queue_item_size     = sizeof(health_report_st),
+        .queue_buffer_size   = HEALTH_REPORT_BUFFER_SIZE,
+        .priority            = MQTT_PRIORITY_NORMAL,
         .data_type           = DATA_TYPE_HEALTH_REPORT,
         .message_type        = MESSAGE_TYPE_TARGET,
     },
+    [HISTORY_CHUNK] = {
+        .topic               = "history",
+        .qos                 = QOS_1,
+        .mqtt_data_direction = PUBLISH,
+        .queue_length        = SD_CARD_HISTORY_QUEUED_CHUNKS,
+        .queue_item_size     = SD_CARD_HISTORY_CHUNK_SIZE,
+        .queue_buffer_size   = HISTORY_CHUNK_BUFFER_SIZE,
+        .publish_budget      = {.max_messages = 1},
+        .priority            = MQTT_PRIORITY_BACKGROUND,
+        .format              = MQTT_PAYLOAD_FORMAT_PACKED,
+        .data_type           = DATA_TYPE_HISTORY_CHUNK,
+        .message_type        = MESSAGE_TYPE_TARGET,
+    },
 };
 
 /**
@@ -115,6 +176,10 @@ mqtt_topic_st mqtt_topics[TOPIC_COUNT] = {
         .info        = &mqtt_topic_infos[HEALTH_REPORT],
         .queue_index = HEALTH_REPORT_QUEUE_ID,
     },
+    [HISTORY_CHUNK] = {
+        .info        = &mqtt_topic_infos[HISTORY_CHUNK],
+        .queue_index = HISTORY_CHUNK_QUEUE_ID,
+    },
 };
 
 /**
@@ -123,10 +188,14 @@ mqtt_topic_st mqtt_topics[TOPIC_COUNT] = {
  * Function pointers are set to NULL initially and assigned during bridge initialization.
  */
 mqtt_bridge_st mqtt_bridge = {
-    .fetch_publish_data = NULL, /**< Function pointer to fetch publish data */
-    .get_topic          = NULL, /**< Function pointer to subscribe to topics */
-    .handle_event_data  = NULL, /**< Function pointer to handle incoming MQTT data */
-    .get_topics_count   = NULL, /**< Function pointer to get the number of registered topics */
+    .fetch_publish_data   = NULL, /**< Function pointer to fetch publish data */
+    .get_topic            = NULL, /**< Function pointer to subscribe to topics */
+    .handle_event_data    = NULL, /**< Function pointer to handle incoming MQTT data */
+    .get_topics_count     = NULL, /**< Function pointer to get the number of registered topics */
+    .set_publish_notify   = NULL, /**< Function pointer to attach the MQTT task to publish notifications */
+    .get_publish_budget   = NULL, /**< Function pointer to get the publish drain budget of a topic */
+    .get_publish_priority = NULL, /**< Function pointer to get the publish priority class of a topic */
+    .get_payload_limit    = NULL, /**< Function pointer to get the inbound payload limit of a received topic */
 };
 
 /**
@@ -201,7 +270,7 @@ static const char *TAG = "Application Task";  ///< Tag used for logging.
  *       It assumes FreeRTOS is initialized and queues are created.
  */
 kernel_error_st app_initialize(global_structures_st *global_structures) {
-    logger_print(DEBUG, TAG, "Application initialization started");
+    LOGGER_PRINT(DEBUG, TAG, "Application initialization started");
 
     kernel_error_st err = validate_global_structure(global_structures);
     if (err != KERNEL_SUCCESS) {
@@ -230,6 +299,12 @@ kernel_error_st app_initialize(global_structures_st *global_structures) {
         return err;
     }
 
+    err = queue_manager_register(SD_CARD_HISTORY_QUEUE_ID, 1, sizeof(sd_card_history_request_st));
+    if (err != KERNEL_SUCCESS) {
+        logger_print(ERR, TAG, "Failed to register SD Card history queue - %d", err);
+        return err;
+    }
+
     err = task_handler_attach_task(&sensor_manager_task);
     if (err != KERNEL_SUCCESS) {
         logger_print(ERR, TAG, "Failed to initialized Sensor Manager Task - %d", err);
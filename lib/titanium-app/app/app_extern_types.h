@@ -61,7 +61,13 @@
  * @def MAX_SYSTEM_TASKS
  * @brief Maximum number of system tasks supported.
  */
-#define MAX_SYSTEM_TASKS 10
+#define MAX_SYSTEM_TASKS 12
+
+/**
+ * @def CALIBRATION_BATCH_MAXIMUM_ITEMS
+ * @brief Maximum number of calibrations in one CMD_SET_CALIBRATION_BATCH command.
+ */
+#define CALIBRATION_BATCH_MAXIMUM_ITEMS NUM_OF_SENSORS
 
 /* === Data Types === */
 
@@ -80,6 +86,7 @@ typedef enum mqtt_topic_index_e {
     TARGET_COMMAND,    /**< Topic for receiving direct commands targeted at this device. */
     RESPONSE_COMMAND,  /**< Topic for publishing responses/acknowledgments to commands. */
     HEALTH_REPORT,     /**< Topic for publishing responses/acknowledgments to commands. */
+    HISTORY_CHUNK,     /**< Topic for streaming historical data read back from the SD card log. */
     TOPIC_COUNT,       /**< Total number of defined topics (used for bounds checking). */
 } mqtt_topic_index_et;
 
@@ -92,6 +99,7 @@ typedef enum app_data_type_e {
     DATA_TYPE_COMMAND,           /**< Command sent to the device */
     DATA_TYPE_COMMAND_RESPONSE,  /**< Response to a previously issued command */
     DATA_TYPE_HEALTH_REPORT,     /**< Health report */
+    DATA_TYPE_HISTORY_CHUNK,     /**< Chunk of historical data, encoded by the SD card log (sd_log_codec.h) */
     END_OF_DATA_TYPES            /**< End marker for enumeration */
 } app_data_type_et;
 
@@ -100,9 +108,11 @@ typedef enum app_data_type_e {
  * @brief Enumerates all supported command types.
  */
 typedef enum command_index_e {
-    CMD_GET_TIME = 0,    /**< Request device time */
-    CMD_SET_CALIBRATION, /**< Set calibration parameters for a sensor */
-    CMD_GET_SYSTEM_INFO  /**< Request system information (user/password protected) */
+    CMD_GET_TIME = 0,         /**< Request device time */
+    CMD_SET_CALIBRATION,      /**< Set calibration parameters for a sensor */
+    CMD_GET_SYSTEM_INFO,      /**< Request system information (user/password protected) */
+    CMD_SET_CALIBRATION_BATCH, /**< Set calibration parameters for several sensors at once */
+    CMD_GET_HISTORY            /**< Stream the logged reports of a time range on the history topic */
     // Future commands can be added here
 } command_index_et;
 
@@ -116,6 +126,8 @@ typedef enum command_status_e {
     COMMAND_CALIBRATION_FAIL    = -2, /**< Calibration-specific failure */
     COMMAND_AUTHENTICATION_FAIL = -3, /**< Calibration-specific failure */
     COMMAND_PARSE_FAIL          = -4, /**< Parse-specific failure */
+    COMMAND_BUSY                = -5, /**< Rejected, the window of outstanding commands is full */
+    COMMAND_ABORTED             = -6, /**< Batch item not applied because another item of the batch failed */
 } command_status_et;
 
 /** @enum
@@ -124,6 +136,8 @@ typedef enum command_status_e {
  *  @var TARGET_COMMAND_QUEUE_ID Queue for target-specific commands.
  *  @var BROADCAST_COMMAND_QUEUE_ID Queue for broadcast/system-wide commands.
  *  @var RESPONSE_COMMAND_QUEUE_ID Queue for task/module responses.
+ *  @var SD_CARD_HISTORY_QUEUE_ID Queue for historical data requests to the SD card task.
+ *  @var HISTORY_CHUNK_QUEUE_ID Message buffer for historical data chunks.
  */
 enum {
     SENSOR_REPORT_QUEUE_ID = LAST_KERNEL_QUEUE_ID,
@@ -132,6 +146,8 @@ enum {
     RESPONSE_COMMAND_QUEUE_ID,
     HEALTH_REPORT_QUEUE_ID,
     SD_CARD_QUEUE_ID,
+    SD_CARD_HISTORY_QUEUE_ID,
+    HISTORY_CHUNK_QUEUE_ID,
 };
 
 /**
@@ -161,6 +177,32 @@ typedef struct cmd_set_calibration_s {
     float offset;         /**< Calibration offset value */
 } cmd_set_calibration_st;
 
+/**
+ * @struct cmd_set_calibration_batch_st
+ * @brief Payload for CMD_SET_CALIBRATION_BATCH.
+ *
+ * Calibrations applied together: either every item is applied or none is.
+ */
+typedef struct cmd_set_calibration_batch_s {
+    uint8_t num_of_items;                                          /**< Number of calibrations in `items` */
+    cmd_set_calibration_st items[CALIBRATION_BATCH_MAXIMUM_ITEMS]; /**< Calibrations, in request order */
+} cmd_set_calibration_batch_st;
+
+/**
+ * @struct cmd_get_history_st
+ * @brief Payload for CMD_GET_HISTORY.
+ *
+ * Selects the logged reports whose timestamp lies in [from, to]. The reports
+ * are sent in chunks numbered from 0; a stream that was interrupted is
+ * resumed by repeating the request with the sequence number of the first
+ * chunk still missing as `offset`.
+ */
+typedef struct cmd_get_history_s {
+    int64_t from;   /**< First timestamp of the range, unix seconds */
+    int64_t to;     /**< Last timestamp of the range, unix seconds */
+    int32_t offset; /**< Sequence number of the first chunk to send, 0 for the whole range */
+} cmd_get_history_st;
+
 /**
  * @struct cmd_get_system_info_st
  * @brief Payload for CMD_GET_SYSTEM_INFO.
@@ -181,9 +223,12 @@ typedef struct cmd_get_system_info_s {
  */
 typedef struct target_command_s {
     command_index_et command_index; /**< Type of command */
+    uint32_t correlation_id;        /**< Client-supplied request identifier ("id"), 0 when absent */
     union {
-        cmd_set_calibration_st set_calibration;     /**< Payload for CMD_SET_CALIBRATION */
-        cmd_get_system_info_st cmd_get_system_info; /**< Payload for CMD_GET_SYSTEM_INFO */
+        cmd_set_calibration_st set_calibration;             /**< Payload for CMD_SET_CALIBRATION */
+        cmd_get_system_info_st cmd_get_system_info;         /**< Payload for CMD_GET_SYSTEM_INFO */
+        cmd_set_calibration_batch_st set_calibration_batch; /**< Payload for CMD_SET_CALIBRATION_BATCH */
+        cmd_get_history_st get_history;                     /**< Payload for CMD_GET_HISTORY */
         // Additional payloads for future targeted commands can be added here
     } command_u;
 } command_st;
@@ -218,19 +263,32 @@ typedef struct cmd_system_info_response_s {
     sensor_calibration_status_st sensor_calibration_status[NUM_OF_SENSORS]; /**< Offset value used in calibration */
 } cmd_system_info_response_st;
 
+/**
+ * @struct cmd_calibration_batch_response_st
+ * @brief Response payload for CMD_SET_CALIBRATION_BATCH.
+ *
+ * Holds one status per requested item, in request order.
+ */
+typedef struct cmd_calibration_batch_response_s {
+    uint8_t num_of_items;                                /**< Number of items in the batch */
+    int8_t item_status[CALIBRATION_BATCH_MAXIMUM_ITEMS]; /**< command_status_et of each item */
+} cmd_calibration_batch_response_st;
+
 /**
  * @struct command_response_st
  * @brief Response returned after executing a command.
  *
- * Echoes the original command identifier and contains a union with the
- * corresponding payload based on the type of command executed.
+ * Echoes the original command identifier and correlation ID, and contains
+ * a union with the corresponding payload based on the type of command executed.
  */
 typedef struct command_response_s {
     command_index_et command_index;   /**< Original command identifier */
     command_status_et command_status; /**< Execution result of the command */
+    uint32_t correlation_id;          /**< Correlation ID of the command, 0 when absent */
     union {
         cmd_sensor_response_st cmd_sensor_response; /**< Payload for sensor-level command responses */
         cmd_system_info_response_st cmd_system_info_response;
+        cmd_calibration_batch_response_st cmd_calibration_batch_response; /**< Payload for batch calibration responses */
         // Additional response payloads for future commands can be added here
     } command_u;
 } command_response_st;
@@ -246,14 +304,31 @@ typedef struct task_health_s {
     UBaseType_t high_water_mark;            /**< Minimum amount of stack space that remained (in words) since the task started. */
 } task_health_st;
 
+/**
+ * @struct sd_card_stats_s
+ * @brief Availability and data-loss counters of the SD card log.
+ *
+ * Counters are cumulative since boot.
+ */
+typedef struct sd_card_stats_s {
+    bool mounted;              /**< Whether reports are written to the card now */
+    uint32_t remounts;         /**< Successful remounts after the card was lost */
+    uint32_t remount_failures; /**< Failed mount attempts */
+    uint32_t reports_spilled;  /**< Reports held in RAM because the card could not be written */
+    uint32_t reports_pending;  /**< Reports in RAM now, written once the card is back */
+    uint32_t reports_dropped;  /**< Reports lost: the oldest when the RAM buffer is full, or ones that cannot be encoded */
+} sd_card_stats_st;
+
 /**
  * @struct health_report_s
  * @brief Aggregates health information for multiple tasks.
  *
- * Contains an array of task health entries and the number
- * of tasks currently reported.
+ * Contains the SD card log counters, the number of tasks currently
+ * reported and an array of task health entries. The array comes last so a
+ * report can be transported truncated to its populated entries.
  */
 typedef struct health_report_s {
-    task_health_st task_health[MAX_SYSTEM_TASKS]; /**< Array of task health information. */
+    sd_card_stats_st sd_card;                     /**< Availability and data-loss counters of the SD card log. */
     uint8_t num_of_tasks;                         /**< Number of tasks included in the report. */
+    task_health_st task_health[MAX_SYSTEM_TASKS]; /**< Array of task health information. */
 } health_report_st;
@@ -23,6 +23,7 @@
 #define COMMAND_MANAGER_TASK_PRIORITY 6
 #define COMMAND_MANAGER_TASK_STACK_SIZE (2048 * 2)
 #define COMMAND_MANAGER_TASK_NAME "Command Manager"
+#define COMMAND_MANAGER_MAXIMUM_OUTSTANDING 16  ///< Window of commands a client may send per queue before receiving their responses.
 /** @} */
 
 /** @name Health Manager Task Configuration */
@@ -37,4 +38,18 @@
 #define SD_CARD_MANAGER_TASK_PRIORITY 2
 #define SD_CARD_MANAGER_TASK_STACK_SIZE (2048 * 2)
 #define SD_CARD_MANAGER_TASK_NAME "SD Card Manager"
+#define SD_CARD_WRITE_BUFFER_SIZE (8 * 512)       ///< Write-behind buffer, a multiple of the SD sector dividing the FAT allocation unit.
+#define SD_CARD_WRITE_BUFFER_MAX_AGE_MS (30000)  ///< Longest time a buffered report waits before being written to the card.
+#define SD_CARD_LOG_BINARY 1                     ///< 1 logs fixed-size binary records (sd_log_codec.h) with a time index, 0 logs CSV lines.
+#define SD_CARD_LOG_INDEX_INTERVAL 16            ///< Blocks of the binary log between two time index entries.
+#define SD_CARD_LOG_SEGMENT_SIZE (2 * 1024 * 1024)        ///< Bytes preallocated for each binary log segment; a full segment starts the next one.
+#define SD_CARD_LOG_SEGMENT_SECONDS (24 * 60 * 60)       ///< Time window of a binary log segment; a record of the next window starts a new one.
+#define SD_CARD_LOG_MIN_FREE_BYTES (64ULL * 1024 * 1024) ///< The oldest segments are deleted while the card has less free space.
+#define SD_CARD_HISTORY_CHUNK_SIZE (2 * 1024)            ///< Largest history chunk, at most MQTT_MAXIMUM_PAYLOAD_LENGTH so it is published from the static buffer.
+#define SD_CARD_HISTORY_QUEUED_CHUNKS 2                  ///< History chunks waiting to be published; the log is not read while they are queued.
+#define SD_CARD_HISTORY_BLOCKS_PER_STEP 32               ///< Log blocks read between two drains of the SD card queue while streaming history.
+#define SD_CARD_HISTORY_STALL_MS (60000)                 ///< A stream whose next chunk cannot be queued for this long is aborted.
+#define SD_CARD_SPILL_BUFFER_SIZE (32 * 1024)            ///< RAM holding reports while the card cannot be written, as log records (about 34 minutes at one report every 7.5 s).
+#define SD_CARD_REMOUNT_MIN_MS (1000)                    ///< Wait before the first remount of a lost card, doubled after each failed attempt.
+#define SD_CARD_REMOUNT_MAX_MS (60000)                   ///< Longest wait between two remount attempts.
 /** @} */
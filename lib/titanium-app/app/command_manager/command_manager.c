@@ -4,17 +4,25 @@
  *
  * This module processes commands received by the device, invoking
  * the appropriate logic and generating structured responses.
+ *
+ * The task sleeps on its notification value: both command queues notify it
+ * through the Queue Manager when a command is enqueued. Each wakeup drains
+ * every ready command, target commands before broadcast ones, and the
+ * processing latency of each command type is logged periodically.
  */
 #include "command_manager.h"
 
 #include "stddef.h"
 #include "string.h"
 
+#include "esp_timer.h"
+
 #include "kernel/device/device_info.h"
 #include "kernel/error/error_num.h"
 #include "kernel/logger/logger.h"
 
 #include "app/app_tasks_config.h"
+#include "app/sd_card_manager/sd_card_manager.h"
 
 /* Application Global Variables */
 
@@ -23,6 +31,29 @@
  */
 static const char* TAG = "Command Manager";
 
+#define COMMAND_NOTIFY_TARGET_BIT (1UL << 0)     ///< Notification bit set when a target command is enqueued.
+#define COMMAND_NOTIFY_BROADCAST_BIT (1UL << 1)  ///< Notification bit set when a broadcast command is enqueued.
+#define COMMAND_LATENCY_SLOTS (CMD_GET_HISTORY + 1)  ///< One latency slot per command_index_et value.
+
+static const TickType_t COMMAND_POLL_WAIT         = pdMS_TO_TICKS(100);    ///< Wait between polls when notifications are unavailable.
+static const TickType_t COMMAND_LATENCY_WAIT      = pdMS_TO_TICKS(60000);  ///< Longest idle wait while latency statistics are unreported.
+static const int64_t COMMAND_LATENCY_REPORT_US    = 60 * 1000 * 1000;      ///< Interval between per-command latency reports.
+
+/**
+ * @brief Processing latency statistics of one command type.
+ *
+ * Latency is measured from the moment a command is taken from its queue to
+ * the moment its response is handed to the response transport.
+ */
+typedef struct command_latency_s {
+    uint32_t count;     ///< Commands processed in the current report interval.
+    int64_t total_us;   ///< Sum of latencies in the current report interval.
+    int64_t max_us;     ///< Largest latency in the current report interval.
+} command_latency_st;
+
+static command_latency_st command_latencies[COMMAND_LATENCY_SLOTS] = {0};  ///< Per-command latency statistics.
+static int64_t last_latency_report                                 = 0;    ///< Time of the last latency report.
+
 /**
  * @brief Processes the CMD_SET_CALIBRATION command.
  *
@@ -60,6 +91,79 @@ kernel_error_st process_set_calibration_command(command_st* command, command_res
     return result;
 }
 
+/**
+ * @brief Processes the CMD_SET_CALIBRATION_BATCH command.
+ *
+ * Applies every calibration of the batch or none of them. Each item is
+ * checked first: an item with a sensor index out of range, or repeating the
+ * sensor of an earlier item, fails with COMMAND_CALIBRATION_FAIL. When every
+ * item is valid, the batch is applied at once with sensor_calibrate_batch();
+ * otherwise, or if that fails, the valid items are reported COMMAND_ABORTED.
+ *
+ * The response lists the status of each item in request order, and its
+ * overall status is COMMAND_SUCCESS only when the batch was applied.
+ *
+ * @param command Pointer to the parsed command structure containing the calibrations.
+ * @param command_response Pointer to the response structure to populate with the item statuses.
+ * @return kernel_error_st Result of the batch:
+ *         - KERNEL_SUCCESS if every calibration was applied
+ *         - KERNEL_ERROR_NULL if input pointers are NULL
+ *         - KERNEL_ERROR_INVALID_ARG if an item is invalid
+ *         - Errors from sensor_calibrate_batch() if the batch could not be applied
+ */
+kernel_error_st process_set_calibration_batch_command(command_st* command, command_response_st* command_response) {
+    kernel_error_st result = KERNEL_SUCCESS;
+
+    if ((command == NULL) || (command_response == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    const cmd_set_calibration_batch_st* cmd     = &command->command_u.set_calibration_batch;
+    cmd_calibration_batch_response_st* response = &command_response->command_u.cmd_calibration_batch_response;
+    sensor_calibration_st calibrations[CALIBRATION_BATCH_MAXIMUM_ITEMS];
+    bool calibrated[NUM_OF_SENSORS]             = {false};
+    uint8_t num_of_items                        = cmd->num_of_items;
+
+    if (num_of_items > CALIBRATION_BATCH_MAXIMUM_ITEMS) {
+        num_of_items = CALIBRATION_BATCH_MAXIMUM_ITEMS;
+    }
+
+    command_response->command_index = CMD_SET_CALIBRATION_BATCH;
+    response->num_of_items          = num_of_items;
+
+    for (uint8_t i = 0; i < num_of_items; i++) {
+        int32_t sensor_index = cmd->items[i].sensor_index;
+
+        if ((sensor_index < 0) || (sensor_index >= NUM_OF_SENSORS) || calibrated[sensor_index]) {
+            response->item_status[i] = COMMAND_CALIBRATION_FAIL;
+            result                   = KERNEL_ERROR_INVALID_ARG;
+            continue;
+        }
+
+        calibrated[sensor_index]     = true;
+        response->item_status[i]     = COMMAND_SUCCESS;
+        calibrations[i].sensor_index = (uint8_t)sensor_index;
+        calibrations[i].offset       = cmd->items[i].offset;
+        calibrations[i].gain         = cmd->items[i].gain;
+    }
+
+    if (result == KERNEL_SUCCESS) {
+        result = sensor_calibrate_batch(calibrations, num_of_items);
+    }
+
+    if (result != KERNEL_SUCCESS) {
+        for (uint8_t i = 0; i < num_of_items; i++) {
+            if (response->item_status[i] == COMMAND_SUCCESS) {
+                response->item_status[i] = COMMAND_ABORTED;
+            }
+        }
+    }
+
+    command_response->command_status = result == KERNEL_SUCCESS ? COMMAND_SUCCESS : COMMAND_CALIBRATION_FAIL;
+
+    return result;
+}
+
 /**
  * @brief Processes the CMD_GET_SYSTEM_INFO command.
  *
@@ -129,6 +233,45 @@ kernel_error_st process_get_system_info_command(command_st* command, command_res
     return result;
 }
 
+/**
+ * @brief Processes the CMD_GET_HISTORY command.
+ *
+ * Hands the time range to the SD card task, which streams the logged reports
+ * on the history topic in chunks tagged with the command's correlation ID.
+ * The response only tells whether the request was accepted; a new request
+ * replaces the stream in progress, and a range with `from` after `to` ends it
+ * with an empty last chunk.
+ *
+ * @param command Pointer to the parsed command structure containing the range.
+ * @param command_response Pointer to the response structure to populate with the status.
+ * @return kernel_error_st Result of the request:
+ *         - KERNEL_SUCCESS if the SD card task accepted the request
+ *         - KERNEL_ERROR_NULL if input pointers are NULL
+ *         - KERNEL_ERROR_INVALID_ARG if the offset is negative
+ *         - Errors from sd_card_manager_request_history() otherwise
+ */
+kernel_error_st process_get_history_command(command_st* command, command_response_st* command_response) {
+    kernel_error_st result = KERNEL_SUCCESS;
+
+    if ((command == NULL) || (command_response == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    const cmd_get_history_st* cmd = &command->command_u.get_history;
+
+    if (cmd->offset < 0) {
+        result = KERNEL_ERROR_INVALID_ARG;
+    } else {
+        result = sd_card_manager_request_history(cmd, command->correlation_id);
+    }
+
+    command_response->command_index = CMD_GET_HISTORY;
+    command_response->command_status =
+        (result == KERNEL_SUCCESS) ? COMMAND_SUCCESS : ((result == KERNEL_ERROR_QUEUE_FULL) ? COMMAND_BUSY : COMMAND_FAIL);
+
+    return result;
+}
+
 /**
  * @brief Dispatches a command to the appropriate handler.
  *
@@ -157,6 +300,14 @@ kernel_error_st process_command(command_st* command, command_response_st* comman
             result = process_get_system_info_command(command, command_response);
             break;
         }
+        case CMD_SET_CALIBRATION_BATCH: {
+            result = process_set_calibration_batch_command(command, command_response);
+            break;
+        }
+        case CMD_GET_HISTORY: {
+            result = process_get_history_command(command, command_response);
+            break;
+        }
         default:
             result = KERNEL_ERROR_INVALID_COMMAND;
     }
@@ -165,59 +316,203 @@ kernel_error_st process_command(command_st* command, command_response_st* comman
 }
 
 /**
- * @brief Handles incoming commands from a queue and sends responses to another queue.
+ * @brief Computes the number of meaningful bytes in a command response.
+ *
+ * The response transport stores variable-length messages, so only the header
+ * and the payload variant that matches the command are sent. Failed commands
+ * carry no payload, except batches, whose item statuses are always sent.
+ *
+ * @param command_response Pointer to the populated response.
+ * @return size_t Number of bytes to transport.
+ */
+static size_t command_response_size(const command_response_st* command_response) {
+    size_t header_size = offsetof(command_response_st, command_u);
+
+    if (command_response->command_index == CMD_SET_CALIBRATION_BATCH) {
+        return header_size + offsetof(cmd_calibration_batch_response_st, item_status) +
+               command_response->command_u.cmd_calibration_batch_response.num_of_items;
+    }
+
+    if (command_response->command_status != COMMAND_SUCCESS) {
+        return header_size;
+    }
+
+    switch (command_response->command_index) {
+        case CMD_SET_CALIBRATION:
+            return header_size + sizeof(command_response->command_u.cmd_sensor_response);
+        case CMD_GET_SYSTEM_INFO:
+            return header_size + sizeof(command_response->command_u.cmd_system_info_response);
+        case CMD_GET_HISTORY:
+            return header_size;
+        default:
+            return sizeof(command_response_st);
+    }
+}
+
+/**
+ * @brief Records the processing latency of a command in its type statistics.
+ *
+ * @param command_index Type of the processed command.
+ * @param started_us    Time the command was taken from its queue.
+ */
+static void record_command_latency(command_index_et command_index, int64_t started_us) {
+    if (((int)command_index < 0) || ((int)command_index >= COMMAND_LATENCY_SLOTS)) {
+        return;
+    }
+
+    int64_t latency_us        = esp_timer_get_time() - started_us;
+    command_latency_st* stats = &command_latencies[command_index];
+
+    stats->count++;
+    stats->total_us += latency_us;
+    if (latency_us > stats->max_us) {
+        stats->max_us = latency_us;
+    }
+}
+
+/**
+ * @brief Checks whether latency statistics are waiting to be reported.
+ */
+static bool has_pending_latency(void) {
+    for (int i = 0; i < COMMAND_LATENCY_SLOTS; i++) {
+        if (command_latencies[i].count > 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Logs and resets the per-command latency statistics.
+ *
+ * Called after every drain, only reports once per COMMAND_LATENCY_REPORT_US.
+ */
+static void report_command_latency(void) {
+    int64_t now = esp_timer_get_time();
+
+    if ((now - last_latency_report) < COMMAND_LATENCY_REPORT_US) {
+        return;
+    }
+
+    last_latency_report = now;
+
+    for (int i = 0; i < COMMAND_LATENCY_SLOTS; i++) {
+        command_latency_st* stats = &command_latencies[i];
+
+        if (stats->count == 0) {
+            continue;
+        }
+
+        logger_print(INFO, TAG, "Command %d latency: %lu cmds, avg %lld us, max %lld us",
+                     i,
+                     (unsigned long)stats->count,
+                     stats->total_us / stats->count,
+                     stats->max_us);
+
+        *stats = (command_latency_st){0};
+    }
+}
+
+/**
+ * @brief Handles one incoming command from a command transport and sends its response.
+ *
+ * Takes the oldest command from the transport without waiting, processes it,
+ * and sends the response, carrying the command's correlation ID, to the
+ * RESPONSE_COMMAND_QUEUE_ID transport, using only the bytes the response
+ * needs. If an error occurs, it is logged.
  *
- * This function retrieves commands from the command_queue, processes them, and
- * sends responses to the response_command_queue. If an error occurs, it is logged.
+ * Commands are variable-length messages holding only their payload variant,
+ * so the command is cleared before it is received.
  *
- * @param command_queue Queue handle from which to receive incoming commands.
- * @param response_command_queue Queue handle to send command responses.
+ * @param queue_index Queue Manager ID of the command transport.
  * @return kernel_error_st Result of processing:
- *         - KERNEL_SUCCESS on success
- *         - KERNEL_ERROR_NULL if input pointers are invalid
+ *         - KERNEL_SUCCESS if a command was processed
+ *         - KERNEL_ERROR_EMPTY_QUEUE if no command was waiting
+ *         - KERNEL_ERROR_QUEUE_NULL if no transport is registered for the ID
  *         - KERNEL_ERROR_QUEUE_FULL if sending response fails
  */
-kernel_error_st handle_incoming_command(QueueHandle_t command_queue, QueueHandle_t response_command_queue) {
+kernel_error_st handle_incoming_command(uint8_t queue_index) {
     command_st command                   = {0};
     command_response_st command_response = {0};
 
-    if (xQueueReceive(command_queue, &command, pdMS_TO_TICKS(100)) == pdPASS) {
-        kernel_error_st err = process_command(&command, &command_response);
-        if (err != KERNEL_SUCCESS) {
-            logger_print(WARN, TAG, "Failed to process incoming command! - %d", err);
+    kernel_error_st received = queue_manager_receive(queue_index, &command, sizeof(command), NULL, 0);
+    if (received != KERNEL_SUCCESS) {
+        return received;
+    }
+
+    int64_t started_us  = esp_timer_get_time();
+    kernel_error_st err = process_command(&command, &command_response);
+    if (err != KERNEL_SUCCESS) {
+        logger_print(WARN, TAG, "Failed to process incoming command! - %d", err);
+    }
+
+    command_response.correlation_id = command.correlation_id;
+
+    if (queue_manager_send(RESPONSE_COMMAND_QUEUE_ID,
+                           &command_response,
+                           command_response_size(&command_response),
+                           pdMS_TO_TICKS(100)) != KERNEL_SUCCESS) {
+        logger_print(ERR, TAG, "Failed to send command response to queue");
+        return KERNEL_ERROR_QUEUE_FULL;
+    }
+
+    record_command_latency(command.command_index, started_us);
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Processes every ready command, target commands first.
+ *
+ * The target queue is checked again before each broadcast command, so a
+ * target command never waits behind a backlog of broadcasts.
+ *
+ * Stops as soon as both transports are empty or cannot be read.
+ */
+static void drain_commands(void) {
+    while (1) {
+        kernel_error_st err = handle_incoming_command(TARGET_COMMAND_QUEUE_ID);
+        if ((err == KERNEL_ERROR_EMPTY_QUEUE) || (err == KERNEL_ERROR_QUEUE_NULL)) {
+            err = handle_incoming_command(BROADCAST_COMMAND_QUEUE_ID);
         }
 
-        if (xQueueSend(response_command_queue, &command_response, pdMS_TO_TICKS(100)) != pdPASS) {
-            logger_print(ERR, TAG, "Failed to send command response to queue");
-            return KERNEL_ERROR_QUEUE_FULL;
+        if ((err == KERNEL_ERROR_EMPTY_QUEUE) || (err == KERNEL_ERROR_QUEUE_NULL)) {
+            return;
         }
     }
-    return KERNEL_SUCCESS;
 }
 
 /**
  * @brief Main loop of the command manager task.
  *
- * Continuously processes incoming commands from both target and broadcast queues
- * and sends responses. Runs indefinitely with a delay between iterations.
+ * Attaches the task to both command queues, then blocks on its notification
+ * value until a command is enqueued and processes every ready command at
+ * once. Without notifications, the queues are polled every COMMAND_POLL_WAIT.
  *
- * @param args Pointer to a command_manager_init_st structure containing queue handles.
+ * @param args Unused.
  */
 void command_manager_loop(void* args) {
-    QueueHandle_t command_queue        = queue_manager_get(TARGET_COMMAND_QUEUE_ID);
-    QueueHandle_t broadcast_queue      = queue_manager_get(BROADCAST_COMMAND_QUEUE_ID);
-    QueueHandle_t response_command_queue = queue_manager_get(RESPONSE_COMMAND_QUEUE_ID);
-
-    if ((command_queue == NULL) || (broadcast_queue == NULL) || (response_command_queue == NULL)) {
-        logger_print(ERR, TAG, "Command Manager Loop received NULL queue handles");
-        vTaskDelete(NULL);
-        return;
+    TaskHandle_t task    = xTaskGetCurrentTaskHandle();
+    TickType_t idle_wait = portMAX_DELAY;
+    if ((queue_manager_set_notify(TARGET_COMMAND_QUEUE_ID, task, COMMAND_NOTIFY_TARGET_BIT) != KERNEL_SUCCESS) ||
+        (queue_manager_set_notify(BROADCAST_COMMAND_QUEUE_ID, task, COMMAND_NOTIFY_BROADCAST_BIT) != KERNEL_SUCCESS)) {
+        logger_print(WARN, TAG, "Command notifications unavailable, falling back to periodic polling");
+        idle_wait = COMMAND_POLL_WAIT;
     }
 
+    last_latency_report = esp_timer_get_time();
+
     while (1) {
-        handle_incoming_command(command_queue, response_command_queue);
-        handle_incoming_command(broadcast_queue, response_command_queue);
+        /* Commands enqueued before the wait raise a pending notification, so none is missed. */
+        drain_commands();
+        report_command_latency();
+
+        TickType_t wait_ticks = idle_wait;
+        if (has_pending_latency() && (wait_ticks > COMMAND_LATENCY_WAIT)) {
+            wait_ticks = COMMAND_LATENCY_WAIT;
+        }
 
-        vTaskDelay(pdMS_TO_TICKS(100));
+        xTaskNotifyWait(0, UINT32_MAX, NULL, wait_ticks);
     }
-}
\ No newline at end of file
+}
@@ -14,9 +14,9 @@
 /**
  * @brief Main loop of the command manager task.
  *
- * Continuously processes incoming commands from both target and broadcast queues
- * and sends responses. Runs indefinitely with a delay between iterations.
+ * Sleeps until a command is enqueued, then processes every ready command,
+ * target commands before broadcast ones, and sends the responses.
  *
- * @param args Pointer to a command_manager_init_st structure containing queue handles.
+ * @param args Unused.
  */
 void command_manager_loop(void* args);
@@ -1,5 +1,7 @@
 #include "health_manager.h"
 
+#include <stddef.h>
+
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -8,6 +10,8 @@
 #include "kernel/logger/logger.h"
 #include "kernel/tasks/manager/task_handler.h"
 
+#include "app/sd_card_manager/sd_card_manager.h"
+
 /** @brief LED states */
 typedef enum {
     LED_OFF = 0, /**< LED is off */
@@ -25,15 +29,22 @@ static health_report_st report = {0};              /** Health report structure *
 /**
  * @brief Update the health report task list.
  *
- * Synchronizes the report structure with the current list of tasks.
- * Ensures task names are safely copied and null-terminated.
+ * Synchronizes the report structure with the current list of tasks, at most
+ * MAX_SYSTEM_TASKS of them. Ensures task names are safely copied and null-terminated.
  */
 static void update_health_report_list(void) {
-    if (report.num_of_tasks == task_handler_get_task_count()) {
+    int task_count = task_handler_get_task_count();
+    int reported   = (task_count > MAX_SYSTEM_TASKS) ? MAX_SYSTEM_TASKS : task_count;
+
+    if (report.num_of_tasks == reported) {
         return;
     }
 
-    for (size_t i = 0; i < task_handler_get_task_count(); i++) {
+    if (reported < task_count) {
+        logger_print(WARN, TAG, "Health report holds %d of %d tasks", reported, task_count);
+    }
+
+    for (size_t i = 0; i < (size_t)reported; i++) {
         size_t task_name_size = snprintf(report.task_health[i].task_name,
                                          TASK_MAXIMUM_NAME_SIZE,
                                          "%s",
@@ -44,7 +55,7 @@ static void update_health_report_list(void) {
             report.task_health[i].task_name[TASK_MAXIMUM_NAME_SIZE - 1] = '\0';
         }
     }
-    report.num_of_tasks = task_handler_get_task_count();
+    report.num_of_tasks = (uint8_t)reported;
 }
 
 /**
@@ -65,8 +76,8 @@ static void toggle_health_led(void) {
 /**
  * @brief Send a health report to the system queue.
  *
- * Updates stack usage for each task and enqueues the health report.
- * If the queue is not available, logs an error.
+ * Updates stack usage for each task and the SD card log counters, and
+ * enqueues the health report, trimmed to the populated task entries. If sending fails, logs an error.
  */
 static void send_health_report(void) {
     update_health_report_list();
@@ -75,13 +86,14 @@ static void send_health_report(void) {
         report.task_health[i].high_water_mark = task_handler_get_highwater(i);
     }
 
-    QueueHandle_t queue = queue_manager_get(HEALTH_REPORT_QUEUE_ID);
-    if (queue == NULL) {
-        logger_print(ERR, TAG, "Health report queue not found");
-        return;
-    }
+    sd_card_manager_get_stats(&report.sd_card);
+
+    size_t report_size = offsetof(health_report_st, task_health) + (report.num_of_tasks * sizeof(task_health_st));
 
-    xQueueSend(queue, &report, pdMS_TO_TICKS(100));
+    kernel_error_st err = queue_manager_send(HEALTH_REPORT_QUEUE_ID, &report, report_size, pdMS_TO_TICKS(100));
+    if (err != KERNEL_SUCCESS) {
+        logger_print(ERR, TAG, "Failed to send health report - %d", err);
+    }
 }
 
 /**
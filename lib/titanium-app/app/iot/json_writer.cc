@@ -0,0 +1,295 @@
+#include "json_writer.h"
+
+#include <string.h>
+
+#include "app/third_party/json_handler.h"
+
+/**
+ * Hundredths below this magnitude are printed by the fixed-point path.
+ * Up to here (|value| < 100000) ArduinoJson's float output is exactly the
+ * two-decimal representation; larger values lose decimals to float
+ * precision and go through json_writer_float() to stay byte-identical.
+ */
+#define JSON_WRITER_FIXED2_LIMIT (10000000)
+
+/**
+ * @brief Reserves space for `needed` characters plus the terminator.
+ *
+ * @return true if the characters can be written, false after an overflow.
+ */
+static bool reserve(json_writer_st *writer, size_t needed) {
+    if (writer->overflow) {
+        return false;
+    }
+
+    if ((writer->length + needed) >= writer->size) {
+        writer->overflow = true;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Size of the separator owed before the next element (0 or 1).
+ */
+static size_t separator_size(const json_writer_st *writer) {
+    if (writer->after_key || (writer->depth == 0)) {
+        return 0;
+    }
+
+    return (writer->first_mask & (1U << writer->depth)) ? 0 : 1;
+}
+
+/**
+ * @brief Writes the owed separator and marks the current element as started.
+ *
+ * Space must have been reserved by the caller.
+ */
+static void begin_element(json_writer_st *writer) {
+    if (separator_size(writer) != 0) {
+        writer->buffer[writer->length++] = ',';
+    }
+
+    writer->first_mask &= (uint8_t)~(1U << writer->depth);
+    writer->after_key = false;
+}
+
+/**
+ * @brief Formats an unsigned integer backwards, ending just before `end`.
+ *
+ * @return Pointer to the first digit.
+ */
+static char *format_uint(char *end, uint64_t value) {
+    char *begin = end;
+    do {
+        *--begin = (char)('0' + (value % 10));
+        value /= 10;
+    } while (value != 0);
+
+    return begin;
+}
+
+/**
+ * @brief Writes the number held in `text` as one element.
+ */
+static void write_number(json_writer_st *writer, const char *text, size_t text_length) {
+    if (!reserve(writer, separator_size(writer) + text_length)) {
+        return;
+    }
+
+    begin_element(writer);
+    memcpy(&writer->buffer[writer->length], text, text_length);
+    writer->length += text_length;
+}
+
+/**
+ * @brief Opens a container with the given bracket.
+ */
+static void container_begin(json_writer_st *writer, char bracket) {
+    if (!reserve(writer, separator_size(writer) + 1)) {
+        return;
+    }
+
+    if ((writer->depth + 1) >= JSON_WRITER_MAXIMUM_DEPTH) {
+        writer->overflow = true;
+        return;
+    }
+
+    begin_element(writer);
+    writer->buffer[writer->length++] = bracket;
+    writer->depth++;
+    writer->first_mask |= (uint8_t)(1U << writer->depth);
+}
+
+/**
+ * @brief Closes the current container with the given bracket.
+ */
+static void container_end(json_writer_st *writer, char bracket) {
+    if (!reserve(writer, 1) || (writer->depth == 0)) {
+        writer->overflow = true;
+        return;
+    }
+
+    writer->buffer[writer->length++] = bracket;
+    writer->first_mask &= (uint8_t)~(1U << writer->depth);
+    writer->depth--;
+}
+
+void json_writer_begin(json_writer_st *writer, char *buffer, size_t size) {
+    writer->buffer     = buffer;
+    writer->size       = size;
+    writer->length     = 0;
+    writer->depth      = 0;
+    writer->first_mask = 0;
+    writer->after_key  = false;
+    writer->overflow   = (buffer == NULL) || (size == 0);
+}
+
+size_t json_writer_end(json_writer_st *writer) {
+    if (writer->overflow || (writer->depth != 0)) {
+        return 0;
+    }
+
+    writer->buffer[writer->length] = '\0';
+
+    return writer->length;
+}
+
+void json_writer_object_begin(json_writer_st *writer) {
+    container_begin(writer, '{');
+}
+
+void json_writer_object_end(json_writer_st *writer) {
+    container_end(writer, '}');
+}
+
+void json_writer_array_begin(json_writer_st *writer) {
+    container_begin(writer, '[');
+}
+
+void json_writer_array_end(json_writer_st *writer) {
+    container_end(writer, ']');
+}
+
+void json_writer_key(json_writer_st *writer, const char *key) {
+    size_t key_length = strlen(key);
+
+    if (!reserve(writer, separator_size(writer) + key_length + 3)) {
+        return;
+    }
+
+    begin_element(writer);
+
+    char *out = &writer->buffer[writer->length];
+    *out++    = '"';
+    memcpy(out, key, key_length);
+    out += key_length;
+    *out++ = '"';
+    *out++ = ':';
+
+    writer->length += key_length + 3;
+    writer->after_key = true;
+}
+
+void json_writer_int(json_writer_st *writer, int64_t value) {
+    char digits[21];
+    char *end   = digits + sizeof(digits);
+    char *begin = format_uint(end, (value < 0) ? (0 - (uint64_t)value) : (uint64_t)value);
+
+    if (value < 0) {
+        *--begin = '-';
+    }
+
+    write_number(writer, begin, (size_t)(end - begin));
+}
+
+void json_writer_uint(json_writer_st *writer, uint64_t value) {
+    char digits[20];
+    char *end   = digits + sizeof(digits);
+    char *begin = format_uint(end, value);
+
+    write_number(writer, begin, (size_t)(end - begin));
+}
+
+void json_writer_bool(json_writer_st *writer, bool value) {
+    if (value) {
+        write_number(writer, "true", 4);
+    } else {
+        write_number(writer, "false", 5);
+    }
+}
+
+/**
+ * @brief Escape letter for a character, 0 if it is written as is.
+ */
+static char escape_char(char c) {
+    switch (c) {
+        case '"':
+            return '"';
+        case '\\':
+            return '\\';
+        case '\b':
+            return 'b';
+        case '\f':
+            return 'f';
+        case '\n':
+            return 'n';
+        case '\r':
+            return 'r';
+        case '\t':
+            return 't';
+        default:
+            return 0;
+    }
+}
+
+void json_writer_string(json_writer_st *writer, const char *value) {
+    size_t escaped_length = 0;
+    for (const char *c = value; *c != '\0'; c++) {
+        escaped_length += (escape_char(*c) != 0) ? 2 : 1;
+    }
+
+    if (!reserve(writer, separator_size(writer) + escaped_length + 2)) {
+        return;
+    }
+
+    begin_element(writer);
+
+    char *out = &writer->buffer[writer->length];
+    *out++    = '"';
+    for (const char *c = value; *c != '\0'; c++) {
+        char escaped = escape_char(*c);
+        if (escaped != 0) {
+            *out++ = '\\';
+            *out++ = escaped;
+        } else {
+            *out++ = *c;
+        }
+    }
+    *out++ = '"';
+
+    writer->length += escaped_length + 2;
+}
+
+void json_writer_fixed2(json_writer_st *writer, int32_t hundredths) {
+    if ((hundredths <= -JSON_WRITER_FIXED2_LIMIT) || (hundredths >= JSON_WRITER_FIXED2_LIMIT)) {
+        json_writer_float(writer, hundredths / 100.00f);
+        return;
+    }
+
+    uint32_t magnitude = (hundredths < 0) ? (uint32_t)(-hundredths) : (uint32_t)hundredths;
+    uint32_t fraction  = magnitude % 100;
+
+    /* Built backwards: up to sign + 5 integral digits + point + 2 decimals */
+    char text[12];
+    char *end   = text + sizeof(text);
+    char *begin = end;
+
+    if (fraction != 0) {
+        if ((fraction % 10) != 0) {
+            *--begin = (char)('0' + (fraction % 10));
+        }
+        *--begin = (char)('0' + (fraction / 10));
+        *--begin = '.';
+    }
+
+    begin = format_uint(begin, magnitude / 100);
+
+    if (hundredths < 0) {
+        *--begin = '-';
+    }
+
+    write_number(writer, begin, (size_t)(end - begin));
+}
+
+void json_writer_float(json_writer_st *writer, float value) {
+    /* Rare path: let ArduinoJson format the single value so the text matches exactly. */
+    StaticJsonDocument<16> value_doc;
+    value_doc.set(value);
+
+    char text[24];
+    size_t text_length = serializeJson(value_doc, text, sizeof(text));
+
+    write_number(writer, text, text_length);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+/**
+ * @file json_writer.h
+ * @brief Single-pass JSON writer into a caller-provided buffer.
+ *
+ * Writes compact JSON straight into the output buffer, with no intermediate
+ * document. Commas are inserted automatically. Each field checks the
+ * remaining space once, before it is written. After an overflow every
+ * further call is ignored and json_writer_end() returns 0.
+ *
+ * The output matches ArduinoJson's serializeJson() for the same values, so
+ * payloads stay byte-identical to the DOM-based serializers it replaces.
+ *
+ * The writer is a plain value: to undo a partially written element, copy
+ * the writer before writing and assign the copy back.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define JSON_WRITER_MAXIMUM_DEPTH 8  ///< Maximum nesting of objects and arrays.
+
+/**
+ * @brief State of a JSON document being written.
+ */
+typedef struct json_writer_s {
+    char *buffer;         ///< Output buffer.
+    size_t size;          ///< Size of the output buffer in bytes, including the terminator.
+    size_t length;        ///< Characters written so far.
+    uint8_t depth;        ///< Current nesting level.
+    uint8_t first_mask;   ///< Bit n set while the container at depth n has no element yet.
+    bool after_key;       ///< A key was written and its value is pending.
+    bool overflow;        ///< Output did not fit, or nesting was exceeded.
+} json_writer_st;
+
+/**
+ * @brief Starts a JSON document in the given buffer.
+ *
+ * @param writer Writer state to initialize.
+ * @param buffer Output buffer.
+ * @param size   Size of the output buffer in bytes.
+ */
+void json_writer_begin(json_writer_st *writer, char *buffer, size_t size);
+
+/**
+ * @brief Terminates the document.
+ *
+ * @param writer Writer state.
+ * @return Length of the document without the terminator, 0 on overflow.
+ */
+size_t json_writer_end(json_writer_st *writer);
+
+/**
+ * @brief Opens or closes an object or array.
+ *
+ * @param writer Writer state.
+ */
+void json_writer_object_begin(json_writer_st *writer);
+void json_writer_object_end(json_writer_st *writer);
+void json_writer_array_begin(json_writer_st *writer);
+void json_writer_array_end(json_writer_st *writer);
+
+/**
+ * @brief Writes an object key; the next call writes its value.
+ *
+ * @param writer Writer state.
+ * @param key    Key, written without escaping.
+ */
+void json_writer_key(json_writer_st *writer, const char *key);
+
+/**
+ * @brief Writes an integer or boolean value.
+ *
+ * @param writer Writer state.
+ * @param value  Value to write.
+ */
+void json_writer_int(json_writer_st *writer, int64_t value);
+void json_writer_uint(json_writer_st *writer, uint64_t value);
+void json_writer_bool(json_writer_st *writer, bool value);
+
+/**
+ * @brief Writes a string value, escaped the same way as ArduinoJson.
+ *
+ * @param writer Writer state.
+ * @param value  Null-terminated string.
+ */
+void json_writer_string(json_writer_st *writer, const char *value);
+
+/**
+ * @brief Writes a value given in hundredths as a decimal number.
+ *
+ * Produces the text ArduinoJson prints for `(float)hundredths / 100`:
+ * trailing zeros are dropped, so 2340 prints as 23.4 and 2300 as 23.
+ * This is the fixed-point path for sensor values rounded to two decimals.
+ *
+ * @param writer     Writer state.
+ * @param hundredths Value multiplied by 100.
+ */
+void json_writer_fixed2(json_writer_st *writer, int32_t hundredths);
+
+/**
+ * @brief Writes a float value formatted like ArduinoJson.
+ *
+ * @param writer Writer state.
+ * @param value  Value to write.
+ */
+void json_writer_float(json_writer_st *writer, float value);
@@ -3,6 +3,8 @@
 
 #include "mqtt_bridge.h"
 
+#include "freertos/timers.h"
+
 #include "kernel/device/device_info.h"
 #include "kernel/inter_task_communication/inter_task_communication.h"
 #include "kernel/logger/logger.h"
@@ -26,6 +28,51 @@ static size_t mqtt_bridge_num_topics = 0;
  */
 static mqtt_topic_st mqtt_topics[MAX_MQTT_TOPICS] = {0};
 
+/**
+ * @brief Full MQTT topic string of a registered topic, built once at registration.
+ */
+typedef struct mqtt_topic_name_s {
+    char name[MQTT_MAXIMUM_TOPIC_LENGTH];  ///< Null-terminated topic, including the iocloud prefix and device ID.
+    uint8_t length;                        ///< Length of `name` without the terminator.
+} mqtt_topic_name_st;
+
+/**
+ * @brief Full topic string of each registered topic, indexed like mqtt_topics.
+ */
+static mqtt_topic_name_st mqtt_topic_names[MAX_MQTT_TOPICS] = {0};
+
+/**
+ * @brief Indices of the SUBSCRIBE topics, sorted by full topic (length first, then bytes).
+ *
+ * Incoming messages are routed by binary search with an exact match on the
+ * received topic and its length.
+ */
+static uint8_t mqtt_route_table[MAX_MQTT_TOPICS] = {0};
+
+/**
+ * @brief Number of entries in mqtt_route_table.
+ */
+static size_t mqtt_route_count = 0;
+
+/**
+ * @brief Runtime state of a batching topic.
+ */
+typedef struct mqtt_batch_state_s {
+    TimerHandle_t timer;    ///< One-shot timer bounding how long the oldest item is held.
+    TickType_t started;     ///< Tick at which the first item of the current batch was observed.
+    volatile bool expired;  ///< Set by the timer when the batch must be flushed regardless of its size.
+} mqtt_batch_state_st;
+
+/**
+ * @brief Batching state of each registered topic, indexed like mqtt_topics.
+ */
+static mqtt_batch_state_st mqtt_batch_states[MAX_MQTT_TOPICS] = {0};
+
+/**
+ * @brief Task notified when publish data is ready, set by set_publish_notify().
+ */
+static TaskHandle_t publish_notify_task = NULL;
+
 /**
  * @brief Validates the Quality of Service (QoS) level.
  *
@@ -95,6 +142,7 @@ kernel_error_st validate_mqtt_topic_length(const char *topic) {
  * - QoS
  * - Data direction
  * - Topic string
+ * - Inbound payload limit (does not exceed MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH)
  * - Number of registered topics (does not exceed MAX_MQTT_TOPICS)
  *
  * @param[in] topic Pointer to the topic structure to validate.
@@ -117,6 +165,10 @@ kernel_error_st validate_mqtt_topic(const mqtt_topic_st *topic) {
         return KERNEL_ERROR_MQTT_INVALID_TOPIC;
     }
 
+    if (topic->info->max_payload_length > MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
     if (mqtt_bridge_num_topics >= MAX_MQTT_TOPICS) {
         return KERNEL_ERROR_MQTT_TOO_MANY_TOPICS;
     }
@@ -124,13 +176,289 @@ kernel_error_st validate_mqtt_topic(const mqtt_topic_st *topic) {
     return KERNEL_SUCCESS;
 }
 
+/**
+ * @brief Creates the transport backing a topic.
+ *
+ * Topics with a non-zero `queue_buffer_size` are backed by a variable-length
+ * message buffer, so each message only takes the bytes it needs instead of a
+ * slot sized for the largest variant. The RAM saved against the equivalent
+ * fixed-slot queue is logged so the sizing can be checked on target.
+ *
+ * @param[in] topic Pointer to the topic structure.
+ * @return KERNEL_SUCCESS on success, or the error reported by the Queue Manager.
+ */
+static kernel_error_st register_topic_transport(const mqtt_topic_st *topic) {
+    const mqtt_topic_info_st *info = topic->info;
+
+    if (info->queue_buffer_size == 0) {
+        return queue_manager_register(topic->queue_index, info->queue_length, info->queue_item_size);
+    }
+
+    kernel_error_st err = queue_manager_register_message_buffer(topic->queue_index,
+                                                                info->queue_buffer_size,
+                                                                info->queue_item_size);
+    if (err != KERNEL_SUCCESS) {
+        return err;
+    }
+
+    size_t fixed_size = info->queue_length * info->queue_item_size;
+    logger_print(INFO, TAG, "Topic %s: %d byte message buffer replaces %d byte queue, saving %d bytes",
+                 info->topic,
+                 info->queue_buffer_size,
+                 fixed_size,
+                 (int)fixed_size - (int)info->queue_buffer_size);
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Checks whether a topic publishes batches.
+ *
+ * @param[in] topic Pointer to the topic structure.
+ * @return true if the topic is a PUBLISH topic with batching enabled.
+ */
+static bool is_batching_topic(const mqtt_topic_st *topic) {
+    return (topic->info->mqtt_data_direction == PUBLISH) && (topic->info->batch.max_reports > 1);
+}
+
+/**
+ * @brief Batch timer callback, flushes a batch that reached its maximum wait.
+ *
+ * Runs in the timer service task. It marks the batch as expired and wakes the
+ * MQTT task with the topic bit so the partial batch is published.
+ *
+ * @param[in] timer Timer handle, its ID holds the topic index.
+ */
+static void batch_timer_callback(TimerHandle_t timer) {
+    uint32_t mqtt_index = (uint32_t)(uintptr_t)pvTimerGetTimerID(timer);
+
+    mqtt_batch_states[mqtt_index].expired = true;
+
+    if (publish_notify_task != NULL) {
+        xTaskNotify(publish_notify_task, (1UL << mqtt_index), eSetBits);
+    }
+}
+
+/**
+ * @brief Creates the batching state of a topic.
+ *
+ * @param[in] topic      Pointer to the topic structure.
+ * @param[in] mqtt_index Index the topic will take in the internal list.
+ *
+ * @return KERNEL_SUCCESS on success;
+ * @return KERNEL_ERROR_INVALID_ARG if the topic is backed by a message buffer or has no wait time;
+ * @return KERNEL_ERROR_NO_MEM if the timer could not be created.
+ */
+static kernel_error_st register_topic_batch(const mqtt_topic_st *topic, size_t mqtt_index) {
+    const mqtt_topic_info_st *info = topic->info;
+
+    if ((info->queue_buffer_size != 0) || (info->batch.max_wait_ms == 0)) {
+        return KERNEL_ERROR_INVALID_ARG;
+    }
+
+    TimerHandle_t timer = xTimerCreate(info->topic,
+                                       pdMS_TO_TICKS(info->batch.max_wait_ms),
+                                       pdFALSE,
+                                       (void *)(uintptr_t)mqtt_index,
+                                       batch_timer_callback);
+    if (timer == NULL) {
+        return KERNEL_ERROR_NO_MEM;
+    }
+
+    mqtt_batch_states[mqtt_index].timer   = timer;
+    mqtt_batch_states[mqtt_index].expired = false;
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Deletes the batch timer of a topic whose registration failed.
+ *
+ * @param[in] mqtt_index Index the topic would have taken in the internal list.
+ */
+static void unregister_topic_batch(size_t mqtt_index) {
+    if (mqtt_batch_states[mqtt_index].timer != NULL) {
+        xTimerDelete(mqtt_batch_states[mqtt_index].timer, portMAX_DELAY);
+        mqtt_batch_states[mqtt_index].timer = NULL;
+    }
+}
+
+/**
+ * @brief Checks whether a batching topic has a batch ready to publish.
+ *
+ * A batch is ready once `max_reports` items are queued or its timer expired.
+ * The timer is armed for the full `max_wait_ms` when the first item of a batch
+ * is observed and disarmed when the queue is found empty.
+ *
+ * @param[in] mqtt_index Index of the topic in the internal list.
+ * @return true if the batch should be published now.
+ */
+static bool is_batch_ready(uint8_t mqtt_index) {
+    mqtt_topic_st *current     = &mqtt_topics[mqtt_index];
+    mqtt_batch_state_st *state = &mqtt_batch_states[mqtt_index];
+    size_t waiting             = queue_manager_messages_waiting(current->queue_index);
+
+    if (waiting == 0) {
+        xTimerStop(state->timer, 0);
+        state->expired = false;
+        return false;
+    }
+
+    if (state->expired || (waiting >= current->info->batch.max_reports)) {
+        return true;
+    }
+
+    if (xTimerIsTimerActive(state->timer) == pdFALSE) {
+        state->started = xTaskGetTickCount();
+        xTimerChangePeriod(state->timer, pdMS_TO_TICKS(current->info->batch.max_wait_ms), 0);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Closes the current batch of a topic after it was serialized.
+ *
+ * Items left over by a batch capped at `max_reports` or at the payload size
+ * were all queued after the first item of that batch, so they keep its
+ * deadline: the timer is re-armed for what remains of it, or the next batch
+ * is flushed at once if it already passed.
+ *
+ * @param[in] mqtt_index Index of the topic in the internal list.
+ */
+static void close_batch(uint8_t mqtt_index) {
+    mqtt_batch_state_st *state = &mqtt_batch_states[mqtt_index];
+
+    xTimerStop(state->timer, 0);
+    state->expired = false;
+
+    if (queue_manager_messages_waiting(mqtt_topics[mqtt_index].queue_index) == 0) {
+        return;
+    }
+
+    TickType_t max_wait = pdMS_TO_TICKS(mqtt_topics[mqtt_index].info->batch.max_wait_ms);
+    TickType_t elapsed  = xTaskGetTickCount() - state->started;
+
+    if (elapsed >= max_wait) {
+        state->expired = true;
+    } else {
+        xTimerChangePeriod(state->timer, max_wait - elapsed, 0);
+    }
+}
+
+/**
+ * @brief Builds the full topic string of a topic.
+ *
+ * - PUBLISH: `iocloud/response/<device_id>/<topic>`
+ * - SUBSCRIBE, target: `iocloud/request/<device_id>/<topic>`
+ * - SUBSCRIBE, broadcast: `iocloud/request/<topic>`
+ *
+ * @param[in]  topic Pointer to the topic structure.
+ * @param[out] name  Full topic string and its length.
+ *
+ * @return KERNEL_SUCCESS on success;
+ * @return KERNEL_ERROR_MQTT_INVALID_MESSAGE_TYPE if a SUBSCRIBE topic has an unsupported message type;
+ * @return KERNEL_ERROR_FORMATTING if the full topic does not fit MQTT_MAXIMUM_TOPIC_LENGTH.
+ */
+static kernel_error_st build_topic_name(const mqtt_topic_st *topic, mqtt_topic_name_st *name) {
+    int channel_size = 0;
+
+    if (topic->info->mqtt_data_direction == PUBLISH) {
+        channel_size = snprintf(name->name, sizeof(name->name), "iocloud/response/%s/%s", device_info_get_id(), topic->info->topic);
+    } else if (topic->info->message_type == MESSAGE_TYPE_TARGET) {
+        channel_size = snprintf(name->name, sizeof(name->name), "iocloud/request/%s/%s", device_info_get_id(), topic->info->topic);
+    } else if (topic->info->message_type == MESSAGE_TYPE_BROADCAST) {
+        channel_size = snprintf(name->name, sizeof(name->name), "iocloud/request/%s", topic->info->topic);
+    } else {
+        return KERNEL_ERROR_MQTT_INVALID_MESSAGE_TYPE;
+    }
+
+    if ((channel_size < 0) || ((size_t)channel_size >= sizeof(name->name))) {
+        return KERNEL_ERROR_FORMATTING;
+    }
+
+    name->length = (uint8_t)channel_size;
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Orders a received topic against a registered topic name.
+ *
+ * Shorter topics sort first; topics of equal length are ordered bytewise.
+ *
+ * @return Negative, zero or positive like memcmp().
+ */
+static int compare_topic_name(const char *topic, size_t topic_length, const mqtt_topic_name_st *name) {
+    if (topic_length != name->length) {
+        return (topic_length < name->length) ? -1 : 1;
+    }
+
+    return memcmp(topic, name->name, topic_length);
+}
+
+/**
+ * @brief Inserts a SUBSCRIBE topic in the sorted routing table.
+ *
+ * The caller checks with find_route() that the full topic is not routed yet.
+ *
+ * @param[in] mqtt_index Index of the topic, its name must already be built.
+ */
+static void add_route(uint8_t mqtt_index) {
+    const mqtt_topic_name_st *name = &mqtt_topic_names[mqtt_index];
+    size_t position                = mqtt_route_count;
+
+    while ((position > 0) && (compare_topic_name(name->name, name->length, &mqtt_topic_names[mqtt_route_table[position - 1]]) < 0)) {
+        mqtt_route_table[position] = mqtt_route_table[position - 1];
+        position--;
+    }
+
+    mqtt_route_table[position] = mqtt_index;
+    mqtt_route_count++;
+}
+
+/**
+ * @brief Finds the SUBSCRIBE topic that exactly matches a received topic.
+ *
+ * @param[in] topic        Received topic, not necessarily null-terminated.
+ * @param[in] topic_length Length of the received topic.
+ * @return Pointer to the matching topic, or NULL if none matches.
+ */
+static mqtt_topic_st *find_route(const char *topic, size_t topic_length) {
+    size_t low  = 0;
+    size_t high = mqtt_route_count;
+
+    while (low < high) {
+        size_t middle = low + ((high - low) / 2);
+        uint8_t index = mqtt_route_table[middle];
+        int order     = compare_topic_name(topic, topic_length, &mqtt_topic_names[index]);
+
+        if (order == 0) {
+            return &mqtt_topics[index];
+        }
+
+        if (order < 0) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+
+    return NULL;
+}
+
 /**
  * @brief Registers a new MQTT topic in the bridge.
  *
  * Validates the topic and, if successful:
- * - Creates a FreeRTOS queue for the topic
+ * - Builds its full topic string, and routes it if it is a SUBSCRIBE topic
+ * - Creates a FreeRTOS queue (or message buffer) for the topic
  * - Stores the topic in the bridge’s internal topic list
  *
+ * Everything that can reject the topic runs before its queue is created, and
+ * a batch timer is deleted again if the queue cannot be created, so a failed
+ * registration leaves nothing behind and can be retried.
+ *
  * @param[in,out] topic Pointer to the topic structure to register. Queue handle will be assigned.
  * @return KERNEL_SUCCESS on success;
  * @return KERNEL_ERROR_NULL if topic is NULL;
@@ -147,14 +475,38 @@ kernel_error_st register_topic(mqtt_topic_st *topic) {
         return KERNEL_ERROR_MQTT_REGISTER_FAIL;
     }
 
-    kernel_error_st err = queue_manager_register(topic->queue_index,
-                                                 topic->info->queue_length,
-                                                 topic->info->queue_item_size);
+    kernel_error_st err = build_topic_name(topic, &mqtt_topic_names[mqtt_bridge_num_topics]);
+    if (err != KERNEL_SUCCESS) {
+        logger_print(ERR, TAG, "Failed to build full topic for %s - %d", topic->info->topic, err);
+        return KERNEL_ERROR_MQTT_REGISTER_FAIL;
+    }
+
+    const mqtt_topic_name_st *name = &mqtt_topic_names[mqtt_bridge_num_topics];
+    if ((topic->info->mqtt_data_direction == SUBSCRIBE) && (find_route(name->name, name->length) != NULL)) {
+        logger_print(ERR, TAG, "Topic %s is already routed", name->name);
+        return KERNEL_ERROR_MQTT_REGISTER_FAIL;
+    }
+
+    if (is_batching_topic(topic)) {
+        err = register_topic_batch(topic, mqtt_bridge_num_topics);
+        if (err != KERNEL_SUCCESS) {
+            logger_print(ERR, TAG, "Failed to set up batching for topic %s - %d", topic->info->topic, err);
+            return KERNEL_ERROR_MQTT_REGISTER_FAIL;
+        }
+    }
+
+    /* Last step that can fail: there is no way to unregister a transport */
+    err = register_topic_transport(topic);
     if (err != KERNEL_SUCCESS) {
         logger_print(ERR, TAG, "Failed to create queue for topic %s", topic->info->topic);
+        unregister_topic_batch(mqtt_bridge_num_topics);
         return KERNEL_ERROR_QUEUE_NULL;
     }
 
+    if (topic->info->mqtt_data_direction == SUBSCRIBE) {
+        add_route(mqtt_bridge_num_topics);
+    }
+
     mqtt_topics[mqtt_bridge_num_topics++] = *topic;
 
     return KERNEL_SUCCESS;
@@ -163,8 +515,8 @@ kernel_error_st register_topic(mqtt_topic_st *topic) {
 /**
  * @brief Checks if a topic has pending data to publish.
  *
- * Inspects the FreeRTOS queue associated with the topic to determine
- * if there are messages waiting to be sent.
+ * Inspects the FreeRTOS queue or message buffer associated with the topic
+ * to determine if there are messages waiting to be sent.
  *
  * @param[in] topic Pointer to the MQTT topic structure.
  * @retval true  if data is available in the queue.
@@ -175,23 +527,41 @@ bool has_data_to_publish(const mqtt_topic_st *topic) {
         return false;
     }
 
-    QueueHandle_t queue = queue_manager_get(topic->queue_index);
-    if (queue == NULL) {
-        return false;
+    return queue_manager_has_data(topic->queue_index);
+}
+
+/**
+ * @brief Copies the prebuilt full topic string of a topic into a buffer.
+ *
+ * @param[in]  mqtt_index Index of the topic in the internal topic list.
+ * @param[out] topic      Destination buffer, `length` is set to the topic length.
+ * @return KERNEL_SUCCESS on success;
+ * @return KERNEL_ERROR_FORMATTING if the buffer is too small.
+ */
+static kernel_error_st copy_topic_name(uint8_t mqtt_index, mqtt_buffer_st *topic) {
+    const mqtt_topic_name_st *name = &mqtt_topic_names[mqtt_index];
+
+    if (name->length >= topic->size) {
+        logger_print(WARN, TAG, "Channel buffer too small");
+        return KERNEL_ERROR_FORMATTING;
     }
-    
-    return (uxQueueMessagesWaiting(queue) > 0);
+
+    memcpy(topic->buffer, name->name, name->length + 1);
+    topic->length = name->length;
+
+    return KERNEL_SUCCESS;
 }
 
 /**
  * @brief Fetches the next publishable message for a topic.
  *
- * Retrieves data from the topic queue, serializes it, and builds
- * the complete MQTT topic string including the device ID.
+ * Retrieves data from the topic queue, serializes it, and copies the
+ * topic string prebuilt at registration. Batching topics report an empty
+ * queue until their batch is ready.
  *
  * @param[in]  mqtt_index Index of the topic in the internal topic list.
  * @param[out] topic      Pointer to buffer structure for the formatted MQTT topic string.
- * @param[out] payload    Pointer to buffer structure for the serialized payload.
+ * @param[out] payload    Pointer to buffer structure for the serialized payload, `length` is set to its size.
  * @param[out] qos        Pointer to store the message QoS level.
  *
  * @return KERNEL_SUCCESS on success.
@@ -218,30 +588,30 @@ kernel_error_st fetch_publish_data(uint8_t mqtt_index, mqtt_buffer_st *topic, mq
         return KERNEL_ERROR_MQTT_INVALID_DATA_DIRECTION;
     }
 
+    bool is_batching = is_batching_topic(current);
+
+    if (is_batching && !is_batch_ready(mqtt_index)) {
+        return KERNEL_ERROR_EMPTY_QUEUE;
+    }
+
     if (!has_data_to_publish(current)) {
         return KERNEL_ERROR_EMPTY_QUEUE;
     }
 
-    kernel_error_st err = mqtt_serialize_data(
-        current,
-        payload->buffer,
-        payload->size);
+    kernel_error_st err = mqtt_serialize_data(current, payload);
+
+    if (is_batching) {
+        close_batch(mqtt_index);
+    }
 
     if (err != KERNEL_SUCCESS) {
         logger_print(ERR, TAG, "Failed to serialize message for topic %s", current->info->topic);
         return err;
     }
 
-    size_t channel_size = snprintf(
-        topic->buffer,
-        topic->size,
-        "iocloud/response/%s/%s",
-        device_info_get_id(),
-        current->info->topic);
-
-    if (channel_size >= topic->size) {
-        logger_print(WARN, TAG, "Channel buffer too small");
-        return KERNEL_ERROR_FORMATTING;
+    kernel_error_st name_err = copy_topic_name(mqtt_index, topic);
+    if (name_err != KERNEL_SUCCESS) {
+        return name_err;
     }
 
     *qos = current->info->qos;
@@ -258,11 +628,94 @@ static inline size_t get_topics_count(void) {
     return mqtt_bridge_num_topics;
 }
 
+/**
+ * @brief Attaches a task as consumer of every PUBLISH topic transport.
+ *
+ * Each topic notifies the task with bit `(1 << mqtt_index)` when data is enqueued,
+ * letting the MQTT task sleep until there is something to publish. Batch timers
+ * use the same bit when a partial batch must be flushed.
+ *
+ * @param[in] task Task to notify, or NULL to detach.
+ *
+ * @return KERNEL_SUCCESS on success, or the error reported by the Queue Manager.
+ */
+static kernel_error_st set_publish_notify(TaskHandle_t task) {
+    publish_notify_task = task;
+
+    for (uint8_t i = 0; i < mqtt_bridge_num_topics; i++) {
+        mqtt_topic_st *current = &mqtt_topics[i];
+
+        if (current->info->mqtt_data_direction != PUBLISH) {
+            continue;
+        }
+
+        kernel_error_st err = queue_manager_set_notify(current->queue_index, task, (1UL << i));
+        if (err != KERNEL_SUCCESS) {
+            logger_print(ERR, TAG, "Failed to attach notification for topic %s - %d", current->info->topic, err);
+            return err;
+        }
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Gets the publish drain budget of a topic.
+ *
+ * Zero fields in the topic configuration are replaced by the
+ * MQTT_DEFAULT_PUBLISH_BUDGET_* values.
+ *
+ * @param[in]  mqtt_index Index of the topic in the internal list.
+ * @param[out] budget     Pointer to store the effective budget.
+ *
+ * @return KERNEL_SUCCESS on success;
+ * @return KERNEL_ERROR_NULL if budget is NULL;
+ * @return KERNEL_ERROR_INVALID_INDEX if index is invalid.
+ */
+static kernel_error_st get_publish_budget(uint8_t mqtt_index, mqtt_publish_budget_st *budget) {
+    if (budget == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (mqtt_index >= mqtt_bridge_num_topics) {
+        return KERNEL_ERROR_INVALID_INDEX;
+    }
+
+    *budget = mqtt_topics[mqtt_index].info->publish_budget;
+
+    if (budget->max_messages == 0) {
+        budget->max_messages = MQTT_DEFAULT_PUBLISH_BUDGET_MESSAGES;
+    }
+
+    if (budget->max_bytes == 0) {
+        budget->max_bytes = MQTT_DEFAULT_PUBLISH_BUDGET_BYTES;
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Gets the publish priority class of a topic.
+ *
+ * @param[in] mqtt_index Index of the topic in the internal list.
+ * @return The configured priority class, or MQTT_PRIORITY_BULK if the index
+ *         or the configured value is invalid.
+ */
+static mqtt_priority_et get_publish_priority(uint8_t mqtt_index) {
+    if (mqtt_index >= mqtt_bridge_num_topics) {
+        return MQTT_PRIORITY_BULK;
+    }
+
+    mqtt_priority_et priority = mqtt_topics[mqtt_index].info->priority;
+
+    return (priority < MQTT_PRIORITY_COUNT) ? priority : MQTT_PRIORITY_BULK;
+}
+
 /**
  * @brief Builds subscription details for a topic.
  *
- * Constructs the full MQTT subscription string including device ID (if required),
- * and retrieves the associated QoS.
+ * Copies the full MQTT subscription string, prebuilt at registration with the
+ * device ID when required, and retrieves the associated QoS.
  *
  * @param[in]  mqtt_index Index of the topic in the internal list.
  * @param[out] topic      Pointer to buffer for the subscription topic string.
@@ -272,7 +725,6 @@ static inline size_t get_topics_count(void) {
  * @return KERNEL_ERROR_INVALID_INDEX if index is invalid;
  * @return KERNEL_ERROR_MQTT_QUEUE_NULL if queue is NULL;
  * @return KERNEL_ERROR_MQTT_INVALID_DATA_DIRECTION if topic is not SUBSCRIBE type;
- * @return KERNEL_ERROR_MQTT_INVALID_MESSAGE_TYPE if message type is not supported;
  * @return KERNEL_ERROR_FORMATTING if buffer is too small.
  */
 static kernel_error_st get_topic(uint8_t mqtt_index, mqtt_buffer_st *topic, qos_et *qos) {
@@ -286,29 +738,9 @@ static kernel_error_st get_topic(uint8_t mqtt_index, mqtt_buffer_st *topic, qos_
         return KERNEL_ERROR_MQTT_INVALID_DATA_DIRECTION;
     }
 
-    size_t channel_size = 0;
-    if (current->info->message_type == MESSAGE_TYPE_TARGET) {
-        channel_size = snprintf(
-            topic->buffer,
-            topic->size,
-            "iocloud/request/%s/%s",
-            device_info_get_id(),
-            current->info->topic);
-
-    } else if (current->info->message_type == MESSAGE_TYPE_BROADCAST) {
-        channel_size = snprintf(
-            topic->buffer,
-            topic->size,
-            "iocloud/request/%s",
-            current->info->topic);
-
-    } else {
-        return KERNEL_ERROR_MQTT_INVALID_MESSAGE_TYPE;
-    }
-
-    if (channel_size >= topic->size) {
-        logger_print(WARN, TAG, "Channel buffer too small");
-        return KERNEL_ERROR_FORMATTING;
+    kernel_error_st err = copy_topic_name(mqtt_index, topic);
+    if (err != KERNEL_SUCCESS) {
+        return err;
     }
 
     *qos = current->info->qos;
@@ -317,51 +749,61 @@ static kernel_error_st get_topic(uint8_t mqtt_index, mqtt_buffer_st *topic, qos_
 }
 
 /**
- * @brief Initializes the MQTT bridge and registers topics.
+ * @brief Routes an incoming MQTT message to its topic.
  *
- * Sets function pointers in the bridge instance, assigns the device unique ID,
- * and registers all topics specified in the initialization structure.
+ * The received topic is matched exactly, on its full string and length,
+ * against the routing table built at registration.
  *
- * @param[in] mqtt_bridge_init_struct Pointer to initialization structure containing:
- *            - Bridge instance
- *            - List of topics
- *            - Number of topics
+ * @param[in] topic   Received topic; `length` holds its size, it is not null-terminated.
+ * @param[in] payload Received payload, complete; `length` holds its size.
  *
  * @return KERNEL_SUCCESS on success;
  * @return KERNEL_ERROR_NULL if pointers are invalid;
- * @return KERNEL_ERROR_FORMATTING if device ID is too long;
- * @return KERNEL_ERROR_MQTT_REGISTER_FAIL if topic registration fails.
+ * @return KERNEL_ERROR_INVALID_SIZE if the payload is empty;
+ * @return KERNEL_ERROR_MQTT_INVALID_TOPIC if no registered topic matches;
+ * @return Error from mqtt_deserialize_data() otherwise.
  */
-static kernel_error_st handle_event_data(char *topic, mqtt_buffer_st *payload) {
-    if ((topic == NULL) || (payload->buffer == NULL)) {
+static kernel_error_st handle_event_data(const mqtt_buffer_st *topic, mqtt_buffer_st *payload) {
+    if ((topic == NULL) || (topic->buffer == NULL) || (payload == NULL) || (payload->buffer == NULL)) {
         return KERNEL_ERROR_NULL;
     }
 
-    if (payload->size == 0) {
+    if (payload->length == 0) {
         return KERNEL_ERROR_INVALID_SIZE;
     }
-    kernel_error_st err = KERNEL_SUCCESS;
 
-    for (uint8_t i = 0; i < mqtt_bridge_num_topics; i++) {
-        mqtt_topic_st *current = &mqtt_topics[i];
+    mqtt_topic_st *current = find_route(topic->buffer, topic->length);
+    if (current == NULL) {
+        logger_print(WARN, TAG, "No route for topic %.*s", (int)topic->length, topic->buffer);
+        return KERNEL_ERROR_MQTT_INVALID_TOPIC;
+    }
 
-        // TODO: Currently, strstr works well for specific target commands, but it causes an issue
-        // when processing broadcast commands. All target commands may be mistakenly identified
-        // as broadcast commands. To improve this, a more robust check is needed.
-        //
-        // As a temporary fix, we process all broadcast commands before target commands.
-        // This ensures that target commands are not mistakenly handled as broadcast commands.
-        if (strstr(topic, mqtt_topics[i].info->topic) != NULL) {
-            err = mqtt_deserialize_data(
-                current,
-                payload->buffer,
-                payload->size);
+    return mqtt_deserialize_data(current, payload->buffer, payload->length);
+}
 
-            break;
-        }
+/**
+ * @brief Gets the largest inbound payload accepted on a received topic.
+ *
+ * @param[in]  topic      Received topic; `length` holds its size, it is not null-terminated.
+ * @param[out] max_length Payload limit of the matching topic in bytes.
+ *
+ * @return KERNEL_SUCCESS on success;
+ * @return KERNEL_ERROR_NULL if pointers are invalid;
+ * @return KERNEL_ERROR_MQTT_INVALID_TOPIC if no registered topic matches.
+ */
+static kernel_error_st get_payload_limit(const mqtt_buffer_st *topic, size_t *max_length) {
+    if ((topic == NULL) || (topic->buffer == NULL) || (max_length == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    const mqtt_topic_st *current = find_route(topic->buffer, topic->length);
+    if (current == NULL) {
+        return KERNEL_ERROR_MQTT_INVALID_TOPIC;
     }
 
-    return err;
+    *max_length = (current->info->max_payload_length != 0) ? current->info->max_payload_length : MQTT_MAXIMUM_PAYLOAD_LENGTH;
+
+    return KERNEL_SUCCESS;
 }
 
 /**
@@ -390,10 +832,14 @@ kernel_error_st mqtt_bridge_initialize(mqtt_bridge_init_struct_st *mqtt_bridge_i
         return KERNEL_ERROR_NULL;
     }
 
-    mqtt_bridge->fetch_publish_data = fetch_publish_data;
-    mqtt_bridge->get_topics_count   = get_topics_count;
-    mqtt_bridge->get_topic          = get_topic;
-    mqtt_bridge->handle_event_data  = handle_event_data;
+    mqtt_bridge->fetch_publish_data   = fetch_publish_data;
+    mqtt_bridge->get_topics_count     = get_topics_count;
+    mqtt_bridge->get_topic            = get_topic;
+    mqtt_bridge->handle_event_data    = handle_event_data;
+    mqtt_bridge->set_publish_notify   = set_publish_notify;
+    mqtt_bridge->get_publish_budget   = get_publish_budget;
+    mqtt_bridge->get_publish_priority = get_publish_priority;
+    mqtt_bridge->get_payload_limit    = get_payload_limit;
 
     for (size_t i = 0; i < mqtt_bridge_init_struct->topic_count; i++) {
         mqtt_topic_st *current = &mqtt_bridge_init_struct->topics[i];
@@ -3,58 +3,179 @@
 #include "kernel/logger/logger.h"
 
 #include "app/app_extern_types.h"
+#include "app/iot/packed_report_codec.h"
 #include "app/iot/serializer_handlers.h"
 
 /* MQTT Serializer Global Variables */
 static const char *TAG = "MQTT_Serializer";
 
+/**
+ * @brief Serializes queued device reports into the packed binary layout.
+ *
+ * Up to `max_reports` reports are encoded into one payload (see
+ * packed_report_codec.h). Reports are peeked before being encoded and only
+ * removed from the queue once they fit, so a report that would exceed the
+ * size cap stays queued for the next payload.
+ *
+ * @param[in]  queue_index  Queue Manager ID from which the device reports will be read.
+ * @param[in]  max_reports  Maximum number of reports in the payload.
+ * @param[in]  max_bytes    Payload size cap, 0 to use the whole output buffer.
+ * @param[out] buffer       Output buffer.
+ * @param[in]  buffer_size  Size of the output buffer in bytes.
+ * @param[out] out_length   Number of bytes written.
+ *
+ * @return KERNEL_SUCCESS on success.
+ * @return KERNEL_ERROR_EMPTY_QUEUE if no report was available.
+ * @return KERNEL_ERROR_FORMATTING if a single report does not fit (the report is dropped).
+ * @return Other kernel_error_st values returned by the Queue Manager or the encoder.
+ */
+static kernel_error_st serialize_data_report_packed(uint8_t queue_index,
+                                                    uint8_t max_reports,
+                                                    size_t max_bytes,
+                                                    char *buffer,
+                                                    size_t buffer_size,
+                                                    size_t *out_length) {
+    size_t payload_limit = buffer_size;
+    if ((max_bytes != 0) && (max_bytes < payload_limit)) {
+        payload_limit = max_bytes;
+    }
+
+    packed_report_writer_st writer = {0};
+    kernel_error_st err            = packed_report_begin(&writer, (uint8_t *)buffer, payload_limit);
+    if (err != KERNEL_SUCCESS) {
+        return err;
+    }
+
+    while (writer.num_of_samples < max_reports) {
+        device_report_st device_report = {0};
+
+        err = queue_manager_peek(queue_index, &device_report, 0);
+        if (err != KERNEL_SUCCESS) {
+            break;
+        }
+
+        err = packed_report_add(&writer,
+                                (uint32_t)device_report.timestamp,
+                                device_report.sensors,
+                                device_report.num_of_sensors);
+
+        if ((err != KERNEL_SUCCESS) && (writer.num_of_samples == 0)) {
+            /* A report that cannot be encoded alone would block the queue forever, drop it. */
+            queue_manager_receive(queue_index, &device_report, sizeof(device_report), NULL, 0);
+            return KERNEL_ERROR_FORMATTING;
+        }
+
+        if (err != KERNEL_SUCCESS) {
+            break;
+        }
+
+        queue_manager_receive(queue_index, &device_report, sizeof(device_report), NULL, 0);
+    }
+
+    *out_length = packed_report_end(&writer);
+
+    return (*out_length > 0) ? KERNEL_SUCCESS : err;
+}
+
+/**
+ * @brief Moves the next history chunk to the payload buffer.
+ *
+ * Chunks are encoded by the SD card task (see sd_log_codec.h) and queued as
+ * variable-length messages, so the message is received as the payload.
+ *
+ * @param[in]  queue_index  Queue Manager ID of the history chunk message buffer.
+ * @param[out] buffer       Output buffer.
+ * @param[in]  buffer_size  Size of the output buffer in bytes.
+ * @param[out] out_length   Number of bytes written.
+ *
+ * @return KERNEL_SUCCESS on success.
+ * @return KERNEL_ERROR_EMPTY_QUEUE if no chunk was available.
+ * @return Other kernel_error_st values returned by the Queue Manager.
+ */
+static kernel_error_st serialize_history_chunk(uint8_t queue_index, char *buffer, size_t buffer_size, size_t *out_length) {
+    return queue_manager_receive(queue_index, buffer, buffer_size, out_length, 0);
+}
+
 /**
  * @brief Serializes data from a topic's queue into a buffer for MQTT transmission.
  *
- * This function handles serialization based on the topic's data type.
- * It reads data from the associated FreeRTOS queue and converts it into a JSON string
- * or other appropriate format, storing it in the provided buffer.
+ * This function handles serialization based on the topic's data type and payload format.
+ * It reads data from the associated FreeRTOS queue or message buffer and converts it into a JSON string
+ * or, for MQTT_PAYLOAD_FORMAT_PACKED topics, the packed binary layout, storing it in the payload buffer.
+ * Every serializer reports the exact number of bytes written in `payload->length`, so the
+ * payload is never re-scanned and may be binary. Single-message JSON payloads that do not
+ * fit grow the buffer through its reserve hook.
  *
  * Currently supports:
- * - DATA_TYPE_SENSOR_REPORT: Uses `serialize_data_report()` to serialize sensor data.
+ * - DATA_TYPE_SENSOR_REPORT: Uses `serialize_data_report()` to serialize sensor data,
+ *   or `serialize_data_report_batch()` when the topic has batching enabled.
+ * - DATA_TYPE_COMMAND_RESPONSE: Uses `serialize_command_response()`.
+ * - DATA_TYPE_HEALTH_REPORT: Uses `serialize_health_report()`.
+ * - DATA_TYPE_HISTORY_CHUNK (packed only): Uses `serialize_history_chunk()`.
  *
- * @param[in] topic        Pointer to the MQTT topic containing the queue and metadata.
- * @param[out] buffer      Output buffer where serialized data will be stored.
- * @param[in] buffer_size  Size of the output buffer in bytes.
+ * @param[in]  topic    Pointer to the MQTT topic containing the queue and metadata.
+ * @param[out] payload  Payload buffer; `length` is set to the number of bytes written.
  *
  * @return KERNEL_SUCCESS on success.
  * @return KERNEL_ERROR_NULL if any input pointer is NULL.
  * @return KERNEL_ERROR_INVALID_SIZE if the buffer size is zero.
- * @return KERNEL_ERROR_UNSUPPORTED_TYPE if the topic data type is not recognized.
+ * @return KERNEL_ERROR_UNSUPPORTED_TYPE if the topic data type or format is not supported.
  * @return Other kernel_error_st values returned by specific serializer functions.
  */
-kernel_error_st mqtt_serialize_data(mqtt_topic_st *topic, char *buffer, size_t buffer_size) {
-    if ((topic == NULL) || (buffer == NULL)) {
+kernel_error_st mqtt_serialize_data(mqtt_topic_st *topic, mqtt_buffer_st *payload) {
+    if ((topic == NULL) || (payload == NULL) || (payload->buffer == NULL)) {
         logger_print(ERR, TAG, "%s - Null pointer argument", __func__);
         return KERNEL_ERROR_NULL;
     }
 
-    if (buffer_size == 0) {
+    if (payload->size == 0) {
         logger_print(ERR, TAG, "%s - Buffer size is zero", __func__);
         return KERNEL_ERROR_INVALID_SIZE;
     }
 
     kernel_error_st err = KERNEL_ERROR_FAIL;
-    QueueHandle_t queue = queue_manager_get(topic->queue_index);
-    if (queue == NULL) {
-        logger_print(ERR, TAG, "%s - Queue not found for index %d", __func__, topic->queue_index);
-        return KERNEL_ERROR_MQTT_QUEUE_NULL;
+    payload->length     = 0;
+
+    if (topic->info->format == MQTT_PAYLOAD_FORMAT_PACKED) {
+        if (topic->info->data_type == DATA_TYPE_HISTORY_CHUNK) {
+            err = serialize_history_chunk(topic->queue_index, payload->buffer, payload->size, &payload->length);
+        } else if (topic->info->data_type == DATA_TYPE_SENSOR_REPORT) {
+            uint8_t max_reports = (topic->info->batch.max_reports > 1) ? topic->info->batch.max_reports : 1;
+
+            err = serialize_data_report_packed(topic->queue_index,
+                                               max_reports,
+                                               topic->info->batch.max_bytes,
+                                               payload->buffer,
+                                               payload->size,
+                                               &payload->length);
+        } else {
+            logger_print(ERR, TAG, "Packed format not supported for data type: %d", topic->info->data_type);
+            return KERNEL_ERROR_UNSUPPORTED_TYPE;
+        }
+
+        if (err != KERNEL_SUCCESS) {
+            logger_print(ERR, TAG, "Serialization failed for topic %s - %d", topic->info->topic, err);
+        }
+
+        return err;
     }
 
     switch (topic->info->data_type) {
         case DATA_TYPE_SENSOR_REPORT:
-            err = serialize_data_report(queue, buffer, buffer_size);
+            if (topic->info->batch.max_reports > 1) {
+                err = serialize_data_report_batch(topic->queue_index,
+                                                  topic->info->batch.max_reports,
+                                                  topic->info->batch.max_bytes,
+                                                  payload);
+            } else {
+                err = serialize_data_report(topic->queue_index, payload);
+            }
             break;
         case DATA_TYPE_COMMAND_RESPONSE:
-            err = serialize_command_response(queue, buffer, buffer_size);
+            err = serialize_command_response(topic->queue_index, payload);
             break;
         case DATA_TYPE_HEALTH_REPORT:
-            err = serialize_health_report(queue, buffer, buffer_size);
+            err = serialize_health_report(topic->queue_index, payload);
             break;
         default:
             logger_print(ERR, TAG, "Unsupported data type: %d", topic->info->data_type);
@@ -79,8 +200,8 @@ kernel_error_st mqtt_serialize_data(mqtt_topic_st *topic, char *buffer, size_t b
  * - DATA_TYPE_COMMAND: Uses `deserialize_command()` to parse the incoming JSON and enqueue a command.
  *
  * @param[in] topic        Pointer to the MQTT topic associated with the incoming data.
- * @param[in] buffer       Buffer containing the raw MQTT payload data (typically a JSON string).
- * @param[in] buffer_size  Size of the buffer in bytes.
+ * @param[in] buffer       Complete MQTT payload (typically JSON), only read; not null-terminated.
+ * @param[in] buffer_size  Length of the payload in bytes.
  *
  * @return KERNEL_SUCCESS on success.
  * @return KERNEL_ERROR_NULL if any pointer argument is NULL.
@@ -100,15 +221,10 @@ kernel_error_st mqtt_deserialize_data(mqtt_topic_st *topic, char *buffer, size_t
     }
 
     kernel_error_st err = KERNEL_ERROR_FAIL;
-    QueueHandle_t queue = queue_manager_get(topic->queue_index);
-    if (queue == NULL) {
-        logger_print(ERR, TAG, "%s - Queue not found for index %d", __func__, topic->queue_index);
-        return KERNEL_ERROR_MQTT_QUEUE_NULL;
-    }
 
     switch (topic->info->data_type) {
         case DATA_TYPE_COMMAND:
-            err = deserialize_command(queue, buffer, buffer_size);
+            err = deserialize_command(topic->queue_index, buffer, buffer_size);
             break;
 
         default:
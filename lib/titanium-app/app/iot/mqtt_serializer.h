@@ -6,26 +6,26 @@
 #include "kernel/inter_task_communication/inter_task_communication.h"
 
 /**
- * @brief Deserializes MQTT payload data and pushes the result into the appropriate queue.
+ * @brief Serializes data from a topic's queue into a buffer for MQTT transmission.
  *
- * This function interprets incoming MQTT message content according to the topic’s expected
- * data type. It extracts structured data (e.g., commands) and dispatches it to the application
- * via a queue.
+ * The encoding depends on the topic's data type and payload format: JSON text by
+ * default, or the packed binary layout (see packed_report_codec.h) for sensor
+ * report topics configured with MQTT_PAYLOAD_FORMAT_PACKED. History chunks are
+ * published as encoded by the SD card task (see sd_log_codec.h).
  *
- * Currently supports:
- * - DATA_TYPE_COMMAND: Uses `deserialize_command()` to parse the incoming JSON and enqueue a command.
+ * Single-message JSON payloads that do not fit the buffer grow it through its
+ * reserve hook, when one is set.
  *
- * @param[in] topic        Pointer to the MQTT topic associated with the incoming data.
- * @param[in] buffer       Buffer containing the raw MQTT payload data (typically a JSON string).
- * @param[in] buffer_size  Size of the buffer in bytes.
+ * @param[in]  topic    Pointer to the MQTT topic containing the queue and metadata.
+ * @param[out] payload  Payload buffer; `length` is set to the number of bytes written.
  *
  * @return KERNEL_SUCCESS on success.
- * @return KERNEL_ERROR_NULL if any pointer argument is NULL.
- * @return KERNEL_ERROR_INVALID_SIZE if buffer size is zero.
- * @return KERNEL_ERROR_UNSUPPORTED_TYPE if the topic data type is not supported.
- * @return Other kernel_error_st values returned by specific deserializer functions.
+ * @return KERNEL_ERROR_NULL if any input pointer is NULL.
+ * @return KERNEL_ERROR_INVALID_SIZE if the buffer size is zero.
+ * @return KERNEL_ERROR_UNSUPPORTED_TYPE if the topic data type or format is not supported.
+ * @return Other kernel_error_st values returned by specific serializer functions.
  */
-kernel_error_st mqtt_serialize_data(mqtt_topic_st *topic, char *buffer, size_t buffer_size);
+kernel_error_st mqtt_serialize_data(mqtt_topic_st *topic, mqtt_buffer_st *payload);
 
 /**
  * @brief Deserializes MQTT payload data and pushes the result into the appropriate queue.
@@ -38,8 +38,8 @@ kernel_error_st mqtt_serialize_data(mqtt_topic_st *topic, char *buffer, size_t b
  * - DATA_TYPE_COMMAND: Uses `deserialize_command()` to parse the incoming JSON and enqueue a command.
  *
  * @param[in] topic        Pointer to the MQTT topic associated with the incoming data.
- * @param[in] buffer       Buffer containing the raw MQTT payload data (typically a JSON string).
- * @param[in] buffer_size  Size of the buffer in bytes.
+ * @param[in] buffer       Complete MQTT payload (typically JSON), only read; not null-terminated.
+ * @param[in] buffer_size  Length of the payload in bytes.
  *
  * @return KERNEL_SUCCESS on success.
  * @return KERNEL_ERROR_NULL if any pointer argument is NULL.
@@ -0,0 +1,113 @@
+#include "packed_report_codec.h"
+
+#include "string.h"
+
+/**
+ * @brief Writes a 16-bit value in little-endian order.
+ */
+static void put_u16(uint8_t *out, uint16_t value) {
+    out[0] = (uint8_t)(value);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief Writes a 32-bit value in little-endian order.
+ */
+static void put_u32(uint8_t *out, uint32_t value) {
+    out[0] = (uint8_t)(value);
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+size_t packed_report_sample_size(uint8_t num_of_sensors) {
+    return sizeof(uint16_t) + ((num_of_sensors + 7) / 8) + (num_of_sensors * sizeof(int32_t));
+}
+
+kernel_error_st packed_report_begin(packed_report_writer_st *writer, uint8_t *buffer, size_t size) {
+    if ((writer == NULL) || (buffer == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (size < PACKED_REPORT_HEADER_SIZE) {
+        return KERNEL_ERROR_BUFFER_TOO_SHORT;
+    }
+
+    writer->buffer         = buffer;
+    writer->size           = size;
+    writer->length         = PACKED_REPORT_HEADER_SIZE;
+    writer->base_timestamp = 0;
+    writer->num_of_sensors = 0;
+    writer->num_of_samples = 0;
+
+    return KERNEL_SUCCESS;
+}
+
+kernel_error_st packed_report_add(packed_report_writer_st *writer,
+                                  uint32_t timestamp,
+                                  const sensor_report_st *sensors,
+                                  uint8_t num_of_sensors) {
+    if ((writer == NULL) || (sensors == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (writer->num_of_samples == UINT8_MAX) {
+        return KERNEL_ERROR_INVALID_ARG;
+    }
+
+    if (writer->num_of_samples == 0) {
+        writer->base_timestamp = timestamp;
+        writer->num_of_sensors = num_of_sensors;
+    } else if (num_of_sensors != writer->num_of_sensors) {
+        return KERNEL_ERROR_INVALID_ARG;
+    }
+
+    if ((timestamp < writer->base_timestamp) || ((timestamp - writer->base_timestamp) > UINT16_MAX)) {
+        return KERNEL_ERROR_INVALID_ARG;
+    }
+
+    size_t sample_size = packed_report_sample_size(num_of_sensors);
+    if ((writer->length + sample_size) > writer->size) {
+        return KERNEL_ERROR_BUFFER_TOO_SHORT;
+    }
+
+    uint8_t *out = &writer->buffer[writer->length];
+
+    put_u16(out, (uint16_t)(timestamp - writer->base_timestamp));
+    out += sizeof(uint16_t);
+
+    size_t mask_size = (num_of_sensors + 7) / 8;
+    memset(out, 0, mask_size);
+    for (uint8_t i = 0; i < num_of_sensors; i++) {
+        if (sensors[i].active) {
+            out[i / 8] |= (uint8_t)(1 << (i % 8));
+        }
+    }
+    out += mask_size;
+
+    for (uint8_t i = 0; i < num_of_sensors; i++) {
+        /* Same rounding as the JSON serializer */
+        int32_t value = (int32_t)(sensors[i].value * PACKED_REPORT_VALUE_SCALE + 0.5);
+        put_u32(out, (uint32_t)value);
+        out += sizeof(int32_t);
+    }
+
+    writer->length += sample_size;
+    writer->num_of_samples++;
+
+    return KERNEL_SUCCESS;
+}
+
+size_t packed_report_end(packed_report_writer_st *writer) {
+    if ((writer == NULL) || (writer->num_of_samples == 0)) {
+        return 0;
+    }
+
+    writer->buffer[0] = PACKED_REPORT_VERSION;
+    writer->buffer[1] = writer->num_of_samples;
+    writer->buffer[2] = writer->num_of_sensors;
+    writer->buffer[3] = 0;
+    put_u32(&writer->buffer[4], writer->base_timestamp);
+
+    return writer->length;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+/**
+ * @file packed_report_codec.h
+ * @brief Compact binary encoding of device reports.
+ *
+ * Versioned, little-endian layout used by topics whose format is
+ * MQTT_PAYLOAD_FORMAT_PACKED. One payload holds one or more samples that
+ * share a header:
+ *
+ * | Offset | Size | Field                                          |
+ * |--------|------|------------------------------------------------|
+ * | 0      | 1    | version (PACKED_REPORT_VERSION)                |
+ * | 1      | 1    | number of samples                              |
+ * | 2      | 1    | number of sensors per sample                   |
+ * | 3      | 1    | reserved, 0                                    |
+ * | 4      | 4    | base timestamp, unix seconds (uint32)          |
+ *
+ * followed by, for each sample:
+ *
+ * | Size           | Field                                                   |
+ * |----------------|---------------------------------------------------------|
+ * | 2              | seconds since the base timestamp (uint16)               |
+ * | ceil(n / 8)    | active bitmask, bit i of byte i / 8 is sensor i         |
+ * | 4 * n          | sensor values, fixed point x100 (int32)                 |
+ *
+ * Values use the same two-decimal rounding as the JSON serializer.
+ * The module has no RTOS dependency so it can be built on the host.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernel/error/error_num.h"
+
+#include "app/sensor_manager/sensor_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PACKED_REPORT_VERSION 1        ///< Layout version written in the header.
+#define PACKED_REPORT_HEADER_SIZE 8    ///< Size in bytes of the shared header.
+#define PACKED_REPORT_VALUE_SCALE 100  ///< Fixed-point scale of sensor values.
+
+/**
+ * @brief State of a packed report being written.
+ */
+typedef struct packed_report_writer_s {
+    uint8_t *buffer;          ///< Output buffer.
+    size_t size;              ///< Size of the output buffer in bytes.
+    size_t length;            ///< Bytes written so far.
+    uint32_t base_timestamp;  ///< Timestamp of the first sample.
+    uint8_t num_of_sensors;   ///< Sensors per sample, fixed by the first sample.
+    uint8_t num_of_samples;   ///< Samples written so far.
+} packed_report_writer_st;
+
+/**
+ * @brief Size in bytes of one encoded sample.
+ *
+ * @param num_of_sensors Sensors in the sample.
+ * @return Encoded sample size in bytes.
+ */
+size_t packed_report_sample_size(uint8_t num_of_sensors);
+
+/**
+ * @brief Starts a packed report in the given buffer.
+ *
+ * @param writer Writer state to initialize.
+ * @param buffer Output buffer.
+ * @param size   Size of the output buffer in bytes.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if writer or buffer is null
+ *         - KERNEL_ERROR_BUFFER_TOO_SHORT if the header does not fit
+ */
+kernel_error_st packed_report_begin(packed_report_writer_st *writer, uint8_t *buffer, size_t size);
+
+/**
+ * @brief Appends one sample to a packed report.
+ *
+ * The first sample fixes the base timestamp and the number of sensors.
+ *
+ * @param writer         Writer state.
+ * @param timestamp      Sample timestamp, unix seconds.
+ * @param sensors        Sensor readings of the sample.
+ * @param num_of_sensors Number of readings in `sensors`.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if writer or sensors is null
+ *         - KERNEL_ERROR_INVALID_ARG if the sensor count differs from the first sample,
+ *           the sample is older than the base or too far from it, or the report is full
+ *         - KERNEL_ERROR_BUFFER_TOO_SHORT if the sample does not fit (nothing is written)
+ */
+kernel_error_st packed_report_add(packed_report_writer_st *writer,
+                                  uint32_t timestamp,
+                                  const sensor_report_st *sensors,
+                                  uint8_t num_of_sensors);
+
+/**
+ * @brief Finalizes a packed report.
+ *
+ * @param writer Writer state.
+ * @return Total encoded length in bytes, 0 if no sample was written.
+ */
+size_t packed_report_end(packed_report_writer_st *writer);
+
+#ifdef __cplusplus
+}
+#endif
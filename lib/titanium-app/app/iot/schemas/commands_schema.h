@@ -6,7 +6,9 @@
  * deserialized into application-specific command structures. Each schema
  * corresponds to a specific command and ensures type and presence validation.
  *
- * These schemas are used in combination with the `validate_json_schema()` function.
+ * Each command is described once, as a field list mapping JSON keys to the
+ * members of its payload struct. The lists expand into `validate_json_schema()`
+ * schemas and into the compile-time binding tables of `schema_bind_command()`.
  */
 
 #pragma once
@@ -14,7 +16,28 @@
 #include "schema_validator.h"
 
 /**
- * @brief Schema definition for the CMD_SET_CALIBRATION command.
+ * @brief Expands a field list entry into a json_field_t initializer.
+ *
+ * Field lists are X-macros: `FIELD(type, key, json_type, member)` binds the
+ * JSON key `key` of the expected type to `type::member`. The same list
+ * generates the validation schema below and the binding table used by
+ * schema_bind_command() (see JSON_BINDING_FIELD in schema_binder.h).
+ */
+#define JSON_SCHEMA_FIELD(type, key, json_type, member) {#key, json_type},
+
+/**
+ * @brief Expands a field list array entry into a json_field_t initializer.
+ *
+ * Lists holding arrays of objects take a second X-macro,
+ * `ARRAY(type, key, member, elements)`, binding the JSON array `key` to the
+ * struct array `type::member`. `elements` names the element binding built with
+ * JSON_ARRAY_BINDING() next to the binding tables; the schema only checks
+ * that the value is an array.
+ */
+#define JSON_SCHEMA_ARRAY(type, key, member, elements) {#key, JSON_TYPE_ARRAY},
+
+/**
+ * @brief Fields of the CMD_SET_CALIBRATION command.
  *
  * Expected payload structure:
  * {
@@ -23,13 +46,13 @@
  *   "offset": float
  * }
  */
-static const json_field_t get_calibration_schema[] = {
-    {"sensor_id", JSON_TYPE_INT},
-    {"gain", JSON_TYPE_FLOAT},
-    {"offset", JSON_TYPE_FLOAT}};
+#define CMD_SET_CALIBRATION_FIELDS(FIELD)                                 \
+    FIELD(cmd_set_calibration_st, sensor_id, JSON_TYPE_INT, sensor_index) \
+    FIELD(cmd_set_calibration_st, gain, JSON_TYPE_FLOAT, gain)            \
+    FIELD(cmd_set_calibration_st, offset, JSON_TYPE_FLOAT, offset)
 
 /**
- * @brief Schema definition for the CMD_GET_SYSTEM_INFO command.
+ * @brief Fields of the CMD_GET_SYSTEM_INFO command.
  *
  * Expected payload structure:
  * {
@@ -37,12 +60,62 @@ static const json_field_t get_calibration_schema[] = {
  *   "password": string,
  * }
  */
-static const json_field_t get_system_info_schema[] = {
-    {"user", JSON_TYPE_STRING},
-    {"password", JSON_TYPE_STRING},
-};
+#define CMD_GET_SYSTEM_INFO_FIELDS(FIELD)                           \
+    FIELD(cmd_get_system_info_st, user, JSON_TYPE_STRING, user)     \
+    FIELD(cmd_get_system_info_st, password, JSON_TYPE_STRING, password)
+
+/**
+ * @brief Fields of the CMD_SET_CALIBRATION_BATCH command.
+ *
+ * Each element of `calibrations` has the fields of CMD_SET_CALIBRATION.
+ *
+ * Expected payload structure:
+ * {
+ *   "calibrations": [
+ *     {"sensor_id": int, "gain": float, "offset": float},
+ *     ...
+ *   ]
+ * }
+ */
+#define CMD_SET_CALIBRATION_BATCH_FIELDS(FIELD, ARRAY) \
+    ARRAY(cmd_set_calibration_batch_st, calibrations, items, set_calibration_items)
+
+/**
+ * @brief Fields of the CMD_GET_HISTORY command.
+ *
+ * Expected payload structure:
+ * {
+ *   "from": int64,
+ *   "to": int64,
+ *   "offset": int
+ * }
+ */
+#define CMD_GET_HISTORY_FIELDS(FIELD)                         \
+    FIELD(cmd_get_history_st, from, JSON_TYPE_INT64, from)   \
+    FIELD(cmd_get_history_st, to, JSON_TYPE_INT64, to)       \
+    FIELD(cmd_get_history_st, offset, JSON_TYPE_INT, offset)
+
+/**
+ * @brief Schema definition for the CMD_SET_CALIBRATION command.
+ */
+static const json_field_t get_calibration_schema[] = {CMD_SET_CALIBRATION_FIELDS(JSON_SCHEMA_FIELD)};
+
+/**
+ * @brief Schema definition for the CMD_GET_SYSTEM_INFO command.
+ */
+static const json_field_t get_system_info_schema[] = {CMD_GET_SYSTEM_INFO_FIELDS(JSON_SCHEMA_FIELD)};
+
+/**
+ * @brief Schema definition for the CMD_SET_CALIBRATION_BATCH command.
+ */
+static const json_field_t set_calibration_batch_schema[] = {
+    CMD_SET_CALIBRATION_BATCH_FIELDS(JSON_SCHEMA_FIELD, JSON_SCHEMA_ARRAY)};
+
+/**
+ * @brief Schema definition for the CMD_GET_HISTORY command.
+ */
+static const json_field_t get_history_schema[] = {CMD_GET_HISTORY_FIELDS(JSON_SCHEMA_FIELD)};
 
-// Future command schemas can be added below:
-// static const json_field_t reboot_schema[] = {
-//     {"delay_ms", JSON_TYPE_INT}
-// };
+// Future command field lists can be added below:
+// #define CMD_REBOOT_FIELDS(FIELD)
+//     FIELD(cmd_reboot_st, delay_ms, JSON_TYPE_INT, delay_ms)
@@ -0,0 +1,1151 @@
+#include "schema_binder.h"
+
+#include <math.h>
+#include <string.h>
+
+/*
+ * The reader follows ArduinoJson 6.21 with the configuration used by the
+ * firmware (no comments, no NaN/Infinity, 32-bit floats, 64-bit integers,
+ * Unicode escapes decoded), so the same payloads are accepted and bind to
+ * the same values: single-quoted strings and unquoted keys are allowed, a
+ * NUL byte ends the input, the last of duplicate keys wins, and strings and
+ * keys compare up to their first decoded NUL.
+ */
+
+#define SCHEMA_BINDER_NESTING_LIMIT 10  ///< Deepest container nesting, ARDUINOJSON_DEFAULT_NESTING_LIMIT.
+#define SCHEMA_BINDER_NUMBER_LENGTH 63  ///< Longest number token read by ArduinoJson.
+#define SCHEMA_BINDER_KEY_SIZE 32       ///< Longest key compared with the bindings, including terminator.
+#define SCHEMA_BINDER_MAXIMUM_FIELDS 16 ///< Most bindings per command.
+
+#define FLOAT_MANTISSA_MAX ((1UL << 23) - 1)  ///< Largest mantissa kept by the float parser.
+#define FLOAT_EXPONENT_MAX 38                 ///< Largest decimal exponent of a float.
+
+/**
+ * @brief Input being read.
+ */
+typedef struct {
+    const char *cursor;  ///< Next character.
+    const char *end;     ///< End of input: end of buffer or first NUL byte.
+} json_reader_t;
+
+/**
+ * @brief Kind of a JSON value, as stored by ArduinoJson.
+ */
+typedef enum {
+    JSON_VALUE_NULL,
+    JSON_VALUE_BOOL,
+    JSON_VALUE_UNSIGNED,  ///< Non-negative integer.
+    JSON_VALUE_SIGNED,    ///< Negative integer (or -0).
+    JSON_VALUE_FLOAT,
+    JSON_VALUE_STRING,
+    JSON_VALUE_OBJECT,
+    JSON_VALUE_ARRAY,
+} json_value_kind_t;
+
+/**
+ * @brief A scalar JSON value; containers and strings only record their kind.
+ */
+typedef struct {
+    json_value_kind_t kind;
+    union {
+        bool boolean;
+        uint64_t unsigned_integer;
+        int64_t signed_integer;
+        float real;
+    } as;
+} json_value_t;
+
+/**
+ * @brief Destination of a decoded string.
+ *
+ * Characters are stored up to `size - 1` and counted up to the first decoded
+ * NUL, which ends the string for comparison and copy.
+ */
+typedef struct {
+    char *out;        ///< Destination, NULL to only validate.
+    size_t size;      ///< Size of the destination.
+    size_t length;    ///< Decoded length up to the first NUL.
+    bool terminated;  ///< A NUL was decoded, further characters are ignored.
+} json_string_sink_t;
+
+/**
+ * @brief Binding state of one field.
+ */
+typedef enum {
+    FIELD_MISSING = 0,
+    FIELD_BOUND,
+    FIELD_INVALID_TYPE,
+    FIELD_TOO_LONG,     ///< String longer than its field, or array longer than its struct array.
+    FIELD_INCOMPLETE,   ///< Array with an element missing a member.
+} field_status_t;
+
+static const float positive_powers_of_ten[] = {1e1f, 1e2f, 1e4f, 1e8f, 1e16f, 1e32f};
+static const float negative_powers_of_ten[] = {1e-1f, 1e-2f, 1e-4f, 1e-8f, 1e-16f, 1e-32f};
+
+static char current(const json_reader_t *reader) {
+    return (reader->cursor < reader->end) ? *reader->cursor : '\0';
+}
+
+static bool eat(json_reader_t *reader, char c) {
+    if (current(reader) != c) {
+        return false;
+    }
+
+    reader->cursor++;
+    return true;
+}
+
+/**
+ * @brief Skips whitespace.
+ *
+ * @return false at the end of input.
+ */
+static bool skip_spaces(json_reader_t *reader) {
+    for (;;) {
+        switch (current(reader)) {
+            case '\0':
+                return false;
+            case ' ':
+            case '\t':
+            case '\r':
+            case '\n':
+                reader->cursor++;
+                continue;
+            default:
+                return true;
+        }
+    }
+}
+
+static bool is_digit(char c) {
+    return (c >= '0') && (c <= '9');
+}
+
+static bool can_be_in_number(char c) {
+    return is_digit(c) || (c == '+') || (c == '-') || (c == '.') || (c == 'e') || (c == 'E');
+}
+
+static bool can_be_in_unquoted_key(char c) {
+    return is_digit(c) || ((c >= '_') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'));
+}
+
+static void sink_append(json_string_sink_t *sink, char c) {
+    if (sink->terminated) {
+        return;
+    }
+
+    if (c == '\0') {
+        sink->terminated = true;
+        return;
+    }
+
+    if ((sink->out != NULL) && (sink->length + 1 < sink->size)) {
+        sink->out[sink->length] = c;
+    }
+    sink->length++;
+}
+
+/**
+ * @brief Terminates the sink and clears the rest of its destination.
+ */
+static void sink_finish(json_string_sink_t *sink) {
+    if ((sink->out == NULL) || (sink->size == 0)) {
+        return;
+    }
+
+    size_t stored = (sink->length < sink->size) ? sink->length : (sink->size - 1);
+    memset(&sink->out[stored], 0, sink->size - stored);
+}
+
+/**
+ * @brief Appends a code point encoded in UTF-8, as ArduinoJson does.
+ */
+static void sink_append_codepoint(json_string_sink_t *sink, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        sink_append(sink, (char)codepoint);
+        return;
+    }
+
+    char bytes[4];
+    size_t count = 0;
+
+    bytes[count++]       = (char)((codepoint | 0x80) & 0xBF);
+    uint16_t codepoint16 = (uint16_t)(codepoint >> 6);
+    if (codepoint16 < 0x20) {
+        bytes[count++] = (char)(codepoint16 | 0xC0);
+    } else {
+        bytes[count++] = (char)((codepoint16 | 0x80) & 0xBF);
+        codepoint16    = (uint16_t)(codepoint16 >> 6);
+        if (codepoint16 < 0x10) {
+            bytes[count++] = (char)(codepoint16 | 0xE0);
+        } else {
+            bytes[count++] = (char)((codepoint16 | 0x80) & 0xBF);
+            codepoint16    = (uint16_t)(codepoint16 >> 6);
+            bytes[count++] = (char)(codepoint16 | 0xF0);
+        }
+    }
+
+    while (count > 0) {
+        sink_append(sink, bytes[--count]);
+    }
+}
+
+/**
+ * @brief Value of a hex digit, above 0x0F when invalid (ArduinoJson's decodeHex()).
+ */
+static uint8_t decode_hex(char c) {
+    if (c < 'A') {
+        return (uint8_t)(c - '0');
+    }
+
+    c = (char)(c & ~0x20);
+    return (uint8_t)(c - 'A' + 10);
+}
+
+static char unescape_char(char c) {
+    switch (c) {
+        case '/':
+            return '/';
+        case '"':
+            return '"';
+        case '\\':
+            return '\\';
+        case 'b':
+            return '\b';
+        case 'f':
+            return '\f';
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        default:
+            return '\0';
+    }
+}
+
+/**
+ * @brief Reads a quoted string, decoding escapes into `sink`.
+ */
+static bool read_quoted_string(json_reader_t *reader, json_string_sink_t *sink) {
+    const char stop_char = current(reader);
+    uint16_t high_surrogate = 0;
+
+    reader->cursor++;
+
+    for (;;) {
+        char c = current(reader);
+        if (c == '\0') {
+            return false;
+        }
+        reader->cursor++;
+
+        if (c == stop_char) {
+            break;
+        }
+
+        if (c == '\\') {
+            c = current(reader);
+            if (c == '\0') {
+                return false;
+            }
+            reader->cursor++;
+
+            if (c == 'u') {
+                uint16_t codeunit = 0;
+                for (int i = 0; i < 4; i++) {
+                    char digit = current(reader);
+                    if (digit == '\0') {
+                        return false;
+                    }
+
+                    uint8_t value = decode_hex(digit);
+                    if (value > 0x0F) {
+                        return false;
+                    }
+
+                    codeunit = (uint16_t)((codeunit << 4) | value);
+                    reader->cursor++;
+                }
+
+                if ((codeunit >= 0xD800) && (codeunit < 0xDC00)) {
+                    high_surrogate = codeunit & 0x3FF;
+                } else if ((codeunit >= 0xDC00) && (codeunit < 0xE000)) {
+                    sink_append_codepoint(sink, (uint32_t)(0x10000 + ((high_surrogate << 10) | (codeunit & 0x3FF))));
+                } else {
+                    sink_append_codepoint(sink, codeunit);
+                }
+                continue;
+            }
+
+            c = unescape_char(c);
+            if (c == '\0') {
+                return false;
+            }
+        }
+
+        sink_append(sink, c);
+    }
+
+    sink_finish(sink);
+    return true;
+}
+
+/**
+ * @brief Reads an object key, quoted or not.
+ */
+static bool read_key(json_reader_t *reader, json_string_sink_t *sink) {
+    char c = current(reader);
+
+    if ((c == '"') || (c == '\'')) {
+        return read_quoted_string(reader, sink);
+    }
+
+    if (!can_be_in_unquoted_key(c)) {
+        return false;
+    }
+
+    do {
+        sink_append(sink, c);
+        reader->cursor++;
+        c = current(reader);
+    } while (can_be_in_unquoted_key(c));
+
+    sink_finish(sink);
+    return true;
+}
+
+/**
+ * @brief Scales a mantissa by a power of ten, as ArduinoJson's make_float().
+ */
+static float make_float(float mantissa, int exponent) {
+    const float *powers = (exponent > 0) ? positive_powers_of_ten : negative_powers_of_ten;
+
+    if (exponent < 0) {
+        exponent = -exponent;
+    }
+
+    for (size_t index = 0; exponent != 0; index++) {
+        if (exponent & 1) {
+            mantissa *= (index < (sizeof(positive_powers_of_ten) / sizeof(float))) ? powers[index] : 0.0f;
+        }
+        exponent >>= 1;
+    }
+
+    return mantissa;
+}
+
+/**
+ * @brief Converts a number token, as ArduinoJson's parseNumber().
+ *
+ * Integers that fit 64 bits are kept exact; anything else becomes a float.
+ */
+static bool parse_number(const char *s, json_value_t *value) {
+    bool is_negative = false;
+
+    if (*s == '-') {
+        is_negative = true;
+        s++;
+    } else if (*s == '+') {
+        s++;
+    }
+
+    if (!is_digit(*s) && (*s != '.')) {
+        return false;
+    }
+
+    uint64_t mantissa      = 0;
+    int8_t exponent_offset = 0;
+
+    while (is_digit(*s)) {
+        uint8_t digit = (uint8_t)(*s - '0');
+        if (mantissa > UINT64_MAX / 10) {
+            break;
+        }
+        mantissa *= 10;
+        if (mantissa > UINT64_MAX - digit) {
+            break;
+        }
+        mantissa += digit;
+        s++;
+    }
+
+    if (*s == '\0') {
+        if (!is_negative) {
+            value->kind                = JSON_VALUE_UNSIGNED;
+            value->as.unsigned_integer = mantissa;
+            return true;
+        }
+
+        if (mantissa <= (UINT64_C(1) << 63)) {
+            value->kind              = JSON_VALUE_SIGNED;
+            value->as.signed_integer = (int64_t)(~mantissa + 1);
+            return true;
+        }
+    }
+
+    while (mantissa > FLOAT_MANTISSA_MAX) {
+        mantissa /= 10;
+        exponent_offset++;
+    }
+
+    while (is_digit(*s)) {
+        exponent_offset++;
+        s++;
+    }
+
+    if (*s == '.') {
+        s++;
+        while (is_digit(*s)) {
+            if (mantissa < FLOAT_MANTISSA_MAX / 10) {
+                mantissa = (mantissa * 10) + (uint8_t)(*s - '0');
+                exponent_offset--;
+            }
+            s++;
+        }
+    }
+
+    int exponent = 0;
+    if ((*s == 'e') || (*s == 'E')) {
+        s++;
+        bool negative_exponent = false;
+        if (*s == '-') {
+            negative_exponent = true;
+            s++;
+        } else if (*s == '+') {
+            s++;
+        }
+
+        while (is_digit(*s)) {
+            exponent = (exponent * 10) + (*s - '0');
+            if (exponent + exponent_offset > FLOAT_EXPONENT_MAX) {
+                value->kind = JSON_VALUE_FLOAT;
+                if (negative_exponent) {
+                    value->as.real = is_negative ? -0.0f : 0.0f;
+                } else {
+                    value->as.real = is_negative ? -INFINITY : INFINITY;
+                }
+                return true;
+            }
+            s++;
+        }
+
+        if (negative_exponent) {
+            exponent = -exponent;
+        }
+    }
+
+    exponent += exponent_offset;
+
+    if (*s != '\0') {
+        return false;
+    }
+
+    float result   = make_float((float)mantissa, exponent);
+    value->kind    = JSON_VALUE_FLOAT;
+    value->as.real = is_negative ? -result : result;
+
+    return true;
+}
+
+static bool read_number(json_reader_t *reader, json_value_t *value) {
+    char token[SCHEMA_BINDER_NUMBER_LENGTH + 1];
+    size_t length = 0;
+
+    while (can_be_in_number(current(reader)) && (length < SCHEMA_BINDER_NUMBER_LENGTH)) {
+        token[length++] = *reader->cursor++;
+    }
+    token[length] = '\0';
+
+    return parse_number(token, value);
+}
+
+static bool read_keyword(json_reader_t *reader, const char *keyword) {
+    for (; *keyword != '\0'; keyword++) {
+        if (!eat(reader, *keyword)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool read_value(json_reader_t *reader, json_value_t *value, json_string_sink_t *sink, uint8_t nesting);
+
+/**
+ * @brief Reads an object or array, validating every member.
+ */
+static bool skip_container(json_reader_t *reader, uint8_t nesting) {
+    const bool is_object = (current(reader) == '{');
+    const char close     = is_object ? '}' : ']';
+    json_value_t member  = {};
+
+    if (nesting == 0) {
+        return false;
+    }
+
+    reader->cursor++;
+    if (!skip_spaces(reader)) {
+        return false;
+    }
+
+    if (eat(reader, close)) {
+        return true;
+    }
+
+    for (;;) {
+        if (is_object) {
+            json_string_sink_t key = {};
+            if (!read_key(reader, &key) || !skip_spaces(reader) || !eat(reader, ':')) {
+                return false;
+            }
+        }
+
+        if (!read_value(reader, &member, NULL, (uint8_t)(nesting - 1)) || !skip_spaces(reader)) {
+            return false;
+        }
+
+        if (eat(reader, close)) {
+            return true;
+        }
+
+        if (!eat(reader, ',')) {
+            return false;
+        }
+
+        if (is_object && !skip_spaces(reader)) {
+            return false;
+        }
+    }
+}
+
+/**
+ * @brief Reads any value.
+ *
+ * @param[out] value   Kind of the value, and the value itself for scalars.
+ * @param[out] sink    Destination of a string value, NULL to only validate.
+ * @param[in]  nesting Remaining container nesting.
+ */
+static bool read_value(json_reader_t *reader, json_value_t *value, json_string_sink_t *sink, uint8_t nesting) {
+    json_string_sink_t discard = {};
+
+    if (!skip_spaces(reader)) {
+        return false;
+    }
+
+    switch (current(reader)) {
+        case '{':
+            value->kind = JSON_VALUE_OBJECT;
+            return skip_container(reader, nesting);
+        case '[':
+            value->kind = JSON_VALUE_ARRAY;
+            return skip_container(reader, nesting);
+        case '"':
+        case '\'':
+            value->kind = JSON_VALUE_STRING;
+            return read_quoted_string(reader, (sink != NULL) ? sink : &discard);
+        case 't':
+            value->kind       = JSON_VALUE_BOOL;
+            value->as.boolean = true;
+            return read_keyword(reader, "true");
+        case 'f':
+            value->kind       = JSON_VALUE_BOOL;
+            value->as.boolean = false;
+            return read_keyword(reader, "false");
+        case 'n':
+            value->kind = JSON_VALUE_NULL;
+            return read_keyword(reader, "null");
+        default:
+            return read_number(reader, value);
+    }
+}
+
+static bool is_int(const json_value_t *value) {
+    switch (value->kind) {
+        case JSON_VALUE_UNSIGNED:
+            return value->as.unsigned_integer <= INT32_MAX;
+        case JSON_VALUE_SIGNED:
+            return value->as.signed_integer >= INT32_MIN;
+        default:
+            return false;
+    }
+}
+
+static bool is_int64(const json_value_t *value) {
+    return ((value->kind == JSON_VALUE_UNSIGNED) && (value->as.unsigned_integer <= INT64_MAX)) ||
+           (value->kind == JSON_VALUE_SIGNED);
+}
+
+static bool is_uint32(const json_value_t *value) {
+    switch (value->kind) {
+        case JSON_VALUE_UNSIGNED:
+            return value->as.unsigned_integer <= UINT32_MAX;
+        case JSON_VALUE_SIGNED:
+            return (value->as.signed_integer >= 0) && (value->as.signed_integer <= UINT32_MAX);
+        default:
+            return false;
+    }
+}
+
+static bool is_number(const json_value_t *value) {
+    return (value->kind == JSON_VALUE_UNSIGNED) || (value->kind == JSON_VALUE_SIGNED) || (value->kind == JSON_VALUE_FLOAT);
+}
+
+/**
+ * @brief Stores an integer, 0 when it does not fit the field (ArduinoJson's convertNumber()).
+ */
+static void store_int(uint8_t *field, uint16_t size, int64_t value) {
+    switch (size) {
+        case sizeof(int8_t): {
+            int8_t narrow = ((value >= INT8_MIN) && (value <= INT8_MAX)) ? (int8_t)value : 0;
+            memcpy(field, &narrow, sizeof(narrow));
+            break;
+        }
+        case sizeof(int16_t): {
+            int16_t narrow = ((value >= INT16_MIN) && (value <= INT16_MAX)) ? (int16_t)value : 0;
+            memcpy(field, &narrow, sizeof(narrow));
+            break;
+        }
+        case sizeof(int32_t): {
+            int32_t narrow = (int32_t)value;
+            memcpy(field, &narrow, sizeof(narrow));
+            break;
+        }
+        default:
+            memcpy(field, &value, sizeof(value));
+            break;
+    }
+}
+
+static void store_float(uint8_t *field, uint16_t size, const json_value_t *value) {
+    float real = value->as.real;
+
+    if (value->kind == JSON_VALUE_UNSIGNED) {
+        real = (float)value->as.unsigned_integer;
+    } else if (value->kind == JSON_VALUE_SIGNED) {
+        real = (float)value->as.signed_integer;
+    }
+
+    if (size == sizeof(double)) {
+        double wide = real;
+        memcpy(field, &wide, sizeof(wide));
+    } else {
+        memcpy(field, &real, sizeof(real));
+    }
+}
+
+/**
+ * @brief Checks a value against its binding and stores it.
+ *
+ * Strings are stored while they are read, by the caller.
+ */
+static field_status_t bind_value(const json_binding_t *binding, const json_value_t *value, uint8_t *payload) {
+    uint8_t *field = &payload[binding->offset];
+
+    switch (binding->expected_type) {
+        case JSON_TYPE_INT:
+            if (!is_int(value)) {
+                return FIELD_INVALID_TYPE;
+            }
+            store_int(field,
+                      binding->size,
+                      (value->kind == JSON_VALUE_UNSIGNED) ? (int64_t)value->as.unsigned_integer : value->as.signed_integer);
+            return FIELD_BOUND;
+
+        case JSON_TYPE_INT64: {
+            if (!is_int64(value)) {
+                return FIELD_INVALID_TYPE;
+            }
+            int64_t wide = (value->kind == JSON_VALUE_UNSIGNED) ? (int64_t)value->as.unsigned_integer : value->as.signed_integer;
+            memcpy(field, &wide, sizeof(wide));
+            return FIELD_BOUND;
+        }
+
+        case JSON_TYPE_FLOAT:
+            if (!is_number(value)) {
+                return FIELD_INVALID_TYPE;
+            }
+            store_float(field, binding->size, value);
+            return FIELD_BOUND;
+
+        case JSON_TYPE_BOOL:
+            if (value->kind != JSON_VALUE_BOOL) {
+                return FIELD_INVALID_TYPE;
+            }
+            memcpy(field, &value->as.boolean, sizeof(bool));
+            return FIELD_BOUND;
+
+        default:
+            return FIELD_INVALID_TYPE;
+    }
+}
+
+static const json_binding_t *find_binding(const json_binding_t *fields, size_t num_fields, const json_string_sink_t *key) {
+    if (key->length >= SCHEMA_BINDER_KEY_SIZE) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < num_fields; i++) {
+        if (strcmp(fields[i].key, key->out) == 0) {
+            return &fields[i];
+        }
+    }
+
+    return NULL;
+}
+
+static bool bind_object(json_reader_t *reader,
+                        const json_binding_t *fields,
+                        size_t num_fields,
+                        uint8_t *payload,
+                        size_t payload_size,
+                        field_status_t *status,
+                        uint8_t nesting);
+
+/**
+ * @brief Stores an element count in an integer field of 1, 2 or 4 bytes.
+ */
+static void store_count(uint8_t *field, uint16_t size, uint16_t count) {
+    switch (size) {
+        case sizeof(uint8_t): {
+            uint8_t narrow = (uint8_t)count;
+            memcpy(field, &narrow, sizeof(narrow));
+            break;
+        }
+        case sizeof(uint16_t):
+            memcpy(field, &count, sizeof(count));
+            break;
+        default: {
+            uint32_t wide = count;
+            memcpy(field, &wide, sizeof(wide));
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Status of an array element from the status of its members.
+ *
+ * The first member missing or of the wrong type, in binding order, decides;
+ * otherwise a string too long for its field.
+ */
+static field_status_t element_status(const field_status_t *status, size_t num_fields) {
+    bool too_long = false;
+
+    for (size_t i = 0; i < num_fields; i++) {
+        switch (status[i]) {
+            case FIELD_MISSING:
+            case FIELD_INCOMPLETE:
+                return FIELD_INCOMPLETE;
+            case FIELD_INVALID_TYPE:
+                return FIELD_INVALID_TYPE;
+            case FIELD_TOO_LONG:
+                too_long = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    return too_long ? FIELD_TOO_LONG : FIELD_BOUND;
+}
+
+/**
+ * @brief Reads an array of objects, binding each element to the next struct of the array field.
+ *
+ * The first failing element, in array order, sets the status of the field.
+ * Elements past the capacity of the struct array are only validated, and the
+ * field is then too long whatever the other elements hold.
+ *
+ * @return false if the input is not valid JSON.
+ */
+static bool bind_array(json_reader_t *reader,
+                       const json_binding_t *binding,
+                       uint8_t *payload,
+                       field_status_t *status,
+                       uint8_t nesting) {
+    const json_array_binding_t *array = binding->array;
+    uint8_t *elements                 = &payload[binding->offset];
+    json_value_t value                = {};
+    field_status_t result             = FIELD_BOUND;
+    uint16_t count                    = 0;
+
+    if ((current(reader) != '[') || (array->num_fields > SCHEMA_BINDER_MAXIMUM_FIELDS)) {
+        if (!read_value(reader, &value, NULL, nesting)) {
+            return false;
+        }
+
+        /* A repeated key set to null keeps the earlier value, as in ArduinoJson. */
+        if ((value.kind != JSON_VALUE_NULL) || (*status == FIELD_MISSING)) {
+            memset(elements, 0, binding->size);
+            store_count(&payload[array->count_offset], array->count_size, 0);
+            *status = FIELD_INVALID_TYPE;
+        }
+        return true;
+    }
+
+    if (nesting == 0) {
+        return false;
+    }
+
+    memset(elements, 0, binding->size);
+
+    reader->cursor++;
+    if (!skip_spaces(reader)) {
+        return false;
+    }
+
+    if (!eat(reader, ']')) {
+        for (;;) {
+            if (!skip_spaces(reader)) {
+                return false;
+            }
+
+            if (count >= array->max_elements) {
+                if (!read_value(reader, &value, NULL, (uint8_t)(nesting - 1))) {
+                    return false;
+                }
+                result = FIELD_TOO_LONG;
+            } else if (current(reader) == '{') {
+                field_status_t member_status[SCHEMA_BINDER_MAXIMUM_FIELDS] = {};
+
+                if (!bind_object(reader,
+                                 array->fields,
+                                 array->num_fields,
+                                 &elements[count * array->element_size],
+                                 array->element_size,
+                                 member_status,
+                                 (uint8_t)(nesting - 1))) {
+                    return false;
+                }
+
+                if (result == FIELD_BOUND) {
+                    result = element_status(member_status, array->num_fields);
+                }
+                count++;
+            } else {
+                if (!read_value(reader, &value, NULL, (uint8_t)(nesting - 1))) {
+                    return false;
+                }
+
+                if (result == FIELD_BOUND) {
+                    result = FIELD_INVALID_TYPE;
+                }
+                count++;
+            }
+
+            if (!skip_spaces(reader)) {
+                return false;
+            }
+
+            if (eat(reader, ']')) {
+                break;
+            }
+
+            if (!eat(reader, ',')) {
+                return false;
+            }
+        }
+    }
+
+    store_count(&payload[array->count_offset], array->count_size, count);
+    *status = result;
+
+    return true;
+}
+
+/**
+ * @brief Reads an object value, binding its members to the fields of a struct.
+ *
+ * Used for `params` and for the elements of array fields. A value that is not
+ * an object is validated and leaves every field missing.
+ */
+static bool bind_object(json_reader_t *reader,
+                        const json_binding_t *fields,
+                        size_t num_fields,
+                        uint8_t *payload,
+                        size_t payload_size,
+                        field_status_t *status,
+                        uint8_t nesting) {
+    json_value_t value = {};
+
+    memset(payload, 0, payload_size);
+    memset(status, 0, num_fields * sizeof(field_status_t));
+
+    if (!skip_spaces(reader)) {
+        return false;
+    }
+
+    if (current(reader) != '{') {
+        return read_value(reader, &value, NULL, nesting);
+    }
+
+    if (nesting == 0) {
+        return false;
+    }
+
+    reader->cursor++;
+    if (!skip_spaces(reader)) {
+        return false;
+    }
+
+    if (eat(reader, '}')) {
+        return true;
+    }
+
+    for (;;) {
+        char key_buffer[SCHEMA_BINDER_KEY_SIZE];
+        json_string_sink_t key = {key_buffer, sizeof(key_buffer), 0, false};
+
+        if (!read_key(reader, &key) || !skip_spaces(reader) || !eat(reader, ':')) {
+            return false;
+        }
+
+        const json_binding_t *binding = find_binding(fields, num_fields, &key);
+        if (binding == NULL) {
+            if (!read_value(reader, &value, NULL, (uint8_t)(nesting - 1))) {
+                return false;
+            }
+        } else {
+            size_t index = (size_t)(binding - fields);
+
+            if (binding->expected_type == JSON_TYPE_ARRAY) {
+                if (!skip_spaces(reader) || !bind_array(reader, binding, payload, &status[index], (uint8_t)(nesting - 1))) {
+                    return false;
+                }
+            } else if (binding->expected_type == JSON_TYPE_STRING) {
+                json_string_sink_t field = {(char *)&payload[binding->offset], binding->size, 0, false};
+
+                if (!read_value(reader, &value, &field, (uint8_t)(nesting - 1))) {
+                    return false;
+                }
+
+                if ((value.kind == JSON_VALUE_NULL) && (status[index] != FIELD_MISSING)) {
+                    /* A repeated key set to null keeps the earlier value, as in ArduinoJson. */
+                } else if (value.kind != JSON_VALUE_STRING) {
+                    status[index] = FIELD_INVALID_TYPE;
+                } else {
+                    status[index] = (field.length < binding->size) ? FIELD_BOUND : FIELD_TOO_LONG;
+                }
+            } else {
+                if (!read_value(reader, &value, NULL, (uint8_t)(nesting - 1))) {
+                    return false;
+                }
+
+                if ((value.kind != JSON_VALUE_NULL) || (status[index] == FIELD_MISSING)) {
+                    status[index] = bind_value(binding, &value, payload);
+                }
+            }
+        }
+
+        if (!skip_spaces(reader)) {
+            return false;
+        }
+
+        if (eat(reader, '}')) {
+            return true;
+        }
+
+        if (!eat(reader, ',') || !skip_spaces(reader)) {
+            return false;
+        }
+    }
+}
+
+static const json_command_binding_t *find_command(const json_command_binding_t *commands,
+                                                  size_t num_commands,
+                                                  const json_value_t *value) {
+    if (!is_int(value)) {
+        return NULL;
+    }
+
+    int32_t index = (value->kind == JSON_VALUE_UNSIGNED) ? (int32_t)value->as.unsigned_integer : (int32_t)value->as.signed_integer;
+
+    for (size_t i = 0; i < num_commands; i++) {
+        if (commands[i].command_index == index) {
+            return &commands[i];
+        }
+    }
+
+    return NULL;
+}
+
+kernel_error_st schema_bind_command(const char *buffer,
+                                    size_t buffer_size,
+                                    const json_command_binding_t *commands,
+                                    size_t num_commands,
+                                    int32_t *command_index,
+                                    uint32_t *correlation_id,
+                                    void *payload,
+                                    size_t payload_size,
+                                    bool *params_rejected) {
+    if ((buffer == NULL) || (commands == NULL) || (command_index == NULL) || (correlation_id == NULL) || (payload == NULL) ||
+        (params_rejected == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    *params_rejected = false;
+    *correlation_id  = 0;
+
+    const char *end      = (const char *)memchr(buffer, '\0', buffer_size);
+    json_reader_t reader = {buffer, (end != NULL) ? end : (buffer + buffer_size)};
+    json_value_t value   = {};
+
+    if (!skip_spaces(&reader)) {
+        return KERNEL_ERROR_DESERIALIZE_JSON;
+    }
+
+    if (current(&reader) != '{') {
+        /* Not an object: it has no "command". A number must end the input. */
+        if (!read_value(&reader, &value, NULL, SCHEMA_BINDER_NESTING_LIMIT)) {
+            return KERNEL_ERROR_DESERIALIZE_JSON;
+        }
+
+        if (is_number(&value) && (current(&reader) != '\0')) {
+            return KERNEL_ERROR_DESERIALIZE_JSON;
+        }
+
+        return KERNEL_ERROR_MISSING_FIELD;
+    }
+
+    field_status_t status[SCHEMA_BINDER_MAXIMUM_FIELDS] = {};
+    json_value_t command_value                          = {};
+    bool has_command                                    = false;
+    json_value_t id_value                               = {};
+    bool has_id                                         = false;
+    const char *params                                  = NULL;
+    const json_command_binding_t *bound                 = NULL;
+    const uint8_t member_nesting                        = SCHEMA_BINDER_NESTING_LIMIT - 1;
+
+    reader.cursor++;
+    if (!skip_spaces(&reader)) {
+        return KERNEL_ERROR_DESERIALIZE_JSON;
+    }
+
+    if (!eat(&reader, '}')) {
+        for (;;) {
+            char key_buffer[SCHEMA_BINDER_KEY_SIZE];
+            json_string_sink_t key = {key_buffer, sizeof(key_buffer), 0, false};
+
+            if (!read_key(&reader, &key) || !skip_spaces(&reader) || !eat(&reader, ':') || !skip_spaces(&reader)) {
+                return KERNEL_ERROR_DESERIALIZE_JSON;
+            }
+
+            bool is_known_key = key.length < SCHEMA_BINDER_KEY_SIZE;
+
+            if (is_known_key && (strcmp(key_buffer, "command") == 0)) {
+                if (!read_value(&reader, &value, NULL, member_nesting)) {
+                    return KERNEL_ERROR_DESERIALIZE_JSON;
+                }
+
+                /* A repeated key set to null keeps the earlier value, as in ArduinoJson. */
+                if (!has_command || (value.kind != JSON_VALUE_NULL)) {
+                    command_value = value;
+                }
+                has_command = true;
+            } else if (is_known_key && (strcmp(key_buffer, "id") == 0)) {
+                if (!read_value(&reader, &value, NULL, member_nesting)) {
+                    return KERNEL_ERROR_DESERIALIZE_JSON;
+                }
+
+                if (!has_id || (value.kind != JSON_VALUE_NULL)) {
+                    id_value = value;
+                }
+                has_id = true;
+            } else if (is_known_key && (strcmp(key_buffer, "params") == 0) && (params != NULL) &&
+                       (current(&reader) == 'n')) {
+                if (!read_value(&reader, &value, NULL, member_nesting)) {
+                    return KERNEL_ERROR_DESERIALIZE_JSON;
+                }
+            } else if (is_known_key && (strcmp(key_buffer, "params") == 0)) {
+                const json_command_binding_t *command =
+                    has_command ? find_command(commands, num_commands, &command_value) : NULL;
+
+                params = reader.cursor;
+                bound  = NULL;
+
+                if ((command != NULL) && (command->num_fields <= SCHEMA_BINDER_MAXIMUM_FIELDS)) {
+                    if (!bind_object(&reader, command->fields, command->num_fields, (uint8_t *)payload, payload_size, status,
+                                     member_nesting)) {
+                        return KERNEL_ERROR_DESERIALIZE_JSON;
+                    }
+                    bound = command;
+                } else if (!read_value(&reader, &value, NULL, member_nesting)) {
+                    return KERNEL_ERROR_DESERIALIZE_JSON;
+                }
+            } else if (!read_value(&reader, &value, NULL, member_nesting)) {
+                return KERNEL_ERROR_DESERIALIZE_JSON;
+            }
+
+            if (!skip_spaces(&reader)) {
+                return KERNEL_ERROR_DESERIALIZE_JSON;
+            }
+
+            if (eat(&reader, '}')) {
+                break;
+            }
+
+            if (!eat(&reader, ',') || !skip_spaces(&reader)) {
+                return KERNEL_ERROR_DESERIALIZE_JSON;
+            }
+        }
+    }
+
+    if (!has_command) {
+        return KERNEL_ERROR_MISSING_FIELD;
+    }
+
+    if (!is_int(&command_value)) {
+        return KERNEL_ERROR_INVALID_TYPE;
+    }
+
+    if (has_id) {
+        if (!is_uint32(&id_value)) {
+            return KERNEL_ERROR_INVALID_TYPE;
+        }
+
+        *correlation_id = (id_value.kind == JSON_VALUE_UNSIGNED) ? (uint32_t)id_value.as.unsigned_integer
+                                                                 : (uint32_t)id_value.as.signed_integer;
+    }
+
+    if (params == NULL) {
+        return KERNEL_ERROR_MISSING_FIELD;
+    }
+
+    const json_command_binding_t *command = find_command(commands, num_commands, &command_value);
+    if ((command == NULL) || (command->num_fields > SCHEMA_BINDER_MAXIMUM_FIELDS)) {
+        return KERNEL_ERROR_INVALID_COMMAND;
+    }
+
+    if (bound != command) {
+        /* "params" came before the final "command": bind it now that the command is known. */
+        json_reader_t params_reader = {params, reader.end};
+        if (!bind_object(&params_reader, command->fields, command->num_fields, (uint8_t *)payload, payload_size, status,
+                         member_nesting)) {
+            return KERNEL_ERROR_DESERIALIZE_JSON;
+        }
+    }
+
+    *command_index = command->command_index;
+
+    for (size_t i = 0; i < command->num_fields; i++) {
+        if ((status[i] == FIELD_MISSING) || (status[i] == FIELD_INCOMPLETE)) {
+            *params_rejected = true;
+            return KERNEL_ERROR_MISSING_FIELD;
+        }
+
+        if (status[i] == FIELD_INVALID_TYPE) {
+            *params_rejected = true;
+            return KERNEL_ERROR_INVALID_TYPE;
+        }
+    }
+
+    for (size_t i = 0; i < command->num_fields; i++) {
+        if (status[i] == FIELD_TOO_LONG) {
+            return KERNEL_ERROR_INVALID_SIZE;
+        }
+    }
+
+    return KERNEL_SUCCESS;
+}
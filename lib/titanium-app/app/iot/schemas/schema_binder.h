@@ -0,0 +1,170 @@
+#pragma once
+
+/**
+ * @file schema_binder.h
+ * @brief One-pass validation and binding of JSON command payloads.
+ *
+ * A command payload has the form `{"command": <index>, "id": <id>, "params": {...}}`,
+ * where the correlation ID `id` is optional.
+ * The binder reads it once, with no intermediate document: each `params`
+ * key is looked up in the binding table of the command and its value is
+ * type-checked and stored straight into the command payload struct.
+ *
+ * Binding tables are generated at compile time from the field lists of
+ * commands_schema.h with JSON_BINDING_FIELD(). An array of objects binds to
+ * a fixed array of structs (JSON_BINDING_ARRAY()), each element with its own
+ * binding table, so batch commands are also bound in the same pass. The
+ * accepted input and the
+ * returned errors are the same as parsing with ArduinoJson and checking the
+ * fields with validate_json_schema(), so both paths can be compared by the
+ * parity test (test/tools/schema_binder_parity.cpp).
+ *
+ * The input buffer is only read, never modified.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+#include "kernel/error/error_num.h"
+
+#include "schema_validator.h"
+
+typedef struct json_array_binding_s json_array_binding_t;
+
+/**
+ * @brief Binding of one JSON key to a field of a command payload struct.
+ */
+typedef struct json_binding_s {
+    const char *key;                   ///< JSON key.
+    json_field_type_t expected_type;   ///< Expected JSON type, as in json_field_t.
+    uint16_t offset;                   ///< Offset of the field in the payload struct.
+    uint16_t size;                     ///< Size of the field in bytes (capacity for strings).
+    const json_array_binding_t *array; ///< Element binding of a JSON_TYPE_ARRAY field, NULL otherwise.
+} json_binding_t;
+
+/**
+ * @brief Binding of the elements of an array of objects to an array of structs.
+ */
+struct json_array_binding_s {
+    const json_binding_t *fields;  ///< Bindings of the element keys, in validation order.
+    size_t num_fields;             ///< Number of bindings.
+    uint16_t element_size;         ///< Size of one struct element in bytes.
+    uint16_t max_elements;         ///< Capacity of the struct array.
+    uint16_t count_offset;         ///< Offset of the element count in the payload struct.
+    uint16_t count_size;           ///< Size of the element count in bytes.
+};
+
+/**
+ * @brief Binding table of one command.
+ */
+typedef struct {
+    int32_t command_index;          ///< Value of the `command` key selecting this table.
+    const json_binding_t *fields;   ///< Bindings of the `params` keys, in validation order.
+    size_t num_fields;              ///< Number of bindings.
+} json_command_binding_t;
+
+/**
+ * @brief Expands a commands_schema.h field into a json_binding_t initializer.
+ */
+#define JSON_BINDING_FIELD(type, key, json_type, member) \
+    {#key, json_type, (uint16_t)offsetof(type, member), (uint16_t)sizeof(((type *)0)->member), NULL},
+
+/**
+ * @brief Expands a commands_schema.h array field into a json_binding_t initializer.
+ *
+ * `elements` names the json_array_binding_t of the elements, built with JSON_ARRAY_BINDING().
+ */
+#define JSON_BINDING_ARRAY(type, key, member, elements) \
+    {#key, JSON_TYPE_ARRAY, (uint16_t)offsetof(type, member), (uint16_t)sizeof(((type *)0)->member), &(elements)},
+
+/**
+ * @brief Initializer of a json_array_binding_t.
+ *
+ * @param type         Payload struct holding the array.
+ * @param member       Struct array receiving the elements.
+ * @param count_member Integer member receiving the number of elements.
+ * @param fields       Binding table of the element struct.
+ */
+#define JSON_ARRAY_BINDING(type, member, count_member, fields)                                         \
+    {fields,                                                                                           \
+     sizeof(fields) / sizeof(json_binding_t),                                                          \
+     (uint16_t)sizeof(((type *)0)->member[0]),                                                         \
+     (uint16_t)(sizeof(((type *)0)->member) / sizeof(((type *)0)->member[0])),                         \
+     (uint16_t)offsetof(type, count_member),                                                           \
+     (uint16_t)sizeof(((type *)0)->count_member)}
+
+/**
+ * @brief Expands a commands_schema.h field into a check that its member can hold the JSON type.
+ */
+#define JSON_BINDING_CHECK(type, key, json_type, member)                                         \
+    static_assert(json_binding_supported<decltype(((type *)0)->member)>(json_type),              \
+                  "Field \"" #key "\" cannot be bound to " #type "::" #member);
+
+/**
+ * @brief Expands a commands_schema.h array field into a check that its member is an array of structs.
+ */
+#define JSON_BINDING_ARRAY_CHECK(type, key, member, elements) \
+    JSON_BINDING_CHECK(type, key, JSON_TYPE_ARRAY, member)
+
+/**
+ * @brief Whether a struct member of type T can be bound to a JSON type.
+ *
+ * Integers bind to signed integral members of at most 32 bits and accept the
+ * int32_t range, 64-bit integers to 64-bit signed members, floats to
+ * floating-point members, booleans to bool, strings to char arrays and arrays
+ * to arrays of structs. Objects are not bindable.
+ */
+template <typename T>
+constexpr bool json_binding_supported(json_field_type_t type) {
+    return (type == JSON_TYPE_INT)      ? (std::is_integral<T>::value && std::is_signed<T>::value && !std::is_same<T, bool>::value &&
+                                          (sizeof(T) <= sizeof(int32_t)))
+           : (type == JSON_TYPE_INT64)  ? (std::is_integral<T>::value && std::is_signed<T>::value && (sizeof(T) == sizeof(int64_t)))
+           : (type == JSON_TYPE_FLOAT)  ? std::is_floating_point<T>::value
+           : (type == JSON_TYPE_BOOL)   ? std::is_same<T, bool>::value
+           : (type == JSON_TYPE_STRING) ? (std::is_array<T>::value && std::is_same<typename std::remove_extent<T>::type, char>::value)
+           : (type == JSON_TYPE_ARRAY)  ? (std::is_array<T>::value && std::is_class<typename std::remove_extent<T>::type>::value)
+                                        : false;
+}
+
+/**
+ * @brief Validates a JSON command payload and binds its parameters.
+ *
+ * The payload struct is cleared, then each `params` value is stored in its
+ * field as it is read. When `params` precedes `command`, it is bound once the
+ * command is known.
+ *
+ * @param[in]  buffer          JSON payload, not necessarily null-terminated.
+ * @param[in]  buffer_size     Length of the payload in bytes.
+ * @param[in]  commands        Binding tables of the supported commands.
+ * @param[in]  num_commands    Number of binding tables.
+ * @param[out] command_index   Value of `command`, set once it is known to be a supported command.
+ * @param[out] correlation_id  Value of `id`, 0 when absent; set as soon as it is known to be valid,
+ *                             so it is also available for error responses.
+ * @param[out] payload         Payload struct receiving the parameters.
+ * @param[in]  payload_size    Size of the payload struct in bytes.
+ * @param[out] params_rejected Set to true when the error comes from the `params`
+ *                             validation of a supported command.
+ *
+ * @return KERNEL_SUCCESS on success;
+ * @return KERNEL_ERROR_DESERIALIZE_JSON if the payload is not valid JSON;
+ * @return KERNEL_ERROR_MISSING_FIELD if `command`, `params`, a parameter or a member of
+ *         an array element is missing;
+ * @return KERNEL_ERROR_INVALID_TYPE if `command`, `id`, a parameter, an array element or
+ *         one of its members has the wrong type
+ *         (`id` must be an integer from 0 to UINT32_MAX);
+ * @return KERNEL_ERROR_INVALID_COMMAND if `command` is not in `commands`;
+ * @return KERNEL_ERROR_INVALID_SIZE if a string parameter does not fit its field, or an
+ *         array parameter has more elements than its struct array holds.
+ */
+kernel_error_st schema_bind_command(const char *buffer,
+                                    size_t buffer_size,
+                                    const json_command_binding_t *commands,
+                                    size_t num_commands,
+                                    int32_t *command_index,
+                                    uint32_t *correlation_id,
+                                    void *payload,
+                                    size_t payload_size,
+                                    bool *params_rejected);
@@ -37,6 +37,9 @@ kernel_error_st validate_json_schema(JsonObject &obj, const json_field_t *schema
             case JSON_TYPE_INT:
                 if (!value.is<int>()) return KERNEL_ERROR_INVALID_TYPE;
                 break;
+            case JSON_TYPE_INT64:
+                if (!value.is<int64_t>()) return KERNEL_ERROR_INVALID_TYPE;
+                break;
             case JSON_TYPE_FLOAT:
                 if (!value.is<float>()) return KERNEL_ERROR_INVALID_TYPE;
                 break;
@@ -6,6 +6,7 @@
 
 typedef enum {
     JSON_TYPE_INT,
+    JSON_TYPE_INT64,
     JSON_TYPE_FLOAT,
     JSON_TYPE_BOOL,
     JSON_TYPE_STRING,
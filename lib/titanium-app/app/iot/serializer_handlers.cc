@@ -1,56 +1,176 @@
 #include "serializer_handlers.h"
 
+#include <stddef.h>
+
 #include "kernel/inter_task_communication/queues/queue_manager.h"
 
 #include "app/app_extern_types.h"
+#include "app/iot/json_writer.h"
 #include "app/iot/schemas/commands_schema.h"
-#include "app/iot/schemas/schema_validator.h"
-#include "app/third_party/json_handler.h"
+#include "app/iot/schemas/schema_binder.h"
+
+CMD_SET_CALIBRATION_FIELDS(JSON_BINDING_CHECK)
+CMD_GET_SYSTEM_INFO_FIELDS(JSON_BINDING_CHECK)
+CMD_SET_CALIBRATION_BATCH_FIELDS(JSON_BINDING_CHECK, JSON_BINDING_ARRAY_CHECK)
+CMD_GET_HISTORY_FIELDS(JSON_BINDING_CHECK)
 
-#define MAXIMUM_SERIALIZE_DOC_SIZE (3072)
-#define MAXIMUM_DESERIALIZE_DOC_SIZE (512)
-static StaticJsonDocument<MAXIMUM_SERIALIZE_DOC_SIZE> serialize_doc;
-static StaticJsonDocument<MAXIMUM_DESERIALIZE_DOC_SIZE> deserialize_doc;
+/**
+ * @brief Binding tables of the command parameters, generated from commands_schema.h.
+ */
+static const json_binding_t set_calibration_binding[] = {CMD_SET_CALIBRATION_FIELDS(JSON_BINDING_FIELD)};
+static const json_binding_t get_system_info_binding[] = {CMD_GET_SYSTEM_INFO_FIELDS(JSON_BINDING_FIELD)};
+static const json_binding_t get_history_binding[]     = {CMD_GET_HISTORY_FIELDS(JSON_BINDING_FIELD)};
+
+/**
+ * @brief Elements of a calibration batch, bound like CMD_SET_CALIBRATION parameters.
+ */
+static const json_array_binding_t set_calibration_items =
+    JSON_ARRAY_BINDING(cmd_set_calibration_batch_st, items, num_of_items, set_calibration_binding);
+static const json_binding_t set_calibration_batch_binding[] = {
+    CMD_SET_CALIBRATION_BATCH_FIELDS(JSON_BINDING_FIELD, JSON_BINDING_ARRAY)};
 
 /**
- * @note This module uses StaticJsonDocument and avoids dynamic allocation.
- *       All serialized/deserialized JSON must fit within MAXIMUM_DOC_SIZE.
+ * @brief Commands accepted by deserialize_command() and the binding of their parameters.
+ */
+static const json_command_binding_t command_bindings[] = {
+    {CMD_SET_CALIBRATION, set_calibration_binding, sizeof(set_calibration_binding) / sizeof(json_binding_t)},
+    {CMD_GET_SYSTEM_INFO, get_system_info_binding, sizeof(get_system_info_binding) / sizeof(json_binding_t)},
+    {CMD_SET_CALIBRATION_BATCH, set_calibration_batch_binding, sizeof(set_calibration_batch_binding) / sizeof(json_binding_t)},
+    {CMD_GET_HISTORY, get_history_binding, sizeof(get_history_binding) / sizeof(json_binding_t)},
+};
+
+/**
+ * @note This module avoids dynamic allocation. Outgoing payloads are written
+ *       directly into the caller's buffer by the streaming JSON writer;
+ *       incoming commands are validated and bound to `command_st` in one
+ *       pass by the schema binder, with no intermediate document.
  */
 
 /**
  * @brief Generates and enqueues an error response for an invalid or failed command.
  *
  * This function constructs a `command_response_st` structure representing a failed
- * command execution (with status `COMMAND_PARSE_FAIL`) and sends it to the
- * `RESPONSE_COMMAND_QUEUE_ID` queue for further processing by the response handler task.
+ * command execution and sends it to the `RESPONSE_COMMAND_QUEUE_ID` transport for
+ * further processing by the response handler task.
  *
- * The error response includes the command index to help identify which command failed.
+ * The error response includes the command index and correlation ID to help
+ * identify which command failed.
  *
- * @param[in] cmd_index The index of the command that caused the error.
+ * @param[in] cmd_index      The index of the command that caused the error.
+ * @param[in] correlation_id Correlation ID of the command, 0 when absent.
+ * @param[in] status         Failure status, e.g. COMMAND_PARSE_FAIL or COMMAND_BUSY.
  *
  * @return kernel_error_st
  *         - KERNEL_SUCCESS on success
  *         - KERNEL_ERROR_QUEUE_SEND if the response could not be enqueued
  */
-kernel_error_st generate_error_command_response(command_index_et cmd_index) {
+kernel_error_st generate_error_command_response(command_index_et cmd_index,
+                                                uint32_t correlation_id,
+                                                command_status_et status) {
     command_response_st command_response_error{};
     command_response_error.command_index  = cmd_index;
-    command_response_error.command_status = COMMAND_PARSE_FAIL;
-
-    if (xQueueSend(queue_manager_get(RESPONSE_COMMAND_QUEUE_ID),
-                   &command_response_error,
-                   pdMS_TO_TICKS(100)) != pdPASS) {
+    command_response_error.command_status = status;
+    command_response_error.correlation_id = correlation_id;
+
+    /* Error responses carry no payload, only the header is transported. */
+    if (queue_manager_send(RESPONSE_COMMAND_QUEUE_ID,
+                           &command_response_error,
+                           offsetof(command_response_st, command_u),
+                           pdMS_TO_TICKS(100)) != KERNEL_SUCCESS) {
         return KERNEL_ERROR_QUEUE_SEND;
     }
 
     return KERNEL_SUCCESS;
 }
 
+/**
+ * @brief Appends the sensor readings of a device report to a JSON array.
+ *
+ * Each sensor becomes an object with its `value`, rounded to two decimals,
+ * and its `active` flag.
+ *
+ * @param writer        JSON writer positioned where the array goes.
+ * @param device_report Report holding the sensor readings.
+ */
+static void write_sensor_array(json_writer_st *writer, const device_report_st &device_report) {
+    json_writer_array_begin(writer);
+    for (int i = 0; i < device_report.num_of_sensors; i++) {
+        json_writer_object_begin(writer);
+        json_writer_key(writer, "value");
+        json_writer_fixed2(writer, (int32_t)(device_report.sensors[i].value * 100 + 0.5));
+        json_writer_key(writer, "active");
+        json_writer_bool(writer, device_report.sensors[i].active);
+        json_writer_object_end(writer);
+    }
+    json_writer_array_end(writer);
+}
+
+/**
+ * @brief Serializes an item, growing the payload buffer until it fits.
+ *
+ * The item is written into the payload buffer first. If it does not fit and
+ * the buffer has a reserve hook, the buffer is grown by doubling, up to
+ * MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH, and the item is written again. The item
+ * was already received, so retrying never loses it.
+ *
+ * @param write    Serializer of the item, fills `payload->length`.
+ * @param item     Item to serialize.
+ * @param payload  Payload buffer.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_FORMATTING if the item does not fit in the largest buffer
+ *         - Errors from the serializer or the reserve hook
+ */
+template <typename T>
+static kernel_error_st write_payload(kernel_error_st (*write)(T *, mqtt_buffer_st *), T *item, mqtt_buffer_st *payload) {
+    kernel_error_st err = write(item, payload);
+
+    while ((err == KERNEL_ERROR_FORMATTING) &&
+           (payload->reserve != NULL) &&
+           (payload->size < MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH)) {
+        size_t size = payload->size * 2;
+        if (size > MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH) {
+            size = MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH;
+        }
+
+        if (payload->reserve(payload, size) != KERNEL_SUCCESS) {
+            break;
+        }
+
+        err = write(item, payload);
+    }
+
+    return err;
+}
+
+/**
+ * @brief Writes a device report as JSON into the payload buffer.
+ *
+ * @param device_report Report to write.
+ * @param payload       Payload buffer, `length` is set on success.
+ * @return KERNEL_SUCCESS, or KERNEL_ERROR_FORMATTING if the JSON does not fit.
+ */
+static kernel_error_st write_data_report(device_report_st *device_report, mqtt_buffer_st *payload) {
+    json_writer_st writer;
+    json_writer_begin(&writer, payload->buffer, payload->size);
+
+    json_writer_object_begin(&writer);
+    json_writer_key(&writer, "timestamp");
+    json_writer_int(&writer, device_report->timestamp);
+    json_writer_key(&writer, "sensors");
+    write_sensor_array(&writer, *device_report);
+    json_writer_object_end(&writer);
+
+    payload->length = json_writer_end(&writer);
+
+    return (payload->length == 0) ? KERNEL_ERROR_FORMATTING : KERNEL_SUCCESS;
+}
+
 /**
  * @brief Serializes a device report into JSON format.
  *
  * This function receives a `device_report_st` structure from the provided FreeRTOS queue
- * and serializes it into a JSON object using ArduinoJson. The JSON format includes a
+ * and writes it as JSON with the streaming JSON writer. The JSON format includes a
  * timestamp and an array of sensor readings with their `value` and `active` status.
  *
  * Example output:
@@ -62,49 +182,149 @@ kernel_error_st generate_error_command_response(command_index_et cmd_index) {
  *   ]
  * }
  *
- * @param queue         The FreeRTOS queue from which the device report will be read.
- * @param out_buffer    A pointer to the buffer where the serialized JSON will be written.
- * @param buffer_size   The size of the output buffer in bytes.
+ * @param queue_index   Queue Manager ID from which the device report will be read.
+ * @param payload       Payload buffer; `length` is set to the JSON length. Grown
+ *                      through its reserve hook if the JSON does not fit.
  * @return kernel_error_st
  *         - KERNEL_SUCCESS on success
- *         - KERNEL_ERROR_NULL if the output buffer is null or size is 0
- *         - KERNEL_ERROR_NULL_MQTT_QUEUE if the queue is null
+ *         - KERNEL_ERROR_NULL if the payload buffer is null or size is 0
+ *         - KERNEL_ERROR_QUEUE_NULL if no transport is registered for the ID
  *         - KERNEL_ERROR_EMPTY_QUEUE if no report was available within timeout
  *         - KERNEL_ERROR_FORMATTING if the resulting JSON didn't fit in the buffer
  */
-kernel_error_st serialize_data_report(QueueHandle_t queue, char *out_buffer, size_t buffer_size) {
-    if (out_buffer == NULL || buffer_size == 0) {
+kernel_error_st serialize_data_report(uint8_t queue_index, mqtt_buffer_st *payload) {
+    if ((payload == NULL) || (payload->buffer == NULL) || (payload->size == 0)) {
         return KERNEL_ERROR_NULL;
     }
 
-    if (queue == NULL) {
-        return KERNEL_ERROR_QUEUE_NULL;
-    }
-
     device_report_st device_report{};
-    if (xQueueReceive(queue, &device_report, pdMS_TO_TICKS(100)) != pdTRUE) {
-        return KERNEL_ERROR_EMPTY_QUEUE;
+    kernel_error_st err = queue_manager_receive(queue_index, &device_report, sizeof(device_report), NULL, pdMS_TO_TICKS(100));
+    if (err != KERNEL_SUCCESS) {
+        return err;
     }
 
-    serialize_doc.clear();
+    return write_payload(write_data_report, &device_report, payload);
+}
 
-    serialize_doc["timestamp"] = device_report.timestamp;
+/**
+ * @brief Serializes several queued device reports into one batched JSON payload.
+ *
+ * Reports share a single header holding the timestamp of the first report;
+ * each sample carries its offset in seconds from it (`dt`) and the same sensor
+ * array as `serialize_data_report()`. Reports are peeked before being added
+ * and only removed from the queue once they fit, so a report that would exceed
+ * the size cap stays queued for the next batch.
+ *
+ * Example output:
+ * {
+ *   "timestamp": 1751898180,
+ *   "samples": [
+ *     {"dt": 0, "sensors": [{"value": 23.4, "active": 1}, ...]},
+ *     {"dt": 5, "sensors": [{"value": 23.5, "active": 1}, ...]}
+ *   ]
+ * }
+ *
+ * @param queue_index   Queue Manager ID from which the device reports will be read (fixed-slot queue).
+ * @param max_reports   Maximum number of reports in the batch.
+ * @param max_bytes     Payload size cap, 0 to use the whole payload buffer.
+ * @param payload       Payload buffer; `length` is set to the JSON length. Never grown,
+ *                      reports beyond the cap wait for the next batch.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if the payload buffer is null or size is 0
+ *         - KERNEL_ERROR_QUEUE_NULL if no transport is registered for the ID
+ *         - KERNEL_ERROR_UNSUPPORTED_TYPE if the ID is backed by a message buffer
+ *         - KERNEL_ERROR_EMPTY_QUEUE if no report was available
+ *         - KERNEL_ERROR_FORMATTING if a single report does not fit (the report is dropped)
+ */
+kernel_error_st serialize_data_report_batch(uint8_t queue_index, uint8_t max_reports, size_t max_bytes, mqtt_buffer_st *payload) {
+    if ((payload == NULL) || (payload->buffer == NULL) || (payload->size == 0)) {
+        return KERNEL_ERROR_NULL;
+    }
 
-    JsonArray sensors = serialize_doc.createNestedArray("sensors");
-    for (int i = 0; i < device_report.num_of_sensors; i++) {
-        JsonObject sensor = sensors.createNestedObject();
-        /* This is not very maintable, it's necessary to find a better way to trunk the float value */
-        sensor["value"]  = (int)(device_report.sensors[i].value * 100 + 0.5) / 100.00f;
-        sensor["active"] = device_report.sensors[i].active;
+    size_t payload_limit = payload->size - 1;
+    if ((max_bytes != 0) && (max_bytes < payload_limit)) {
+        payload_limit = max_bytes;
     }
 
-    size_t json_size = serializeJson(serialize_doc, out_buffer, buffer_size);
+    /* One byte more than the cap is the terminator, never counted as payload. */
+    json_writer_st writer;
+    json_writer_begin(&writer, payload->buffer, payload_limit + 1);
+
+    time_t base_timestamp  = 0;
+    uint8_t num_of_samples = 0;
+
+    while (num_of_samples < max_reports) {
+        device_report_st device_report{};
+        kernel_error_st err = queue_manager_peek(queue_index, &device_report, 0);
+        if (err != KERNEL_SUCCESS) {
+            if (num_of_samples == 0) {
+                return err;
+            }
+            break;
+        }
 
-    if (json_size == 0 || json_size >= buffer_size) {
-        return KERNEL_ERROR_FORMATTING;
+        json_writer_st checkpoint = writer;
+
+        if (num_of_samples == 0) {
+            base_timestamp = device_report.timestamp;
+            json_writer_object_begin(&writer);
+            json_writer_key(&writer, "timestamp");
+            json_writer_int(&writer, base_timestamp);
+            json_writer_key(&writer, "samples");
+            json_writer_array_begin(&writer);
+        }
+
+        json_writer_object_begin(&writer);
+        json_writer_key(&writer, "dt");
+        json_writer_int(&writer, (int32_t)(device_report.timestamp - base_timestamp));
+        json_writer_key(&writer, "sensors");
+        write_sensor_array(&writer, device_report);
+        json_writer_object_end(&writer);
+
+        /* Room for the closing "]}" is kept so the batch can always be terminated. */
+        if (writer.overflow || ((writer.length + 2) > payload_limit)) {
+            if (num_of_samples == 0) {
+                /* A single report larger than the cap can never be sent, drop it so the queue moves on. */
+                queue_manager_receive(queue_index, &device_report, sizeof(device_report), NULL, 0);
+                return KERNEL_ERROR_FORMATTING;
+            }
+
+            writer = checkpoint;
+            break;
+        }
+
+        queue_manager_receive(queue_index, &device_report, sizeof(device_report), NULL, 0);
+        num_of_samples++;
     }
 
-    return KERNEL_SUCCESS;
+    json_writer_array_end(&writer);
+    json_writer_object_end(&writer);
+
+    payload->length = json_writer_end(&writer);
+
+    return (payload->length == 0) ? KERNEL_ERROR_FORMATTING : KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Writes the fields shared by every command response.
+ *
+ * The correlation ID is only written when the command carried one, so
+ * responses to commands without `id` are unchanged.
+ *
+ * @param writer           JSON writer positioned inside the response object.
+ * @param command_response Response being written.
+ */
+static void write_response_header(json_writer_st *writer, const command_response_st *command_response) {
+    json_writer_key(writer, "command_index");
+    json_writer_int(writer, command_response->command_index);
+    json_writer_key(writer, "command_status");
+    json_writer_int(writer, command_response->command_status);
+
+    if (command_response->correlation_id != 0) {
+        json_writer_key(writer, "id");
+        json_writer_uint(writer, command_response->correlation_id);
+    }
 }
 
 /**
@@ -112,39 +332,96 @@ kernel_error_st serialize_data_report(QueueHandle_t queue, char *out_buffer, siz
  *
  * Outputs a JSON object with:
  * {
+ *   "command_index": 1,
  *   "command_status": <status>,
- *   "sensor_id": <sensor index>
+ *   "id": <correlation ID, when the command had one>,
+ *   "sensor_id": <sensor index>,
+ *   "gain": <gain>,
+ *   "offset": <offset>
  * }
  *
  * @param command_response Pointer to the sensor response command.
- * @param out_buffer Buffer where the serialized JSON will be written.
- * @param buffer_size Size of the output buffer.
+ * @param payload Payload buffer; `length` is set to the JSON length.
  * @return kernel_error_st Serialization result.
  */
-kernel_error_st serialize_cmd_set_calibration(command_response_st *command_response, char *out_buffer, size_t buffer_size) {
-    if ((out_buffer == NULL) || (command_response == NULL)) {
+kernel_error_st serialize_cmd_set_calibration(command_response_st *command_response, mqtt_buffer_st *payload) {
+    if ((payload == NULL) || (payload->buffer == NULL) || (command_response == NULL)) {
         return KERNEL_ERROR_NULL;
     }
 
-    if (buffer_size == 0) {
+    if (payload->size == 0) {
         return KERNEL_ERROR_INVALID_SIZE;
     }
 
-    serialize_doc.clear();
+    json_writer_st writer;
+    json_writer_begin(&writer, payload->buffer, payload->size);
+
+    json_writer_object_begin(&writer);
+    write_response_header(&writer, command_response);
+    json_writer_key(&writer, "sensor_id");
+    json_writer_uint(&writer, command_response->command_u.cmd_sensor_response.sensor_index);
+    json_writer_key(&writer, "gain");
+    json_writer_float(&writer, command_response->command_u.cmd_sensor_response.gain);
+    json_writer_key(&writer, "offset");
+    json_writer_float(&writer, command_response->command_u.cmd_sensor_response.offset);
+    json_writer_object_end(&writer);
 
-    serialize_doc["command_index"]  = command_response->command_index;
-    serialize_doc["command_status"] = command_response->command_status;
-    serialize_doc["sensor_id"]      = command_response->command_u.cmd_sensor_response.sensor_index;
-    serialize_doc["gain"]           = command_response->command_u.cmd_sensor_response.gain;
-    serialize_doc["offset"]         = command_response->command_u.cmd_sensor_response.offset;
+    payload->length = json_writer_end(&writer);
+
+    return (payload->length == 0) ? KERNEL_ERROR_FORMATTING : KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Serializes a CMD_SET_CALIBRATION_BATCH command response into JSON format.
+ *
+ * Lists the status of every item of the batch, in request order, as a bare
+ * array of command_status_et values. The overall status is COMMAND_SUCCESS
+ * only when every calibration was applied; otherwise none was, and the
+ * failing items are the ones not reported COMMAND_ABORTED (-6).
+ *
+ * Example output:
+ * {
+ *   "command_index": 3,
+ *   "command_status": -2,
+ *   "id": 42,
+ *   "item_status": [-6, -2, -6]
+ * }
+ *
+ * @param command_response Pointer to the batch response.
+ * @param payload Payload buffer; `length` is set to the JSON length.
+ * @return kernel_error_st Serialization result.
+ */
+kernel_error_st serialize_cmd_set_calibration_batch(command_response_st *command_response, mqtt_buffer_st *payload) {
+    if ((payload == NULL) || (payload->buffer == NULL) || (command_response == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
 
-    size_t json_size = serializeJson(serialize_doc, out_buffer, buffer_size);
+    if (payload->size == 0) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
 
-    if (json_size == 0 || json_size >= buffer_size) {
-        return KERNEL_ERROR_FORMATTING;
+    const cmd_calibration_batch_response_st *batch = &command_response->command_u.cmd_calibration_batch_response;
+    uint8_t num_of_items                           = batch->num_of_items;
+    if (num_of_items > CALIBRATION_BATCH_MAXIMUM_ITEMS) {
+        num_of_items = CALIBRATION_BATCH_MAXIMUM_ITEMS;
     }
 
-    return KERNEL_SUCCESS;
+    json_writer_st writer;
+    json_writer_begin(&writer, payload->buffer, payload->size);
+
+    json_writer_object_begin(&writer);
+    write_response_header(&writer, command_response);
+    json_writer_key(&writer, "item_status");
+    json_writer_array_begin(&writer);
+    for (uint8_t i = 0; i < num_of_items; i++) {
+        json_writer_int(&writer, batch->item_status[i]);
+    }
+    json_writer_array_end(&writer);
+    json_writer_object_end(&writer);
+
+    payload->length = json_writer_end(&writer);
+
+    return (payload->length == 0) ? KERNEL_ERROR_FORMATTING : KERNEL_SUCCESS;
 }
 
 /**
@@ -156,6 +433,7 @@ kernel_error_st serialize_cmd_set_calibration(command_response_st *command_respo
  * {
  *   "command_index": 2,
  *   "command_status": 0,
+ *   "id": 42,
  *   "device_id": "ABC123",
  *   "ip_address": "192.168.1.10",
  *   "uptime": 102345,
@@ -166,72 +444,82 @@ kernel_error_st serialize_cmd_set_calibration(command_response_st *command_respo
  * }
  *
  * @param[in]  command_response Pointer to the response structure containing system info.
- * @param[out] out_buffer       Buffer where the serialized JSON will be written.
- * @param[in]  buffer_size      Size of the output buffer in bytes.
+ * @param[out] payload          Payload buffer; `length` is set to the JSON length.
  *
  * @return kernel_error_st
  *         - KERNEL_SUCCESS on success
- *         - KERNEL_ERROR_NULL if command_response or out_buffer is NULL
- *         - KERNEL_ERROR_INVALID_SIZE if buffer_size is 0
+ *         - KERNEL_ERROR_NULL if command_response or the payload buffer is NULL
+ *         - KERNEL_ERROR_INVALID_SIZE if the payload buffer size is 0
  *         - KERNEL_ERROR_FORMATTING if JSON serialization failed or didn’t fit
  */
-kernel_error_st serialize_cmd_get_system_info(command_response_st *command_response, char *out_buffer, size_t buffer_size) {
-    if ((out_buffer == NULL) || (command_response == NULL)) {
+kernel_error_st serialize_cmd_get_system_info(command_response_st *command_response, mqtt_buffer_st *payload) {
+    if ((payload == NULL) || (payload->buffer == NULL) || (command_response == NULL)) {
         return KERNEL_ERROR_NULL;
     }
 
-    if (buffer_size == 0) {
+    if (payload->size == 0) {
         return KERNEL_ERROR_INVALID_SIZE;
     }
 
-    serialize_doc.clear();
+    const cmd_system_info_response_st *system_info = &command_response->command_u.cmd_system_info_response;
 
-    serialize_doc["command_index"]  = command_response->command_index;
-    serialize_doc["command_status"] = command_response->command_status;
+    json_writer_st writer;
+    json_writer_begin(&writer, payload->buffer, payload->size);
 
-    serialize_doc["device_id"]  = command_response->command_u.cmd_system_info_response.device_id;
-    serialize_doc["ip_address"] = command_response->command_u.cmd_system_info_response.ip_address;
-    serialize_doc["uptime"]     = command_response->command_u.cmd_system_info_response.uptime;
+    json_writer_object_begin(&writer);
+    write_response_header(&writer, command_response);
 
-    JsonArray sensors = serialize_doc.createNestedArray("sensors");
-    for (uint8_t i = 0; i < NUM_OF_SENSORS; i++) {
-        JsonObject sensor = sensors.createNestedObject();
-        sensor["gain"]    = command_response->command_u.cmd_system_info_response.sensor_calibration_status[i].gain;
-        sensor["offset"]  = command_response->command_u.cmd_system_info_response.sensor_calibration_status[i].offset;
-        sensor["index"]   = command_response->command_u.cmd_system_info_response.sensor_calibration_status[i].sensor_index;
-        sensor["state"]   = command_response->command_u.cmd_system_info_response.sensor_calibration_status[i].state;
+    json_writer_key(&writer, "device_id");
+    json_writer_string(&writer, system_info->device_id);
+    json_writer_key(&writer, "ip_address");
+    json_writer_string(&writer, system_info->ip_address);
+    json_writer_key(&writer, "uptime");
+    json_writer_uint(&writer, system_info->uptime);
 
-        switch (command_response->command_u.cmd_system_info_response.sensor_calibration_status[i].sensor_type) {
+    json_writer_key(&writer, "sensors");
+    json_writer_array_begin(&writer);
+    for (uint8_t i = 0; i < NUM_OF_SENSORS; i++) {
+        json_writer_object_begin(&writer);
+        json_writer_key(&writer, "gain");
+        json_writer_float(&writer, system_info->sensor_calibration_status[i].gain);
+        json_writer_key(&writer, "offset");
+        json_writer_float(&writer, system_info->sensor_calibration_status[i].offset);
+        json_writer_key(&writer, "index");
+        json_writer_uint(&writer, system_info->sensor_calibration_status[i].sensor_index);
+        json_writer_key(&writer, "state");
+        json_writer_int(&writer, system_info->sensor_calibration_status[i].state);
+
+        json_writer_key(&writer, "unit");
+        switch (system_info->sensor_calibration_status[i].sensor_type) {
             case SENSOR_TYPE_TEMPERATURE:
-                sensor["unit"] = "°C";
+                json_writer_string(&writer, "°C");
                 break;
             case SENSOR_TYPE_PRESSURE:
-                sensor["unit"] = "kPa";
+                json_writer_string(&writer, "kPa");
                 break;
             case SENSOR_TYPE_VOLTAGE:
-                sensor["unit"] = "V";
+                json_writer_string(&writer, "V");
                 break;
             case SENSOR_TYPE_CURRENT:
-                sensor["unit"] = "A";
+                json_writer_string(&writer, "A");
                 break;
             case SENSOR_TYPE_POWER:
-                sensor["unit"] = "W";
+                json_writer_string(&writer, "W");
                 break;
             case SENSOR_TYPE_POWER_FACTOR:
-                sensor["unit"] = "%";
+                json_writer_string(&writer, "%");
                 break;
             default:
-                sensor["unit"] = "Unkown";
+                json_writer_string(&writer, "Unkown");
         }
+        json_writer_object_end(&writer);
     }
+    json_writer_array_end(&writer);
+    json_writer_object_end(&writer);
 
-    size_t json_size = serializeJson(serialize_doc, out_buffer, buffer_size);
+    payload->length = json_writer_end(&writer);
 
-    if (json_size == 0 || json_size >= buffer_size) {
-        return KERNEL_ERROR_FORMATTING;
-    }
-
-    return KERNEL_SUCCESS;
+    return (payload->length == 0) ? KERNEL_ERROR_FORMATTING : KERNEL_SUCCESS;
 }
 
 /**
@@ -244,41 +532,73 @@ kernel_error_st serialize_cmd_get_system_info(command_response_st *command_respo
  * Example output:
  * {
  *   "command_index": 3,
- *   "command_status": 2
+ *   "command_status": -4,
+ *   "id": 42
  * }
  *
  * @param[in]  command_response Pointer to the command response structure.
- * @param[out] out_buffer       Buffer where the serialized JSON will be written.
- * @param[in]  buffer_size      Size of the output buffer in bytes.
+ * @param[out] payload          Payload buffer; `length` is set to the JSON length.
  *
  * @return kernel_error_st
  *         - KERNEL_SUCCESS on success
  *         - KERNEL_ERROR_NULL if any pointer is NULL
- *         - KERNEL_ERROR_INVALID_SIZE if buffer_size is 0
+ *         - KERNEL_ERROR_INVALID_SIZE if the payload buffer size is 0
  *         - KERNEL_ERROR_FORMATTING if serialization fails or exceeds buffer size
  */
 
-kernel_error_st serialize_cmd_error(command_response_st *command_response, char *out_buffer, size_t buffer_size) {
-    if ((out_buffer == NULL) || (command_response == NULL)) {
+kernel_error_st serialize_cmd_error(command_response_st *command_response, mqtt_buffer_st *payload) {
+    if ((payload == NULL) || (payload->buffer == NULL) || (command_response == NULL)) {
         return KERNEL_ERROR_NULL;
     }
 
-    if (buffer_size == 0) {
+    if (payload->size == 0) {
         return KERNEL_ERROR_INVALID_SIZE;
     }
 
-    serialize_doc.clear();
+    json_writer_st writer;
+    json_writer_begin(&writer, payload->buffer, payload->size);
+
+    json_writer_object_begin(&writer);
+    write_response_header(&writer, command_response);
+    json_writer_object_end(&writer);
 
-    serialize_doc["command_index"]  = command_response->command_index;
-    serialize_doc["command_status"] = command_response->command_status;
+    payload->length = json_writer_end(&writer);
 
-    size_t json_size = serializeJson(serialize_doc, out_buffer, buffer_size);
+    return (payload->length == 0) ? KERNEL_ERROR_FORMATTING : KERNEL_SUCCESS;
+}
 
-    if (json_size == 0 || json_size >= buffer_size) {
-        return KERNEL_ERROR_FORMATTING;
+/**
+ * @brief Writes a received command response with the serializer matching its command.
+ *
+ * @param command_response Response to write.
+ * @param payload          Payload buffer, `length` is set on success.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_FORMATTING if the JSON does not fit
+ *         - KERNEL_ERROR_INVALID_COMMAND_RESPONSE if the command type is not recognized
+ */
+static kernel_error_st write_command_response(command_response_st *command_response, mqtt_buffer_st *payload) {
+    /* A processed batch lists its item statuses whatever its outcome; parse and busy errors have none. */
+    if ((command_response->command_index == CMD_SET_CALIBRATION_BATCH) &&
+        ((command_response->command_status == COMMAND_SUCCESS) || (command_response->command_status == COMMAND_CALIBRATION_FAIL))) {
+        return serialize_cmd_set_calibration_batch(command_response, payload);
     }
 
-    return KERNEL_SUCCESS;
+    if (command_response->command_status != COMMAND_SUCCESS) {
+        return serialize_cmd_error(command_response, payload);
+    }
+
+    switch (command_response->command_index) {
+        case CMD_SET_CALIBRATION:
+            return serialize_cmd_set_calibration(command_response, payload);
+        case CMD_GET_SYSTEM_INFO:
+            return serialize_cmd_get_system_info(command_response, payload);
+        case CMD_GET_HISTORY:
+            /* The reports follow on the history topic, the response only acknowledges the request. */
+            return serialize_cmd_error(command_response, payload);
+        default:
+            return KERNEL_ERROR_INVALID_COMMAND_RESPONSE;
+    }
 }
 
 /**
@@ -288,242 +608,178 @@ kernel_error_st serialize_cmd_error(command_response_st *command_response, char
  * and serialize it into the given output buffer based on the command type. Currently supports
  * CMD_SET_CALIBRATION responses.
  *
- * @param[in]  queue        Handle to the FreeRTOS queue containing command responses.
- * @param[out] out_buffer   Pointer to the character buffer where the serialized response will be stored.
- * @param[in]  buffer_size  Size of the output buffer in bytes.
+ * @param[in]  queue_index  Queue Manager ID of the queue or message buffer containing command responses.
+ * @param[out] payload      Payload buffer; `length` is set to the JSON length. Grown through
+ *                          its reserve hook when the response does not fit (e.g. system info).
  *
  * @return kernel_error_st Returns:
  *                         - KERNEL_SUCCESS on success
- *                         - KERNEL_ERROR_NULL if out_buffer is NULL
- *                         - KERNEL_ERROR_INVALID_SIZE if buffer_size is 0
- *                         - KERNEL_ERROR_QUEUE_NULL if queue is NULL
+ *                         - KERNEL_ERROR_NULL if the payload buffer is NULL
+ *                         - KERNEL_ERROR_INVALID_SIZE if the payload buffer size is 0
+ *                         - KERNEL_ERROR_QUEUE_NULL if no transport is registered for the ID
  *                         - KERNEL_ERROR_EMPTY_QUEUE if the queue is empty or timed out
  *                         - KERNEL_ERROR_INVALID_COMMAND if the command type is not recognized
  */
-kernel_error_st serialize_command_response(QueueHandle_t queue, char *out_buffer, size_t buffer_size) {
-    if (out_buffer == NULL) {
+kernel_error_st serialize_command_response(uint8_t queue_index, mqtt_buffer_st *payload) {
+    if ((payload == NULL) || (payload->buffer == NULL)) {
         return KERNEL_ERROR_NULL;
     }
 
-    if (buffer_size == 0) {
+    if (payload->size == 0) {
         return KERNEL_ERROR_INVALID_SIZE;
     }
 
-    if (queue == NULL) {
-        return KERNEL_ERROR_QUEUE_NULL;
-    }
-
     command_response_st command_response{};
-    if (xQueueReceive(queue, &command_response, pdMS_TO_TICKS(100)) != pdTRUE) {
-        return KERNEL_ERROR_EMPTY_QUEUE;
+    kernel_error_st err = queue_manager_receive(queue_index, &command_response, sizeof(command_response), NULL, pdMS_TO_TICKS(100));
+    if (err != KERNEL_SUCCESS) {
+        return err;
     }
 
-    kernel_error_st err = KERNEL_SUCCESS;
-    if (command_response.command_status == COMMAND_SUCCESS) {
-        switch (command_response.command_index) {
-            case CMD_SET_CALIBRATION:
-                err = serialize_cmd_set_calibration(&command_response, out_buffer, buffer_size);
-                break;
-            case CMD_GET_SYSTEM_INFO:
-                err = serialize_cmd_get_system_info(&command_response, out_buffer, buffer_size);
-                break;
-            default:
-                err = KERNEL_ERROR_INVALID_COMMAND_RESPONSE;
-        }
-    } else {
-        err = serialize_cmd_error(&command_response, out_buffer, buffer_size);
-    }
+    return write_payload(write_command_response, &command_response, payload);
+}
 
-    return err;
+/**
+ * @brief Writes a health report as JSON into the payload buffer.
+ *
+ * @param health_report Report to write.
+ * @param payload       Payload buffer, `length` is set on success.
+ * @return KERNEL_SUCCESS, or KERNEL_ERROR_FORMATTING if the JSON does not fit.
+ */
+static kernel_error_st write_health_report(health_report_st *health_report, mqtt_buffer_st *payload) {
+    json_writer_st writer;
+    json_writer_begin(&writer, payload->buffer, payload->size);
+
+    json_writer_object_begin(&writer);
+    json_writer_key(&writer, "num_of_tasks");
+    json_writer_uint(&writer, health_report->num_of_tasks);
+
+    const sd_card_stats_st &sd_card = health_report->sd_card;
+    json_writer_key(&writer, "sd_card");
+    json_writer_object_begin(&writer);
+    json_writer_key(&writer, "mounted");
+    json_writer_bool(&writer, sd_card.mounted);
+    json_writer_key(&writer, "remounts");
+    json_writer_uint(&writer, sd_card.remounts);
+    json_writer_key(&writer, "remount_failures");
+    json_writer_uint(&writer, sd_card.remount_failures);
+    json_writer_key(&writer, "spilled");
+    json_writer_uint(&writer, sd_card.reports_spilled);
+    json_writer_key(&writer, "pending");
+    json_writer_uint(&writer, sd_card.reports_pending);
+    json_writer_key(&writer, "dropped");
+    json_writer_uint(&writer, sd_card.reports_dropped);
+    json_writer_object_end(&writer);
+
+    json_writer_key(&writer, "tasks");
+    json_writer_array_begin(&writer);
+    for (int i = 0; i < health_report->num_of_tasks; i++) {
+        json_writer_object_begin(&writer);
+        json_writer_key(&writer, "name");
+        json_writer_string(&writer, health_report->task_health[i].task_name);
+        json_writer_key(&writer, "high_water_mark");
+        json_writer_uint(&writer, health_report->task_health[i].high_water_mark);
+        json_writer_object_end(&writer);
+    }
+    json_writer_array_end(&writer);
+    json_writer_object_end(&writer);
+
+    payload->length = json_writer_end(&writer);
+
+    return (payload->length == 0) ? KERNEL_ERROR_FORMATTING : KERNEL_SUCCESS;
 }
 
 /**
  * @brief Serializes a health report into JSON format.
  *
  * This function receives a `health_report_st` structure from the provided FreeRTOS queue
- * and serializes it into a JSON object using ArduinoJson. The JSON format includes the
- * number of tasks and an array of task objects, each containing the task `name` and its
- * `high_water_mark` value.
+ * and writes it as JSON with the streaming JSON writer. The JSON format includes the
+ * number of tasks, the SD card log counters and an array of task objects, each
+ * containing the task `name` and its `high_water_mark` value.
  *
  * Example output:
  * {
  *   "num_of_tasks": 2,
+ *   "sd_card": {"mounted": true, "remounts": 1, "remount_failures": 3, "spilled": 40, "pending": 0, "dropped": 0},
  *   "tasks": [
  *     {"name": "MQTT Task", "high_water_mark": 128},
  *     {"name": "Sensor Task", "high_water_mark": 256}
  *   ]
  * }
  *
- * @param queue         The FreeRTOS queue from which the health report will be read.
- * @param out_buffer    A pointer to the buffer where the serialized JSON will be written.
- * @param buffer_size   The size of the output buffer in bytes.
+ * @param queue_index   Queue Manager ID from which the health report will be read.
+ * @param payload       Payload buffer; `length` is set to the JSON length. Grown
+ *                      through its reserve hook if the JSON does not fit.
  * @return kernel_error_st
  *         - KERNEL_SUCCESS on success
- *         - KERNEL_ERROR_NULL if the output buffer is null or size is 0
- *         - KERNEL_ERROR_QUEUE_NULL if the queue is null
+ *         - KERNEL_ERROR_NULL if the payload buffer is null or size is 0
+ *         - KERNEL_ERROR_QUEUE_NULL if no transport is registered for the ID
  *         - KERNEL_ERROR_EMPTY_QUEUE if no report was available within timeout
  *         - KERNEL_ERROR_FORMATTING if the resulting JSON didn't fit in the buffer
  */
-kernel_error_st serialize_health_report(QueueHandle_t queue, char *out_buffer, size_t buffer_size) {
-    if (out_buffer == NULL || buffer_size == 0) {
+kernel_error_st serialize_health_report(uint8_t queue_index, mqtt_buffer_st *payload) {
+    if ((payload == NULL) || (payload->buffer == NULL) || (payload->size == 0)) {
         return KERNEL_ERROR_NULL;
     }
 
-    if (queue == NULL) {
-        return KERNEL_ERROR_QUEUE_NULL;
-    }
-
     health_report_st health_report{};
-    if (xQueueReceive(queue, &health_report, pdMS_TO_TICKS(100)) != pdTRUE) {
-        return KERNEL_ERROR_EMPTY_QUEUE;
+    kernel_error_st err = queue_manager_receive(queue_index, &health_report, sizeof(health_report), NULL, pdMS_TO_TICKS(100));
+    if (err != KERNEL_SUCCESS) {
+        return err;
     }
 
-    serialize_doc.clear();
-
-    serialize_doc["num_of_tasks"] = health_report.num_of_tasks;
-
-    JsonArray sensors = serialize_doc.createNestedArray("tasks");
-    for (int i = 0; i < health_report.num_of_tasks; i++) {
-        JsonObject sensor = sensors.createNestedObject();
-
-        sensor["name"]            = health_report.task_health[i].task_name;
-        sensor["high_water_mark"] = health_report.task_health[i].high_water_mark;
-    }
-
-    size_t json_size = serializeJson(serialize_doc, out_buffer, buffer_size);
-
-    if (json_size == 0 || json_size >= buffer_size) {
-        return KERNEL_ERROR_FORMATTING;
-    }
-
-    return KERNEL_SUCCESS;
+    return write_payload(write_health_report, &health_report, payload);
 }
 
 /**
- * @brief Deserializes a `set_calibration` command from a JSON object and pushes it to a queue.
+ * @brief Computes the number of meaningful bytes in a command.
  *
- * This function expects a JSON object with the following keys:
- * - `"sensor_id"` (int)
- * - `"gain"` (float)
- * - `"offset"` (float)
+ * The command transports store variable-length messages, so only the header
+ * and the payload variant of the command are sent; a batch only carries its
+ * populated items.
  *
- * It validates the presence and types of all required fields. If valid,
- * the function constructs a `target_command_s` structure with the `CMD_SET_CALIBRATION`
- * index and populates its payload, then sends it to the provided FreeRTOS queue.
- *
- * Example expected JSON input:
- * {
- *   "sensor_id": 1,
- *   "gain": 10.5,
- *   "offset": -2.1
- * }
- *
- * @param queue         FreeRTOS queue where the parsed command will be sent.
- * @param json_object   Reference to a JsonObject containing command parameters.
- * @return kernel_error_st
- *         - KERNEL_SUCCESS on success
- *         - KERNEL_ERROR_MISSING_FIELD if a required key is missing
- *         - KERNEL_ERROR_INVALID_TYPE if any value is of the wrong type
- *         - KERNEL_ERROR_QUEUE_SEND if sending to the queue fails
+ * @param command Pointer to the bound command.
+ * @return size_t Number of bytes to transport.
  */
-kernel_error_st deserialize_command_set_calibration(QueueHandle_t queue, JsonObject &json_object) {
-    kernel_error_st validation_result = validate_json_schema(
-        json_object, get_calibration_schema, sizeof(get_calibration_schema) / sizeof(json_field_t));
-
-    if (validation_result != KERNEL_SUCCESS) {
-        generate_error_command_response(CMD_SET_CALIBRATION);
-        return validation_result;
-    }
-
-    command_st command{};
-    command.command_index                          = CMD_SET_CALIBRATION;
-    command.command_u.set_calibration.sensor_index = json_object["sensor_id"];
-    command.command_u.set_calibration.gain         = json_object["gain"];
-    command.command_u.set_calibration.offset       = json_object["offset"];
-    if (xQueueSend(queue, &command, pdMS_TO_TICKS(100)) != pdPASS) {
-        return KERNEL_ERROR_QUEUE_SEND;
+static size_t command_size(const command_st *command) {
+    size_t header_size = offsetof(command_st, command_u);
+
+    switch (command->command_index) {
+        case CMD_SET_CALIBRATION:
+            return header_size + sizeof(command->command_u.set_calibration);
+        case CMD_GET_SYSTEM_INFO:
+            return header_size + sizeof(command->command_u.cmd_get_system_info);
+        case CMD_SET_CALIBRATION_BATCH:
+            return header_size + offsetof(cmd_set_calibration_batch_st, items) +
+                   (command->command_u.set_calibration_batch.num_of_items * sizeof(cmd_set_calibration_st));
+        case CMD_GET_HISTORY:
+            return header_size + sizeof(command->command_u.get_history);
+        default:
+            return sizeof(command_st);
     }
-
-    return KERNEL_SUCCESS;
 }
 
 /**
- * @brief Deserializes a `get_system_info` command from a JSON object and pushes it to a queue.
- *
- * Expects a JSON object with:
- * - `"user"` (string)
- * - `"password"` (string)
+ * @brief Deserializes a command from a JSON payload and dispatches it.
  *
- * Example expected JSON:
- * {
- *   "user": "root",
- *   "password": "root"
- * }
+ * The payload is validated and its parameters are bound to a `command_st` in
+ * a single pass (see schema_bind_command()), using the binding tables
+ * generated from commands_schema.h. The command is then sent through the
+ * Queue Manager, which wakes the consumer attached to the queue.
  *
- * The parsed command is wrapped in a `command_st` structure and sent to the given queue.
+ * Parameters that are missing or of the wrong type are answered with a
+ * COMMAND_PARSE_FAIL response (see generate_error_command_response()). A
+ * command arriving while the command transport is full (see
+ * COMMAND_MANAGER_MAXIMUM_OUTSTANDING) is answered at once with COMMAND_BUSY.
+ * Both responses echo the correlation ID when it could be read.
  *
- * @param[in] queue       FreeRTOS queue where the parsed command will be sent.
- * @param[in] json_object JSON object containing the command fields.
- *
- * @return kernel_error_st
- *         - KERNEL_SUCCESS on success
- *         - KERNEL_ERROR_NULL if user or password is missing
- *         - KERNEL_ERROR_INVALID_SIZE if credentials exceed buffer size
- *         - KERNEL_ERROR_QUEUE_SEND if sending to the queue fails
- *         - Other validation errors from schema validation
- */
-kernel_error_st deserialize_command_get_system_info(QueueHandle_t queue, JsonObject &json_object) {
-    kernel_error_st validation_result = validate_json_schema(
-        json_object, get_system_info_schema, sizeof(get_system_info_schema) / sizeof(json_field_t));
-
-    if (validation_result != KERNEL_SUCCESS) {
-        generate_error_command_response(CMD_GET_SYSTEM_INFO);
-        return validation_result;
-    }
-
-    command_st command{};
-    command.command_index    = CMD_GET_SYSTEM_INFO;
-    const char *user_src     = json_object["user"];
-    const char *password_src = json_object["password"];
-
-    if (user_src == NULL || password_src == NULL) {
-        return KERNEL_ERROR_NULL;
-    }
-
-    size_t user_size = snprintf(command.command_u.cmd_get_system_info.user,
-                                sizeof(command.command_u.cmd_get_system_info.user),
-                                "%s",
-                                user_src);
-
-    if (user_size >= sizeof(command.command_u.cmd_get_system_info.user)) {
-        return KERNEL_ERROR_INVALID_SIZE;
-    }
-
-    size_t password_size = snprintf(command.command_u.cmd_get_system_info.password,
-                                    sizeof(command.command_u.cmd_get_system_info.password),
-                                    "%s",
-                                    password_src);
-    if (password_size >= sizeof(command.command_u.cmd_get_system_info.password)) {
-        return KERNEL_ERROR_INVALID_SIZE;
-    }
-
-    if (xQueueSend(queue, &command, pdMS_TO_TICKS(100)) != pdPASS) {
-        return KERNEL_ERROR_QUEUE_SEND;
-    }
-
-    return KERNEL_SUCCESS;
-}
-
-/**
- * @brief Deserializes a command from a JSON string buffer and dispatches it.
- *
- * This function parses a JSON string from `buffer`, extracts the command identifier (`"command"`)
- * and its associated parameters (`"params"`), and delegates to the appropriate handler based
- * on the command type. The parsed command is then sent to the specified FreeRTOS queue.
+ * A CMD_SET_CALIBRATION_BATCH command carries up to
+ * CALIBRATION_BATCH_MAXIMUM_ITEMS calibrations in `params.calibrations`, each
+ * with the parameters of CMD_SET_CALIBRATION, bound in the same pass.
  *
  * Expected JSON structure:
  * {
  *   "command": 1,            // integer corresponding to command_index_et
+ *   "id": 42,                // optional correlation ID, echoed in the response
  *   "params": {
  *     "sensor_id": 1,
  *     "gain": 10.0,
@@ -531,51 +787,47 @@ kernel_error_st deserialize_command_get_system_info(QueueHandle_t queue, JsonObj
  *   }
  * }
  *
- * @param queue         Queue handle to which the decoded command will be sent.
- * @param buffer        JSON string buffer to deserialize.
- * @param buffer_size   Size of the buffer (unused here but kept for API consistency).
+ * @param queue_index   Queue Manager ID to which the decoded command will be sent.
+ * @param buffer        JSON payload to deserialize; only read, need not be null-terminated.
+ * @param buffer_size   Length of the payload in bytes.
  * @return kernel_error_st
  *         - KERNEL_SUCCESS on success
  *         - KERNEL_ERROR_DESERIALIZE_JSON if the JSON is malformed
  *         - KERNEL_ERROR_MISSING_FIELD if required fields are not found
+ *         - KERNEL_ERROR_INVALID_TYPE if a field has the wrong type
  *         - KERNEL_ERROR_INVALID_COMMAND if the command index is unrecognized
- *         - Any other error code returned by a specific command deserializer
+ *         - KERNEL_ERROR_INVALID_SIZE if a string parameter is too long or a batch has too many items
+ *         - KERNEL_ERROR_QUEUE_SEND if the transport is full (window of outstanding commands reached)
  */
-kernel_error_st deserialize_command(QueueHandle_t queue, char *buffer, size_t buffer_size) {
-    deserialize_doc.clear();
-    kernel_error_st result = KERNEL_SUCCESS;
-
-    DeserializationError error = deserializeJson(deserialize_doc, buffer);
-    if (error) {
-        return KERNEL_ERROR_DESERIALIZE_JSON;
-    }
+kernel_error_st deserialize_command(uint8_t queue_index, char *buffer, size_t buffer_size) {
+    command_st command{};
+    int32_t command_index = 0;
+    bool params_rejected  = false;
 
-    if (!deserialize_doc.containsKey("command")) {
-        return KERNEL_ERROR_MISSING_FIELD;
-    }
+    kernel_error_st result = schema_bind_command(buffer,
+                                                 buffer_size,
+                                                 command_bindings,
+                                                 sizeof(command_bindings) / sizeof(json_command_binding_t),
+                                                 &command_index,
+                                                 &command.correlation_id,
+                                                 &command.command_u,
+                                                 sizeof(command.command_u),
+                                                 &params_rejected);
 
-    if (!deserialize_doc["command"].is<int>()) {
-        return KERNEL_ERROR_INVALID_TYPE;
+    if (params_rejected) {
+        generate_error_command_response((command_index_et)command_index, command.correlation_id, COMMAND_PARSE_FAIL);
     }
 
-    command_index_et command_index = deserialize_doc["command"];
-    if (!deserialize_doc.containsKey("params")) {
-        return KERNEL_ERROR_MISSING_FIELD;
+    if (result != KERNEL_SUCCESS) {
+        return result;
     }
-    JsonObject params = deserialize_doc["params"];
 
-    switch (command_index) {
-        case CMD_SET_CALIBRATION: {
-            result = deserialize_command_set_calibration(queue, params);
-            break;
-        }
-        case CMD_GET_SYSTEM_INFO: {
-            result = deserialize_command_get_system_info(queue, params);
-            break;
-        }
-        default:
-            result = KERNEL_ERROR_INVALID_COMMAND;
+    /* The transport holds the window of outstanding commands: reject at once when it is full. */
+    command.command_index = (command_index_et)command_index;
+    if (queue_manager_send(queue_index, &command, command_size(&command), 0) != KERNEL_SUCCESS) {
+        generate_error_command_response(command.command_index, command.correlation_id, COMMAND_BUSY);
+        return KERNEL_ERROR_QUEUE_SEND;
     }
 
-    return result;
+    return KERNEL_SUCCESS;
 }
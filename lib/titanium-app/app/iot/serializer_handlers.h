@@ -13,7 +13,7 @@ extern "C" {
  * @brief Serializes a device report into JSON format.
  *
  * This function receives a `device_report_st` structure from the provided FreeRTOS queue
- * and serializes it into a JSON object using ArduinoJson. The JSON format includes a
+ * and writes it as JSON with the streaming JSON writer. The JSON format includes a
  * timestamp and an array of sensor readings with their `value` and `active` status.
  *
  * Example output:
@@ -25,17 +25,42 @@ extern "C" {
  *   ]
  * }
  *
- * @param queue         The FreeRTOS queue from which the device report will be read.
- * @param out_buffer    A pointer to the buffer where the serialized JSON will be written.
- * @param buffer_size   The size of the output buffer in bytes.
+ * @param queue_index   Queue Manager ID from which the device report will be read.
+ * @param payload       Payload buffer; `length` is set to the JSON length. Grown
+ *                      through its reserve hook if the JSON does not fit.
  * @return kernel_error_st
  *         - KERNEL_SUCCESS on success
- *         - KERNEL_ERROR_NULL if the output buffer is null or size is 0
- *         - KERNEL_ERROR_NULL_MQTT_QUEUE if the queue is null
+ *         - KERNEL_ERROR_NULL if the payload buffer is null or size is 0
+ *         - KERNEL_ERROR_QUEUE_NULL if no transport is registered for the ID
  *         - KERNEL_ERROR_EMPTY_QUEUE if no report was available within timeout
  *         - KERNEL_ERROR_FORMATTING if the resulting JSON didn't fit in the buffer
  */
-kernel_error_st serialize_data_report(QueueHandle_t queue, char *out_buffer, size_t buffer_size);
+kernel_error_st serialize_data_report(uint8_t queue_index, mqtt_buffer_st *payload);
+
+/**
+ * @brief Serializes several queued device reports into one batched JSON payload.
+ *
+ * Reports share one header with the timestamp of the first report, and each
+ * sample carries its offset in seconds (`dt`) plus the usual sensor array:
+ * {
+ *   "timestamp": 1751898180,
+ *   "samples": [{"dt": 0, "sensors": [...]}, {"dt": 5, "sensors": [...]}]
+ * }
+ * Reports that would exceed the size cap stay queued for the next batch.
+ *
+ * @param queue_index   Queue Manager ID from which the device reports will be read (fixed-slot queue).
+ * @param max_reports   Maximum number of reports in the batch.
+ * @param max_bytes     Payload size cap, 0 to use the whole payload buffer.
+ * @param payload       Payload buffer; `length` is set to the JSON length. Never grown.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if the payload buffer is null or size is 0
+ *         - KERNEL_ERROR_QUEUE_NULL if no transport is registered for the ID
+ *         - KERNEL_ERROR_UNSUPPORTED_TYPE if the ID is backed by a message buffer
+ *         - KERNEL_ERROR_EMPTY_QUEUE if no report was available
+ *         - KERNEL_ERROR_FORMATTING if a single report does not fit (the report is dropped)
+ */
+kernel_error_st serialize_data_report_batch(uint8_t queue_index, uint8_t max_reports, size_t max_bytes, mqtt_buffer_st *payload);
 
 /**
  * @brief Serializes a CMD_SET_CALIBRATION command response into JSON format.
@@ -46,18 +71,18 @@ kernel_error_st serialize_data_report(QueueHandle_t queue, char *out_buffer, siz
  *   "sensor_id": <sensor index>
  * }
  *
- * @param cmd_sensor_response Pointer to the sensor response payload.
- * @param out_buffer Buffer where the serialized JSON will be written.
- * @param buffer_size Size of the output buffer.
+ * @param queue_index Queue Manager ID from which the command response will be read.
+ * @param payload     Payload buffer; `length` is set to the JSON length. Grown through
+ *                    its reserve hook when the response does not fit (e.g. system info).
  * @return kernel_error_st Serialization result.
  */
-kernel_error_st serialize_command_response(QueueHandle_t queue, char *out_buffer, size_t buffer_size);
+kernel_error_st serialize_command_response(uint8_t queue_index, mqtt_buffer_st *payload);
 
 /**
  * @brief Serializes a health report into JSON format.
  *
  * This function receives a `health_report_st` structure from the provided FreeRTOS queue
- * and serializes it into a JSON object using ArduinoJson. The JSON format includes the
+ * and writes it as JSON with the streaming JSON writer. The JSON format includes the
  * number of tasks and an array of task objects, each containing the task `name` and its
  * `high_water_mark` value.
  *
@@ -70,46 +95,46 @@ kernel_error_st serialize_command_response(QueueHandle_t queue, char *out_buffer
  *   ]
  * }
  *
- * @param queue         The FreeRTOS queue from which the health report will be read.
- * @param out_buffer    A pointer to the buffer where the serialized JSON will be written.
- * @param buffer_size   The size of the output buffer in bytes.
+ * @param queue_index   Queue Manager ID from which the health report will be read.
+ * @param payload       Payload buffer; `length` is set to the JSON length. Grown
+ *                      through its reserve hook if the JSON does not fit.
  * @return kernel_error_st
  *         - KERNEL_SUCCESS on success
- *         - KERNEL_ERROR_NULL if the output buffer is null or size is 0
- *         - KERNEL_ERROR_QUEUE_NULL if the queue is null
+ *         - KERNEL_ERROR_NULL if the payload buffer is null or size is 0
+ *         - KERNEL_ERROR_QUEUE_NULL if no transport is registered for the ID
  *         - KERNEL_ERROR_EMPTY_QUEUE if no report was available within timeout
  *         - KERNEL_ERROR_FORMATTING if the resulting JSON didn't fit in the buffer
  */
-kernel_error_st serialize_health_report(QueueHandle_t queue, char *out_buffer, size_t buffer_size);
+kernel_error_st serialize_health_report(uint8_t queue_index, mqtt_buffer_st *payload);
 
 /**
- * @brief Deserializes a `set_calibration` command from a JSON object and pushes it to a queue.
- *
- * This function expects a JSON object with the following keys:
- * - `"sensor_id"` (int)
- * - `"gain"` (float)
- * - `"offset"` (float)
+ * @brief Deserializes a command from a JSON payload and pushes it to a queue.
  *
- * It validates the presence and types of all required fields. If valid,
- * the function constructs a `command_st` structure with the `CMD_SET_CALIBRATION`
- * index and populates its payload, then sends it to the provided FreeRTOS queue.
+ * Validation and binding of the parameters to `command_st` happen in a single
+ * pass over the payload. Missing or mistyped parameters of a known command are
+ * answered with an error response, and so is a command that finds its queue
+ * full (COMMAND_BUSY). The optional `id` is echoed in every response.
  *
  * Example expected JSON input:
  * {
- *   "sensor_id": 1,
- *   "gain": 10.5,
- *   "offset": -2.1
+ *   "command": 1,
+ *   "id": 42,
+ *   "params": {"sensor_id": 1, "gain": 10.5, "offset": -2.1}
  * }
  *
- * @param queue         FreeRTOS queue where the parsed command will be sent.
- * @param json_object   Reference to a JsonObject containing command parameters.
+ * @param queue_index   Queue Manager ID where the parsed command will be sent.
+ * @param buffer        JSON payload; only read, need not be null-terminated.
+ * @param buffer_size   Length of the payload in bytes.
  * @return kernel_error_st
  *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_DESERIALIZE_JSON if the JSON is malformed
  *         - KERNEL_ERROR_MISSING_FIELD if a required key is missing
  *         - KERNEL_ERROR_INVALID_TYPE if any value is of the wrong type
- *         - KERNEL_ERROR_QUEUE_SEND if sending to the queue fails
+ *         - KERNEL_ERROR_INVALID_COMMAND if the command index is unrecognized
+ *         - KERNEL_ERROR_INVALID_SIZE if a string parameter is too long
+ *         - KERNEL_ERROR_QUEUE_SEND if the queue is full (window of outstanding commands reached)
  */
-kernel_error_st deserialize_command(QueueHandle_t queue, char *buffer, size_t buffer_size);
+kernel_error_st deserialize_command(uint8_t queue_index, char *buffer, size_t buffer_size);
 
 #ifdef __cplusplus
 }
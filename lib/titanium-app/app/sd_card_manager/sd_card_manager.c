@@ -5,6 +5,39 @@
  * This module handles SPI initialization for SD card, mounts FAT filesystem,
  * opens a log file, converts device reports to CSV, and writes them safely.
  * Designed for single-threaded logging of sensor data.
+ *
+ * CSV lines are collected in a write-behind buffer and written in
+ * sector-aligned blocks: a block is written when it reaches the next
+ * SD_CARD_WRITE_BUFFER_SIZE boundary of the file, and the pending bytes are
+ * also written once the oldest one is SD_CARD_WRITE_BUFFER_MAX_AGE_MS old, on
+ * restart and before the card is dismounted. The task sleeps on its
+ * notification value and is woken by the SD card queue, the buffer age or the
+ * restart request.
+ *
+ * With SD_CARD_LOG_BINARY, reports are stored as fixed-size records in
+ * CRC-protected blocks (sd_log_codec.h) instead of CSV lines, and a time
+ * index entry is appended to a second file every SD_CARD_LOG_INDEX_INTERVAL
+ * blocks. The block being filled is rewritten in place by each flush until
+ * it is full, so the records of a partly written block are not lost.
+ *
+ * The binary log is split in numbered segment files, managed by
+ * sd_log_segments.h; the next segment is started when the open one is full
+ * or when a record falls in the next SD_CARD_LOG_SEGMENT_SECONDS window.
+ *
+ * When the card cannot be written, because it failed to mount or was
+ * dismounted after MAX_WRITE_ERROR_COUNTER failed writes in a row, reports
+ * are kept as log records in a RAM spill ring of SD_CARD_SPILL_BUFFER_SIZE
+ * bytes, the oldest dropped when it is full. The card is mounted again after
+ * SD_CARD_REMOUNT_MIN_MS, the wait doubling after each failed attempt up to
+ * SD_CARD_REMOUNT_MAX_MS, and the spilled records are written before any
+ * newer report. Records of the binary log not on the card yet when it is
+ * lost go back to the ring; CSV lines stay in the write-behind buffer. The
+ * counters are read with sd_card_manager_get_stats().
+ *
+ * The binary log can also be read back: a history request (see
+ * sd_card_manager_request_history()) streams the records of a time range to
+ * the history topic through sd_log_history.h, one step between two drains of
+ * the SD card queue.
  */
 #include "sd_card_manager.h"
 
@@ -14,9 +47,17 @@
 #include <sys/stat.h>
 #include <sys/unistd.h>
 
+#include "esp_system.h"
+
 #include "kernel/inter_task_communication/inter_task_communication.h"
 #include "kernel/logger/logger.h"
 
+#include "app/app_tasks_config.h"
+#include "app/sd_card_manager/sd_csv_format.h"
+#include "app/sd_card_manager/sd_log_codec.h"
+#include "app/sd_card_manager/sd_log_history.h"
+#include "app/sd_card_manager/sd_log_segments.h"
+
 // This should be temporary, or not who knows
 #define PIN_NUM_MISO GPIO_NUM_12
 #define PIN_NUM_MOSI GPIO_NUM_13
@@ -26,95 +67,625 @@
 #define FILE_BUFFER_SIZE 512 /**< Size of the temporary buffer for a single CSV line */
 #define FILEPATH_SIZE 128    /**< Maximum length of the full file path */
 
+#define SD_SECTOR_SIZE 512                  /**< Size of an SD card sector */
+#define SD_ALLOCATION_UNIT_SIZE (16 * 1024) /**< FAT cluster size used when formatting the card */
+
+#define SPILL_RECORDS (SD_CARD_SPILL_BUFFER_SIZE / sizeof(sd_log_record_st)) /**< Records held by the spill ring */
+
+#define SD_CARD_NOTIFY_REPORT_BIT (1UL << 0)   /**< Notification bit set when a report is enqueued */
+#define SD_CARD_NOTIFY_SHUTDOWN_BIT (1UL << 1) /**< Notification bit set when the system restarts */
+#define SD_CARD_NOTIFY_HISTORY_BIT (1UL << 2)  /**< Notification bit set when a history request is enqueued */
+
+_Static_assert((SD_CARD_WRITE_BUFFER_SIZE % SD_SECTOR_SIZE) == 0, "SD_CARD_WRITE_BUFFER_SIZE must be a multiple of the sector size");
+_Static_assert((SD_ALLOCATION_UNIT_SIZE % SD_CARD_WRITE_BUFFER_SIZE) == 0,
+               "SD_CARD_WRITE_BUFFER_SIZE must divide the FAT allocation unit");
+_Static_assert(SD_CSV_LINE_MAXIMUM_LENGTH(NUM_OF_SENSORS) <= FILE_BUFFER_SIZE, "A CSV line must fit in the file buffer");
+_Static_assert(SPILL_RECORDS >= 1, "SD_CARD_SPILL_BUFFER_SIZE must hold a record");
+_Static_assert((SD_CARD_WRITE_BUFFER_SIZE % SD_LOG_BLOCK_SIZE) == 0, "SD_CARD_WRITE_BUFFER_SIZE must hold whole log blocks");
+_Static_assert(SD_CARD_LOG_INDEX_INTERVAL > (SD_CARD_WRITE_BUFFER_SIZE / SD_LOG_BLOCK_SIZE),
+               "At most one time index entry may be waiting for a flush");
+
+#if SD_CARD_LOG_BINARY
+_Static_assert((SD_CARD_LOG_SEGMENT_SIZE % SD_CARD_WRITE_BUFFER_SIZE) == 0,
+               "SD_CARD_LOG_SEGMENT_SIZE must be a multiple of SD_CARD_WRITE_BUFFER_SIZE");
+#endif
+
 static const char* TAG                       = "SD Card Manager"; /**< Logger tag */
 static const char* MOUNT_POINT               = "/sdcard";         /**< Mount point for SD card */
 static const uint8_t MAX_WRITE_ERROR_COUNTER = 5;
 
+static const TickType_t SD_CARD_POLL_WAIT           = pdMS_TO_TICKS(100);  /**< Wait between polls when notifications are unavailable */
+static const TickType_t SD_CARD_SHUTDOWN_FLUSH_WAIT = pdMS_TO_TICKS(500);  /**< Longest time a restart waits for the final write */
+
 static bool is_sd_card_present                       = false; /**< Tracks SD card presence */
 static bool is_file_open                             = false; /**< */
-static char filepath[FILEPATH_SIZE]                  = {0};   /**< Full path to the file on the SD card */
-static char file_buffer[FILE_BUFFER_SIZE]            = {0};
-static FILE* file                                    = NULL; /**< File pointer for open log file */
 static sdmmc_card_t* card                            = NULL;
 static esp_vfs_fat_sdmmc_mount_config_t mount_config = {0};
 static sdmmc_host_t host                             = SDSPI_HOST_DEFAULT();
 static sdspi_device_config_t slot_config             = SDSPI_DEVICE_CONFIG_DEFAULT();
 
 /**
- * @brief Write the contents of the CSV buffer to the open log file.
+ * Write-behind buffer. It holds one extra CSV line so a line never has to be
+ * split when the block boundary falls inside it.
+ */
+static char write_buffer[SD_CARD_WRITE_BUFFER_SIZE + FILE_BUFFER_SIZE] = {0};
+
+static size_t write_buffer_length         = 0;                         /**< Bytes waiting in write_buffer */
+static size_t write_buffer_limit          = SD_CARD_WRITE_BUFFER_SIZE; /**< Bytes up to the next block boundary of the file */
+static size_t file_size                   = 0;                         /**< Bytes already written to the log file */
+static TickType_t oldest_buffered_at      = 0;                         /**< Tick at which the oldest waiting byte was buffered */
+static TaskHandle_t sd_card_task          = NULL;                      /**< Handle of the SD card manager task */
+static SemaphoreHandle_t shutdown_flushed = NULL;                      /**< Given once the restart write is done */
+
+static sd_log_record_st spill_ring[SPILL_RECORDS] = {0}; /**< Reports waiting for the card, the oldest at spill_head */
+static size_t spill_head                          = 0;   /**< Index of the oldest spilled record */
+static size_t spill_count                         = 0;   /**< Records in spill_ring */
+static uint8_t sensor_types[NUM_OF_SENSORS]       = {0}; /**< Sensor types of the last report, for records that do not carry them */
+static TickType_t remount_failed_at               = 0;   /**< Tick at which the card was lost or last failed to mount */
+static TickType_t remount_backoff                 = 0;   /**< Wait after remount_failed_at before the next mount attempt */
+static sd_card_stats_st stats                     = {0}; /**< Availability and data-loss counters */
+
+#if SD_CARD_LOG_BINARY
+static sd_log_segment_st segment                            = {0};   /**< Open segment of the log */
+static uint8_t current_block[SD_LOG_BLOCK_SIZE]             = {0};   /**< Log block being filled */
+static bool current_block_dirty                             = false; /**< current_block has records not yet written */
+static uint32_t next_block_number                           = 0;     /**< Number of the next block to start, 0 before the header */
+static uint8_t pending_index_entry[SD_LOG_INDEX_ENTRY_SIZE] = {0};   /**< Time index entry waiting for a flush */
+static bool has_pending_index_entry                         = false; /**< pending_index_entry must be appended */
+static int64_t segment_window                               = 0;     /**< Time window of the first record of the open segment */
+static uint8_t partial_block_records                        = 0;     /**< Records of the block at file_size already written by a flush */
+#else
+static char filepath[FILEPATH_SIZE]       = {0};  /**< Full path to the file on the SD card */
+static FILE* file                         = NULL; /**< File pointer for open log file */
+static char file_buffer[FILE_BUFFER_SIZE] = {0};  /**< CSV line being formatted */
+#endif
+
+/**
+ * @brief Log file being written: the open segment of the binary log, or the CSV file.
  *
- * Uses fputs() to safely write the buffer, and flushes the file to ensure
- * data is persisted to SD card immediately.
+ * @return The file, NULL when none is open
+ */
+static FILE* log_file(void) {
+#if SD_CARD_LOG_BINARY
+    return segment.file;
+#else
+    return file;
+#endif
+}
+
+/**
+ * @brief Write the first bytes of the write-behind buffer to the open log file.
+ *
+ * The bytes are written at file_size with a single fwrite() and made durable
+ * with one fsync(). The committed bytes are then dropped from the buffer and
+ * the rest moved to its start; bytes written but not committed (the binary
+ * block being filled) are rewritten by the next write. On failure the buffer
+ * is kept, so the write is retried on the next flush.
  *
+ * @param size        Number of bytes to write.
+ * @param commit_size Number of written bytes that are final (at most write_buffer_length).
  * @return KERNEL_SUCCESS if write succeeds, otherwise an appropriate error code
  */
-static kernel_error_st write_to_file(void) {
+static kernel_error_st write_to_file(size_t size, size_t commit_size) {
+    FILE* file = log_file();
     if (!file) {
         logger_print(ERR, TAG, "File not open for writing");
         return KERNEL_ERROR_NULL;
     }
 
-    if (fputs(file_buffer, file) == EOF) {
+    if (size == 0) {
+        return KERNEL_SUCCESS;
+    }
+
+    if ((fseek(file, (long)file_size, SEEK_SET) != 0) || (fwrite(write_buffer, 1, size, file) != size)) {
         logger_print(ERR, TAG, "Failed to write to SD card!");
-        is_sd_card_present = false;
         return KERNEL_ERROR_FAILED_TO_WRITE_TO_FILE;
     }
 
-    int errno = fsync(fileno(file));
-    if (errno < 0) {
-        logger_print(ERR, TAG, "fsync failed (%d)", errno);
-        is_sd_card_present = false;
+    if (fsync(fileno(file)) < 0) {
+        logger_print(ERR, TAG, "fsync failed");
         return KERNEL_ERROR_FAILED_TO_WRITE_TO_FILE;
     }
-    fflush(file);
+
+    file_size += commit_size;
+    write_buffer_length -= commit_size;
+    memmove(write_buffer, write_buffer + commit_size, write_buffer_length);
+    write_buffer_limit = SD_CARD_WRITE_BUFFER_SIZE - (file_size % SD_CARD_WRITE_BUFFER_SIZE);
+    oldest_buffered_at = xTaskGetTickCount();
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Append a record to the spill ring, dropping the oldest one when it is full.
+ *
+ * @param record Record of a report that cannot be written now.
+ */
+static void spill_push(const sd_log_record_st* record) {
+    if (spill_count == SPILL_RECORDS) {
+        spill_head = (spill_head + 1) % SPILL_RECORDS;
+        spill_count--;
+        stats.reports_dropped++;
+    }
+
+    spill_ring[(spill_head + spill_count) % SPILL_RECORDS] = *record;
+    spill_count++;
+    stats.reports_spilled++;
+    stats.reports_pending = (uint32_t)spill_count;
+}
+
+#if SD_CARD_LOG_BINARY
+/**
+ * @brief Put a record in front of the spill ring, as older than every record in it.
+ *
+ * When the ring is full the record is the oldest one, so it is dropped.
+ *
+ * @param record Record taken back from the write-behind buffer.
+ */
+static void spill_push_front(const sd_log_record_st* record) {
+    if (spill_count == SPILL_RECORDS) {
+        stats.reports_dropped++;
+        return;
+    }
+
+    spill_head             = (spill_head + SPILL_RECORDS - 1) % SPILL_RECORDS;
+    spill_ring[spill_head] = *record;
+    spill_count++;
+    stats.reports_spilled++;
+    stats.reports_pending = (uint32_t)spill_count;
+}
+
+/**
+ * @brief Append the waiting time index entry to the index file.
+ *
+ * The entry is written after the data it points to. A failed entry is
+ * dropped: readers fall back to the previous entry.
+ */
+static void write_pending_index_entry(void) {
+    if (!has_pending_index_entry) {
+        return;
+    }
+
+    has_pending_index_entry = false;
+    sd_log_segment_write_index_entry(&segment, pending_index_entry);
+}
+
+/**
+ * @brief Write every pending byte of the write-behind buffer to the log file.
+ *
+ * The block being filled is sealed and written after the complete blocks,
+ * but not committed: it is rewritten by the next flush until it is full.
+ *
+ * @return KERNEL_SUCCESS if write succeeds, otherwise an appropriate error code
+ */
+static kernel_error_st flush_write_buffer(void) {
+    size_t size = write_buffer_length;
+
+    if (current_block_dirty) {
+        sd_log_block_seal(current_block, segment.file_id);
+        memcpy(write_buffer + write_buffer_length, current_block, SD_LOG_BLOCK_SIZE);
+        size += SD_LOG_BLOCK_SIZE;
+    }
+
+    kernel_error_st err = write_to_file(size, write_buffer_length);
+    if (err != KERNEL_SUCCESS) {
+        return err;
+    }
+
+    current_block_dirty   = false;
+    partial_block_records = sd_log_block_count(current_block);
+    write_pending_index_entry();
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Whether reports are buffered but not written yet.
+ */
+static bool has_unwritten_data(void) {
+    return (write_buffer_length != 0) || current_block_dirty;
+}
+
+/**
+ * @brief Move the full block being filled to the write-behind buffer.
+ *
+ * Writes the buffer once it reaches the next SD_CARD_WRITE_BUFFER_SIZE
+ * boundary of the file.
+ *
+ * @return KERNEL_SUCCESS if the block is buffered and any due write done;
+ *         otherwise the write_to_file() error (the block is buffered).
+ */
+static kernel_error_st close_current_block(void) {
+    sd_log_block_seal(current_block, segment.file_id);
+    memcpy(write_buffer + write_buffer_length, current_block, SD_LOG_BLOCK_SIZE);
+    write_buffer_length += SD_LOG_BLOCK_SIZE;
+    current_block_dirty = false;
+    memset(current_block, 0, sizeof(current_block));
+
+    if (write_buffer_length < write_buffer_limit) {
+        return KERNEL_SUCCESS;
+    }
+
+    kernel_error_st err = write_to_file(write_buffer_limit, write_buffer_limit);
+    if (err == KERNEL_SUCCESS) {
+        /* The block now at file_size was never flushed */
+        partial_block_records = 0;
+        write_pending_index_entry();
+    }
+
+    return err;
+}
+
+static kernel_error_st close_and_dismount_sd_partition();
+static void schedule_remount(TickType_t backoff);
+
+/**
+ * @brief Whether a record with this timestamp must start the next segment.
+ *
+ * The open segment is left when it has no room for another block or when
+ * the record belongs to another time window than its first record.
+ */
+static bool segment_due(int64_t timestamp) {
+    if (next_block_number <= 1) {
+        return false;
+    }
+
+    if (sd_log_segment_window(timestamp) != segment_window) {
+        return true;
+    }
+
+    return (sd_log_block_count(current_block) == 0) && (next_block_number >= SD_LOG_SEGMENT_BLOCKS);
+}
+
+/**
+ * @brief Set the writer up to append after the data of the segment just opened.
+ *
+ * @param end Where the data of the segment ends; its last block, if not full, is in current_block.
+ */
+static void resume_writer(const sd_log_segment_end_st* end) {
+    file_size               = end->size;
+    next_block_number       = end->next_block_number;
+    segment_window          = end->window;
+    partial_block_records   = end->last_block_records;
+    current_block_dirty     = false;
+    has_pending_index_entry = false;
+    write_buffer_length     = 0;
+    write_buffer_limit      = SD_CARD_WRITE_BUFFER_SIZE - (file_size % SD_CARD_WRITE_BUFFER_SIZE);
+}
+
+/**
+ * @brief Close the open segment and start the next one.
+ *
+ * The pending bytes are written first, so the closed segment can be shrunk
+ * to the blocks it holds. When the next segment cannot be opened, the card
+ * is dismounted and a remount scheduled, so later reports go to the spill
+ * ring instead of a buffer no file will take.
+ *
+ * @return KERNEL_SUCCESS on success, otherwise the flush_write_buffer() or sd_log_segment_rotate() error
+ */
+static kernel_error_st rotate_segment(void) {
+    kernel_error_st err = flush_write_buffer();
+    if (err != KERNEL_SUCCESS) {
+        return err;
+    }
+
+    size_t used_size = file_size + ((sd_log_block_count(current_block) != 0) ? SD_LOG_BLOCK_SIZE : 0);
+
+    sd_log_segment_end_st end;
+    err = sd_log_segment_rotate(&segment, used_size, sd_log_history_first_segment(), current_block, &end);
+    if (err == KERNEL_ERROR_INVALID_INDEX) {
+        return err;
+    }
+
+    if (err != KERNEL_SUCCESS) {
+        logger_print(ERR, TAG, "Failed to open %s - %d, remounting the card", segment.path, err);
+        close_and_dismount_sd_partition();
+        schedule_remount(pdMS_TO_TICKS(SD_CARD_REMOUNT_MIN_MS));
+        return err;
+    }
+
+    resume_writer(&end);
 
     return KERNEL_SUCCESS;
 }
 
+/**
+ * @brief Append a record to the binary log.
+ *
+ * The next segment is started first when the record does not belong to the
+ * open one. The file header is buffered before the first record of a
+ * segment, with the sensor types of the last report. A time index entry is
+ * prepared when the first record of every SD_CARD_LOG_INDEX_INTERVAL-th block
+ * is added.
+ *
+ * @param record   Record to append.
+ * @param buffered Set to whether the record was buffered; if not, the caller keeps it.
+ * @return KERNEL_SUCCESS if the record is buffered and any due write done;
+ *         KERNEL_ERROR_BUFFER_TOO_SHORT if earlier writes failed and the record does not fit;
+ *         otherwise the write_to_file() or rotate_segment() error.
+ */
+static kernel_error_st buffer_record(const sd_log_record_st* record, bool* buffered) {
+    kernel_error_st err = KERNEL_SUCCESS;
+
+    *buffered = false;
+
+    if (segment_due(record->timestamp)) {
+        err = rotate_segment();
+        if (err != KERNEL_SUCCESS) {
+            return err;
+        }
+    }
+
+    /* Blocks closed by this record, keeping room for flush_write_buffer() to append the block being filled */
+    size_t needed = SD_LOG_BLOCK_SIZE;
+    if (next_block_number == 0) {
+        needed += SD_LOG_BLOCK_SIZE;
+    }
+    if (sd_log_block_count(current_block) == (SD_LOG_RECORDS_PER_BLOCK - 1)) {
+        needed += SD_LOG_BLOCK_SIZE;
+    }
+    if ((write_buffer_length + needed) > sizeof(write_buffer)) {
+        return KERNEL_ERROR_BUFFER_TOO_SHORT;
+    }
+
+    if (!has_unwritten_data()) {
+        oldest_buffered_at = xTaskGetTickCount();
+    }
+
+    if (next_block_number == 0) {
+        sd_log_header_st header = {
+            .file_id        = segment.file_id,
+            .num_of_sensors = NUM_OF_SENSORS,
+            .index_interval = SD_CARD_LOG_INDEX_INTERVAL,
+        };
+        memcpy(header.sensor_types, sensor_types, sizeof(header.sensor_types));
+
+        sd_log_header_encode((uint8_t*)(write_buffer + write_buffer_length), &header);
+        write_buffer_length += SD_LOG_BLOCK_SIZE;
+        next_block_number = 1;
+    }
+
+    if (sd_log_block_count(current_block) == 0) {
+        uint32_t block_number = next_block_number++;
+        sd_log_block_begin(current_block, block_number);
+
+        if (block_number == 1) {
+            segment_window = sd_log_segment_window(record->timestamp);
+        }
+
+        if (((block_number - 1) % SD_CARD_LOG_INDEX_INTERVAL) == 0) {
+            sd_log_index_encode(pending_index_entry, record->timestamp, block_number);
+            has_pending_index_entry = true;
+        }
+    }
+
+    sd_log_block_add(current_block, record);
+    current_block_dirty = true;
+    *buffered           = true;
+
+    if (sd_log_block_count(current_block) < SD_LOG_RECORDS_PER_BLOCK) {
+        return KERNEL_SUCCESS;
+    }
+
+    return close_current_block();
+}
+
+/**
+ * @brief Push the records of a block from `first` on in front of the spill ring.
+ *
+ * @param block Data block, sealed or being filled.
+ * @param count Records in the block.
+ * @param first Index of the first record to push.
+ */
+static void spill_block_records(const uint8_t* block, uint8_t count, uint8_t first) {
+    sd_log_record_st record;
+
+    /* Newest first, each in front of the newer ones */
+    for (uint8_t i = count; i > first; i--) {
+        if (sd_log_block_record(block, i - 1, &record) == KERNEL_SUCCESS) {
+            spill_push_front(&record);
+        }
+    }
+}
+
+/**
+ * @brief Move the records not on the card yet back to the spill ring.
+ *
+ * Called when the card is lost. The records of the block at file_size that
+ * a flush already wrote are skipped, as the segment resumes from them on
+ * the next mount; a write that failed after reaching the card may leave
+ * duplicates of later records.
+ */
+static void spill_unwritten_records(void) {
+    const uint8_t* first_block = current_block_dirty ? current_block : NULL;
+    uint32_t block_number      = 0;
+    uint8_t count              = 0;
+
+    /* The buffer may start with the segment header, which fails the check */
+    for (size_t offset = 0; offset < write_buffer_length; offset += SD_LOG_BLOCK_SIZE) {
+        if (sd_log_block_check((const uint8_t*)write_buffer + offset, segment.file_id, &block_number, &count) == KERNEL_SUCCESS) {
+            first_block = (const uint8_t*)write_buffer + offset;
+            break;
+        }
+    }
+
+    if (current_block_dirty) {
+        spill_block_records(current_block, sd_log_block_count(current_block),
+                            (first_block == current_block) ? partial_block_records : 0);
+    }
+
+    for (size_t offset = write_buffer_length; offset >= SD_LOG_BLOCK_SIZE; offset -= SD_LOG_BLOCK_SIZE) {
+        const uint8_t* block = (const uint8_t*)write_buffer + offset - SD_LOG_BLOCK_SIZE;
+        if (sd_log_block_check(block, segment.file_id, &block_number, &count) == KERNEL_SUCCESS) {
+            spill_block_records(block, count, (block == first_block) ? partial_block_records : 0);
+        }
+    }
+}
+#else
+/**
+ * @brief Write every pending byte of the write-behind buffer to the log file.
+ *
+ * @return KERNEL_SUCCESS if write succeeds, otherwise an appropriate error code
+ */
+static kernel_error_st flush_write_buffer(void) {
+    return write_to_file(write_buffer_length, write_buffer_length);
+}
+
+/**
+ * @brief Whether reports are buffered but not written yet.
+ */
+static bool has_unwritten_data(void) {
+    return write_buffer_length != 0;
+}
+
 /**
  * @brief Converts a device_report_st into a CSV string in the file_buffer.
  *
  * Format: timestamp,value1,type1,active1,value2,type2,active2,...,num_of_sensors\n
- * Handles multiple sensors and checks buffer size to prevent overflow.
+ * Formatted by sd_csv_format_record(), byte-identical to the former
+ * snprintf() path without its float formatting cost.
  *
  * @param device_report Pointer to the device report to convert
+ * @param csv_length    Length of the CSV line written to file_buffer
  * @return KERNEL_SUCCESS if conversion succeeds, otherwise error code
  */
-static kernel_error_st device_report_to_csv(const device_report_st* device_report) {
-    if (!device_report) {
+static kernel_error_st device_report_to_csv(const device_report_st* device_report, size_t* csv_length) {
+    if (!device_report || !csv_length) {
         return KERNEL_ERROR_NULL;
     }
 
-    int written   = 0;
-    int remaining = sizeof(file_buffer);
+    return sd_csv_format_record(device_report->timestamp,
+                                device_report->sensors,
+                                device_report->num_of_sensors,
+                                file_buffer,
+                                sizeof(file_buffer),
+                                csv_length);
+}
+
+/**
+ * @brief Append the CSV line in file_buffer to the write-behind buffer.
+ *
+ * Writes the completed block once the buffer reaches the next
+ * SD_CARD_WRITE_BUFFER_SIZE boundary of the file, so full blocks always
+ * cover whole sectors.
+ *
+ * @param length   Length of the CSV line.
+ * @param buffered Set to whether the line was buffered.
+ * @return KERNEL_SUCCESS if the line is buffered and any due block written;
+ *         KERNEL_ERROR_BUFFER_TOO_SHORT if earlier writes failed and the line does not fit;
+ *         otherwise the write_to_file() error (the line is buffered).
+ */
+static kernel_error_st buffer_csv_line(size_t length, bool* buffered) {
+    *buffered = false;
 
-    int size = snprintf(file_buffer + written, remaining, "%lld,", device_report->timestamp);
-    if (size < 0 || size >= remaining) {
+    if ((write_buffer_length + length) > sizeof(write_buffer)) {
         return KERNEL_ERROR_BUFFER_TOO_SHORT;
     }
-    written += size;
-    remaining -= size;
 
-    for (uint8_t i = 0; i < device_report->num_of_sensors; i++) {
-        size = snprintf(file_buffer + written,
-                        remaining,
-                        "%.2f,%d,%d,",
-                        device_report->sensors[i].value,
-                        (uint8_t)device_report->sensors[i].sensor_type,
-                        device_report->sensors[i].active ? 1 : 0);
-        if (size < 0 || size >= remaining) {
-            return KERNEL_ERROR_BUFFER_TOO_SHORT;
-        }
-        written += size;
-        remaining -= size;
+    if (write_buffer_length == 0) {
+        oldest_buffered_at = xTaskGetTickCount();
     }
 
-    size = snprintf(file_buffer + written, remaining, "%d\n", device_report->num_of_sensors);
-    if (size < 0 || size >= remaining) {
-        return KERNEL_ERROR_BUFFER_TOO_SHORT;
+    memcpy(write_buffer + write_buffer_length, file_buffer, length);
+    write_buffer_length += length;
+    *buffered = true;
+
+    if (write_buffer_length < write_buffer_limit) {
+        return KERNEL_SUCCESS;
     }
 
-    return KERNEL_SUCCESS;
+    return write_to_file(write_buffer_limit, write_buffer_limit);
+}
+
+/**
+ * @brief Append a device report to the CSV log.
+ *
+ * @param device_report Report to append.
+ * @param buffered      Set to whether the line was buffered.
+ * @return KERNEL_SUCCESS if the line is buffered and any due write done;
+ *         KERNEL_ERROR_FORMATTING if the report cannot be formatted, so it can never be written;
+ *         otherwise the buffer_csv_line() error.
+ */
+static kernel_error_st buffer_report(const device_report_st* device_report, bool* buffered) {
+    size_t csv_length   = 0;
+    kernel_error_st err = device_report_to_csv(device_report, &csv_length);
+    if (err != KERNEL_SUCCESS) {
+        logger_print(ERR, TAG, "Failed to convert device report to CSV - %d", err);
+        *buffered = false;
+        return KERNEL_ERROR_FORMATTING;
+    }
+
+    return buffer_csv_line(csv_length, buffered);
+}
+
+/**
+ * @brief Append a spilled record to the CSV log.
+ *
+ * Values come back from the hundredths of the record, so a value exactly
+ * halfway between two hundredths may print one hundredth away from the line
+ * buffer_report() would have written.
+ *
+ * @param record   Record to append.
+ * @param buffered Set to whether the line was buffered.
+ * @return KERNEL_SUCCESS if the line is buffered and any due write done;
+ *         KERNEL_ERROR_FORMATTING if the record cannot be formatted, so it can never be written;
+ *         otherwise the buffer_csv_line() error.
+ */
+static kernel_error_st buffer_record(const sd_log_record_st* record, bool* buffered) {
+    sensor_report_st sensors[NUM_OF_SENSORS];
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        sensors[i].value       = sd_log_value_decode(record->values[i]);
+        sensors[i].active      = (record->active_mask & (1UL << i)) != 0;
+        sensors[i].sensor_type = (sensor_type_et)sensor_types[i];
+    }
+
+    size_t csv_length   = 0;
+    kernel_error_st err = sd_csv_format_record(record->timestamp, sensors, NUM_OF_SENSORS, file_buffer, sizeof(file_buffer),
+                                               &csv_length);
+    if (err != KERNEL_SUCCESS) {
+        logger_print(ERR, TAG, "Failed to convert spilled record to CSV - %d", err);
+        *buffered = false;
+        return KERNEL_ERROR_FORMATTING;
+    }
+
+    return buffer_csv_line(csv_length, buffered);
+}
+#endif
+
+/**
+ * @brief Ticks until the oldest buffered byte reaches SD_CARD_WRITE_BUFFER_MAX_AGE_MS.
+ *
+ * @return 0 if the buffer is due, portMAX_DELAY if it is empty or the card is not mounted.
+ */
+static TickType_t write_buffer_time_left(void) {
+    if (!is_file_open || !has_unwritten_data()) {
+        return portMAX_DELAY;
+    }
+
+    TickType_t age     = xTaskGetTickCount() - oldest_buffered_at;
+    TickType_t max_age = pdMS_TO_TICKS(SD_CARD_WRITE_BUFFER_MAX_AGE_MS);
+
+    return (age >= max_age) ? 0 : (max_age - age);
+}
+
+/**
+ * @brief Restart hook: has the SD card task write the pending bytes.
+ *
+ * Registered with esp_register_shutdown_handler(). Waits at most
+ * SD_CARD_SHUTDOWN_FLUSH_WAIT for the write.
+ */
+static void sd_card_manager_shutdown_handler(void) {
+    if (sd_card_task == NULL) {
+        return;
+    }
+
+    if (xTaskGetCurrentTaskHandle() == sd_card_task) {
+        flush_write_buffer();
+        return;
+    }
+
+    xTaskNotify(sd_card_task, SD_CARD_NOTIFY_SHUTDOWN_BIT, eSetBits);
+    xSemaphoreTake(shutdown_flushed, SD_CARD_SHUTDOWN_FLUSH_WAIT);
 }
 
 /**
@@ -158,13 +729,34 @@ static kernel_error_st open_and_mount_sd_partition() {
         return kerr;
     }
 
+#if SD_CARD_LOG_BINARY
+    sd_log_segment_end_st end;
+    kerr = sd_log_segment_open_newest(&segment, sd_log_history_first_segment(), current_block, &end);
+    if (kerr != KERNEL_SUCCESS) {
+        logger_print(ERR, TAG, "Failed to open log file");
+        return kerr;
+    }
+
+    resume_writer(&end);
+#else
     file = fopen(filepath, "a");
     if (!file) {
         logger_print(ERR, TAG, "Failed to open log file");
         return KERNEL_ERROR_FAILED_TO_OPEN_FILE;
     }
 
-    is_file_open = true;
+    struct stat file_stat;
+    file_size = (fstat(fileno(file), &file_stat) == 0) ? (size_t)file_stat.st_size : 0;
+
+    /* Blocks are already sector-aligned: hand them to FATFS without stdio re-buffering. */
+    setvbuf(file, NULL, _IONBF, 0);
+
+    /* Lines kept from a lost card are appended first */
+    write_buffer_limit = SD_CARD_WRITE_BUFFER_SIZE - (file_size % SD_CARD_WRITE_BUFFER_SIZE);
+#endif
+
+    is_file_open  = true;
+    stats.mounted = true;
 
     logger_print(INFO, TAG, "Log file opened successfully");
 
@@ -173,6 +765,25 @@ static kernel_error_st open_and_mount_sd_partition() {
 
 static kernel_error_st close_and_dismount_sd_partition() {
     kernel_error_st kerr = KERNEL_SUCCESS;
+    if (has_unwritten_data() && ((log_file() == NULL) || (flush_write_buffer() != KERNEL_SUCCESS))) {
+#if SD_CARD_LOG_BINARY
+        spill_unwritten_records();
+        logger_print(WARN, TAG, "Unwritten records kept in RAM, %u waiting", (unsigned)spill_count);
+#else
+        logger_print(WARN, TAG, "Keeping %u buffered bytes for the next mount", (unsigned)write_buffer_length);
+#endif
+    }
+
+#if SD_CARD_LOG_BINARY
+    write_buffer_length     = 0;
+    current_block_dirty     = false;
+    has_pending_index_entry = false;
+    sd_log_history_close_file();
+    if (sd_log_segment_close(&segment) != KERNEL_SUCCESS) {
+        logger_print(ERR, TAG, "Failed to close %s", segment.path);
+        kerr = KERNEL_ERROR_FAILED_TO_CLOSE_FILE;
+    }
+#else
     if (file != NULL) {
         int err = fclose(file);
         if (err < 0) {
@@ -181,6 +792,7 @@ static kernel_error_st close_and_dismount_sd_partition() {
         }
         file = NULL;
     }
+#endif
     if (card != NULL) {
         esp_err_t ret = esp_vfs_fat_sdcard_unmount(MOUNT_POINT, card);
         if (ret != ESP_OK) {
@@ -193,6 +805,7 @@ static kernel_error_st close_and_dismount_sd_partition() {
 
     is_file_open       = false;
     is_sd_card_present = false;
+    stats.mounted      = false;
 
     spi_bus_free(host.slot);
 
@@ -200,20 +813,14 @@ static kernel_error_st close_and_dismount_sd_partition() {
 }
 
 /**
- * @brief Initializes the SD card manager and opens the log file.
+ * @brief Initializes the SPI bus, mounts the SD card and opens the log file.
  *
- * Configures SPI bus, mounts SD card, and opens the log file in append mode.
+ * On failure everything started is released again, so the next attempt
+ * starts over.
  *
- * @return KERNEL_SUCCESS if initialization succeeds, otherwise error code
+ * @return KERNEL_SUCCESS if the log file is open, otherwise error code
  */
-static kernel_error_st sd_card_manager_initialize(void) {
-    mount_config.format_if_mount_failed = false;
-    mount_config.max_files              = 5;
-    mount_config.allocation_unit_size   = (16 * 1024);
-
-    slot_config.gpio_cs = PIN_NUM_CS;
-    slot_config.host_id = host.slot;
-
+static kernel_error_st start_sd_card(void) {
     spi_bus_config_t bus_cfg = {
         .mosi_io_num     = PIN_NUM_MOSI,
         .miso_io_num     = PIN_NUM_MISO,
@@ -229,19 +836,285 @@ static kernel_error_st sd_card_manager_initialize(void) {
         return KERNEL_FAILED_INITIALIZE_SPI_BUS;
     }
 
+    kernel_error_st err = open_and_mount_sd_partition();
+    if (err != KERNEL_SUCCESS) {
+        close_and_dismount_sd_partition();
+    }
+
+    return err;
+}
+
+/**
+ * @brief Initializes the SD card manager and opens the log file.
+ *
+ * Configures SPI bus, mounts SD card, and opens the log file in append mode.
+ *
+ * @return KERNEL_SUCCESS if initialization succeeds, otherwise error code
+ */
+static kernel_error_st sd_card_manager_initialize(void) {
+    mount_config.format_if_mount_failed = false;
+    mount_config.max_files              = 5;
+    mount_config.allocation_unit_size   = SD_ALLOCATION_UNIT_SIZE;
+
+    slot_config.gpio_cs = PIN_NUM_CS;
+    slot_config.host_id = host.slot;
+
+#if SD_CARD_LOG_BINARY
+    segment.directory = MOUNT_POINT;
+#else
     size_t filepath_size = snprintf(filepath, sizeof(filepath), "%s/venax.csv", MOUNT_POINT);
     if (filepath_size >= sizeof(filepath)) {
         return KERNEL_ERROR_BUFFER_TOO_SHORT;
     }
+#endif
+
+    return start_sd_card();
+}
+
+/**
+ * @brief Wait `backoff` ticks from now before the next mount attempt.
+ */
+static void schedule_remount(TickType_t backoff) {
+    remount_failed_at = xTaskGetTickCount();
+    remount_backoff   = backoff;
+}
+
+/**
+ * @brief Ticks until the next mount attempt.
+ *
+ * @return 0 if an attempt is due, portMAX_DELAY while the log file is open.
+ */
+static TickType_t remount_time_left(void) {
+    if (is_file_open) {
+        return portMAX_DELAY;
+    }
+
+    TickType_t elapsed = xTaskGetTickCount() - remount_failed_at;
+
+    return (elapsed >= remount_backoff) ? 0 : (remount_backoff - elapsed);
+}
+
+/**
+ * @brief Mount the card again once the backoff has elapsed.
+ *
+ * The wait doubles after each failed attempt, up to SD_CARD_REMOUNT_MAX_MS.
+ */
+static void remount_if_due(void) {
+    if (remount_time_left() != 0) {
+        return;
+    }
+
+    if (start_sd_card() == KERNEL_SUCCESS) {
+        stats.remounts++;
+        logger_print(INFO, TAG, "SD card mounted again, %u reports waiting in RAM", (unsigned)spill_count);
+        return;
+    }
 
-    return open_and_mount_sd_partition();
+    stats.remount_failures++;
+
+    TickType_t backoff = remount_backoff * 2;
+    if (backoff > pdMS_TO_TICKS(SD_CARD_REMOUNT_MAX_MS)) {
+        backoff = pdMS_TO_TICKS(SD_CARD_REMOUNT_MAX_MS);
+    }
+    schedule_remount(backoff);
+
+    logger_print(WARN, TAG, "SD card still unavailable, next attempt in %lu ms", (unsigned long)pdTICKS_TO_MS(backoff));
+}
+
+/**
+ * @brief Count a failed write and dismount the card after too many in a row.
+ *
+ * @param err           Result of the write.
+ * @param error_counter Consecutive write failures, reset by a successful write.
+ */
+static void track_write_result(kernel_error_st err, uint8_t* error_counter) {
+    if (err != KERNEL_SUCCESS) {
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to write device report to SD card - %d", err);
+        (*error_counter)++;
+    } else {
+        *error_counter = 0;
+    }
+
+    if (*error_counter > MAX_WRITE_ERROR_COUNTER) {
+        if (is_file_open) {
+            close_and_dismount_sd_partition();
+            schedule_remount(pdMS_TO_TICKS(SD_CARD_REMOUNT_MIN_MS));
+        }
+        *error_counter = 0;
+    }
+}
+
+/**
+ * @brief Write the spilled records to the log, oldest first.
+ *
+ * Stops at the first failure; a record that was not buffered stays in the
+ * ring, unless it can never be written: that one is dropped and counted.
+ *
+ * @param error_counter Consecutive write failures, reset by a successful write.
+ */
+static void restore_spill(uint8_t* error_counter) {
+    while ((spill_count > 0) && is_file_open) {
+        bool buffered       = false;
+        kernel_error_st err = buffer_record(&spill_ring[spill_head], &buffered);
+        if (buffered || (err == KERNEL_ERROR_FORMATTING)) {
+            spill_head = (spill_head + 1) % SPILL_RECORDS;
+            spill_count--;
+            stats.reports_pending = (uint32_t)spill_count;
+        }
+
+        if (err == KERNEL_ERROR_FORMATTING) {
+            stats.reports_dropped++;
+            continue;
+        }
+
+        track_write_result(err, error_counter);
+        if (err != KERNEL_SUCCESS) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Log one report, or keep it in RAM while the card cannot take it.
+ *
+ * Reports go through the spill ring while it holds older ones, so the log
+ * stays in order. A report that can never be written is counted in
+ * stats.reports_dropped.
+ *
+ * @param device_report Report to log.
+ * @param error_counter Consecutive write failures, reset by a successful write.
+ */
+static void log_report(const device_report_st* device_report, uint8_t* error_counter) {
+    sd_log_record_st record;
+    if (sd_log_record_from_report(&record, device_report->timestamp, device_report->sensors,
+                                  device_report->num_of_sensors) != KERNEL_SUCCESS) {
+        stats.reports_dropped++;
+        return;
+    }
+
+    for (uint8_t i = 0; i < device_report->num_of_sensors; i++) {
+        sensor_types[i] = (uint8_t)device_report->sensors[i].sensor_type;
+    }
+
+    if (!is_file_open || (spill_count > 0)) {
+        spill_push(&record);
+        restore_spill(error_counter);
+        return;
+    }
+
+    bool buffered = false;
+#if SD_CARD_LOG_BINARY
+    kernel_error_st err = buffer_record(&record, &buffered);
+#else
+    kernel_error_st err = buffer_report(device_report, &buffered);
+#endif
+    if (err == KERNEL_ERROR_FORMATTING) {
+        stats.reports_dropped++;
+        return;
+    }
+
+    if (!buffered) {
+        spill_push(&record);
+    }
+
+    track_write_result(err, error_counter);
+}
+
+/**
+ * @brief Log the spilled records, then every report waiting in the SD card queue.
+ *
+ * @param error_counter Consecutive write failures, reset by a successful write.
+ */
+static void drain_reports(uint8_t* error_counter) {
+    device_report_st device_report = {0};
+
+    restore_spill(error_counter);
+
+    while (queue_manager_receive(SD_CARD_QUEUE_ID, &device_report, sizeof(device_report), NULL, 0) == KERNEL_SUCCESS) {
+        log_report(&device_report, error_counter);
+    }
+}
+
+/**
+ * @brief Write the pending bytes of the write-behind buffer, if any.
+ *
+ * After a failure the age is restarted, so the write is retried one
+ * SD_CARD_WRITE_BUFFER_MAX_AGE_MS later or when the next block completes.
+ *
+ * @param error_counter Consecutive write failures, reset by a successful write.
+ */
+static void flush_pending(uint8_t* error_counter) {
+    if (!is_file_open || !has_unwritten_data()) {
+        return;
+    }
+
+    kernel_error_st err = flush_write_buffer();
+    if (err != KERNEL_SUCCESS) {
+        oldest_buffered_at = xTaskGetTickCount();
+    }
+
+    track_write_result(err, error_counter);
+}
+
+#if SD_CARD_LOG_BINARY
+/**
+ * @brief Take the waiting history request, if any.
+ *
+ * The pending reports are written first so the stream covers everything
+ * logged before the request.
+ *
+ * @param error_counter Consecutive write failures, reset by a successful write.
+ */
+static void take_history_request(uint8_t* error_counter) {
+    sd_card_history_request_st request;
+
+    if (queue_manager_receive(SD_CARD_HISTORY_QUEUE_ID, &request, sizeof(request), NULL, 0) == KERNEL_SUCCESS) {
+        flush_pending(error_counter);
+        sd_log_history_start(&request, &segment);
+    }
+}
+#endif
+
+kernel_error_st sd_card_manager_request_history(const cmd_get_history_st* range, uint32_t request_id) {
+#if SD_CARD_LOG_BINARY
+    if (range == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    sd_card_history_request_st request = {
+        .range      = *range,
+        .request_id = request_id,
+    };
+
+    return queue_manager_send(SD_CARD_HISTORY_QUEUE_ID, &request, sizeof(request), 0);
+#else
+    (void)range;
+    (void)request_id;
+
+    return KERNEL_ERROR_UNSUPPORTED_TYPE;
+#endif
+}
+
+kernel_error_st sd_card_manager_get_stats(sd_card_stats_st* out) {
+    if (out == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    *out = stats;
+
+    return KERNEL_SUCCESS;
 }
 
 /**
  * @brief Main loop task for SD card manager.
  *
  * Continuously receives device reports from the SD card queue,
- * converts them to CSV, and writes them to the open log file.
+ * converts them to CSV, and writes them to the open log file through the
+ * write-behind buffer. The task blocks on its notification value until a
+ * report or a history request is enqueued, the buffer reaches its maximum
+ * age, a remount attempt is due or the system restarts; while a history
+ * stream is in progress it only waits for room in the history transport.
+ * Without notifications, the queues are polled every SD_CARD_POLL_WAIT.
  *
  * @param args Task argument (unused)
  */
@@ -251,44 +1124,64 @@ void sd_card_manager_loop(void* args) {
     kernel_error_st err = sd_card_manager_initialize();
     if (err != KERNEL_SUCCESS) {
         logger_print(ERR, TAG, "Failed to initialize SD card manager! - %d", err);
+        stats.remount_failures++;
+        schedule_remount(pdMS_TO_TICKS(SD_CARD_REMOUNT_MIN_MS));
     }
 
-    QueueHandle_t sd_card_queue = queue_manager_get(SD_CARD_QUEUE_ID);
-    if (!sd_card_queue) {
-        logger_print(ERR, TAG, "SD Card report queue is NULL");
-        vTaskDelete(NULL);
-        return;
+    sd_card_task     = xTaskGetCurrentTaskHandle();
+    shutdown_flushed = xSemaphoreCreateBinary();
+    if ((shutdown_flushed == NULL) || (esp_register_shutdown_handler(sd_card_manager_shutdown_handler) != ESP_OK)) {
+        logger_print(WARN, TAG, "Buffered reports will not be written on restart");
     }
 
+    TickType_t idle_wait = portMAX_DELAY;
+    if (queue_manager_set_notify(SD_CARD_QUEUE_ID, sd_card_task, SD_CARD_NOTIFY_REPORT_BIT) != KERNEL_SUCCESS) {
+        logger_print(WARN, TAG, "SD card notifications unavailable, falling back to periodic polling");
+        idle_wait = SD_CARD_POLL_WAIT;
+    }
+
+#if SD_CARD_LOG_BINARY
+    if (queue_manager_set_notify(SD_CARD_HISTORY_QUEUE_ID, sd_card_task, SD_CARD_NOTIFY_HISTORY_BIT) != KERNEL_SUCCESS) {
+        logger_print(WARN, TAG, "History notifications unavailable, falling back to periodic polling");
+        idle_wait = SD_CARD_POLL_WAIT;
+    }
+#endif
+
     while (1) {
-        device_report_st device_report = {0};
+        remount_if_due();
 
-        if (xQueueReceive(sd_card_queue, &device_report, pdMS_TO_TICKS(100)) != pdPASS) {
-            vTaskDelay(pdMS_TO_TICKS(100));
-            continue;
+        /* Reports enqueued before the wait raise a pending notification, so none is missed. */
+        drain_reports(&error_counter);
+
+        if (write_buffer_time_left() == 0) {
+            flush_pending(&error_counter);
         }
 
-        if (is_file_open && is_sd_card_present) {
-            err = device_report_to_csv(&device_report);
-            if (err != KERNEL_SUCCESS) {
-                logger_print(ERR, TAG, "Failed to convert device report to CSV - %d", err);
-                vTaskDelay(pdMS_TO_TICKS(1000));
-                continue;
-            }
-
-            err = write_to_file();
-            if (err != KERNEL_SUCCESS) {
-                logger_print(ERR, TAG, "Failed to write device report to SD card - %d", err);
-                error_counter++;
-            } else {
-                error_counter = 0;
-            }
-
-            if (error_counter > MAX_WRITE_ERROR_COUNTER) {
-                close_and_dismount_sd_partition();
-            }
+        TickType_t wait_ticks = write_buffer_time_left();
+        if (wait_ticks > idle_wait) {
+            wait_ticks = idle_wait;
         }
+        if (remount_time_left() < wait_ticks) {
+            wait_ticks = remount_time_left();
+        }
+
+#if SD_CARD_LOG_BINARY
+        /* Live reports first: the history stream advances one step per wakeup. */
+        take_history_request(&error_counter);
+        sd_log_history_step(&segment);
+
+        if (sd_log_history_time_left() < wait_ticks) {
+            wait_ticks = sd_log_history_time_left();
+        }
+#endif
+
+        uint32_t notified_bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &notified_bits, wait_ticks);
 
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        if (notified_bits & SD_CARD_NOTIFY_SHUTDOWN_BIT) {
+            drain_reports(&error_counter);
+            flush_pending(&error_counter);
+            xSemaphoreGive(shutdown_flushed);
+        }
     }
 }
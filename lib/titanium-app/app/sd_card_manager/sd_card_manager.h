@@ -4,11 +4,50 @@
 
 #include "app/app_extern_types.h"
 
+/**
+ * @brief Historical data request handed to the SD card task.
+ */
+typedef struct sd_card_history_request_s {
+    cmd_get_history_st range;  ///< Time range and first chunk to send.
+    uint32_t request_id;       ///< Correlation ID of the command, copied in every chunk.
+} sd_card_history_request_st;
+
+/**
+ * @brief Asks the SD card task to stream the logged reports of a time range.
+ *
+ * The records are published on the history topic in chunks encoded by
+ * sd_log_codec.h, numbered from `range->offset`; the last chunk carries
+ * SD_LOG_CHUNK_LAST. A new request replaces the stream in progress.
+ *
+ * @param range      Time range and first chunk to send.
+ * @param request_id Correlation ID copied in every chunk.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS if the request was handed to the SD card task
+ *         - KERNEL_ERROR_NULL if range is null
+ *         - KERNEL_ERROR_UNSUPPORTED_TYPE if the log is written as CSV (SD_CARD_LOG_BINARY is 0)
+ *         - KERNEL_ERROR_QUEUE_FULL if an earlier request was not taken yet
+ */
+kernel_error_st sd_card_manager_request_history(const cmd_get_history_st* range, uint32_t request_id);
+
+/**
+ * @brief Copies the availability and data-loss counters of the SD card log.
+ *
+ * Each counter is read atomically; they are not a snapshot of one instant.
+ *
+ * @param stats Output counters.
+ * @return KERNEL_SUCCESS, or KERNEL_ERROR_NULL if stats is null
+ */
+kernel_error_st sd_card_manager_get_stats(sd_card_stats_st* stats);
+
 /**
  * @brief Main loop task for SD card manager.
  *
  * Continuously receives device reports from the SD card queue,
- * converts them to CSV, and writes them to the open log file.
+ * converts them to CSV, and writes them to the open log file through a
+ * sector-aligned write-behind buffer. While the card cannot be written,
+ * reports are kept in RAM and the card is remounted with exponential
+ * backoff. Between reports, streams the records requested with
+ * sd_card_manager_request_history().
  *
  * @param args Task argument (unused)
  */
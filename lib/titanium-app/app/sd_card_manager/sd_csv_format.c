@@ -0,0 +1,219 @@
+#include "sd_csv_format.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define SD_CSV_FALLBACK_SIZE 48  ///< Longest "%.2f" of a float, "-3.4e38" in full, plus terminator.
+
+_Static_assert((SD_CSV_VALUE_LIMIT - 1) / 100 < 10000000UL, "The fixed-point value must fit SD_CSV_VALUE_MAXIMUM_LENGTH");
+
+/**
+ * @brief The two ASCII digits of every value from 0 to 99.
+ */
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * @brief Formats an unsigned integer backwards, two digits at a time, ending just before `end`.
+ *
+ * Digits above 32 bits are peeled off with 64-bit divisions, the rest with
+ * 32-bit ones, which are much cheaper on the ESP32.
+ *
+ * @return Pointer to the first digit.
+ */
+static char *format_uint(char *end, uint64_t value) {
+    char *begin = end;
+
+    while (value > UINT32_MAX) {
+        uint32_t pair = (uint32_t)(value % 100);
+        value /= 100;
+        begin -= 2;
+        memcpy(begin, &digit_pairs[pair * 2], 2);
+    }
+
+    uint32_t small = (uint32_t)value;
+    while (small >= 100) {
+        uint32_t pair = small % 100;
+        small /= 100;
+        begin -= 2;
+        memcpy(begin, &digit_pairs[pair * 2], 2);
+    }
+
+    if (small >= 10) {
+        begin -= 2;
+        memcpy(begin, &digit_pairs[small * 2], 2);
+    } else {
+        *--begin = (char)('0' + small);
+    }
+
+    return begin;
+}
+
+/**
+ * @brief Writes an unsigned integer at `out`.
+ *
+ * @return Pointer just past the last digit.
+ */
+static char *put_uint(char *out, uint64_t value) {
+    char digits[SD_CSV_TIMESTAMP_MAXIMUM_LENGTH];
+    char *end   = digits + sizeof(digits);
+    char *begin = format_uint(end, value);
+
+    memcpy(out, begin, (size_t)(end - begin));
+    return out + (end - begin);
+}
+
+/**
+ * @brief Writes a signed integer at `out`, as "%lld".
+ *
+ * @return Pointer just past the last digit.
+ */
+static char *put_int(char *out, int64_t value) {
+    if (value < 0) {
+        *out++ = '-';
+        return put_uint(out, 0 - (uint64_t)value);
+    }
+
+    return put_uint(out, (uint64_t)value);
+}
+
+/**
+ * @brief Rounds a float to hundredths as "%.2f" does.
+ *
+ * `value * 100` is computed exactly from the mantissa and exponent (a 24-bit
+ * mantissa times 100 fits in 31 bits), then rounded to nearest, ties to
+ * even. The sign is the sign bit, so -0.001 gives "-0.00" like printf.
+ *
+ * @param value      Value to round.
+ * @param hundredths Magnitude of the rounded value, in hundredths.
+ * @param negative   Whether the value has its sign bit set.
+ * @return true if the value is finite and the magnitude below SD_CSV_VALUE_LIMIT.
+ */
+static bool to_hundredths(float value, uint32_t *hundredths, bool *negative) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t biased_exponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa        = bits & 0x7FFFFF;
+    int32_t exponent         = -149;
+
+    if (biased_exponent == 0xFF) {
+        return false;
+    }
+
+    if (biased_exponent != 0) {
+        mantissa |= 0x800000;
+        exponent = (int32_t)biased_exponent - 150;
+    }
+
+    uint64_t scaled = (uint64_t)mantissa * 100;
+
+    if (exponent >= 0) {
+        if (exponent >= 32) {
+            return false;
+        }
+        scaled <<= exponent;
+    } else if (exponent <= -32) {
+        /* scaled < 2^31, so the value is below half a hundredth. */
+        scaled = 0;
+    } else {
+        uint32_t shift    = (uint32_t)-exponent;
+        uint64_t half     = 1ULL << (shift - 1);
+        uint64_t fraction = scaled & ((half << 1) - 1);
+
+        scaled >>= shift;
+        if ((fraction > half) || ((fraction == half) && ((scaled & 1) != 0))) {
+            scaled++;
+        }
+    }
+
+    if (scaled >= SD_CSV_VALUE_LIMIT) {
+        return false;
+    }
+
+    *hundredths = (uint32_t)scaled;
+    *negative   = (bits >> 31) != 0;
+    return true;
+}
+
+kernel_error_st sd_csv_format_record(int64_t timestamp,
+                                     const sensor_report_st *sensors,
+                                     uint8_t num_of_sensors,
+                                     char *line,
+                                     size_t size,
+                                     size_t *length) {
+    if ((sensors == NULL) || (line == NULL) || (length == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (num_of_sensors > NUM_OF_SENSORS) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
+    size_t maximum_length = SD_CSV_LINE_MAXIMUM_LENGTH(num_of_sensors);
+    if (maximum_length > size) {
+        return KERNEL_ERROR_BUFFER_TOO_SHORT;
+    }
+
+    /* Room left for fallback values longer than SD_CSV_VALUE_MAXIMUM_LENGTH */
+    size_t spare = size - maximum_length;
+    char *out    = line;
+
+    out    = put_int(out, timestamp);
+    *out++ = ',';
+
+    for (uint8_t i = 0; i < num_of_sensors; i++) {
+        uint32_t hundredths = 0;
+        bool negative       = false;
+
+        if (to_hundredths(sensors[i].value, &hundredths, &negative)) {
+            if (negative) {
+                *out++ = '-';
+            }
+            out    = put_uint(out, hundredths / 100);
+            *out++ = '.';
+            memcpy(out, &digit_pairs[(hundredths % 100) * 2], 2);
+            out += 2;
+        } else {
+            char text[SD_CSV_FALLBACK_SIZE];
+            int text_length = snprintf(text, sizeof(text), "%.2f", (double)sensors[i].value);
+            if ((text_length < 0) || ((size_t)text_length >= sizeof(text))) {
+                return KERNEL_ERROR_BUFFER_TOO_SHORT;
+            }
+
+            if ((size_t)text_length > SD_CSV_VALUE_MAXIMUM_LENGTH) {
+                size_t extra = (size_t)text_length - SD_CSV_VALUE_MAXIMUM_LENGTH;
+                if (extra > spare) {
+                    return KERNEL_ERROR_BUFFER_TOO_SHORT;
+                }
+                spare -= extra;
+            }
+
+            memcpy(out, text, (size_t)text_length);
+            out += text_length;
+        }
+
+        *out++ = ',';
+        out    = put_uint(out, (uint8_t)sensors[i].sensor_type);
+        *out++ = ',';
+        *out++ = sensors[i].active ? '1' : '0';
+        *out++ = ',';
+    }
+
+    out    = put_uint(out, num_of_sensors);
+    *out++ = '\n';
+    *out   = '\0';
+
+    *length = (size_t)(out - line);
+
+    return KERNEL_SUCCESS;
+}
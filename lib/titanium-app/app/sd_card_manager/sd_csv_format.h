@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * @file sd_csv_format.h
+ * @brief CSV line formatter of the SD card log.
+ *
+ * Writes one device report as
+ * `timestamp,value1,type1,active1,...,valueN,typeN,activeN,N\n`, byte-identical
+ * to the `snprintf` formats `%lld`, `%.2f` and `%d` it replaces, without
+ * going through the C library's float formatting.
+ *
+ * Values are rounded from their exact binary representation, ties to even,
+ * as printf does. Values whose magnitude reaches SD_CSV_VALUE_LIMIT
+ * hundredths, infinities and NaN are rare and still printed by `snprintf`.
+ * The module has no RTOS dependency so it can be built on the host.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernel/error/error_num.h"
+
+#include "app/sensor_manager/sensor_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_CSV_VALUE_LIMIT 1000000000UL     ///< Hundredths from this magnitude on go through snprintf.
+#define SD_CSV_VALUE_MAXIMUM_LENGTH 11      ///< Longest fixed-point value, "-9999999.99".
+#define SD_CSV_TIMESTAMP_MAXIMUM_LENGTH 20  ///< Longest int64 timestamp, "-9223372036854775808".
+
+/**
+ * @brief Longest line of `n` sensors whose values are below SD_CSV_VALUE_LIMIT, terminator included.
+ *
+ * Timestamp and comma, per sensor the value, a type of up to 3 digits, the
+ * active flag and three commas, then the sensor count, newline and terminator.
+ */
+#define SD_CSV_LINE_MAXIMUM_LENGTH(n) \
+    ((SD_CSV_TIMESTAMP_MAXIMUM_LENGTH + 1) + ((size_t)(n) * (SD_CSV_VALUE_MAXIMUM_LENGTH + 7)) + 5)
+
+/**
+ * @brief Formats one device report as a NUL-terminated CSV line.
+ *
+ * The space is checked once, against SD_CSV_LINE_MAXIMUM_LENGTH(); only a
+ * value printed by the snprintf fallback checks again, for the characters
+ * it writes beyond SD_CSV_VALUE_MAXIMUM_LENGTH.
+ *
+ * @param timestamp      Report timestamp, unix seconds.
+ * @param sensors        Readings of the sensors.
+ * @param num_of_sensors Number of readings, at most NUM_OF_SENSORS.
+ * @param line           Output buffer.
+ * @param size           Size of the output buffer in bytes.
+ * @param length         Length of the line, terminator excluded.
+ * @return KERNEL_SUCCESS on success;
+ *         KERNEL_ERROR_NULL if a pointer is NULL;
+ *         KERNEL_ERROR_INVALID_SIZE if num_of_sensors exceeds NUM_OF_SENSORS;
+ *         KERNEL_ERROR_BUFFER_TOO_SHORT if the line may not fit in `size`.
+ */
+kernel_error_st sd_csv_format_record(int64_t timestamp,
+                                     const sensor_report_st *sensors,
+                                     uint8_t num_of_sensors,
+                                     char *line,
+                                     size_t size,
+                                     size_t *length);
+
+#ifdef __cplusplus
+}
+#endif
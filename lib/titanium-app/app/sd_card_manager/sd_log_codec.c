@@ -0,0 +1,380 @@
+#include "sd_log_codec.h"
+
+#include "math.h"
+#include "string.h"
+
+#define SD_LOG_FILE_MAGIC 0x464C5856UL   ///< "VXLF" read as a little-endian uint32.
+#define SD_LOG_BLOCK_MAGIC 0x424C5856UL  ///< "VXLB" read as a little-endian uint32.
+#define SD_LOG_CHUNK_MAGIC 0x434C5856UL  ///< "VXLC" read as a little-endian uint32.
+#define SD_LOG_CRC_OFFSET 12             ///< Offset of the CRC in the file header and in data blocks.
+#define SD_LOG_SENSOR_TYPES_OFFSET 22    ///< Offset of the sensor types in the file header.
+
+_Static_assert(NUM_OF_SENSORS <= 32, "The active bitmask holds at most 32 sensors");
+_Static_assert(SD_LOG_RECORDS_PER_BLOCK >= 1, "A record must fit in a block");
+_Static_assert((SD_LOG_SENSOR_TYPES_OFFSET + NUM_OF_SENSORS) <= SD_LOG_BLOCK_SIZE, "The sensor types must fit in the header");
+
+/**
+ * @brief CRC-32 of each 4-bit value, for the nibble-wise update.
+ */
+static const uint32_t crc32_nibble_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+/**
+ * @brief Writes a 16-bit value in little-endian order.
+ */
+static void put_u16(uint8_t *out, uint16_t value) {
+    out[0] = (uint8_t)(value);
+    out[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief Writes a 32-bit value in little-endian order.
+ */
+static void put_u32(uint8_t *out, uint32_t value) {
+    out[0] = (uint8_t)(value);
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * @brief Writes a 64-bit value in little-endian order.
+ */
+static void put_u64(uint8_t *out, uint64_t value) {
+    put_u32(out, (uint32_t)value);
+    put_u32(out + 4, (uint32_t)(value >> 32));
+}
+
+/**
+ * @brief Reads a little-endian 16-bit value.
+ */
+static uint16_t get_u16(const uint8_t *in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+/**
+ * @brief Reads a little-endian 32-bit value.
+ */
+static uint32_t get_u32(const uint8_t *in) {
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+/**
+ * @brief Reads a little-endian 64-bit value.
+ */
+static uint64_t get_u64(const uint8_t *in) {
+    return (uint64_t)get_u32(in) | ((uint64_t)get_u32(in + 4) << 32);
+}
+
+/**
+ * @brief CRC-32 of a block, computed with its CRC field at 0 and starting from `seed`.
+ */
+static uint32_t block_crc(const uint8_t *block, uint32_t seed) {
+    static const uint8_t zero_crc[4] = {0};
+
+    uint32_t crc = sd_log_crc32(seed, block, SD_LOG_CRC_OFFSET);
+    crc          = sd_log_crc32(crc, zero_crc, sizeof(zero_crc));
+
+    return sd_log_crc32(crc, block + SD_LOG_CRC_OFFSET + 4, SD_LOG_BLOCK_SIZE - SD_LOG_CRC_OFFSET - 4);
+}
+
+/**
+ * @brief Encodes a record at `out`, SD_LOG_RECORD_SIZE bytes.
+ */
+static void encode_record(uint8_t *out, const sd_log_record_st *record) {
+    put_u64(out, (uint64_t)record->timestamp);
+    put_u32(out + 8, record->active_mask);
+    out += 12;
+
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        put_u32(out, (uint32_t)record->values[i]);
+        out += sizeof(int32_t);
+    }
+}
+
+/**
+ * @brief Decodes the record encoded at `in`.
+ */
+static void decode_record(const uint8_t *in, sd_log_record_st *record) {
+    record->timestamp   = (int64_t)get_u64(in);
+    record->active_mask = get_u32(in + 8);
+    in += 12;
+
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        record->values[i] = (int32_t)get_u32(in);
+        in += sizeof(int32_t);
+    }
+}
+
+uint32_t sd_log_crc32(uint32_t crc, const uint8_t *data, size_t size) {
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = (crc >> 4) ^ crc32_nibble_table[(crc ^ data[i]) & 0x0F];
+        crc = (crc >> 4) ^ crc32_nibble_table[(crc ^ (data[i] >> 4)) & 0x0F];
+    }
+
+    return ~crc;
+}
+
+/**
+ * @brief Fixed-point value of a reading.
+ *
+ * Nearest hundredth, as the %.2f of the CSV log. The range is checked before
+ * the conversion, which is undefined for NaN and for values an int32_t cannot
+ * hold; 2^31 is exact in float, and every float below it converts.
+ */
+static int32_t value_encode(float value) {
+    if (isnan(value)) {
+        return SD_LOG_VALUE_NAN;
+    }
+
+    float scaled = value * SD_LOG_VALUE_SCALE;
+    if (scaled >= 2147483648.0f) {
+        return INT32_MAX;
+    }
+    if (scaled <= -2147483648.0f) {
+        return -INT32_MAX;
+    }
+
+    return (int32_t)((scaled < 0) ? (scaled - 0.5f) : (scaled + 0.5f));
+}
+
+kernel_error_st sd_log_record_from_report(sd_log_record_st *record,
+                                          int64_t timestamp,
+                                          const sensor_report_st *sensors,
+                                          uint8_t num_of_sensors) {
+    if ((record == NULL) || (sensors == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (num_of_sensors > NUM_OF_SENSORS) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
+    memset(record, 0, sizeof(*record));
+    record->timestamp = timestamp;
+
+    for (uint8_t i = 0; i < num_of_sensors; i++) {
+        if (sensors[i].active) {
+            record->active_mask |= (1UL << i);
+        }
+        record->values[i] = value_encode(sensors[i].value);
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+float sd_log_value_decode(int32_t value) {
+    return (value == SD_LOG_VALUE_NAN) ? NAN : ((float)value / SD_LOG_VALUE_SCALE);
+}
+
+void sd_log_header_encode(uint8_t *block, const sd_log_header_st *header) {
+    memset(block, 0, SD_LOG_BLOCK_SIZE);
+
+    put_u32(&block[0], SD_LOG_FILE_MAGIC);
+    block[4] = SD_LOG_VERSION;
+    block[5] = header->num_of_sensors;
+    put_u16(&block[6], SD_LOG_BLOCK_SIZE);
+    put_u16(&block[8], SD_LOG_RECORD_SIZE);
+    block[10] = SD_LOG_RECORDS_PER_BLOCK;
+    put_u32(&block[16], header->file_id);
+    put_u16(&block[20], header->index_interval);
+    memcpy(&block[SD_LOG_SENSOR_TYPES_OFFSET], header->sensor_types, NUM_OF_SENSORS);
+
+    put_u32(&block[SD_LOG_CRC_OFFSET], block_crc(block, 0));
+}
+
+kernel_error_st sd_log_header_decode(const uint8_t *block, sd_log_header_st *header) {
+    if ((block == NULL) || (header == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (get_u32(&block[0]) != SD_LOG_FILE_MAGIC) {
+        return KERNEL_ERROR_FORMAT;
+    }
+
+    if (get_u32(&block[SD_LOG_CRC_OFFSET]) != block_crc(block, 0)) {
+        return KERNEL_ERROR_CRC_MISMATCH;
+    }
+
+    if ((block[4] != SD_LOG_VERSION) || (block[5] != NUM_OF_SENSORS) || (get_u16(&block[6]) != SD_LOG_BLOCK_SIZE) ||
+        (get_u16(&block[8]) != SD_LOG_RECORD_SIZE) || (block[10] != SD_LOG_RECORDS_PER_BLOCK)) {
+        return KERNEL_ERROR_UNSUPPORTED_TYPE;
+    }
+
+    header->file_id        = get_u32(&block[16]);
+    header->num_of_sensors = block[5];
+    header->index_interval = get_u16(&block[20]);
+    memcpy(header->sensor_types, &block[SD_LOG_SENSOR_TYPES_OFFSET], NUM_OF_SENSORS);
+
+    return KERNEL_SUCCESS;
+}
+
+void sd_log_block_begin(uint8_t *block, uint32_t block_number) {
+    memset(block, 0, SD_LOG_BLOCK_SIZE);
+
+    put_u32(&block[0], SD_LOG_BLOCK_MAGIC);
+    put_u32(&block[4], block_number);
+}
+
+kernel_error_st sd_log_block_add(uint8_t *block, const sd_log_record_st *record) {
+    if ((block == NULL) || (record == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    uint8_t count = block[8];
+    if (count >= SD_LOG_RECORDS_PER_BLOCK) {
+        return KERNEL_ERROR_BUFFER_TOO_SHORT;
+    }
+
+    encode_record(&block[SD_LOG_BLOCK_HEADER_SIZE + (count * SD_LOG_RECORD_SIZE)], record);
+    block[8] = count + 1;
+
+    return KERNEL_SUCCESS;
+}
+
+uint8_t sd_log_block_count(const uint8_t *block) {
+    return block[8];
+}
+
+void sd_log_block_seal(uint8_t *block, uint32_t file_id) {
+    put_u32(&block[SD_LOG_CRC_OFFSET], block_crc(block, file_id));
+}
+
+kernel_error_st sd_log_block_check(const uint8_t *block, uint32_t file_id, uint32_t *block_number, uint8_t *count) {
+    if (block == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if ((get_u32(&block[0]) != SD_LOG_BLOCK_MAGIC) || (block[8] > SD_LOG_RECORDS_PER_BLOCK)) {
+        return KERNEL_ERROR_FORMAT;
+    }
+
+    if (get_u32(&block[SD_LOG_CRC_OFFSET]) != block_crc(block, file_id)) {
+        return KERNEL_ERROR_CRC_MISMATCH;
+    }
+
+    if (block_number != NULL) {
+        *block_number = get_u32(&block[4]);
+    }
+
+    if (count != NULL) {
+        *count = block[8];
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+kernel_error_st sd_log_block_record(const uint8_t *block, uint8_t index, sd_log_record_st *record) {
+    if ((block == NULL) || (record == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (index >= block[8]) {
+        return KERNEL_ERROR_INVALID_INDEX;
+    }
+
+    decode_record(&block[SD_LOG_BLOCK_HEADER_SIZE + (index * SD_LOG_RECORD_SIZE)], record);
+
+    return KERNEL_SUCCESS;
+}
+
+void sd_log_index_encode(uint8_t *entry, int64_t timestamp, uint32_t block_number) {
+    put_u64(&entry[0], (uint64_t)timestamp);
+    put_u32(&entry[8], block_number);
+    put_u32(&entry[12], sd_log_crc32(0, entry, 12));
+}
+
+kernel_error_st sd_log_index_decode(const uint8_t *entry, int64_t *timestamp, uint32_t *block_number) {
+    if ((entry == NULL) || (timestamp == NULL) || (block_number == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (get_u32(&entry[12]) != sd_log_crc32(0, entry, 12)) {
+        return KERNEL_ERROR_CRC_MISMATCH;
+    }
+
+    *timestamp    = (int64_t)get_u64(&entry[0]);
+    *block_number = get_u32(&entry[8]);
+
+    return KERNEL_SUCCESS;
+}
+
+void sd_log_chunk_begin(uint8_t *chunk, uint32_t request_id, uint32_t sequence) {
+    memset(chunk, 0, SD_LOG_CHUNK_HEADER_SIZE);
+
+    put_u32(&chunk[0], SD_LOG_CHUNK_MAGIC);
+    chunk[4] = SD_LOG_VERSION;
+    chunk[6] = NUM_OF_SENSORS;
+    put_u32(&chunk[8], request_id);
+    put_u32(&chunk[12], sequence);
+}
+
+kernel_error_st sd_log_chunk_add(uint8_t *chunk, size_t size, const sd_log_record_st *record) {
+    if ((chunk == NULL) || (record == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    uint8_t count = chunk[7];
+    size_t length = SD_LOG_CHUNK_HEADER_SIZE + ((size_t)count * SD_LOG_RECORD_SIZE);
+    if ((count == UINT8_MAX) || ((length + SD_LOG_RECORD_SIZE) > size)) {
+        return KERNEL_ERROR_BUFFER_TOO_SHORT;
+    }
+
+    encode_record(&chunk[length], record);
+    chunk[7] = count + 1;
+
+    return KERNEL_SUCCESS;
+}
+
+uint8_t sd_log_chunk_count(const uint8_t *chunk) {
+    return chunk[7];
+}
+
+size_t sd_log_chunk_end(uint8_t *chunk, uint8_t flags) {
+    chunk[5] = flags;
+
+    return SD_LOG_CHUNK_HEADER_SIZE + ((size_t)chunk[7] * SD_LOG_RECORD_SIZE);
+}
+
+kernel_error_st sd_log_chunk_decode(const uint8_t *chunk, size_t length, sd_log_chunk_header_st *header) {
+    if ((chunk == NULL) || (header == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if ((length < SD_LOG_CHUNK_HEADER_SIZE) || (get_u32(&chunk[0]) != SD_LOG_CHUNK_MAGIC)) {
+        return KERNEL_ERROR_FORMAT;
+    }
+
+    if ((chunk[4] != SD_LOG_VERSION) || (chunk[6] != NUM_OF_SENSORS)) {
+        return KERNEL_ERROR_UNSUPPORTED_TYPE;
+    }
+
+    if (length != (SD_LOG_CHUNK_HEADER_SIZE + ((size_t)chunk[7] * SD_LOG_RECORD_SIZE))) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
+    header->flags          = chunk[5];
+    header->num_of_sensors = chunk[6];
+    header->num_of_records = chunk[7];
+    header->request_id     = get_u32(&chunk[8]);
+    header->sequence       = get_u32(&chunk[12]);
+
+    return KERNEL_SUCCESS;
+}
+
+kernel_error_st sd_log_chunk_record(const uint8_t *chunk, uint8_t index, sd_log_record_st *record) {
+    if ((chunk == NULL) || (record == NULL)) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (index >= chunk[7]) {
+        return KERNEL_ERROR_INVALID_INDEX;
+    }
+
+    decode_record(&chunk[SD_LOG_CHUNK_HEADER_SIZE + ((size_t)index * SD_LOG_RECORD_SIZE)], record);
+
+    return KERNEL_SUCCESS;
+}
@@ -0,0 +1,340 @@
+#pragma once
+
+/**
+ * @file sd_log_codec.h
+ * @brief Fixed-size binary record format of the SD card log.
+ *
+ * A log segment is a sequence of SD_LOG_BLOCK_SIZE blocks, one SD sector
+ * each, so block `n` starts at byte `n * SD_LOG_BLOCK_SIZE`. All fields are
+ * little-endian. Block 0 is the file header:
+ *
+ * | Offset | Size | Field                                              |
+ * |--------|------|----------------------------------------------------|
+ * | 0      | 4    | magic, "VXLF"                                      |
+ * | 4      | 1    | version (SD_LOG_VERSION)                           |
+ * | 5      | 1    | number of sensors per record                       |
+ * | 6      | 2    | block size                                         |
+ * | 8      | 2    | record size                                        |
+ * | 10     | 1    | records per block                                  |
+ * | 11     | 1    | reserved, 0                                        |
+ * | 12     | 4    | CRC-32 of the block, computed with this field at 0 |
+ * | 16     | 4    | file ID, random per segment                        |
+ * | 20     | 2    | index interval, in blocks                          |
+ * | 22     | n    | sensor type of each sensor (sensor_type_et)        |
+ *
+ * Every following block holds up to SD_LOG_RECORDS_PER_BLOCK records:
+ *
+ * | Offset | Size | Field                                              |
+ * |--------|------|----------------------------------------------------|
+ * | 0      | 4    | magic, "VXLB"                                      |
+ * | 4      | 4    | block number (uint32)                              |
+ * | 8      | 1    | number of records                                  |
+ * | 9      | 3    | reserved, 0                                        |
+ * | 12     | 4    | CRC-32 of the block, see below                     |
+ * | 16     | ...  | records                                            |
+ *
+ * and each record is:
+ *
+ * | Size  | Field                                              |
+ * |-------|----------------------------------------------------|
+ * | 8     | timestamp, unix seconds (int64)                    |
+ * | 4     | active bitmask, bit i is sensor i                  |
+ * | 4 * n | sensor values, fixed point x100 (int32)            |
+ *
+ * The CRC of a data block is computed with its CRC field at 0, starting from
+ * the file ID instead of 0. Segments are preallocated, so the space after the
+ * last block may hold stale blocks of a deleted segment: they fail the CRC
+ * check. Unused bytes are 0. The time index file is a sequence of
+ * SD_LOG_INDEX_ENTRY_SIZE entries, one every `index interval` blocks:
+ *
+ * | Offset | Size | Field                                              |
+ * |--------|------|----------------------------------------------------|
+ * | 0      | 8    | timestamp of the first record of the block (int64) |
+ * | 8      | 4    | block number (uint32)                              |
+ * | 12     | 4    | CRC-32 of the first 12 bytes                       |
+ *
+ * Records read back from the log are streamed over MQTT in chunks, each
+ * holding a whole number of records after a SD_LOG_CHUNK_HEADER_SIZE header:
+ *
+ * | Offset | Size | Field                                              |
+ * |--------|------|----------------------------------------------------|
+ * | 0      | 4    | magic, "VXLC"                                      |
+ * | 4      | 1    | version (SD_LOG_VERSION)                           |
+ * | 5      | 1    | flags, SD_LOG_CHUNK_LAST and SD_LOG_CHUNK_ABORTED  |
+ * | 6      | 1    | number of sensors per record                       |
+ * | 7      | 1    | number of records                                  |
+ * | 8      | 4    | request ID, the correlation ID of the request      |
+ * | 12     | 4    | sequence number, 0 for the first chunk of a range  |
+ * | 16     | ...  | records, as in a data block                        |
+ *
+ * Values are rounded to the nearest hundredth, as printed by the CSV log.
+ * The module has no RTOS dependency so the host exporter
+ * (test/tools/sd_log_export.cpp) is built from the same code.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernel/error/error_num.h"
+
+#include "app/sensor_manager/sensor_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SD_LOG_VERSION 2                ///< Layout version written in the file header.
+#define SD_LOG_BLOCK_SIZE 512           ///< Size in bytes of a block, one SD sector.
+#define SD_LOG_BLOCK_HEADER_SIZE 16     ///< Size in bytes of the header of a block.
+#define SD_LOG_RECORD_SIZE (12 + (4 * NUM_OF_SENSORS))  ///< Size in bytes of an encoded record.
+#define SD_LOG_RECORDS_PER_BLOCK ((SD_LOG_BLOCK_SIZE - SD_LOG_BLOCK_HEADER_SIZE) / SD_LOG_RECORD_SIZE)  ///< Records in a full block.
+#define SD_LOG_INDEX_ENTRY_SIZE 16      ///< Size in bytes of a time index entry.
+#define SD_LOG_VALUE_SCALE 100          ///< Fixed-point scale of sensor values.
+#define SD_LOG_VALUE_NAN INT32_MIN      ///< Stored value of a NaN reading; other values saturate at +-INT32_MAX.
+#define SD_LOG_CHUNK_HEADER_SIZE 16     ///< Size in bytes of the header of a history chunk.
+#define SD_LOG_CHUNK_LAST 0x01          ///< Chunk flag: last chunk of the stream.
+#define SD_LOG_CHUNK_ABORTED 0x02       ///< Chunk flag: the stream ended early, on a card or read error.
+#define SD_LOG_CHUNK_RECORDS(size) (((size) - SD_LOG_CHUNK_HEADER_SIZE) / SD_LOG_RECORD_SIZE)  ///< Records in a full chunk of `size` bytes.
+
+/**
+ * @brief One decoded log record.
+ */
+typedef struct sd_log_record_s {
+    int64_t timestamp;               ///< Unix seconds.
+    uint32_t active_mask;            ///< Bit i set when sensor i is active.
+    int32_t values[NUM_OF_SENSORS];  ///< Sensor values, fixed point x SD_LOG_VALUE_SCALE, or SD_LOG_VALUE_NAN.
+} sd_log_record_st;
+
+/**
+ * @brief Decoded log file header.
+ */
+typedef struct sd_log_header_s {
+    uint32_t file_id;                      ///< Seed of the data block CRCs.
+    uint8_t num_of_sensors;                ///< Sensors per record.
+    uint16_t index_interval;               ///< Blocks between time index entries.
+    uint8_t sensor_types[NUM_OF_SENSORS];  ///< sensor_type_et of each sensor.
+} sd_log_header_st;
+
+/**
+ * @brief Decoded history chunk header.
+ */
+typedef struct sd_log_chunk_header_s {
+    uint32_t request_id;     ///< Correlation ID of the request.
+    uint32_t sequence;       ///< Position of the chunk in the stream of the range.
+    uint8_t flags;           ///< SD_LOG_CHUNK_LAST, SD_LOG_CHUNK_ABORTED.
+    uint8_t num_of_sensors;  ///< Sensors per record.
+    uint8_t num_of_records;  ///< Records in the chunk.
+} sd_log_chunk_header_st;
+
+/**
+ * @brief Updates a CRC-32 (IEEE 802.3, as zlib crc32()) with more data.
+ *
+ * @param crc  CRC of the preceding data, 0 to start.
+ * @param data Data to add.
+ * @param size Size of the data in bytes.
+ * @return Updated CRC.
+ */
+uint32_t sd_log_crc32(uint32_t crc, const uint8_t *data, size_t size);
+
+/**
+ * @brief Builds a record from the readings of a device report.
+ *
+ * Values are rounded to the nearest hundredth. Values beyond the fixed-point
+ * range, infinities included, saturate at +-INT32_MAX; NaN is stored as
+ * SD_LOG_VALUE_NAN.
+ *
+ * @param record         Record to fill.
+ * @param timestamp      Report timestamp, unix seconds.
+ * @param sensors        Sensor readings.
+ * @param num_of_sensors Number of readings, at most NUM_OF_SENSORS.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if record or sensors is null
+ *         - KERNEL_ERROR_INVALID_SIZE if there are more readings than NUM_OF_SENSORS
+ */
+kernel_error_st sd_log_record_from_report(sd_log_record_st *record,
+                                          int64_t timestamp,
+                                          const sensor_report_st *sensors,
+                                          uint8_t num_of_sensors);
+
+/**
+ * @brief Converts a stored value back to a sensor reading.
+ *
+ * @param value Fixed-point value of a record.
+ * @return The reading, NAN for SD_LOG_VALUE_NAN.
+ */
+float sd_log_value_decode(int32_t value);
+
+/**
+ * @brief Encodes the file header block.
+ *
+ * @param block  Output block of SD_LOG_BLOCK_SIZE bytes.
+ * @param header Header to encode.
+ */
+void sd_log_header_encode(uint8_t *block, const sd_log_header_st *header);
+
+/**
+ * @brief Decodes and checks the file header block.
+ *
+ * @param block  Block of SD_LOG_BLOCK_SIZE bytes.
+ * @param header Decoded header.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if block or header is null
+ *         - KERNEL_ERROR_FORMAT if the block is not a file header
+ *         - KERNEL_ERROR_CRC_MISMATCH if the CRC is wrong
+ *         - KERNEL_ERROR_UNSUPPORTED_TYPE if the version or layout differs from this firmware
+ */
+kernel_error_st sd_log_header_decode(const uint8_t *block, sd_log_header_st *header);
+
+/**
+ * @brief Starts an empty data block.
+ *
+ * @param block        Output block of SD_LOG_BLOCK_SIZE bytes.
+ * @param block_number Position of the block in the file.
+ */
+void sd_log_block_begin(uint8_t *block, uint32_t block_number);
+
+/**
+ * @brief Appends a record to a data block.
+ *
+ * @param block  Block started with sd_log_block_begin().
+ * @param record Record to append.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if block or record is null
+ *         - KERNEL_ERROR_BUFFER_TOO_SHORT if the block is full (nothing is written)
+ */
+kernel_error_st sd_log_block_add(uint8_t *block, const sd_log_record_st *record);
+
+/**
+ * @brief Number of records in a data block.
+ */
+uint8_t sd_log_block_count(const uint8_t *block);
+
+/**
+ * @brief Writes the CRC of a data block. Must be called before the block is stored.
+ *
+ * @param block   Data block.
+ * @param file_id File ID of the segment holding the block.
+ */
+void sd_log_block_seal(uint8_t *block, uint32_t file_id);
+
+/**
+ * @brief Checks a stored data block.
+ *
+ * @param block        Block of SD_LOG_BLOCK_SIZE bytes.
+ * @param file_id      File ID of the segment holding the block.
+ * @param block_number Decoded block number, may be NULL.
+ * @param count        Decoded number of records, may be NULL.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if block is null
+ *         - KERNEL_ERROR_FORMAT if the magic is wrong or the count exceeds a block
+ *         - KERNEL_ERROR_CRC_MISMATCH if the CRC is wrong, also for a block of another segment
+ */
+kernel_error_st sd_log_block_check(const uint8_t *block, uint32_t file_id, uint32_t *block_number, uint8_t *count);
+
+/**
+ * @brief Decodes one record of a checked data block.
+ *
+ * @param block  Block checked with sd_log_block_check().
+ * @param index  Record index, below the block count.
+ * @param record Decoded record.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if block or record is null
+ *         - KERNEL_ERROR_INVALID_INDEX if index is not below the block count
+ */
+kernel_error_st sd_log_block_record(const uint8_t *block, uint8_t index, sd_log_record_st *record);
+
+/**
+ * @brief Encodes a time index entry.
+ *
+ * @param entry        Output of SD_LOG_INDEX_ENTRY_SIZE bytes.
+ * @param timestamp    Timestamp of the first record of the block.
+ * @param block_number Block the entry points to.
+ */
+void sd_log_index_encode(uint8_t *entry, int64_t timestamp, uint32_t block_number);
+
+/**
+ * @brief Decodes and checks a time index entry.
+ *
+ * @param entry        Entry of SD_LOG_INDEX_ENTRY_SIZE bytes.
+ * @param timestamp    Decoded timestamp.
+ * @param block_number Decoded block number.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if an argument is null
+ *         - KERNEL_ERROR_CRC_MISMATCH if the CRC is wrong
+ */
+kernel_error_st sd_log_index_decode(const uint8_t *entry, int64_t *timestamp, uint32_t *block_number);
+
+/**
+ * @brief Starts an empty history chunk.
+ *
+ * @param chunk      Output buffer, at least SD_LOG_CHUNK_HEADER_SIZE bytes.
+ * @param request_id Correlation ID of the request.
+ * @param sequence   Position of the chunk in the stream.
+ */
+void sd_log_chunk_begin(uint8_t *chunk, uint32_t request_id, uint32_t sequence);
+
+/**
+ * @brief Appends a record to a history chunk.
+ *
+ * @param chunk  Chunk started with sd_log_chunk_begin().
+ * @param size   Size of the chunk buffer in bytes.
+ * @param record Record to append.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if chunk or record is null
+ *         - KERNEL_ERROR_BUFFER_TOO_SHORT if the chunk is full (nothing is written)
+ */
+kernel_error_st sd_log_chunk_add(uint8_t *chunk, size_t size, const sd_log_record_st *record);
+
+/**
+ * @brief Number of records in a history chunk.
+ */
+uint8_t sd_log_chunk_count(const uint8_t *chunk);
+
+/**
+ * @brief Sets the flags of a history chunk.
+ *
+ * @param chunk Chunk started with sd_log_chunk_begin().
+ * @param flags SD_LOG_CHUNK_LAST, SD_LOG_CHUNK_ABORTED or 0.
+ * @return Encoded chunk length in bytes.
+ */
+size_t sd_log_chunk_end(uint8_t *chunk, uint8_t flags);
+
+/**
+ * @brief Decodes and checks the header of a received history chunk.
+ *
+ * @param chunk  Received chunk.
+ * @param length Length of the chunk in bytes.
+ * @param header Decoded header.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if chunk or header is null
+ *         - KERNEL_ERROR_FORMAT if the data is not a history chunk
+ *         - KERNEL_ERROR_UNSUPPORTED_TYPE if the version or layout differs from this firmware
+ *         - KERNEL_ERROR_INVALID_SIZE if the length does not match the number of records
+ */
+kernel_error_st sd_log_chunk_decode(const uint8_t *chunk, size_t length, sd_log_chunk_header_st *header);
+
+/**
+ * @brief Decodes one record of a checked history chunk.
+ *
+ * @param chunk  Chunk checked with sd_log_chunk_decode().
+ * @param index  Record index, below the chunk count.
+ * @param record Decoded record.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if chunk or record is null
+ *         - KERNEL_ERROR_INVALID_INDEX if index is not below the chunk count
+ */
+kernel_error_st sd_log_chunk_record(const uint8_t *chunk, uint8_t index, sd_log_record_st *record);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,429 @@
+#include "sd_log_history.h"
+
+#if SD_CARD_LOG_BINARY
+
+#include <sys/stat.h>
+
+#include "kernel/logger/logger.h"
+
+#include "app/app_tasks_config.h"
+
+#define HISTORY_CHUNK_RECORDS ((uint32_t)SD_LOG_CHUNK_RECORDS(SD_CARD_HISTORY_CHUNK_SIZE)) /**< Records in a full history chunk */
+
+_Static_assert(SD_CARD_HISTORY_CHUNK_SIZE <= MQTT_MAXIMUM_PAYLOAD_LENGTH, "A history chunk must fit in the MQTT payload buffer");
+_Static_assert((HISTORY_CHUNK_RECORDS >= 1) && (HISTORY_CHUNK_RECORDS <= UINT8_MAX), "A history chunk must hold 1 to 255 records");
+
+static const char* TAG                             = "SD Log History";    /**< Logger tag */
+static const TickType_t SD_CARD_HISTORY_RETRY_WAIT = pdMS_TO_TICKS(100);  /**< Wait before queueing a history chunk again when the transport is full */
+
+/**
+ * @brief Position and state of the history stream being sent.
+ */
+typedef struct history_stream_s {
+    bool active;                         /**< A stream is in progress */
+    bool chunk_ready;                    /**< history_chunk is complete and waits for room in the history transport */
+    sd_card_history_request_st request;  /**< Request being served */
+    uint64_t skip;                       /**< Records of the range still to pass over to reach the requested chunk */
+    uint32_t sequence;                   /**< Sequence number of history_chunk */
+    uint32_t segment;                    /**< Segment being read */
+    uint32_t last_segment;               /**< Last segment of the stream, the open one when the request arrived */
+    uint32_t file_id;                    /**< File ID of the segment being read */
+    uint32_t next_block;                 /**< Next block to read, 0 once the data of the segment is read */
+    uint8_t block_count;                 /**< Records of the block in history_block */
+    uint8_t record_index;                /**< Next record of history_block to return */
+    uint8_t flags;                       /**< Chunk flags of history_chunk once ready */
+    size_t chunk_length;                 /**< Length of history_chunk once ready */
+    TickType_t ready_at;                 /**< Tick at which history_chunk became ready */
+} history_stream_st;
+
+static history_stream_st history                         = {0};  /**< History stream, inactive when no request is served */
+static FILE* history_file                                = NULL; /**< Segment read by the stream when it is not the open one */
+static uint8_t history_block[SD_LOG_BLOCK_SIZE]          = {0};  /**< Log block being streamed */
+static uint8_t history_chunk[SD_CARD_HISTORY_CHUNK_SIZE] = {0};  /**< History chunk being filled or queued */
+
+void sd_log_history_close_file(void) {
+    if (history_file != NULL) {
+        fclose(history_file);
+        history_file = NULL;
+    }
+}
+
+/**
+ * @brief File to read the segment of the history stream from.
+ *
+ * The open segment is read through the log file itself, as FATFS gives no
+ * guarantee for a second handle on a file being written. Any other segment
+ * gets its own read-only handle, opened when first needed, so a segment
+ * closed by a rotation keeps being read.
+ *
+ * @param log Open segment of the log.
+ * @return The file, or NULL if the card is not mounted or the segment cannot be opened
+ */
+static FILE* history_segment_file(const sd_log_segment_st* log) {
+    if (log->file == NULL) {
+        return NULL;
+    }
+
+    if (history.segment == log->number) {
+        sd_log_history_close_file();
+        return log->file;
+    }
+
+    char path[SD_LOG_SEGMENT_PATH_SIZE];
+    if ((history_file == NULL) && (sd_log_segment_path(log->directory, path, history.segment, "bin") == KERNEL_SUCCESS)) {
+        history_file = fopen(path, "rb");
+        if (history_file != NULL) {
+            setvbuf(history_file, NULL, _IONBF, 0);
+        }
+    }
+
+    return history_file;
+}
+
+/**
+ * @brief Position the history stream at the start of a segment.
+ *
+ * Reads the file header of the segment for its file ID. A segment that is
+ * missing, torn or written with another record layout has no readable
+ * records: the stream then moves past it. So does the open segment before
+ * its first report, as its header is not on the card yet.
+ *
+ * @param log    Open segment of the log.
+ * @param number Segment number.
+ * @return true if the records of the segment can be read
+ */
+static bool open_history_segment(const sd_log_segment_st* log, uint32_t number) {
+    sd_log_history_close_file();
+
+    history.segment      = number;
+    history.next_block   = 0;
+    history.block_count  = 0;
+    history.record_index = 0;
+
+    FILE* segment = history_segment_file(log);
+    if (segment == NULL) {
+        return false;
+    }
+
+    sd_log_header_st header;
+    if ((fseek(segment, 0, SEEK_SET) != 0) || (fread(history_block, 1, sizeof(history_block), segment) != sizeof(history_block)) ||
+        (sd_log_header_decode(history_block, &header) != KERNEL_SUCCESS)) {
+        return false;
+    }
+
+    history.file_id    = header.file_id;
+    history.next_block = 1;
+
+    return true;
+}
+
+/**
+ * @brief Timestamp of the first record of a segment.
+ *
+ * Leaves the history stream at block 1 of the segment.
+ *
+ * @param log       Open segment of the log.
+ * @param number    Segment number.
+ * @param timestamp First timestamp of the segment.
+ * @return true if the segment holds at least one readable record
+ */
+static bool history_segment_start(const sd_log_segment_st* log, uint32_t number, int64_t* timestamp) {
+    uint8_t count = 0;
+    sd_log_record_st record;
+
+    if (!open_history_segment(log, number) ||
+        !sd_log_segment_read_block(history_segment_file(log), history.file_id, history_block, 1, &count) ||
+        (sd_log_block_record(history_block, 0, &record) != KERNEL_SUCCESS)) {
+        return false;
+    }
+
+    *timestamp = record.timestamp;
+
+    return true;
+}
+
+/**
+ * @brief Find the segment holding the start of the requested range.
+ *
+ * Binary search for the last segment whose first record is not after
+ * `from`. Segments without a readable record count as after it, which
+ * only makes the stream start earlier.
+ *
+ * @param log    Open segment of the log.
+ * @param oldest Lowest segment number on the card.
+ * @param last   Highest segment number to consider.
+ * @return The first segment to read
+ */
+static uint32_t find_history_segment(const sd_log_segment_st* log, uint32_t oldest, uint32_t last) {
+    uint32_t low  = oldest;
+    uint32_t high = last;
+
+    while (low < high) {
+        uint32_t middle   = low + ((high - low + 1) / 2);
+        int64_t timestamp = 0;
+        if (history_segment_start(log, middle, &timestamp) && (timestamp <= history.request.range.from)) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    return low;
+}
+
+/**
+ * @brief Find the first block of the history segment that may hold the range.
+ *
+ * Binary search over the time index for the last entry not after `from`.
+ * Without an index, or with entries that cannot be read, the segment is
+ * read from its first block.
+ *
+ * @param log Open segment of the log.
+ * @return The block to start reading from
+ */
+static uint32_t find_history_block(const sd_log_segment_st* log) {
+    char path[SD_LOG_SEGMENT_PATH_SIZE];
+    uint32_t start_block = 1;
+
+    if (sd_log_segment_path(log->directory, path, history.segment, "idx") != KERNEL_SUCCESS) {
+        return start_block;
+    }
+
+    /* A separate read-only handle: the index of the open segment is being appended to */
+    FILE* index = fopen(path, "rb");
+    if (index == NULL) {
+        return start_block;
+    }
+
+    struct stat index_stat;
+    size_t entries = (fstat(fileno(index), &index_stat) == 0) ? ((size_t)index_stat.st_size / SD_LOG_INDEX_ENTRY_SIZE) : 0;
+    uint8_t entry[SD_LOG_INDEX_ENTRY_SIZE];
+
+    size_t low  = 0;
+    size_t high = entries;
+    while (low < high) {
+        size_t middle         = low + ((high - low) / 2);
+        int64_t timestamp     = 0;
+        uint32_t block_number = 0;
+
+        if ((fseek(index, (long)(middle * SD_LOG_INDEX_ENTRY_SIZE), SEEK_SET) == 0) &&
+            (fread(entry, 1, sizeof(entry), index) == sizeof(entry)) &&
+            (sd_log_index_decode(entry, &timestamp, &block_number) == KERNEL_SUCCESS) &&
+            (timestamp <= history.request.range.from) && (block_number >= 1) && (block_number < SD_LOG_SEGMENT_BLOCKS)) {
+            start_block = block_number;
+            low         = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    fclose(index);
+
+    return start_block;
+}
+
+/**
+ * @brief Result of reading the next record of the history stream.
+ */
+typedef enum history_read_e {
+    HISTORY_READ_RECORD,  /**< A record was read */
+    HISTORY_READ_END,     /**< Every segment of the stream was read */
+    HISTORY_READ_YIELD,   /**< SD_CARD_HISTORY_BLOCKS_PER_STEP blocks were read, continue on the next step */
+} history_read_et;
+
+/**
+ * @brief Read the next record of the history stream.
+ *
+ * Blocks are read in order until the first one that is not a valid block of
+ * the segment, or after a block that is not full: that is where the data of
+ * the segment ends. The stream then moves to the next segment.
+ *
+ * @param log         Open segment of the log.
+ * @param record      Record read.
+ * @param blocks_read Blocks read during this step, updated.
+ * @return history_read_et
+ */
+static history_read_et history_next_record(const sd_log_segment_st* log, sd_log_record_st* record, uint32_t* blocks_read) {
+    while (1) {
+        if (history.record_index < history.block_count) {
+            sd_log_block_record(history_block, history.record_index++, record);
+            return HISTORY_READ_RECORD;
+        }
+
+        if (*blocks_read >= SD_CARD_HISTORY_BLOCKS_PER_STEP) {
+            return HISTORY_READ_YIELD;
+        }
+        (*blocks_read)++;
+
+        if (history.next_block == 0) {
+            if (history.segment >= history.last_segment) {
+                return HISTORY_READ_END;
+            }
+
+            open_history_segment(log, history.segment + 1);
+            continue;
+        }
+
+        uint8_t count = 0;
+        FILE* segment = history_segment_file(log);
+        if ((segment == NULL) || !sd_log_segment_read_block(segment, history.file_id, history_block, history.next_block, &count)) {
+            history.next_block = 0;
+            continue;
+        }
+
+        history.block_count  = count;
+        history.record_index = 0;
+        history.next_block   = ((count == SD_LOG_RECORDS_PER_BLOCK) && ((history.next_block + 1) < SD_LOG_SEGMENT_BLOCKS))
+                                   ? (history.next_block + 1)
+                                   : 0;
+    }
+}
+
+/**
+ * @brief End the history stream without sending anything more.
+ */
+static void stop_history(void) {
+    sd_log_history_close_file();
+    history.active      = false;
+    history.chunk_ready = false;
+}
+
+/**
+ * @brief Queue the ready history chunk for the publisher.
+ *
+ * When the history transport is full, the chunk is kept and queued again on
+ * a later step; a stream that could not queue it for SD_CARD_HISTORY_STALL_MS
+ * is aborted, and may be resumed from the chunk's sequence number. After the
+ * last chunk the stream ends, otherwise the next chunk is started.
+ */
+static void send_history_chunk(void) {
+    if (queue_manager_send(HISTORY_CHUNK_QUEUE_ID, history_chunk, history.chunk_length, 0) != KERNEL_SUCCESS) {
+        if ((xTaskGetTickCount() - history.ready_at) >= pdMS_TO_TICKS(SD_CARD_HISTORY_STALL_MS)) {
+            logger_print(WARN, TAG, "History request %lu stalled at chunk %lu, aborted", (unsigned long)history.request.request_id,
+                         (unsigned long)history.sequence);
+            stop_history();
+        }
+        return;
+    }
+
+    history.chunk_ready = false;
+
+    if (history.flags & SD_LOG_CHUNK_LAST) {
+        logger_print(INFO, TAG, "History request %lu done, %lu chunks%s", (unsigned long)history.request.request_id,
+                     (unsigned long)(history.sequence + 1), (history.flags & SD_LOG_CHUNK_ABORTED) ? ", aborted" : "");
+        stop_history();
+        return;
+    }
+
+    history.sequence++;
+    sd_log_chunk_begin(history_chunk, history.request.request_id, history.sequence);
+}
+
+/**
+ * @brief Complete the history chunk being filled and try to queue it.
+ *
+ * @param flags SD_LOG_CHUNK_LAST and SD_LOG_CHUNK_ABORTED, or 0 for a full chunk.
+ */
+static void finish_history_chunk(uint8_t flags) {
+    if (flags & SD_LOG_CHUNK_LAST) {
+        sd_log_history_close_file();
+    }
+
+    history.flags        = flags;
+    history.chunk_length = sd_log_chunk_end(history_chunk, flags);
+    history.chunk_ready  = true;
+    history.ready_at     = xTaskGetTickCount();
+
+    send_history_chunk();
+}
+
+void sd_log_history_start(const sd_card_history_request_st* request, const sd_log_segment_st* log) {
+    stop_history();
+
+    history.active   = true;
+    history.request  = *request;
+    history.sequence = (uint32_t)request->range.offset;
+    history.skip     = (uint64_t)history.sequence * HISTORY_CHUNK_RECORDS;
+    sd_log_chunk_begin(history_chunk, request->request_id, history.sequence);
+
+    logger_print(INFO, TAG, "History request %lu: %lld to %lld from chunk %lu", (unsigned long)request->request_id,
+                 (long long)request->range.from, (long long)request->range.to, (unsigned long)history.sequence);
+
+    if (log->file == NULL) {
+        finish_history_chunk(SD_LOG_CHUNK_LAST | SD_LOG_CHUNK_ABORTED);
+        return;
+    }
+
+    uint32_t oldest = 0;
+    uint32_t newest = 0;
+    sd_log_segment_find(log->directory, &oldest, &newest);
+
+    if ((request->range.from > request->range.to) || (oldest == 0)) {
+        finish_history_chunk(SD_LOG_CHUNK_LAST);
+        return;
+    }
+
+    history.last_segment = (newest > log->number) ? newest : log->number;
+
+    if (open_history_segment(log, find_history_segment(log, oldest, history.last_segment))) {
+        history.next_block = find_history_block(log);
+    }
+}
+
+void sd_log_history_step(const sd_log_segment_st* log) {
+    if (!history.active) {
+        return;
+    }
+
+    if (history.chunk_ready) {
+        send_history_chunk();
+        return;
+    }
+
+    if (log->file == NULL) {
+        finish_history_chunk(SD_LOG_CHUNK_LAST | SD_LOG_CHUNK_ABORTED);
+        return;
+    }
+
+    uint32_t blocks_read = 0;
+    sd_log_record_st record;
+
+    while (sd_log_chunk_count(history_chunk) < HISTORY_CHUNK_RECORDS) {
+        history_read_et result = history_next_record(log, &record, &blocks_read);
+        if (result == HISTORY_READ_YIELD) {
+            return;
+        }
+
+        if ((result == HISTORY_READ_END) || (record.timestamp > history.request.range.to)) {
+            finish_history_chunk(SD_LOG_CHUNK_LAST);
+            return;
+        }
+
+        if (record.timestamp < history.request.range.from) {
+            continue;
+        }
+
+        if (history.skip > 0) {
+            history.skip--;
+            continue;
+        }
+
+        sd_log_chunk_add(history_chunk, sizeof(history_chunk), &record);
+    }
+
+    finish_history_chunk(0);
+}
+
+TickType_t sd_log_history_time_left(void) {
+    if (!history.active) {
+        return portMAX_DELAY;
+    }
+
+    return history.chunk_ready ? SD_CARD_HISTORY_RETRY_WAIT : 0;
+}
+
+uint32_t sd_log_history_first_segment(void) {
+    return history.active ? history.segment : UINT32_MAX;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * @file sd_log_history.h
+ * @brief History stream of the binary SD card log.
+ *
+ * Streams the records of a time range to the history topic, in chunks of
+ * SD_CARD_HISTORY_CHUNK_SIZE bytes (sd_log_codec.h) numbered from 0. The
+ * first segment and block are found by binary searches over the segments
+ * and the time index, then the log is read at most
+ * SD_CARD_HISTORY_BLOCKS_PER_STEP blocks per step. A chunk is only encoded
+ * when the previous one was queued, so at most SD_CARD_HISTORY_QUEUED_CHUNKS
+ * wait for the publisher and the reading follows the pace of the MQTT task.
+ *
+ * Only the SD card task uses the stream; it passes the open segment of the
+ * log (sd_log_segments.h) to every call that reads it.
+ */
+
+#include <stdint.h>
+
+#include "kernel/inter_task_communication/inter_task_communication.h"
+
+#include "app/sd_card_manager/sd_card_manager.h"
+#include "app/sd_card_manager/sd_log_segments.h"
+
+/**
+ * @brief Starts serving a history request, replacing the stream in progress.
+ *
+ * The stream ends with the segment open at that time, so the caller writes
+ * its pending reports first. Chunks before the requested offset are read but
+ * not sent.
+ *
+ * @param request Request to serve.
+ * @param log     Open segment of the log; no segment open aborts the stream.
+ */
+void sd_log_history_start(const sd_card_history_request_st* request, const sd_log_segment_st* log);
+
+/**
+ * @brief Advances the history stream by at most one chunk.
+ *
+ * Reads at most SD_CARD_HISTORY_BLOCKS_PER_STEP blocks, so the reports
+ * waiting in the SD card queue are written between two steps. The records
+ * are assumed to be in time order, as for the time index, so the stream ends
+ * at the first record after the range. The stream is aborted when no segment
+ * is open, as the card was dismounted.
+ *
+ * @param log Open segment of the log.
+ */
+void sd_log_history_step(const sd_log_segment_st* log);
+
+/**
+ * @brief Ticks until the history stream needs a step again.
+ *
+ * @return 0 while chunks can be produced, a short retry wait while a chunk
+ *         waits for room, portMAX_DELAY when no stream is in progress.
+ */
+TickType_t sd_log_history_time_left(void);
+
+/**
+ * @brief Lowest segment the history stream may still read.
+ *
+ * @return The segment number, UINT32_MAX when no stream is in progress
+ */
+uint32_t sd_log_history_first_segment(void);
+
+/**
+ * @brief Closes the file the stream holds on a segment that is not the open one.
+ *
+ * Called before the card is dismounted; the next step aborts the stream.
+ */
+void sd_log_history_close_file(void);
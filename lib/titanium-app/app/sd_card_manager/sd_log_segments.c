@@ -0,0 +1,331 @@
+#include "sd_log_segments.h"
+
+#if SD_CARD_LOG_BINARY
+
+#include "esp_vfs_fat.h"
+#include <dirent.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <sys/unistd.h>
+
+#include "esp_random.h"
+
+#include "kernel/logger/logger.h"
+
+_Static_assert(SD_CARD_LOG_MIN_FREE_BYTES > SD_CARD_LOG_SEGMENT_SIZE, "SD_CARD_LOG_MIN_FREE_BYTES must leave room for a new segment");
+_Static_assert((SD_CARD_LOG_SEGMENT_SIZE % SD_LOG_BLOCK_SIZE) == 0, "SD_CARD_LOG_SEGMENT_SIZE must hold whole log blocks");
+
+static const char* TAG = "SD Log Segments"; /**< Logger tag */
+
+int64_t sd_log_segment_window(int64_t timestamp) {
+    return timestamp / SD_CARD_LOG_SEGMENT_SECONDS;
+}
+
+kernel_error_st sd_log_segment_path(const char* directory, char* path, uint32_t number, const char* extension) {
+    int size = snprintf(path, SD_LOG_SEGMENT_PATH_SIZE, "%s/" SD_LOG_SEGMENT_NAME_PREFIX "%0*lu.%s", directory,
+                        SD_LOG_SEGMENT_NUMBER_DIGITS, (unsigned long)number, extension);
+
+    return ((size < 0) || (size >= SD_LOG_SEGMENT_PATH_SIZE)) ? KERNEL_ERROR_BUFFER_TOO_SHORT : KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Parse the number of a segment log file name.
+ *
+ * Names are compared without case, as FAT short names are upper case.
+ *
+ * @return true if `name` is a segment log file, with its number in `number`
+ */
+static bool parse_segment_name(const char* name, uint32_t* number) {
+    const size_t prefix_length = strlen(SD_LOG_SEGMENT_NAME_PREFIX);
+
+    if ((strlen(name) != (prefix_length + SD_LOG_SEGMENT_NUMBER_DIGITS + 4)) ||
+        (strncasecmp(name, SD_LOG_SEGMENT_NAME_PREFIX, prefix_length) != 0) ||
+        (strcasecmp(name + prefix_length + SD_LOG_SEGMENT_NUMBER_DIGITS, ".bin") != 0)) {
+        return false;
+    }
+
+    uint32_t value = 0;
+    for (size_t i = 0; i < SD_LOG_SEGMENT_NUMBER_DIGITS; i++) {
+        char digit = name[prefix_length + i];
+        if ((digit < '0') || (digit > '9')) {
+            return false;
+        }
+        value = (value * 10) + (uint32_t)(digit - '0');
+    }
+
+    *number = value;
+
+    return value != 0;
+}
+
+void sd_log_segment_find(const char* directory, uint32_t* oldest, uint32_t* newest) {
+    *oldest = 0;
+    *newest = 0;
+
+    DIR* dir = opendir(directory);
+    if (dir == NULL) {
+        return;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        uint32_t number = 0;
+        if (!parse_segment_name(entry->d_name, &number)) {
+            continue;
+        }
+
+        if ((*oldest == 0) || (number < *oldest)) {
+            *oldest = number;
+        }
+        if (number > *newest) {
+            *newest = number;
+        }
+    }
+
+    closedir(dir);
+}
+
+bool sd_log_segment_read_block(FILE* segment, uint32_t segment_file_id, uint8_t* block, uint32_t block_number, uint8_t* count) {
+    uint32_t stored_number = 0;
+
+    return (fseek(segment, (long)block_number * SD_LOG_BLOCK_SIZE, SEEK_SET) == 0) &&
+           (fread(block, 1, SD_LOG_BLOCK_SIZE, segment) == SD_LOG_BLOCK_SIZE) &&
+           (sd_log_block_check(block, segment_file_id, &stored_number, count) == KERNEL_SUCCESS) &&
+           (stored_number == block_number);
+}
+
+/**
+ * @brief Delete the oldest segments while the card has less than SD_CARD_LOG_MIN_FREE_BYTES free.
+ *
+ * The open segment and the segments from `keep_from` on are never deleted.
+ */
+static void prune_segments(sd_log_segment_st* segment, uint32_t keep_from) {
+    char path[SD_LOG_SEGMENT_PATH_SIZE];
+
+    while ((segment->oldest < segment->number) && (segment->oldest < keep_from)) {
+        uint64_t total_bytes = 0;
+        uint64_t free_bytes  = 0;
+        if ((esp_vfs_fat_info(segment->directory, &total_bytes, &free_bytes) != ESP_OK) ||
+            (free_bytes >= SD_CARD_LOG_MIN_FREE_BYTES)) {
+            return;
+        }
+
+        if (sd_log_segment_path(segment->directory, path, segment->oldest, "bin") == KERNEL_SUCCESS) {
+            remove(path);
+        }
+        if (sd_log_segment_path(segment->directory, path, segment->oldest, "idx") == KERNEL_SUCCESS) {
+            remove(path);
+        }
+
+        logger_print(INFO, TAG, "Deleted segment %lu, %llu bytes free", (unsigned long)segment->oldest, free_bytes);
+        segment->oldest++;
+    }
+}
+
+/**
+ * @brief Find the end of the data in the open segment.
+ *
+ * The segment is preallocated, so its size does not tell where the data
+ * ends: the last valid block is found by a binary search, as the valid
+ * blocks form a prefix of the segment. When the last block is not full, it
+ * becomes the block being filled again.
+ *
+ * @param segment        Open segment, with its file ID read from the header.
+ * @param segment_blocks Number of blocks in the file, header included.
+ * @param last_block     Set to the last block when it is not full.
+ * @param end            Where the data ends.
+ */
+static void resume_segment(const sd_log_segment_st* segment, uint32_t segment_blocks, uint8_t* last_block,
+                           sd_log_segment_end_st* end) {
+    static uint8_t block[SD_LOG_BLOCK_SIZE];
+    uint8_t count = 0;
+
+    end->size              = SD_LOG_BLOCK_SIZE;
+    end->next_block_number = 1;
+
+    if (!sd_log_segment_read_block(segment->file, segment->file_id, block, 1, &count)) {
+        return;
+    }
+
+    sd_log_record_st first_record;
+    if (sd_log_block_record(block, 0, &first_record) == KERNEL_SUCCESS) {
+        end->window = sd_log_segment_window(first_record.timestamp);
+    }
+
+    /* Block `low` is valid, block `high` is not */
+    uint32_t low  = 1;
+    uint32_t high = segment_blocks;
+    while ((high - low) > 1) {
+        uint32_t middle = low + ((high - low) / 2);
+        if (sd_log_segment_read_block(segment->file, segment->file_id, block, middle, &count)) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    sd_log_segment_read_block(segment->file, segment->file_id, block, low, &count);
+    end->next_block_number = low + 1;
+    end->size              = (size_t)end->next_block_number * SD_LOG_BLOCK_SIZE;
+    if (count < SD_LOG_RECORDS_PER_BLOCK) {
+        memcpy(last_block, block, SD_LOG_BLOCK_SIZE);
+        end->size -= SD_LOG_BLOCK_SIZE;
+        end->last_block_records = count;
+    }
+}
+
+/**
+ * @brief Open a segment and its time index, creating them if needed.
+ *
+ * The oldest segments are pruned first, then the segment is extended to
+ * SD_CARD_LOG_SEGMENT_SIZE. An existing segment is resumed where its data
+ * ends; one whose header is torn is started over, as none of its records can
+ * be read without it.
+ *
+ * @param number Segment number; see sd_log_segment_open_newest() for the others.
+ * @return See sd_log_segment_open_newest()
+ */
+static kernel_error_st open_segment(sd_log_segment_st* segment, uint32_t number, uint32_t keep_from, uint8_t* last_block,
+                                    sd_log_segment_end_st* end) {
+    static uint8_t block[SD_LOG_BLOCK_SIZE];
+    char index_path[SD_LOG_SEGMENT_PATH_SIZE];
+
+    memset(last_block, 0, SD_LOG_BLOCK_SIZE);
+    memset(end, 0, sizeof(*end));
+
+    if ((sd_log_segment_path(segment->directory, segment->path, number, "bin") != KERNEL_SUCCESS) ||
+        (sd_log_segment_path(segment->directory, index_path, number, "idx") != KERNEL_SUCCESS)) {
+        return KERNEL_ERROR_BUFFER_TOO_SHORT;
+    }
+
+    segment->number  = number;
+    segment->file_id = esp_random();
+
+    prune_segments(segment, keep_from);
+
+    segment->file = fopen(segment->path, "r+b");
+    if (segment->file == NULL) {
+        segment->file = fopen(segment->path, "w+b");
+    }
+    if (segment->file == NULL) {
+        segment->number = 0;
+        return KERNEL_ERROR_FAILED_TO_OPEN_FILE;
+    }
+
+    /* Blocks are already sector-aligned: hand them to FATFS without stdio re-buffering. */
+    setvbuf(segment->file, NULL, _IONBF, 0);
+
+    struct stat file_stat;
+    size_t size = (fstat(fileno(segment->file), &file_stat) == 0) ? (size_t)file_stat.st_size : 0;
+
+    sd_log_header_st header;
+    kernel_error_st err = KERNEL_ERROR_FORMAT;
+    if ((size >= SD_LOG_BLOCK_SIZE) && (fseek(segment->file, 0, SEEK_SET) == 0) &&
+        (fread(block, 1, sizeof(block), segment->file) == sizeof(block))) {
+        err = sd_log_header_decode(block, &header);
+    }
+
+    if (err == KERNEL_ERROR_UNSUPPORTED_TYPE) {
+        fclose(segment->file);
+        segment->file   = NULL;
+        segment->number = 0;
+        return err;
+    }
+
+    if (err == KERNEL_SUCCESS) {
+        segment->file_id = header.file_id;
+        resume_segment(segment, (uint32_t)(size / SD_LOG_BLOCK_SIZE), last_block, end);
+    }
+
+    if ((size < SD_CARD_LOG_SEGMENT_SIZE) &&
+        ((fseek(segment->file, SD_CARD_LOG_SEGMENT_SIZE - 1, SEEK_SET) != 0) || (fputc(0, segment->file) == EOF) ||
+         (fsync(fileno(segment->file)) < 0))) {
+        logger_print(WARN, TAG, "Failed to preallocate %s, appends will allocate clusters", segment->path);
+    }
+
+    /* The index of a segment started over is stale */
+    segment->index_file = (end->next_block_number != 0) ? fopen(index_path, "r+b") : NULL;
+    if (segment->index_file == NULL) {
+        segment->index_file = fopen(index_path, "w+b");
+    }
+    if (segment->index_file != NULL) {
+        /* Entries are appended after the last whole one, overwriting a torn entry */
+        struct stat index_stat;
+        size_t index_size = (fstat(fileno(segment->index_file), &index_stat) == 0) ? (size_t)index_stat.st_size : 0;
+        fseek(segment->index_file, (long)(index_size - (index_size % SD_LOG_INDEX_ENTRY_SIZE)), SEEK_SET);
+        setvbuf(segment->index_file, NULL, _IONBF, 0);
+    } else {
+        logger_print(WARN, TAG, "Failed to open time index, range reads will scan the log");
+    }
+
+    logger_print(INFO, TAG, "Logging to %s from block %lu", segment->path, (unsigned long)end->next_block_number);
+
+    return KERNEL_SUCCESS;
+}
+
+kernel_error_st sd_log_segment_open_newest(sd_log_segment_st* segment, uint32_t keep_from, uint8_t* last_block,
+                                           sd_log_segment_end_st* end) {
+    uint32_t newest = 0;
+    sd_log_segment_find(segment->directory, &segment->oldest, &newest);
+    if (newest == 0) {
+        segment->oldest = 1;
+        newest          = 1;
+    }
+
+    kernel_error_st err = open_segment(segment, newest, keep_from, last_block, end);
+    if ((err == KERNEL_ERROR_UNSUPPORTED_TYPE) && (newest < SD_LOG_SEGMENT_MAX_NUMBER)) {
+        logger_print(WARN, TAG, "%s was written with another record layout, starting a new segment", segment->path);
+        err = open_segment(segment, newest + 1, keep_from, last_block, end);
+    }
+
+    return err;
+}
+
+kernel_error_st sd_log_segment_rotate(sd_log_segment_st* segment, size_t used_size, uint32_t keep_from, uint8_t* last_block,
+                                      sd_log_segment_end_st* end) {
+    if (segment->number >= SD_LOG_SEGMENT_MAX_NUMBER) {
+        logger_print(ERR, TAG, "No segment number left, the last segment is not rotated");
+        return KERNEL_ERROR_INVALID_INDEX;
+    }
+
+    if (ftruncate(fileno(segment->file), (off_t)used_size) != 0) {
+        logger_print(WARN, TAG, "Failed to shrink %s", segment->path);
+    }
+
+    uint32_t next = segment->number + 1;
+    sd_log_segment_close(segment);
+
+    return open_segment(segment, next, keep_from, last_block, end);
+}
+
+void sd_log_segment_write_index_entry(sd_log_segment_st* segment, const uint8_t* entry) {
+    if (segment->index_file == NULL) {
+        return;
+    }
+
+    if ((fwrite(entry, 1, SD_LOG_INDEX_ENTRY_SIZE, segment->index_file) != SD_LOG_INDEX_ENTRY_SIZE) ||
+        (fsync(fileno(segment->index_file)) < 0)) {
+        logger_print(WARN, TAG, "Failed to write time index entry");
+    }
+}
+
+kernel_error_st sd_log_segment_close(sd_log_segment_st* segment) {
+    kernel_error_st err = KERNEL_SUCCESS;
+
+    if (segment->index_file != NULL) {
+        fclose(segment->index_file);
+        segment->index_file = NULL;
+    }
+
+    if ((segment->file != NULL) && (fclose(segment->file) != 0)) {
+        err = KERNEL_ERROR_FAILED_TO_CLOSE_FILE;
+    }
+
+    segment->file   = NULL;
+    segment->number = 0;
+
+    return err;
+}
+
+#endif
@@ -0,0 +1,148 @@
+#pragma once
+
+/**
+ * @file sd_log_segments.h
+ * @brief Segment files of the binary SD card log.
+ *
+ * The binary log is split in numbered segments, `log<number>.bin` with the
+ * time index in `log<number>.idx`, in one directory. A segment is
+ * preallocated to SD_CARD_LOG_SEGMENT_SIZE when it is created, so appends
+ * only write into clusters that are already allocated. An existing segment
+ * is resumed where its data ends, found by a binary search as the valid
+ * blocks form a prefix of the file. Before a segment is opened, the oldest
+ * ones are deleted while the card has less than SD_CARD_LOG_MIN_FREE_BYTES
+ * free.
+ *
+ * This module only manages the files: the blocks are built and written by
+ * the SD card manager, and read back by the history stream (sd_log_history.h).
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "kernel/error/error_num.h"
+
+#include "app/app_tasks_config.h"
+#include "app/sd_card_manager/sd_log_codec.h"
+
+#define SD_LOG_SEGMENT_NAME_PREFIX "log"  ///< Segments are named log<number>.bin and log<number>.idx.
+#define SD_LOG_SEGMENT_NUMBER_DIGITS 5    ///< Digits of the segment number in the file names.
+#define SD_LOG_SEGMENT_MAX_NUMBER 99999   ///< Largest segment number, SD_LOG_SEGMENT_NUMBER_DIGITS digits.
+#define SD_LOG_SEGMENT_PATH_SIZE 128      ///< Maximum length of the full path of a segment file.
+#define SD_LOG_SEGMENT_BLOCKS ((uint32_t)(SD_CARD_LOG_SEGMENT_SIZE / SD_LOG_BLOCK_SIZE))  ///< Blocks of a segment, header included.
+
+/**
+ * @brief Open segment of the log.
+ */
+typedef struct sd_log_segment_s {
+    const char* directory;               ///< Directory of the segment files, set once by the caller.
+    FILE* file;                          ///< Log file of the segment, NULL when none is open.
+    FILE* index_file;                    ///< Time index of the segment, NULL if it could not be opened.
+    uint32_t number;                     ///< Number of the open segment, 0 when none is open.
+    uint32_t oldest;                     ///< Lowest segment number that may still be on the card.
+    uint32_t file_id;                    ///< File ID of the open segment, seeds its block CRCs.
+    char path[SD_LOG_SEGMENT_PATH_SIZE]; ///< Path of the log file, for messages.
+} sd_log_segment_st;
+
+/**
+ * @brief Where the data of a segment just opened ends, for the writer to append after it.
+ */
+typedef struct sd_log_segment_end_s {
+    size_t size;                 ///< Bytes of the whole blocks on the card, header included; 0 for a new segment.
+    uint32_t next_block_number;  ///< Number of the next block to start, 0 before the header.
+    int64_t window;              ///< Time window of the first record, 0 if the segment has none.
+    uint8_t last_block_records;  ///< Records of the block at `size` when it is not full, 0 otherwise.
+} sd_log_segment_end_st;
+
+/**
+ * @brief Time window of a record timestamp; a record of another window than
+ *        the first record of the open segment starts the next one.
+ */
+int64_t sd_log_segment_window(int64_t timestamp);
+
+/**
+ * @brief Builds the path of a segment file.
+ *
+ * @param directory Directory of the segment files.
+ * @param path      Output buffer of SD_LOG_SEGMENT_PATH_SIZE bytes.
+ * @param number    Segment number.
+ * @param extension "bin" for the log, "idx" for its time index.
+ * @return KERNEL_SUCCESS on success, KERNEL_ERROR_BUFFER_TOO_SHORT if the path does not fit
+ */
+kernel_error_st sd_log_segment_path(const char* directory, char* path, uint32_t number, const char* extension);
+
+/**
+ * @brief Finds the lowest and highest segment numbers in a directory.
+ *
+ * @param directory Directory of the segment files.
+ * @param oldest    Lowest segment number, 0 if there is none.
+ * @param newest    Highest segment number, 0 if there is none.
+ */
+void sd_log_segment_find(const char* directory, uint32_t* oldest, uint32_t* newest);
+
+/**
+ * @brief Reads a block of a segment and checks that it belongs to it.
+ *
+ * @param segment         Segment file.
+ * @param segment_file_id File ID of the segment.
+ * @param block           Output block of SD_LOG_BLOCK_SIZE bytes.
+ * @param block_number    Number of the block.
+ * @param count           Number of records in the block.
+ * @return true if the block is a valid data block of the segment
+ */
+bool sd_log_segment_read_block(FILE* segment, uint32_t segment_file_id, uint8_t* block, uint32_t block_number, uint8_t* count);
+
+/**
+ * @brief Opens the newest segment in `segment->directory`, or the first one.
+ *
+ * When the newest segment was written with another record layout, it is
+ * kept and the next one is started.
+ *
+ * @param segment    Segment to open, none may be open.
+ * @param keep_from  Lowest segment a reader still needs; it and the later ones are never deleted.
+ * @param last_block Block of SD_LOG_BLOCK_SIZE bytes, set to the last block when it is not full, zeroed otherwise.
+ * @param end        Where the data of the segment ends.
+ * @return KERNEL_SUCCESS on success;
+ *         KERNEL_ERROR_UNSUPPORTED_TYPE if the segment was written with another record layout;
+ *         KERNEL_ERROR_BUFFER_TOO_SHORT or KERNEL_ERROR_FAILED_TO_OPEN_FILE otherwise.
+ */
+kernel_error_st sd_log_segment_open_newest(sd_log_segment_st* segment, uint32_t keep_from, uint8_t* last_block,
+                                           sd_log_segment_end_st* end);
+
+/**
+ * @brief Closes the open segment and opens the next one.
+ *
+ * The closed segment is shrunk to `used_size`, giving its unused
+ * preallocated clusters back. The caller writes its pending blocks first.
+ *
+ * @param segment    Open segment.
+ * @param used_size  Bytes of the blocks the closed segment holds.
+ * @param keep_from  Lowest segment a reader still needs, see sd_log_segment_open_newest().
+ * @param last_block See sd_log_segment_open_newest().
+ * @param end        Where the data of the next segment ends.
+ * @return KERNEL_SUCCESS on success;
+ *         KERNEL_ERROR_INVALID_INDEX if no segment number is left, the open segment is then kept;
+ *         otherwise the error of sd_log_segment_open_newest(), with no segment open.
+ */
+kernel_error_st sd_log_segment_rotate(sd_log_segment_st* segment, size_t used_size, uint32_t keep_from, uint8_t* last_block,
+                                      sd_log_segment_end_st* end);
+
+/**
+ * @brief Appends an entry to the time index of the open segment.
+ *
+ * A failed entry is dropped: readers fall back to the previous entry.
+ *
+ * @param segment Open segment.
+ * @param entry   Entry of SD_LOG_INDEX_ENTRY_SIZE bytes.
+ */
+void sd_log_segment_write_index_entry(sd_log_segment_st* segment, const uint8_t* entry);
+
+/**
+ * @brief Closes the files of the open segment, if any.
+ *
+ * @param segment Segment to close.
+ * @return KERNEL_SUCCESS on success, KERNEL_ERROR_FAILED_TO_CLOSE_FILE if the log file could not be closed
+ */
+kernel_error_st sd_log_segment_close(sd_log_segment_st* segment);
@@ -148,7 +148,7 @@ static float calculate_resistance_kohm(float v_ref, float v_ntc, uint16_t sensor
 
     uint32_t resistance_ohm = (FIXED_RESISTOR * v_gain) / (1 - v_gain);
 
-    logger_print(DEBUG, TAG, "Calculated resistance %d: %d Ohm (%.3f kOhm)", sensor_index, resistance_ohm, resistance_ohm / 1000.0f);
+    LOGGER_PRINT(DEBUG, TAG, "Calculated resistance %d: %d Ohm (%.3f kOhm)", sensor_index, resistance_ohm, resistance_ohm / 1000.0f);
     return correct_resistance_kohm(resistance_ohm / 1000.0f);
 }
 
@@ -250,31 +250,31 @@ kernel_error_st temperature_sensor_read(sensor_interface_st* ctx, sensor_report_
 
     err = ctx->mux_controller->select_channel(&ctx->hw->mux_hw_config);
     if (err != KERNEL_SUCCESS) {
-        logger_print(ERR, TAG, "Failed to select MUX for sensor %d", sensor_index);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to select MUX for sensor %d", sensor_index);
         return err;
     }
     vTaskDelay(pdMS_TO_TICKS(10));
     /* First we measure the reference branch to estimate the error based on the voltage input */
     err = ctx->adc_controller->configure(&ctx->hw->adc_ref_branch);
     if (err != KERNEL_SUCCESS) {
-        logger_print(ERR, TAG, "Failed to configure reference branch ADC for sensor %d - %d", sensor_index, err);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to configure reference branch ADC for sensor %d - %d", sensor_index, err);
         return err;
     }
     err = ctx->adc_controller->read(&ctx->hw->adc_ref_branch, &reference_raw_adc);
     if (err != KERNEL_SUCCESS) {
-        logger_print(ERR, TAG, "Failed to read reference branch ADC for sensor %d - %d", sensor_index, err);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to read reference branch ADC for sensor %d - %d", sensor_index, err);
         return err;
     }
 
     /* Them we try to measure using the maximum PGA*/
     err = ctx->adc_controller->configure(&ctx->hw->adc_sensor_branch);
     if (err != KERNEL_SUCCESS) {
-        logger_print(ERR, TAG, "Failed to configure sensor branch ADC for sensor %d - %d", sensor_index, err);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to configure sensor branch ADC for sensor %d - %d", sensor_index, err);
         return err;
     }
     err = ctx->adc_controller->read(&ctx->hw->adc_sensor_branch, &sensor_raw_adc);
     if (err != KERNEL_SUCCESS) {
-        logger_print(ERR, TAG, "Failed to read sensor branch ADC for sensor %d - %d", sensor_index, err);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to read sensor branch ADC for sensor %d - %d", sensor_index, err);
         return err;
     }
 
@@ -286,26 +286,26 @@ kernel_error_st temperature_sensor_read(sensor_interface_st* ctx, sensor_report_
 
     pga_gain_et fine_pga_gain = ctx->adc_controller->get_pga_gain(voltage_sensor);
 
-    logger_print(DEBUG, TAG, "Voltage sensor: %f mV, Current PGA: %d, Fine PGA: %d", voltage_sensor, ctx->hw->adc_sensor_branch.pga_gain, fine_pga_gain);
+    LOGGER_PRINT(DEBUG, TAG, "Voltage sensor: %f mV, Current PGA: %d, Fine PGA: %d", voltage_sensor, ctx->hw->adc_sensor_branch.pga_gain, fine_pga_gain);
 
     if (fine_pga_gain != ctx->hw->adc_sensor_branch.pga_gain) {
         // ctx->hw->adc_sensor_branch.pga_gain = fine_pga_gain;
 
         err = ctx->adc_controller->configure(&ctx->hw->adc_sensor_branch);
         if (err != KERNEL_SUCCESS) {
-            logger_print(ERR, TAG, "Failed to configure sensor branch ADC for sensor %d - %d", sensor_index, err);
+            LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to configure sensor branch ADC for sensor %d - %d", sensor_index, err);
             return err;
         }
         err = ctx->adc_controller->read(&ctx->hw->adc_sensor_branch, &sensor_raw_adc);
         if (err != KERNEL_SUCCESS) {
-            logger_print(ERR, TAG, "Failed to read sensor branch ADC for sensor %d - %d", sensor_index, err);
+            LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to read sensor branch ADC for sensor %d - %d", sensor_index, err);
             return err;
         }
         pga_sensor_branch = ctx->adc_controller->get_lsb_size(ctx->hw->adc_sensor_branch.pga_gain);
         voltage_sensor    = (float)((sensor_raw_adc * pga_sensor_branch));
     }
 
-    logger_print(DEBUG, TAG,
+    LOGGER_PRINT(DEBUG, TAG,
                  "Sensor %d: Reference ADC: %d, Sensor ADC: %d, Reference Voltage: %f mV, Sensor Voltage: %f mV",
                  sensor_index, reference_raw_adc, sensor_raw_adc, voltage_reference, voltage_sensor);
 
@@ -138,7 +138,7 @@ static kernel_error_st receive_power_data(sensor_interface_st *ctx, uint8_t *res
 
     size_t len = uart_interface.uart_read_fn(UART_NUM_2, response_buffer, response_buffer_size, RECEIVE_TIMEOUT_MS);
     if (len <= 0) {
-        logger_print(ERR, TAG, "No response from slave: %d", SLAVE_ADDRESS);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "No response from slave: %d", SLAVE_ADDRESS);
         return KERNEL_ERROR_TIMEOUT;
     }
 
@@ -146,7 +146,7 @@ static kernel_error_st receive_power_data(sensor_interface_st *ctx, uint8_t *res
 
     int decode_result = decode_read_response(response_buffer, len, registers, sizeof(registers));
     if (decode_result < 0) {
-        logger_print(ERR, TAG, "Failed to decode Modbus response: %d", decode_result);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to decode Modbus response: %d", decode_result);
         return KERNEL_ERROR_FAILED_TO_DECODE_PACKET;
     }
 
@@ -253,14 +253,14 @@ kernel_error_st power_sensor_read(sensor_interface_st *ctx, sensor_report_st *se
 
     kernel_error_st err = request_power_data(ctx, buffer, sizeof(buffer));
     if (err != KERNEL_SUCCESS) {
-        logger_print(ERR, TAG, "Failed to send Modbus request - %d", sensor_index);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to send Modbus request - %d", sensor_index);
         return err;
     }
 
     err = receive_power_data(ctx, response, sizeof(response), sensor_report);
 
     if (err != KERNEL_SUCCESS) {
-        logger_print(ERR, TAG, "Failed to receive Modbus response - %d", sensor_index);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to receive Modbus response - %d", sensor_index);
         return err;
     }
 
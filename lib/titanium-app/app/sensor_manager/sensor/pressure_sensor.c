@@ -84,18 +84,18 @@ kernel_error_st pressure_sensor_read(sensor_interface_st *ctx, sensor_report_st
 
     err = ctx->mux_controller->select_channel(&ctx->hw->mux_hw_config);
     if (err != KERNEL_SUCCESS) {
-        logger_print(ERR, TAG, "Failed to select MUX for sensor %d", sensor_index);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to select MUX for sensor %d", sensor_index);
         return err;
     }
 
     err = ctx->adc_controller->configure(&ctx->hw->adc_sensor_branch);
     if (err != KERNEL_SUCCESS) {
-        logger_print(ERR, TAG, "Failed to configure sensor branch ADC for sensor %d", sensor_index);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to configure sensor branch ADC for sensor %d", sensor_index);
         return err;
     }
     err = ctx->adc_controller->read(&ctx->hw->adc_sensor_branch, &sensor_raw_adc);
     if (err != KERNEL_SUCCESS) {
-        logger_print(ERR, TAG, "Failed to read sensor branch ADC for sensor %d", sensor_index);
+        LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to read sensor branch ADC for sensor %d", sensor_index);
         return err;
     }
 
@@ -7,6 +7,7 @@
  * - Sensor interface configuration (temperature, pressure, power, etc.)
  * - Periodic acquisition of sensor data and reporting to the application queue
  * - Calibration utilities and getters for sensor parameters
+ * - Persistence of the calibration table in NVS
  *
  * The sensor manager runs in its own loop task (`sensor_manager_loop`) and
  * periodically collects sensor readings to publish them to higher-level
@@ -15,11 +16,16 @@
 
 #include "sensor_manager.h"
 
+#include <string.h>
+
+#include "esp_rom_crc.h"
+
 #include "kernel/device/device_info.h"
 #include "kernel/error/error_num.h"
 #include "kernel/hal/i2c/i2c.h"
 #include "kernel/inter_task_communication/inter_task_communication.h"
 #include "kernel/logger/logger.h"
+#include "kernel/utils/nvs_util.h"
 
 #include "app/app_extern_types.h"
 #include "app/app_tasks_config.h"
@@ -30,11 +36,35 @@
 #include "app/sensor_manager/sensor/pressure_sensor.h"
 #include "app/sensor_manager/sensor_interface/sensor_interface.h"
 
+#define CALIBRATION_NVS_NAMESPACE    "sensor"      /*!< NVS namespace of the calibration table */
+#define CALIBRATION_NVS_KEY          "calibration" /*!< NVS key of the calibration blob */
+#define CALIBRATION_BLOB_VERSION     (1)           /*!< Layout version of calibration_blob_st */
+#define CALIBRATION_SAVE_DEBOUNCE_MS (2000)        /*!< Quiet time before a changed table is committed */
+
+/**
+ * @brief Calibration table as stored in NVS.
+ *
+ * The whole table is one blob, so loading it costs one read and saving it one
+ * flash commit. A blob with another version, sensor count or a bad CRC is ignored.
+ */
+typedef struct calibration_blob_s {
+    uint16_t version;         /**< CALIBRATION_BLOB_VERSION */
+    uint16_t num_of_sensors;  /**< NUM_OF_SENSORS when the blob was written */
+    struct {
+        float offset;         /**< Offset of the sensor */
+        float gain;           /**< Conversion gain of the sensor */
+    } entries[NUM_OF_SENSORS];
+    uint32_t crc;             /**< CRC-32 of all the preceding fields */
+} calibration_blob_st;
+
 /* Global Variables */
 static const char* TAG                  = "Sensor Manager"; /*!< Tag used for logging */
 static mux_controller_st mux_controller = {0};
 static adc_controller_st adc_controller = {0};
 
+static volatile bool calibration_dirty            = false; /*!< Calibration changed since the last commit */
+static volatile TickType_t calibration_changed_at = 0;     /*!< Tick of the last calibration change */
+
 static sensor_hw_st sensor_hw[NUM_OF_CHANNEL_SENSORS] = {
     [SENSOR_CH_00] = {
         .adc_ref_branch    = {.pga_gain = PGA_2_048V, .data_rate = DR_128SPS, .adc_mux_config = ADC_CONFIG_SINGLE_ENDED_A2},
@@ -416,6 +446,96 @@ static sensor_interface_st sensor_interface[NUM_OF_SENSORS] = {
     },
 };
 
+/**
+ * @brief Computes the CRC of a calibration blob.
+ */
+static uint32_t calibration_blob_crc(const calibration_blob_st* blob) {
+    return esp_rom_crc32_le(0, (const uint8_t*)blob, offsetof(calibration_blob_st, crc));
+}
+
+/**
+ * @brief Loads the calibration table stored in NVS into the sensor interfaces.
+ *
+ * Called once at startup, before the sensor mutexes exist. The sensors keep
+ * their default calibration if no valid table is stored.
+ */
+static void load_calibration(void) {
+    calibration_blob_st blob = {0};
+    size_t size              = sizeof(blob);
+
+    kernel_error_st err = nvs_util_load_blob(CALIBRATION_NVS_NAMESPACE, CALIBRATION_NVS_KEY, &blob, &size);
+    if (err == KERNEL_ERROR_NVS_NOT_FOUND) {
+        logger_print(INFO, TAG, "No stored calibration, using defaults");
+        return;
+    }
+
+    if (err != KERNEL_SUCCESS) {
+        logger_print(WARN, TAG, "Failed to load calibration from NVS: %d", err);
+        return;
+    }
+
+    if ((size != sizeof(blob)) || (blob.version != CALIBRATION_BLOB_VERSION) || (blob.num_of_sensors != NUM_OF_SENSORS) ||
+        (blob.crc != calibration_blob_crc(&blob))) {
+        logger_print(WARN, TAG, "Stored calibration is invalid or outdated, using defaults");
+        return;
+    }
+
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        sensor_interface[i].offset          = blob.entries[i].offset;
+        sensor_interface[i].conversion_gain = blob.entries[i].gain;
+    }
+
+    logger_print(INFO, TAG, "Calibration loaded from NVS");
+}
+
+/**
+ * @brief Records that the calibration table changed and must be committed.
+ */
+static void mark_calibration_dirty(void) {
+    calibration_changed_at = xTaskGetTickCount();
+    calibration_dirty      = true;
+}
+
+/**
+ * @brief Commits the calibration table to NVS once it has stopped changing.
+ *
+ * Called from the sensor manager loop. The table is only written when it
+ * changed and no calibration arrived for CALIBRATION_SAVE_DEBOUNCE_MS, so a
+ * burst of calibration commands costs a single flash commit. A change made
+ * while the table is being copied marks it dirty again and is saved later.
+ */
+static void save_calibration_if_idle(void) {
+    if (!calibration_dirty || ((xTaskGetTickCount() - calibration_changed_at) < pdMS_TO_TICKS(CALIBRATION_SAVE_DEBOUNCE_MS))) {
+        return;
+    }
+
+    calibration_dirty        = false;
+    calibration_blob_st blob = {0};
+    blob.version             = CALIBRATION_BLOB_VERSION;
+    blob.num_of_sensors      = NUM_OF_SENSORS;
+
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        if (xSemaphoreTake(sensor_interface[i].mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+            calibration_dirty = true;  // Retry on the next cycle
+            return;
+        }
+        blob.entries[i].offset = sensor_interface[i].offset;
+        blob.entries[i].gain   = sensor_interface[i].conversion_gain;
+        xSemaphoreGive(sensor_interface[i].mutex);
+    }
+
+    blob.crc = calibration_blob_crc(&blob);
+
+    kernel_error_st err = nvs_util_save_blob(CALIBRATION_NVS_NAMESPACE, CALIBRATION_NVS_KEY, &blob, sizeof(blob));
+    if (err != KERNEL_SUCCESS) {
+        logger_print(ERR, TAG, "Failed to save calibration to NVS: %d", err);
+        calibration_dirty = true;
+        return;
+    }
+
+    logger_print(INFO, TAG, "Calibration saved to NVS");
+}
+
 /**
  * @brief Initialize the sensor manager and its dependencies.
  *
@@ -423,6 +543,8 @@ static sensor_interface_st sensor_interface[NUM_OF_SENSORS] = {
  * its event queue, ADC, and multiplexer controllers. Each sensor channel
  * is assigned the proper interface (ADC + MUX + read function).
  *
+ * The calibration table stored in NVS, if any, is loaded here.
+ *
  * This function must be called once before using any sensor operations.
  *
  * @return
@@ -445,6 +567,8 @@ static kernel_error_st sensor_manager_initialize(void* args) {
         return KERNEL_ERROR_ADC_INIT_ERROR;
     }
 
+    load_calibration();
+
     for (int i = 0; i < NUM_OF_SENSORS; i++) {
         switch (sensor_interface[i].type) {
             case SENSOR_TYPE_TEMPERATURE:
@@ -600,6 +724,7 @@ sensor_state_et sensor_get_state(uint8_t sensor_index) {
  * - Measured voltage = (raw_voltage - offset) * gain
  *
  * These values are stored in the `sensor_interface` table and applied in future readings.
+ * The table is committed to NVS by the sensor manager loop once calibrations stop arriving.
  *
  * @param sensor_index Index of the sensor to calibrate (0 to NUM_OF_MUX_CHANNELS - 1).
  * @param offset       Offset value to subtract from the raw measured voltage.
@@ -619,8 +744,81 @@ kernel_error_st sensor_calibrate(uint8_t sensor_index, float offset, float gain)
         sensor_interface[sensor_index].offset          = offset;
         sensor_interface[sensor_index].conversion_gain = gain;
         xSemaphoreGive(sensor->mutex);
+        mark_calibration_dirty();
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Releases the mutexes of the sensors of a batch below a given index.
+ *
+ * @param batch     Calibration of each sensor of the batch, NULL for the others.
+ * @param end_index Sensors from this index on are not released.
+ */
+static void release_calibration_batch(const sensor_calibration_st* batch[NUM_OF_SENSORS], int end_index) {
+    for (int i = 0; i < end_index; i++) {
+        if (batch[i] != NULL) {
+            xSemaphoreGive(sensor_interface[i].mutex);
+        }
+    }
+}
+
+/**
+ * @brief Calibrates several sensors at once.
+ *
+ * The calibrations are first checked and indexed by sensor. The mutexes of
+ * the sensors involved are then all taken, in sensor index order so two
+ * batches can never deadlock, before any value is written. If a mutex cannot
+ * be taken, the ones already held are released and nothing is changed.
+ *
+ * @param calibrations        Calibrations to apply, at most one per sensor.
+ * @param num_of_calibrations Number of calibrations (0 to NUM_OF_SENSORS).
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if calibrations is NULL
+ *         - KERNEL_ERROR_INVALID_SIZE if there are more calibrations than sensors
+ *         - KERNEL_ERROR_INVALID_ARG if a sensor index is out of range or repeated
+ *         - KERNEL_ERROR_FAILED_TO_LOCK if a sensor mutex could not be taken
+ */
+kernel_error_st sensor_calibrate_batch(const sensor_calibration_st* calibrations, size_t num_of_calibrations) {
+    const sensor_calibration_st* batch[NUM_OF_SENSORS] = {NULL};
+
+    if (calibrations == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (num_of_calibrations > NUM_OF_SENSORS) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
+    for (size_t i = 0; i < num_of_calibrations; i++) {
+        uint8_t sensor_index = calibrations[i].sensor_index;
+
+        if ((sensor_index >= NUM_OF_SENSORS) || (batch[sensor_index] != NULL)) {
+            return KERNEL_ERROR_INVALID_ARG;
+        }
+
+        batch[sensor_index] = &calibrations[i];
+    }
+
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        if ((batch[i] != NULL) && (xSemaphoreTake(sensor_interface[i].mutex, pdMS_TO_TICKS(100)) != pdTRUE)) {
+            release_calibration_batch(batch, i);
+            return KERNEL_ERROR_FAILED_TO_LOCK;
+        }
     }
 
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        if (batch[i] != NULL) {
+            sensor_interface[i].offset          = batch[i]->offset;
+            sensor_interface[i].conversion_gain = batch[i]->gain;
+        }
+    }
+
+    release_calibration_batch(batch, NUM_OF_SENSORS);
+    mark_calibration_dirty();
+
     return KERNEL_SUCCESS;
 }
 
@@ -628,7 +826,8 @@ kernel_error_st sensor_calibrate(uint8_t sensor_index, float offset, float gain)
  * @brief Main loop for the Sensor Manager task.
  *
  * Periodically reads data from all available sensors, builds a device report,
- * and sends it to the sensor manager queue.
+ * and sends it to the sensor manager queue. Pending calibration changes are
+ * committed to NVS between reports.
  *
  * @param args Pointer to a `sensor_manager_init_st` structure containing
  *             the queue handle for sending reports.
@@ -643,20 +842,6 @@ void sensor_manager_loop(void* args) {
         return;
     }
 
-    QueueHandle_t sensor_queue = queue_manager_get(SENSOR_REPORT_QUEUE_ID);
-    if (sensor_queue == NULL) {
-        logger_print(ERR, TAG, "Sensor report queue is NULL");
-        vTaskDelete(NULL);
-        return;
-    }
-
-    QueueHandle_t sd_card_queue = queue_manager_get(SD_CARD_QUEUE_ID);
-    if (sensor_queue == NULL) {
-        logger_print(ERR, TAG, "SD Card queue is NULL");
-        vTaskDelete(NULL);
-        return;
-    }
-
     while (1) {
         device_report_st device_report = {0};
 
@@ -669,27 +854,29 @@ void sensor_manager_loop(void* args) {
             }
             kernel_error_st err = sensor_interface[i].read(&sensor_interface[i], device_report.sensors);
             if (err != KERNEL_SUCCESS) {
-                logger_print(ERR, TAG, "Failed to read sensor at index %d: error %d", i, err);
+                LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to read sensor at index %d: error %d", i, err);
             }
             vTaskDelay(pdMS_TO_TICKS(100));
         }
 
-        logger_print(DEBUG, TAG, "Sensor report generated, sending to queue");
+        LOGGER_PRINT(DEBUG, TAG, "Sensor report generated, sending to queue");
 
         if (device_info_get_current_time(&device_report.timestamp) != KERNEL_SUCCESS) {
             logger_print(ERR, TAG, "Unix timestamp not set yet");  // In the worst case sync with the event
         } else {
             device_report.num_of_sensors = NUM_OF_SENSORS;
 
-            if (xQueueSend(sensor_queue, &device_report, pdMS_TO_TICKS(100)) != pdPASS) {
+            if (queue_manager_send(SENSOR_REPORT_QUEUE_ID, &device_report, sizeof(device_report), pdMS_TO_TICKS(100)) != KERNEL_SUCCESS) {
                 logger_print(ERR, TAG, "Failed to send sensor report to queue");
             }
 
-            if (xQueueSend(sd_card_queue, &device_report, pdMS_TO_TICKS(100)) != pdPASS) {
+            if (queue_manager_send(SD_CARD_QUEUE_ID, &device_report, sizeof(device_report), pdMS_TO_TICKS(100)) != KERNEL_SUCCESS) {
                 logger_print(ERR, TAG, "Failed to send sd card report to queue");
             }
         }
 
+        save_calibration_if_idle();
+
         vTaskDelayUntil(&last_wake_time, interval_ticks);
     }
 }
@@ -20,6 +20,7 @@
  */
 
 #include "stdbool.h"
+#include "stddef.h"
 #include "stdint.h"
 
 #include "app/sensor_manager/sensor_types.h"
@@ -104,3 +105,21 @@ sensor_state_et sensor_get_state(uint8_t sensor_index);
  *         - KERNEL_ERROR_INVALID_ARG if the sensor index is out of range
  */
 kernel_error_st sensor_calibrate(uint8_t sensor_index, float offset, float gain);
+
+/**
+ * @brief Calibrates several sensors at once.
+ *
+ * Every sensor of the batch is locked before any calibration is written, so
+ * the calibration getters see either none or all of the batch. If the batch
+ * is invalid or a sensor cannot be locked, no calibration is changed.
+ *
+ * @param calibrations        Calibrations to apply, at most one per sensor.
+ * @param num_of_calibrations Number of calibrations (0 to NUM_OF_SENSORS).
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if calibrations is NULL
+ *         - KERNEL_ERROR_INVALID_SIZE if there are more calibrations than sensors
+ *         - KERNEL_ERROR_INVALID_ARG if a sensor index is out of range or repeated
+ *         - KERNEL_ERROR_FAILED_TO_LOCK if a sensor mutex could not be taken
+ */
+kernel_error_st sensor_calibrate_batch(const sensor_calibration_st* calibrations, size_t num_of_calibrations);
@@ -107,6 +107,15 @@ typedef enum sensor_state_e {
     SENSOR_ENABLED,
 } sensor_state_et;
 
+/**
+ * @brief Calibration parameters of one sensor.
+ */
+typedef struct sensor_calibration_s {
+    uint8_t sensor_index; /**< Index of the sensor to calibrate */
+    float offset;         /**< Offset value to subtract from the raw measured voltage */
+    float gain;           /**< Gain factor to apply after offset adjustment */
+} sensor_calibration_st;
+
 /**
  * @brief Structure representing a single sensor's report.
  */
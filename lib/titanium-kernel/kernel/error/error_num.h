@@ -41,6 +41,7 @@ typedef enum kernel_error_s {
     KERNEL_ERROR_FAILED_TO_CLOSE_FILE    = 0x0013,
     KERNEL_ERROR_FAILED_DISMOUNT_SDCARD  = 0x0014,
     KERNEL_ERROR_STRING_OVERFLOW         = 0x0015,
+    KERNEL_ERROR_CRC_MISMATCH            = 0x0016,
 
     /* -------- Task/Queue (0x100) -------- */
     KERNEL_ERROR_TASK_CREATE     = 0x0100,
@@ -84,6 +85,7 @@ typedef enum kernel_error_s {
     KERNEL_ERROR_NVS_ERASE_KEY       = 0x0404,
     KERNEL_ERROR_NVS_ERASE_ALL       = 0x0405,
     KERNEL_ERROR_NVS_NOT_INITIALIZED = 0x0406,
+    KERNEL_ERROR_NVS_NOT_FOUND       = 0x0407,
 
     /* -------- OTA (0x500) -------- */
     KERNEL_ERROR_NO_OTA_PARTITION_FOUND = 0x0500,
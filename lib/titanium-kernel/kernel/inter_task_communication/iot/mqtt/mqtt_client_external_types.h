@@ -8,7 +8,11 @@
 
 #define MQTT_MAXIMUM_TOPIC_LENGTH 64      ///< Defines the maximum length of an MQTT topic string.
 #define MQTT_MAXIMUM_PAYLOAD_LENGTH 2048  ///< Defines the maximum length of an MQTT payload string.
-#define MAX_MQTT_TOPICS 10                ///< Maximum number of MQTT topics that can be subscribed to.
+#define MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH (4 * MQTT_MAXIMUM_PAYLOAD_LENGTH)  ///< Largest payload a buffer may grow to through its reserve hook.
+#define MAX_MQTT_TOPICS 10                ///< Maximum number of MQTT topics that can be subscribed to (one notification bit each).
+
+#define MQTT_DEFAULT_PUBLISH_BUDGET_MESSAGES 5                                 ///< Default messages published per topic per wakeup.
+#define MQTT_DEFAULT_PUBLISH_BUDGET_BYTES (4 * MQTT_MAXIMUM_PAYLOAD_LENGTH)    ///< Default payload bytes published per topic per wakeup.
 
 typedef uint32_t data_type_et;  ///< Type of the data used in the topic, used for serialization and routing.
 
@@ -28,17 +32,73 @@ typedef enum message_type_e {
     MESSAGE_TYPE_BROADCAST,   ///< Message is broadcast to all devices.
 } message_type_et;
 
+/**
+ * @brief Publish priority class of a topic.
+ *
+ * The MQTT task always serves the highest class with pending data first, and
+ * lets higher classes use more of the MQTT outbox before backing off.
+ */
+typedef enum mqtt_priority_e {
+    MQTT_PRIORITY_BACKGROUND = 0,  ///< Backfill traffic (e.g. historical data), served only when no other class has data.
+    MQTT_PRIORITY_BULK,            ///< Bulk data (e.g. periodic sensor reports).
+    MQTT_PRIORITY_NORMAL,          ///< Regular telemetry (e.g. health reports).
+    MQTT_PRIORITY_INTERACTIVE,     ///< Request/response traffic (e.g. command responses), served first.
+    MQTT_PRIORITY_COUNT,           ///< Number of priority classes.
+} mqtt_priority_et;
+
+/**
+ * @brief Payload encoding of a PUBLISH topic.
+ */
+typedef enum mqtt_payload_format_e {
+    MQTT_PAYLOAD_FORMAT_JSON = 0,  ///< JSON text (default).
+    MQTT_PAYLOAD_FORMAT_PACKED,    ///< Compact, versioned binary layout defined by the application serializer.
+} mqtt_payload_format_et;
+
 /**
  * @brief MQTT buffer abstraction.
  *
- * Represents a generic character buffer and its size. This is used to pass
- * topic names and payloads around the system in a flexible and consistent way.
+ * Represents a generic character buffer, its size and, for produced data, the
+ * number of valid bytes. This is used to pass topic names and payloads around
+ * the system in a flexible and consistent way.
+ *
+ * A buffer may carry a reserve hook. A producer whose data does not fit calls
+ * it to grow the buffer, up to MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH, and writes
+ * again; the owner of the buffer releases the larger memory afterwards.
  */
 typedef struct mqtt_buffer_t {
-    char *buffer;  ///< Pointer to the buffer memory.
-    size_t size;   ///< Size of the buffer in bytes.
+    char *buffer;   ///< Pointer to the buffer memory.
+    size_t size;    ///< Size of the buffer in bytes.
+    size_t length;  ///< Number of valid bytes written by the producer (payloads may be binary).
+    kernel_error_st (*reserve)(struct mqtt_buffer_t *buffer, size_t size);  ///< Optional, grows `buffer` to at least `size` bytes. NULL for fixed buffers.
 } mqtt_buffer_st;
 
+/**
+ * @brief Per-topic publish drain budget.
+ *
+ * Bounds how much a topic may publish each time the MQTT task wakes up, so a
+ * backlog is drained in bursts without starving the other topics. A zero field
+ * selects the matching MQTT_DEFAULT_PUBLISH_BUDGET_* value.
+ */
+typedef struct mqtt_publish_budget_s {
+    uint16_t max_messages;  ///< Maximum messages published per wakeup.
+    size_t max_bytes;       ///< Maximum payload bytes published per wakeup.
+} mqtt_publish_budget_st;
+
+/**
+ * @brief Batching configuration of a PUBLISH topic.
+ *
+ * When `max_reports` is greater than 1, queued items are held back until
+ * `max_reports` are waiting or the oldest one has waited `max_wait_ms`, and are
+ * then published together as one payload of at most `max_bytes` (the whole
+ * payload buffer when zero). Items that do not fit stay queued for the next
+ * payload. Batching requires a fixed-slot queue transport.
+ */
+typedef struct mqtt_batch_s {
+    uint8_t max_reports;   ///< Items per payload, batching is disabled when 0 or 1.
+    uint32_t max_wait_ms;  ///< Longest time the oldest item is held before the batch is flushed.
+    size_t max_bytes;      ///< Payload size cap, 0 to use the whole payload buffer.
+} mqtt_batch_st;
+
 /**
  * @brief Static configuration for an MQTT topic.
  *
@@ -54,7 +114,13 @@ typedef struct {
     qos_et qos;                                   ///< Quality of Service (QoS) level for the topic.
     mqtt_data_direction_et mqtt_data_direction;   ///< Data direction (PUBLISH or SUBSCRIBE).
     size_t queue_length;                          ///< Number of items the associated queue can hold.
-    uint32_t queue_item_size;                     ///< Size in bytes of each item in the queue.
+    uint32_t queue_item_size;                     ///< Size in bytes of each item in the queue (largest message for message buffers).
+    size_t queue_buffer_size;                     ///< When non-zero, back the topic with a variable-length message buffer of this many bytes instead of a fixed-slot queue.
+    mqtt_publish_budget_st publish_budget;        ///< Drain budget per wakeup for PUBLISH topics (zero fields use the defaults).
+    mqtt_priority_et priority;                    ///< Publish priority class for PUBLISH topics (defaults to MQTT_PRIORITY_BACKGROUND).
+    mqtt_batch_st batch;                          ///< Batching configuration for PUBLISH topics (disabled by default).
+    mqtt_payload_format_et format;                ///< Payload encoding for PUBLISH topics (defaults to JSON).
+    size_t max_payload_length;                    ///< Largest inbound payload of SUBSCRIBE topics, up to MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH (0 for MQTT_MAXIMUM_PAYLOAD_LENGTH).
     data_type_et data_type;                       ///< Type of the data used in the topic, used for serialization and routing.
     message_type_et message_type;                 ///< Type of message (TARGET or BROADCAST).
 } mqtt_topic_info_st;
@@ -88,9 +154,10 @@ typedef kernel_error_st (*get_topic_t)(uint8_t mqtt_index, mqtt_buffer_st *topic
 /**
  * @brief Function pointer for handling incoming MQTT data.
  *
- * Called whenever an MQTT event with incoming data is received.
+ * Called whenever an MQTT event with incoming data is received. The topic
+ * is passed with its length, as received; it is not null-terminated.
  */
-typedef kernel_error_st (*handle_event_data_t)(char *topic, mqtt_buffer_st *payload);
+typedef kernel_error_st (*handle_event_data_t)(const mqtt_buffer_st *topic, mqtt_buffer_st *payload);
 
 /**
  * @brief Function pointer to get the number of active topics.
@@ -99,6 +166,35 @@ typedef kernel_error_st (*handle_event_data_t)(char *topic, mqtt_buffer_st *payl
  */
 typedef size_t (*get_topics_count_t)(void);
 
+/**
+ * @brief Function pointer to attach the MQTT task as consumer of the publish queues.
+ *
+ * The bridge sets bit `(1 << mqtt_index)` on the task notification value whenever
+ * data is enqueued for a PUBLISH topic, so the MQTT task can block until work arrives.
+ */
+typedef kernel_error_st (*set_publish_notify_t)(TaskHandle_t task);
+
+/**
+ * @brief Function pointer to get the publish drain budget of a topic.
+ *
+ * Returns the budget with defaults already applied to zero fields.
+ */
+typedef kernel_error_st (*get_publish_budget_t)(uint8_t mqtt_index, mqtt_publish_budget_st *budget);
+
+/**
+ * @brief Function pointer to get the publish priority class of a topic.
+ */
+typedef mqtt_priority_et (*get_publish_priority_t)(uint8_t mqtt_index);
+
+/**
+ * @brief Function pointer to get the largest inbound payload accepted on a received topic.
+ *
+ * Called on the first fragment of an incoming message, before it is
+ * reassembled. The topic is passed as received, it is not null-terminated.
+ * Returns KERNEL_ERROR_MQTT_INVALID_TOPIC if no registered topic matches.
+ */
+typedef kernel_error_st (*get_payload_limit_t)(const mqtt_buffer_st *topic, size_t *max_length);
+
 /**
  * @brief Represents the MQTT communication bridge.
  *
@@ -111,10 +207,14 @@ typedef size_t (*get_topics_count_t)(void);
  * The MQTT task interacts solely via function pointers.
  */
 typedef struct mqtt_bridge_s {
-    fetch_func_t fetch_publish_data;        ///< Function to fetch data for publishing.
-    get_topic_t get_topic;                  ///< Function to subscribe to topics (optional).
-    handle_event_data_t handle_event_data;  ///< Function to handle incoming MQTT data (optional).
-    get_topics_count_t get_topics_count;    ///< Function to retrieve the number of registered topics.
+    fetch_func_t fetch_publish_data;              ///< Function to fetch data for publishing.
+    get_topic_t get_topic;                        ///< Function to subscribe to topics (optional).
+    handle_event_data_t handle_event_data;        ///< Function to handle incoming MQTT data (optional).
+    get_topics_count_t get_topics_count;          ///< Function to retrieve the number of registered topics.
+    set_publish_notify_t set_publish_notify;      ///< Function to attach the MQTT task to publish queue notifications (optional).
+    get_publish_budget_t get_publish_budget;      ///< Function to get the publish drain budget of a topic (optional).
+    get_publish_priority_t get_publish_priority;  ///< Function to get the publish priority class of a topic (optional).
+    get_payload_limit_t get_payload_limit;        ///< Function to get the inbound payload limit of a received topic (optional).
 } mqtt_bridge_st;
 
 #endif /* MQTT_CLIENT_EXTERNAL_TYPES_H */
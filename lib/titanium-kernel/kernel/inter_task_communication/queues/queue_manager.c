@@ -1,8 +1,10 @@
 #include "queue_manager.h"
 
 #include "freertos/FreeRTOS.h"
+#include "freertos/message_buffer.h"
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
+#include "freertos/task.h"
 
 #include "kernel/error/error_num.h"
 #include "kernel/logger/logger.h"
@@ -10,8 +12,14 @@
 #define QUEUE_MANAGER_MAX_QUEUES 16 /**< Maximum number of queues that can be registered */
 
 typedef struct queue_manager_entry_s {
-    int index;            /**< User-assigned queue ID */
-    QueueHandle_t handle; /**< FreeRTOS queue handle associated with this ID */
+    int index;                            /**< User-assigned queue ID */
+    QueueHandle_t handle;                 /**< FreeRTOS queue handle associated with this ID (fixed-size transport) */
+    size_t item_size;                     /**< Item size of the queue; sends and receives must use exactly this size */
+    MessageBufferHandle_t message_buffer; /**< FreeRTOS message buffer associated with this ID (variable-size transport) */
+    SemaphoreHandle_t write_lock;         /**< Serializes writers of the message buffer (FreeRTOS allows a single writer) */
+    size_t max_message_size;              /**< Largest message accepted by the message buffer */
+    TaskHandle_t notify_task;             /**< Consumer task notified after each successful send (optional) */
+    uint32_t notify_bits;                 /**< Notification bits set on notify_task */
 } queue_manager_entry_st;
 
 static const char *TAG                                             = "Queue Manager";    /**< Logging tag used for Queue Manager messages */
@@ -20,6 +28,75 @@ static queue_manager_entry_st s_registry[QUEUE_MANAGER_MAX_QUEUES] = {0};
 static bool is_initialized                                         = false;              /**< Flag indicating whether the Queue Manager has been initialized */
 static SemaphoreHandle_t s_registry_lock;                                                /**< FreeRTOS mutex protecting access to the queue registry */
 
+/**
+ * @brief Check whether a registry slot is unused.
+ *
+ * @param[in] entry Registry entry to check.
+ * @return true if neither a queue nor a message buffer is stored in the slot.
+ */
+static bool is_slot_free(const queue_manager_entry_st *entry) {
+    return (entry->handle == NULL) && (entry->message_buffer == NULL);
+}
+
+/**
+ * @brief Find the registry entry associated with an ID.
+ *
+ * @note The caller must hold the registry lock.
+ *
+ * @param[in] index The ID of the entry to look up.
+ * @return Pointer to the entry, or NULL if no entry uses this ID.
+ */
+static queue_manager_entry_st *find_entry(uint8_t index) {
+    for (int i = 0; i < QUEUE_MANAGER_MAX_QUEUES; i++) {
+        if (!is_slot_free(&s_registry[i]) && s_registry[i].index == index) {
+            return &s_registry[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Take a copy of the registry entry associated with an ID.
+ *
+ * Entries are never removed once registered, so a copy taken under the
+ * registry lock remains valid after the lock is released.
+ *
+ * @param[in]  index The ID of the entry to look up.
+ * @param[out] out   Copy of the registry entry.
+ *
+ * @return kernel_error_st:
+ *   - KERNEL_SUCCESS if the entry was found.
+ *   - KERNEL_ERROR_MANAGER_NOT_INITIALIZED if init was not called.
+ *   - KERNEL_ERROR_FAILED_TO_LOCK if the mutex could not be acquired.
+ *   - KERNEL_ERROR_QUEUE_NULL if no entry uses this ID.
+ */
+static kernel_error_st get_entry(uint8_t index, queue_manager_entry_st *out) {
+    if (!is_initialized || s_registry_lock == NULL) {
+        logger_print(ERR, TAG, "Queue Manager not initialized!");
+        return KERNEL_ERROR_MANAGER_NOT_INITIALIZED;
+    }
+
+    if (xSemaphoreTake(s_registry_lock, QUEUE_MANAGER_MUTEX_TIMEOUT) != pdTRUE) {
+        logger_print(ERR, TAG, "Failed to acquire registry lock");
+        return KERNEL_ERROR_FAILED_TO_LOCK;
+    }
+
+    queue_manager_entry_st *entry = find_entry(index);
+    if (entry != NULL) {
+        *out = *entry;
+    }
+
+    xSemaphoreGive(s_registry_lock);
+
+    if (entry == NULL) {
+        logger_print(WARN, TAG, "Queue ID=%d not found", index);
+        return KERNEL_ERROR_QUEUE_NULL;
+    }
+
+    return KERNEL_SUCCESS;
+}
+
 /**
  * @brief Initialize the Queue Manager.
  *
@@ -98,10 +175,11 @@ kernel_error_st queue_manager_register(uint8_t index, UBaseType_t queue_length,
     }
 
     for (int i = 0; i < QUEUE_MANAGER_MAX_QUEUES; i++) {
-        if (s_registry[i].handle == NULL) {
-            s_registry[i].index  = index;
-            s_registry[i].handle = queue_handle;
-            logger_print(DEBUG, TAG, "Registered queue ID=%d at slot %d", index, i);
+        if (is_slot_free(&s_registry[i])) {
+            s_registry[i].index     = index;
+            s_registry[i].handle    = queue_handle;
+            s_registry[i].item_size = item_size;
+            LOGGER_PRINT(DEBUG, TAG, "Registered queue ID=%d at slot %d", index, i);
             xSemaphoreGive(s_registry_lock);
             return KERNEL_SUCCESS;
         }
@@ -140,7 +218,7 @@ QueueHandle_t queue_manager_get(uint8_t index) {
     for (int i = 0; i < QUEUE_MANAGER_MAX_QUEUES; i++) {
         if (s_registry[i].handle && s_registry[i].index == index) {
             handle = s_registry[i].handle;
-            logger_print(DEBUG, TAG, "Found queue ID=%d at slot %d", index, i);
+            LOGGER_PRINT(DEBUG, TAG, "Found queue ID=%d at slot %d", index, i);
             break;
         }
     }
@@ -152,4 +230,330 @@ QueueHandle_t queue_manager_get(uint8_t index) {
     xSemaphoreGive(s_registry_lock);
 
     return handle;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Create and register a variable-length message buffer in the manager.
+ *
+ * Creates a FreeRTOS message buffer of `buffer_size` bytes and associates it with
+ * a user-defined ID. Unlike a queue, a message buffer only consumes the bytes each
+ * message actually needs (plus QUEUE_MANAGER_MESSAGE_OVERHEAD for its length
+ * prefix), so a transport whose largest message is much bigger than its typical
+ * one no longer pays for the worst case on every slot.
+ *
+ * Message buffers are accessed through queue_manager_send() and
+ * queue_manager_receive(); queue_manager_get() returns NULL for them.
+ *
+ * @param[in] index            The ID to assign to this message buffer.
+ * @param[in] buffer_size      Total storage, in bytes, of the message buffer.
+ * @param[in] max_message_size Largest message that will be sent through it.
+ *
+ * @return kernel_error_st:
+ *   - KERNEL_SUCCESS on success.
+ *   - KERNEL_ERROR_INVALID_ARG if parameters are invalid or the largest message does not fit.
+ *   - KERNEL_ERROR_MANAGER_NOT_INITIALIZED if init was not called.
+ *   - KERNEL_ERROR_FAILED_TO_LOCK if the mutex could not be acquired.
+ *   - KERNEL_ERROR_NO_MEM if the buffer or its write lock could not be allocated.
+ *   - KERNEL_ERROR_FAIL if the registry is full.
+ */
+kernel_error_st queue_manager_register_message_buffer(uint8_t index, size_t buffer_size, size_t max_message_size) {
+    if ((max_message_size == 0) || (buffer_size < (max_message_size + QUEUE_MANAGER_MESSAGE_OVERHEAD))) {
+        logger_print(ERR, TAG, "Invalid message buffer parameters: size=%d, max_message=%d", buffer_size, max_message_size);
+        return KERNEL_ERROR_INVALID_ARG;
+    }
+
+    if (!is_initialized) {
+        logger_print(ERR, TAG, "Queue Manager not initialized!");
+        return KERNEL_ERROR_MANAGER_NOT_INITIALIZED;
+    }
+
+    if (xSemaphoreTake(s_registry_lock, QUEUE_MANAGER_MUTEX_TIMEOUT) != pdTRUE) {
+        logger_print(ERR, TAG, "Failed to acquire registry lock");
+        return KERNEL_ERROR_FAILED_TO_LOCK;
+    }
+
+    MessageBufferHandle_t message_buffer = xMessageBufferCreate(buffer_size);
+    SemaphoreHandle_t write_lock         = xSemaphoreCreateMutex();
+    if ((message_buffer == NULL) || (write_lock == NULL)) {
+        if (message_buffer != NULL) {
+            vMessageBufferDelete(message_buffer);
+        }
+        if (write_lock != NULL) {
+            vSemaphoreDelete(write_lock);
+        }
+        logger_print(ERR, TAG, "Failed to create message buffer ID=%d", index);
+        xSemaphoreGive(s_registry_lock);
+        return KERNEL_ERROR_NO_MEM;
+    }
+
+    for (int i = 0; i < QUEUE_MANAGER_MAX_QUEUES; i++) {
+        if (is_slot_free(&s_registry[i])) {
+            s_registry[i].index            = index;
+            s_registry[i].message_buffer   = message_buffer;
+            s_registry[i].write_lock       = write_lock;
+            s_registry[i].max_message_size = max_message_size;
+            LOGGER_PRINT(DEBUG, TAG, "Registered message buffer ID=%d at slot %d", index, i);
+            xSemaphoreGive(s_registry_lock);
+            return KERNEL_SUCCESS;
+        }
+    }
+
+    vMessageBufferDelete(message_buffer);
+    vSemaphoreDelete(write_lock);
+    xSemaphoreGive(s_registry_lock);
+    logger_print(ERR, TAG, "Registry full, cannot register ID=%d", index);
+    return KERNEL_ERROR_FAIL;
+}
+
+/**
+ * @brief Send an item to a registered queue or message buffer.
+ *
+ * For queues, `item_size` must equal the queue item size, since the queue always
+ * copies a full slot. For message buffers, exactly `item_size` bytes are stored.
+ * If a consumer was attached with queue_manager_set_notify(), it is notified
+ * once the item is stored.
+ *
+ * @param[in] index     The ID of the destination queue or message buffer.
+ * @param[in] item      Pointer to the data to send.
+ * @param[in] item_size Number of meaningful bytes in `item`.
+ * @param[in] timeout   Maximum time to wait for free space.
+ *
+ * @return kernel_error_st:
+ *   - KERNEL_SUCCESS on success.
+ *   - KERNEL_ERROR_NULL if item is NULL.
+ *   - KERNEL_ERROR_INVALID_SIZE if the item size does not match the queue item size or
+ *     is larger than the message buffer accepts.
+ *   - KERNEL_ERROR_QUEUE_NULL if no transport uses this ID.
+ *   - KERNEL_ERROR_QUEUE_FULL if there was no room before the timeout expired.
+ */
+kernel_error_st queue_manager_send(uint8_t index, const void *item, size_t item_size, TickType_t timeout) {
+    if (item == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    queue_manager_entry_st entry = {0};
+    kernel_error_st err          = get_entry(index, &entry);
+    if (err != KERNEL_SUCCESS) {
+        return err;
+    }
+
+    if (entry.handle != NULL) {
+        if (item_size != entry.item_size) {
+            return KERNEL_ERROR_INVALID_SIZE;
+        }
+
+        if (xQueueSend(entry.handle, item, timeout) != pdPASS) {
+            return KERNEL_ERROR_QUEUE_FULL;
+        }
+    } else {
+        if ((item_size == 0) || (item_size > entry.max_message_size)) {
+            return KERNEL_ERROR_INVALID_SIZE;
+        }
+
+        if (xSemaphoreTake(entry.write_lock, timeout) != pdTRUE) {
+            return KERNEL_ERROR_FAILED_TO_LOCK;
+        }
+
+        size_t sent = xMessageBufferSend(entry.message_buffer, item, item_size, timeout);
+        xSemaphoreGive(entry.write_lock);
+
+        if (sent != item_size) {
+            return KERNEL_ERROR_QUEUE_FULL;
+        }
+    }
+
+    if (entry.notify_task != NULL) {
+        xTaskNotify(entry.notify_task, entry.notify_bits, eSetBits);
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Receive an item from a registered queue or message buffer.
+ *
+ * For queues, `item_size` must equal the queue item size. For message buffers,
+ * the message is copied into `item` and its length reported through
+ * `received_size`; bytes past the message length are left untouched, so callers
+ * receiving a truncated struct should zero it beforehand. A message longer than
+ * `item` stays at the head of the buffer and is reported, not mistaken for an
+ * empty buffer.
+ *
+ * @param[in]  index         The ID of the source queue or message buffer.
+ * @param[out] item          Buffer that receives the data.
+ * @param[in]  item_size     Size of `item` in bytes.
+ * @param[out] received_size Optional, number of bytes received.
+ * @param[in]  timeout       Maximum time to wait for data.
+ *
+ * @return kernel_error_st:
+ *   - KERNEL_SUCCESS on success.
+ *   - KERNEL_ERROR_NULL if item is NULL.
+ *   - KERNEL_ERROR_INVALID_SIZE if `item_size` does not match the queue item size or
+ *     the next message is longer than `item_size`.
+ *   - KERNEL_ERROR_QUEUE_NULL if no transport uses this ID.
+ *   - KERNEL_ERROR_EMPTY_QUEUE if no data arrived before the timeout expired.
+ */
+kernel_error_st queue_manager_receive(uint8_t index, void *item, size_t item_size, size_t *received_size, TickType_t timeout) {
+    if (item == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    queue_manager_entry_st entry = {0};
+    kernel_error_st err          = get_entry(index, &entry);
+    if (err != KERNEL_SUCCESS) {
+        return err;
+    }
+
+    if (received_size != NULL) {
+        *received_size = 0;
+    }
+
+    size_t received = 0;
+    if (entry.handle != NULL) {
+        if (item_size != entry.item_size) {
+            return KERNEL_ERROR_INVALID_SIZE;
+        }
+
+        if (xQueueReceive(entry.handle, item, timeout) == pdTRUE) {
+            received = item_size;
+        }
+    } else {
+        received = xMessageBufferReceive(entry.message_buffer, item, item_size, timeout);
+
+        /* A message that does not fit is left in place, and would otherwise look like an empty buffer */
+        if ((received == 0) && (xMessageBufferNextLengthBytes(entry.message_buffer) > item_size)) {
+            return KERNEL_ERROR_INVALID_SIZE;
+        }
+    }
+
+    if (received_size != NULL) {
+        *received_size = received;
+    }
+
+    return (received > 0) ? KERNEL_SUCCESS : KERNEL_ERROR_EMPTY_QUEUE;
+}
+
+/**
+ * @brief Copy the oldest item of a registered queue without removing it.
+ *
+ * Only fixed-slot queues support peeking; message buffers cannot be peeked.
+ *
+ * @param[in]  index     The ID of the source queue.
+ * @param[out] item      Buffer that receives the data, at least the queue item size.
+ * @param[in]  timeout   Maximum time to wait for data.
+ *
+ * @return kernel_error_st:
+ *   - KERNEL_SUCCESS on success.
+ *   - KERNEL_ERROR_NULL if item is NULL.
+ *   - KERNEL_ERROR_QUEUE_NULL if no transport uses this ID.
+ *   - KERNEL_ERROR_UNSUPPORTED_TYPE if the ID is backed by a message buffer.
+ *   - KERNEL_ERROR_EMPTY_QUEUE if no data arrived before the timeout expired.
+ */
+kernel_error_st queue_manager_peek(uint8_t index, void *item, TickType_t timeout) {
+    if (item == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    queue_manager_entry_st entry = {0};
+    kernel_error_st err          = get_entry(index, &entry);
+    if (err != KERNEL_SUCCESS) {
+        return err;
+    }
+
+    if (entry.handle == NULL) {
+        return KERNEL_ERROR_UNSUPPORTED_TYPE;
+    }
+
+    return (xQueuePeek(entry.handle, item, timeout) == pdTRUE) ? KERNEL_SUCCESS : KERNEL_ERROR_EMPTY_QUEUE;
+}
+
+/**
+ * @brief Get the number of items waiting in a registered queue or message buffer.
+ *
+ * Message buffers do not track a message count, so for them the result is
+ * 1 when at least one message is waiting and 0 otherwise.
+ *
+ * @param[in] index The ID of the queue or message buffer.
+ *
+ * @return Number of items waiting, 0 if empty or not registered.
+ */
+size_t queue_manager_messages_waiting(uint8_t index) {
+    queue_manager_entry_st entry = {0};
+    if (get_entry(index, &entry) != KERNEL_SUCCESS) {
+        return 0;
+    }
+
+    if (entry.handle != NULL) {
+        return uxQueueMessagesWaiting(entry.handle);
+    }
+
+    return (xMessageBufferIsEmpty(entry.message_buffer) == pdFALSE) ? 1 : 0;
+}
+
+/**
+ * @brief Check whether a registered queue or message buffer has pending data.
+ *
+ * @param[in] index The ID of the queue or message buffer.
+ *
+ * @return true if at least one item is waiting, false if empty or not registered.
+ */
+bool queue_manager_has_data(uint8_t index) {
+    queue_manager_entry_st entry = {0};
+    if (get_entry(index, &entry) != KERNEL_SUCCESS) {
+        return false;
+    }
+
+    if (entry.handle != NULL) {
+        return (uxQueueMessagesWaiting(entry.handle) > 0);
+    }
+
+    return (xMessageBufferIsEmpty(entry.message_buffer) == pdFALSE);
+}
+
+/**
+ * @brief Attach a consumer task to be notified when data is sent to an ID.
+ *
+ * After every successful queue_manager_send() to `index`, `notify_bits` are set
+ * on the task's notification value (eSetBits), so the consumer can block on
+ * xTaskNotifyWait() instead of polling. Several IDs may share one task with
+ * different bits. Passing a NULL task detaches the consumer.
+ *
+ * @note Only sends going through queue_manager_send() raise the notification;
+ *       writers using the raw queue handle bypass it.
+ *
+ * @param[in] index       The ID of the queue or message buffer.
+ * @param[in] task        Task to notify, or NULL to detach.
+ * @param[in] notify_bits Bits to set on the task notification value.
+ *
+ * @return kernel_error_st:
+ *   - KERNEL_SUCCESS on success.
+ *   - KERNEL_ERROR_MANAGER_NOT_INITIALIZED if init was not called.
+ *   - KERNEL_ERROR_FAILED_TO_LOCK if the mutex could not be acquired.
+ *   - KERNEL_ERROR_QUEUE_NULL if no transport uses this ID.
+ */
+kernel_error_st queue_manager_set_notify(uint8_t index, TaskHandle_t task, uint32_t notify_bits) {
+    if (!is_initialized || s_registry_lock == NULL) {
+        logger_print(ERR, TAG, "Queue Manager not initialized!");
+        return KERNEL_ERROR_MANAGER_NOT_INITIALIZED;
+    }
+
+    if (xSemaphoreTake(s_registry_lock, QUEUE_MANAGER_MUTEX_TIMEOUT) != pdTRUE) {
+        logger_print(ERR, TAG, "Failed to acquire registry lock");
+        return KERNEL_ERROR_FAILED_TO_LOCK;
+    }
+
+    queue_manager_entry_st *entry = find_entry(index);
+    if (entry != NULL) {
+        entry->notify_task = task;
+        entry->notify_bits = notify_bits;
+    }
+
+    xSemaphoreGive(s_registry_lock);
+
+    if (entry == NULL) {
+        logger_print(WARN, TAG, "Queue ID=%d not found", index);
+        return KERNEL_ERROR_QUEUE_NULL;
+    }
+
+    return KERNEL_SUCCESS;
+}
@@ -8,10 +8,21 @@
  * This module allows creating, registering, and retrieving FreeRTOS queues
  * using user-defined IDs. Queues are managed internally in a static registry
  * protected by a FreeRTOS mutex.
+ *
+ * An ID may alternatively be backed by a FreeRTOS message buffer, which stores
+ * variable-length messages and only consumes the bytes each one needs. Both
+ * transports are reachable through queue_manager_send() / queue_manager_receive().
+ *
+ * A consumer task may be attached to an ID so that it is woken by a task
+ * notification whenever data is sent, instead of polling the transport.
  */
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos/task.h"
 
 #include "kernel/error/error_num.h"
 
@@ -33,6 +44,12 @@ enum {
     LAST_KERNEL_QUEUE_ID = 10
 };
 
+/**
+ * @def QUEUE_MANAGER_MESSAGE_OVERHEAD
+ * @brief Bytes used by a message buffer to store the length of each message.
+ */
+#define QUEUE_MANAGER_MESSAGE_OVERHEAD sizeof(size_t)
+
 /**
  * @brief Initialize the Queue Manager.
  *
@@ -71,10 +88,109 @@ kernel_error_st queue_manager_register(uint8_t index, UBaseType_t queue_length,
  *
  * @return QueueHandle_t
  *   - Queue handle if found.
- *   - NULL if no queue with the given ID is registered.
+ *   - NULL if no queue with the given ID is registered (including IDs backed by a message buffer).
  */
 QueueHandle_t queue_manager_get(uint8_t index);
 
+/**
+ * @brief Create and register a variable-length message buffer with the Queue Manager.
+ *
+ * @param[in] index            User-defined ID for the message buffer.
+ * @param[in] buffer_size      Total storage of the message buffer in bytes.
+ * @param[in] max_message_size Largest message that will be sent through it.
+ *
+ * @return kernel_error_st
+ *   - KERNEL_SUCCESS on success.
+ *   - KERNEL_ERROR_INVALID_ARG if the largest message plus its length prefix does not fit.
+ *   - KERNEL_ERROR_MANAGER_NOT_INITIALIZED if queue_manager_init() was not called.
+ *   - KERNEL_ERROR_FAILED_TO_LOCK if mutex could not be acquired.
+ *   - KERNEL_ERROR_NO_MEM if the message buffer could not be allocated.
+ *   - KERNEL_ERROR_FAIL if the registry is full.
+ */
+kernel_error_st queue_manager_register_message_buffer(uint8_t index, size_t buffer_size, size_t max_message_size);
+
+/**
+ * @brief Send an item to a registered queue or message buffer.
+ *
+ * @param[in] index     ID of the destination.
+ * @param[in] item      Data to send.
+ * @param[in] item_size Meaningful bytes in `item` (only these are stored by a message buffer);
+ *                      for a queue, exactly its item size.
+ * @param[in] timeout   Maximum time to wait for free space.
+ *
+ * @return kernel_error_st
+ *   - KERNEL_SUCCESS on success.
+ *   - KERNEL_ERROR_NULL, KERNEL_ERROR_INVALID_SIZE or KERNEL_ERROR_QUEUE_NULL on invalid input.
+ *   - KERNEL_ERROR_QUEUE_FULL if there was no room before the timeout expired.
+ */
+kernel_error_st queue_manager_send(uint8_t index, const void *item, size_t item_size, TickType_t timeout);
+
+/**
+ * @brief Receive an item from a registered queue or message buffer.
+ *
+ * @param[in]  index         ID of the source.
+ * @param[out] item          Buffer that receives the data.
+ * @param[in]  item_size     Size of `item` in bytes; for a queue, exactly its item size.
+ * @param[out] received_size Optional, number of bytes received.
+ * @param[in]  timeout       Maximum time to wait for data.
+ *
+ * @return kernel_error_st
+ *   - KERNEL_SUCCESS on success.
+ *   - KERNEL_ERROR_NULL or KERNEL_ERROR_QUEUE_NULL on invalid input.
+ *   - KERNEL_ERROR_INVALID_SIZE if `item_size` does not match the queue item size,
+ *     or the next message is longer than `item` (it stays in the buffer).
+ *   - KERNEL_ERROR_EMPTY_QUEUE if nothing arrived before the timeout expired.
+ */
+kernel_error_st queue_manager_receive(uint8_t index, void *item, size_t item_size, size_t *received_size, TickType_t timeout);
+
+/**
+ * @brief Copy the oldest item of a registered queue without removing it.
+ *
+ * @param[in]  index   ID of the source queue.
+ * @param[out] item    Buffer that receives the data, at least the queue item size.
+ * @param[in]  timeout Maximum time to wait for data.
+ *
+ * @return kernel_error_st
+ *   - KERNEL_SUCCESS on success.
+ *   - KERNEL_ERROR_NULL or KERNEL_ERROR_QUEUE_NULL on invalid input.
+ *   - KERNEL_ERROR_UNSUPPORTED_TYPE if the ID is backed by a message buffer.
+ *   - KERNEL_ERROR_EMPTY_QUEUE if nothing arrived before the timeout expired.
+ */
+kernel_error_st queue_manager_peek(uint8_t index, void *item, TickType_t timeout);
+
+/**
+ * @brief Get the number of items waiting in a registered queue or message buffer.
+ *
+ * @param[in] index ID of the queue or message buffer.
+ *
+ * @return Items waiting (at most 1 for message buffers), 0 if empty or not registered.
+ */
+size_t queue_manager_messages_waiting(uint8_t index);
+
+/**
+ * @brief Check whether a registered queue or message buffer has pending data.
+ *
+ * @param[in] index ID of the queue or message buffer.
+ *
+ * @return true if data is waiting, false if empty or not registered.
+ */
+bool queue_manager_has_data(uint8_t index);
+
+/**
+ * @brief Attach a consumer task notified after every successful queue_manager_send().
+ *
+ * @param[in] index       ID of the queue or message buffer.
+ * @param[in] task        Task to notify, or NULL to detach.
+ * @param[in] notify_bits Bits set on the task notification value (eSetBits).
+ *
+ * @return kernel_error_st
+ *   - KERNEL_SUCCESS on success.
+ *   - KERNEL_ERROR_MANAGER_NOT_INITIALIZED if queue_manager_init() was not called.
+ *   - KERNEL_ERROR_FAILED_TO_LOCK if mutex could not be acquired.
+ *   - KERNEL_ERROR_QUEUE_NULL if no transport uses this ID.
+ */
+kernel_error_st queue_manager_set_notify(uint8_t index, TaskHandle_t task, uint32_t notify_bits);
+
 #ifdef __cplusplus
 }
 #endif
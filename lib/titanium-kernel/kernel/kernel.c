@@ -2,6 +2,7 @@
 
 #include "kernel/device/device_info.h"
 #include "kernel/inter_task_communication/queues/queue_manager.h"
+#include "kernel/logger/log_udp.h"
 #include "kernel/utils/nvs_util.h"
 
 task_interface_st sntp_task = {
@@ -22,6 +23,24 @@ task_interface_st watchdog_task = {
     .handle       = NULL,
 };
 
+task_interface_st logger_task = {
+    .arg          = NULL,
+    .name         = LOGGER_TASK_NAME,
+    .priority     = LOGGER_TASK_PRIORITY,
+    .stack_size   = LOGGER_TASK_STACK_SIZE,
+    .task_execute = logger_task_execute,
+    .handle       = NULL,
+};
+
+task_interface_st log_resolver_task = {
+    .arg          = NULL,
+    .name         = LOG_RESOLVER_TASK_NAME,
+    .priority     = LOG_RESOLVER_TASK_PRIORITY,
+    .stack_size   = LOG_RESOLVER_TASK_STACK_SIZE,
+    .task_execute = log_udp_resolver_task_execute,
+    .handle       = NULL,
+};
+
 task_interface_st network_task = {
     .arg          = NULL,
     .name         = NETWORK_TASK_NAME,
@@ -70,6 +89,7 @@ static const char *TAG = "KERNEL";  ///< Tag for logging
 void kernel_restart(void) {
 #ifndef DEBUG
     logger_print(INFO, TAG, "Restarting system due to critical error");
+    logger_flush(pdMS_TO_TICKS(LOGGER_FLUSH_TIMEOUT_MS));
     esp_restart();
 #endif
 }
@@ -180,6 +200,21 @@ kernel_error_st kernel_initialize(release_mode_et release_mode, log_output_et lo
         return ret;
     }
 
+    ret = task_handler_enqueue_task(&logger_task);
+
+    if (ret != KERNEL_SUCCESS) {
+        return ret;
+    }
+
+    if ((log_output == UDP) || (log_output == UDP_BINARY)) {
+        log_resolver_task.arg = (void *)global_structures;
+        ret                   = task_handler_enqueue_task(&log_resolver_task);
+
+        if (ret != KERNEL_SUCCESS) {
+            return ret;
+        }
+    }
+
     return KERNEL_SUCCESS;
 }
 
@@ -0,0 +1,169 @@
+#include "log_codec.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_CODEC_SPEC_SIZE 16  ///< Longest conversion specification formatted, terminator included.
+
+/**
+ * @brief Writes a 32-bit value in little-endian order.
+ */
+static void put_u32(uint8_t *out, uint32_t value) {
+    out[0] = (uint8_t)(value);
+    out[1] = (uint8_t)(value >> 8);
+    out[2] = (uint8_t)(value >> 16);
+    out[3] = (uint8_t)(value >> 24);
+}
+
+/**
+ * @brief Whether `c` is one of the characters `set` holds, never the terminator.
+ */
+static bool is_one_of(char c, const char *set) {
+    return (c != '\0') && (strchr(set, c) != NULL);
+}
+
+/**
+ * @brief Copies text to the output, as much as fits before the terminator.
+ *
+ * @return Updated length of the output.
+ */
+static size_t append_text(char *out, size_t size, size_t length, const char *text, size_t text_length) {
+    size_t room = size - 1 - length;
+    if (text_length > room) {
+        text_length = room;
+    }
+
+    memcpy(out + length, text, text_length);
+    return length + text_length;
+}
+
+/**
+ * @brief Formats one argument with a conversion specification stripped of its widening modifiers.
+ *
+ * @return Updated length of the output.
+ */
+static size_t append_argument(char *out, size_t size, size_t length, const char *spec, char conversion, uint32_t arg) {
+    size_t room = size - length;
+    int written = 0;
+
+    if ((conversion == 'd') || (conversion == 'i')) {
+        written = snprintf(out + length, room, spec, (int)(int32_t)arg);
+    } else if (conversion == 'c') {
+        written = snprintf(out + length, room, spec, (int)arg);
+    } else {
+        written = snprintf(out + length, room, spec, (unsigned int)arg);
+    }
+
+    if (written < 0) {
+        return length;
+    }
+
+    if ((size_t)written >= room) {
+        return size - 1;
+    }
+
+    return length + (size_t)written;
+}
+
+kernel_error_st log_codec_encode(uint8_t *out,
+                                 size_t size,
+                                 const log_codec_header_st *header,
+                                 const void *payload,
+                                 size_t payload_length,
+                                 size_t *length) {
+    if ((out == NULL) || (header == NULL) || (length == NULL) || ((payload == NULL) && (payload_length > 0))) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (payload_length > UINT8_MAX) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
+    if ((LOG_CODEC_HEADER_SIZE + payload_length) > size) {
+        return KERNEL_ERROR_BUFFER_TOO_SHORT;
+    }
+
+    out[0] = LOG_CODEC_MAGIC;
+    out[1] = header->level;
+    out[2] = header->task;
+    out[3] = (uint8_t)payload_length;
+    put_u32(out + 4, header->timestamp);
+    put_u32(out + 8, header->format);
+    put_u32(out + 12, header->tag);
+
+    if (payload_length > 0) {
+        memcpy(out + LOG_CODEC_HEADER_SIZE, payload, payload_length);
+    }
+
+    *length = LOG_CODEC_HEADER_SIZE + payload_length;
+
+    return KERNEL_SUCCESS;
+}
+
+size_t log_codec_format(char *out, size_t size, const char *format, const uint32_t *args, uint8_t argc) {
+    if ((out == NULL) || (size == 0)) {
+        return 0;
+    }
+
+    size_t length = 0;
+    uint8_t next  = 0;
+    const char *p = (format != NULL) ? format : "";
+
+    while ((*p != '\0') && (length < (size - 1))) {
+        if (*p != '%') {
+            out[length++] = *p++;
+            continue;
+        }
+
+        if (p[1] == '%') {
+            out[length++] = '%';
+            p += 2;
+            continue;
+        }
+
+        const char *start  = p++;
+        char spec[LOG_CODEC_SPEC_SIZE];
+        size_t spec_length = 0;
+        bool supported     = true;
+
+        spec[spec_length++] = '%';
+        while (is_one_of(*p, "-+ #0123456789.")) {
+            if (spec_length < (sizeof(spec) - 2)) {
+                spec[spec_length++] = *p;
+            } else {
+                supported = false;
+            }
+            p++;
+        }
+
+        /* `h` and `hh` still apply to an int argument; the others only widen it */
+        uint8_t longs = 0;
+        while (is_one_of(*p, "hlzt")) {
+            if (*p == 'h') {
+                if (spec_length < (sizeof(spec) - 2)) {
+                    spec[spec_length++] = *p;
+                } else {
+                    supported = false;
+                }
+            }
+            longs += (*p == 'l') ? 1 : 0;
+            p++;
+        }
+
+        char conversion = *p;
+        if (conversion != '\0') {
+            p++;
+        }
+
+        if (supported && (longs < 2) && is_one_of(conversion, "diuxXoc") && (next < argc)) {
+            spec[spec_length++] = conversion;
+            spec[spec_length]   = '\0';
+            length              = append_argument(out, size, length, spec, conversion, args[next++]);
+        } else {
+            length = append_text(out, size, length, start, (size_t)(p - start));
+        }
+    }
+
+    out[length] = '\0';
+    return length;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+/**
+ * @file log_codec.h
+ * @brief Binary log records and deferred message formatting.
+ *
+ * A deferred log message stores only the address of its format string and
+ * up to LOG_CODEC_MAX_ARGS raw 32-bit arguments; the text is built later, by
+ * the logger task with log_codec_format() or on the host from the firmware
+ * ELF. With the UDP_BINARY output, every message is sent as one record; all
+ * fields are little-endian:
+ *
+ * | Offset | Size | Field                                                 |
+ * |--------|------|-------------------------------------------------------|
+ * | 0      | 1    | magic, LOG_CODEC_MAGIC                                |
+ * | 1      | 1    | log level (log_level_et)                              |
+ * | 2      | 1    | task index (task handler) or LOG_CODEC_TASK_UNKNOWN   |
+ * | 3      | 1    | payload length in bytes                               |
+ * | 4      | 4    | timestamp, milliseconds since boot                    |
+ * | 8      | 4    | format string address, 0 for a formatted message      |
+ * | 12     | 4    | tag string address                                    |
+ * | 16     | n    | payload                                               |
+ *
+ * The payload of a deferred message is its arguments, 4 bytes each; the
+ * payload of a formatted message is its text, without terminator. Format
+ * and tag addresses point into the firmware's read-only data, so the host
+ * decoder (test/tools/log_decoder.py) reads both strings from the ELF.
+ *
+ * Deferred formats may only use the integer conversions `d i u x X o c`,
+ * with flags, width, precision and the `h`, `hh`, `l`, `z` and `t`
+ * modifiers, since every argument is 32 bits wide on the ESP32. Other
+ * conversions are printed as written. The module has no RTOS dependency so
+ * it can be built on the host.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernel/error/error_num.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOG_CODEC_MAGIC 0xA5         ///< First byte of every binary record.
+#define LOG_CODEC_HEADER_SIZE 16     ///< Size in bytes of the header of a binary record.
+#define LOG_CODEC_MAX_ARGS 6         ///< Most arguments a deferred message carries.
+#define LOG_CODEC_TASK_UNKNOWN 0xFF  ///< Task index of a message logged outside the task handler's tasks.
+
+/**
+ * @brief Header fields of a binary record.
+ */
+typedef struct log_codec_header_s {
+    uint8_t level;       ///< log_level_et of the message.
+    uint8_t task;        ///< Task index, LOG_CODEC_TASK_UNKNOWN if not known.
+    uint32_t timestamp;  ///< Milliseconds since boot.
+    uint32_t format;     ///< Format string address, 0 for a formatted message.
+    uint32_t tag;        ///< Tag string address.
+} log_codec_header_st;
+
+/**
+ * @brief Encodes a binary record.
+ *
+ * @param out            Output buffer.
+ * @param size           Size of the output buffer in bytes.
+ * @param header         Header fields.
+ * @param payload        Arguments or text of the message.
+ * @param payload_length Size of the payload in bytes, at most 255.
+ * @param length         Size of the record in bytes.
+ * @return kernel_error_st
+ *         - KERNEL_SUCCESS on success
+ *         - KERNEL_ERROR_NULL if a pointer is null
+ *         - KERNEL_ERROR_INVALID_SIZE if the payload is longer than 255 bytes
+ *         - KERNEL_ERROR_BUFFER_TOO_SHORT if the record does not fit in `size`
+ */
+kernel_error_st log_codec_encode(uint8_t *out,
+                                 size_t size,
+                                 const log_codec_header_st *header,
+                                 const void *payload,
+                                 size_t payload_length,
+                                 size_t *length);
+
+/**
+ * @brief Formats a deferred message as snprintf() would have.
+ *
+ * Conversions beyond the last argument, and conversions a deferred message
+ * cannot carry, are copied as written. The text is truncated to fit `size`
+ * and always terminated.
+ *
+ * @param out    Output buffer.
+ * @param size   Size of the output buffer in bytes, at least 1.
+ * @param format Format string of the message.
+ * @param args   Raw arguments.
+ * @param argc   Number of arguments.
+ * @return Length of the text, terminator excluded.
+ */
+size_t log_codec_format(char *out, size_t size, const char *format, const uint32_t *args, uint8_t argc);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,72 @@
+#include "log_ring.h"
+
+void log_ring_init(log_ring_st *ring) {
+    for (uint32_t i = 0; i < LOG_RING_SLOTS; i++) {
+        atomic_init(&ring->sequence[i], i);
+    }
+
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->dropped, 0);
+}
+
+bool log_ring_reserve(log_ring_st *ring, bool urgent, uint32_t *position) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    for (;;) {
+        uint32_t sequence = atomic_load_explicit(&ring->sequence[log_ring_slot(head)], memory_order_acquire);
+        int32_t lag       = (int32_t)(sequence - head);
+
+        if (lag < 0) {
+            break;
+        }
+
+        if (lag > 0) {
+            head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+            continue;
+        }
+
+        if (!urgent) {
+            uint32_t used = head - atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            if (used >= (LOG_RING_SLOTS - LOG_RING_RESERVED_SLOTS)) {
+                break;
+            }
+        }
+
+        if (atomic_compare_exchange_weak_explicit(&ring->head, &head, head + 1, memory_order_relaxed, memory_order_relaxed)) {
+            *position = head;
+            return true;
+        }
+    }
+
+    atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+    return false;
+}
+
+void log_ring_commit(log_ring_st *ring, uint32_t position) {
+    atomic_store_explicit(&ring->sequence[log_ring_slot(position)], position + 1, memory_order_release);
+}
+
+bool log_ring_peek(log_ring_st *ring, uint32_t *position) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    if (atomic_load_explicit(&ring->sequence[log_ring_slot(tail)], memory_order_acquire) != (tail + 1)) {
+        return false;
+    }
+
+    *position = tail;
+    return true;
+}
+
+void log_ring_release(log_ring_st *ring, uint32_t position) {
+    atomic_store_explicit(&ring->sequence[log_ring_slot(position)], position + LOG_RING_SLOTS, memory_order_release);
+    atomic_store_explicit(&ring->tail, position + 1, memory_order_relaxed);
+}
+
+bool log_ring_is_empty(log_ring_st *ring) {
+    return atomic_load_explicit(&ring->tail, memory_order_relaxed) == atomic_load_explicit(&ring->head, memory_order_relaxed);
+}
+
+uint32_t log_ring_dropped(log_ring_st *ring) {
+    return atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+/**
+ * @file log_ring.h
+ * @brief Lock-free multi-producer, single-consumer ring of log slots.
+ *
+ * The ring hands out positions; the caller keeps the records in its own
+ * array of LOG_RING_SLOTS entries, indexed with log_ring_slot(). A producer
+ * reserves a position without blocking, fills the record and commits it;
+ * the single consumer takes committed positions in order and releases each
+ * slot once it is done with the record.
+ *
+ * Each slot carries a sequence number that tells producers and the consumer
+ * who owns it: it equals the position when the slot is free for that
+ * position and the position plus one once the record is committed.
+ * Producers race for the head with a compare-and-swap. A reserved slot that
+ * is not yet committed stops the consumer, so records come out in the order
+ * their positions were reserved.
+ *
+ * Reservations that find the ring full are counted as dropped. Requests that
+ * are not urgent are also refused while no more than LOG_RING_RESERVED_SLOTS
+ * slots are free, so a burst of chatter leaves room for the warnings and
+ * errors that explain it. The module has no RTOS dependency so it can be
+ * built on the host.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define LOG_RING_SLOTS (32)          ///< Records the ring holds; a power of two.
+#define LOG_RING_RESERVED_SLOTS (4)  ///< Slots only urgent records may take.
+
+_Static_assert((LOG_RING_SLOTS & (LOG_RING_SLOTS - 1)) == 0, "LOG_RING_SLOTS must be a power of two");
+_Static_assert(LOG_RING_RESERVED_SLOTS < LOG_RING_SLOTS, "The ring must have unreserved slots");
+
+/**
+ * @brief Ring state; the records live with the caller.
+ */
+typedef struct log_ring_s {
+    atomic_uint sequence[LOG_RING_SLOTS];  ///< Ownership of each slot, see above.
+    atomic_uint head;                      ///< Next position a producer reserves.
+    atomic_uint tail;                      ///< Next position the consumer takes.
+    atomic_uint dropped;                   ///< Reservations refused.
+} log_ring_st;
+
+/**
+ * @brief Index in the caller's record array of a ring position.
+ */
+static inline uint32_t log_ring_slot(uint32_t position) {
+    return position & (LOG_RING_SLOTS - 1);
+}
+
+/**
+ * @brief Empties the ring and clears the dropped count.
+ *
+ * Must not run while producers or the consumer use the ring.
+ *
+ * @param ring Ring to initialize.
+ */
+void log_ring_init(log_ring_st *ring);
+
+/**
+ * @brief Reserves the slot of the next record without blocking.
+ *
+ * @param ring     Ring to reserve in.
+ * @param urgent   Whether the record may take one of the LOG_RING_RESERVED_SLOTS last slots.
+ * @param position Ring position of the reserved slot.
+ * @return true if the slot is reserved; false if the record must be dropped, which is counted.
+ */
+bool log_ring_reserve(log_ring_st *ring, bool urgent, uint32_t *position);
+
+/**
+ * @brief Hands a filled slot to the consumer.
+ *
+ * @param ring     Ring the slot was reserved in.
+ * @param position Position returned by log_ring_reserve().
+ */
+void log_ring_commit(log_ring_st *ring, uint32_t position);
+
+/**
+ * @brief Gets the next committed record, for the consumer only.
+ *
+ * @param ring     Ring to read.
+ * @param position Ring position of the record.
+ * @return true if the next record is committed; false if the ring is empty
+ *         or the next record is still being filled.
+ */
+bool log_ring_peek(log_ring_st *ring, uint32_t *position);
+
+/**
+ * @brief Frees the slot of the record returned by log_ring_peek(), for the consumer only.
+ *
+ * @param ring     Ring to release in.
+ * @param position Position returned by log_ring_peek().
+ */
+void log_ring_release(log_ring_st *ring, uint32_t position);
+
+/**
+ * @brief Whether every reserved slot was released.
+ */
+bool log_ring_is_empty(log_ring_st *ring);
+
+/**
+ * @brief Reservations refused since log_ring_init().
+ */
+uint32_t log_ring_dropped(log_ring_st *ring);
@@ -0,0 +1,264 @@
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <stdatomic.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "log_udp.h"
+
+#include "kernel/logger/logger.h"
+
+static const char *TAG = "Log UDP";
+
+static SemaphoreHandle_t destination_mutex         = NULL;             ///< Guards `host`.
+static char host[LOG_UDP_HOST_MAXIMUM_LENGTH]      = LOGGER_UDP_HOST;  ///< Host name to resolve.
+static atomic_uint port                            = LOGGER_UDP_PORT;  ///< Destination port.
+static atomic_uint address                         = 0;                ///< Resolved IPv4 address, network order; 0 until resolved.
+static TaskHandle_t resolver_task                  = NULL;             ///< Resolver task handle, NULL until it runs.
+static int sock                                    = -1;               ///< Non-blocking socket, opened on first use.
+static uint8_t datagram[LOG_UDP_DATAGRAM_SIZE]     = {0};              ///< Pending datagram.
+static size_t datagram_length                      = 0;                ///< Bytes in the pending datagram.
+static TickType_t datagram_started                 = 0;                ///< Tick of the first line of the pending datagram.
+static TickType_t backoff                          = 0;                ///< Current backoff, 0 while sends succeed.
+static TickType_t backoff_started                  = 0;                ///< Tick of the last failure.
+
+/**
+ * @brief Opens the socket once, non-blocking so a full lwIP buffer never stalls the logger task.
+ */
+static kernel_error_st open_socket(void) {
+    if (sock >= 0) {
+        return KERNEL_SUCCESS;
+    }
+
+    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+    if (sock < 0) {
+        return KERNEL_ERROR_SOCK_CREATE_FAIL;
+    }
+
+    int flags = fcntl(sock, F_GETFL, 0);
+    if ((flags < 0) || (fcntl(sock, F_SETFL, flags | O_NONBLOCK) < 0)) {
+        close(sock);
+        sock = -1;
+        return KERNEL_ERROR_SOCK_CREATE_FAIL;
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Starts or doubles the backoff after a failed send.
+ */
+static void start_backoff(void) {
+    if (backoff == 0) {
+        backoff = pdMS_TO_TICKS(LOG_UDP_BACKOFF_MIN_MS);
+    } else if (backoff < pdMS_TO_TICKS(LOG_UDP_BACKOFF_MAX_MS / 2)) {
+        backoff *= 2;
+    } else {
+        backoff = pdMS_TO_TICKS(LOG_UDP_BACKOFF_MAX_MS);
+    }
+
+    backoff_started = xTaskGetTickCount();
+}
+
+/**
+ * @brief Remaining backoff in ticks, 0 once it ran out or if none is running.
+ */
+static TickType_t backoff_remaining(void) {
+    if (backoff == 0) {
+        return 0;
+    }
+
+    TickType_t waited = xTaskGetTickCount() - backoff_started;
+    return (waited >= backoff) ? 0 : (backoff - waited);
+}
+
+/**
+ * @brief Sends the pending datagram.
+ *
+ * The datagram is kept until a send succeeds, so a transient failure such as
+ * a full lwIP buffer loses nothing; the backoff delays the next attempt and
+ * keeps the logger on the serial console meanwhile.
+ */
+static kernel_error_st flush_datagram(void) {
+    if (datagram_length == 0) {
+        return KERNEL_SUCCESS;
+    }
+
+    uint32_t destination = atomic_load_explicit(&address, memory_order_relaxed);
+    if (destination == 0) {
+        return KERNEL_ERROR_FAIL;
+    }
+
+    if (open_socket() != KERNEL_SUCCESS) {
+        start_backoff();
+        return KERNEL_ERROR_FAIL;
+    }
+
+    struct sockaddr_in dest_addr = {0};
+    dest_addr.sin_family         = AF_INET;
+    dest_addr.sin_port           = htons((uint16_t)atomic_load_explicit(&port, memory_order_relaxed));
+    dest_addr.sin_addr.s_addr    = destination;
+
+    if (sendto(sock, datagram, datagram_length, 0, (struct sockaddr *)&dest_addr, sizeof(dest_addr)) < 0) {
+        if ((errno == EBADF) || (errno == ENOTSOCK)) {
+            close(sock);
+            sock = -1;
+        }
+        start_backoff();
+        return KERNEL_ERROR_FAIL;
+    }
+
+    datagram_length = 0;
+    backoff         = 0;
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Resolves a host name to an IPv4 address.
+ *
+ * @return The address in network order, 0 if the host cannot be resolved.
+ */
+static uint32_t resolve(const char *name) {
+    struct addrinfo hints = {0}, *res = NULL;
+    hints.ai_family       = AF_INET;
+    hints.ai_socktype     = SOCK_DGRAM;
+
+    if ((getaddrinfo(name, NULL, &hints, &res) != 0) || (res == NULL)) {
+        return 0;
+    }
+
+    uint32_t resolved = ((struct sockaddr_in *)res->ai_addr)->sin_addr.s_addr;
+    freeaddrinfo(res);
+
+    return resolved;
+}
+
+kernel_error_st log_udp_initialize(void) {
+    if (destination_mutex == NULL) {
+        destination_mutex = xSemaphoreCreateMutex();
+    }
+
+    if (destination_mutex == NULL) {
+        return KERNEL_ERROR_MUTEX_INIT_FAIL;
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+kernel_error_st log_udp_set_destination(const char *name, uint16_t destination_port) {
+    if (name == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (strlen(name) >= sizeof(host)) {
+        return KERNEL_ERROR_STRING_OVERFLOW;
+    }
+
+    if ((destination_mutex == NULL) || (xSemaphoreTake(destination_mutex, portMAX_DELAY) != pdTRUE)) {
+        return KERNEL_ERROR_FAILED_TO_LOCK;
+    }
+
+    strcpy(host, name);
+    atomic_store_explicit(&port, destination_port, memory_order_relaxed);
+    atomic_store_explicit(&address, 0, memory_order_relaxed);
+    xSemaphoreGive(destination_mutex);
+
+    TaskHandle_t task = resolver_task;
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+bool log_udp_available(void) {
+    if (atomic_load_explicit(&address, memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    return backoff_remaining() == 0;
+}
+
+kernel_error_st log_udp_append(const void *data, size_t length) {
+    if (length > sizeof(datagram)) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
+    if (((datagram_length + length) > sizeof(datagram)) && (flush_datagram() != KERNEL_SUCCESS)) {
+        return KERNEL_ERROR_FAIL;
+    }
+
+    if (datagram_length == 0) {
+        datagram_started = xTaskGetTickCount();
+    }
+
+    memcpy(datagram + datagram_length, data, length);
+    datagram_length += length;
+
+    return KERNEL_SUCCESS;
+}
+
+void log_udp_poll(void) {
+    if ((datagram_length > 0) && (log_udp_time_to_flush() == 0)) {
+        flush_datagram();
+    }
+}
+
+TickType_t log_udp_time_to_flush(void) {
+    if ((datagram_length == 0) || (atomic_load_explicit(&address, memory_order_relaxed) == 0)) {
+        return portMAX_DELAY;
+    }
+
+    TickType_t remaining = backoff_remaining();
+    if (remaining > 0) {
+        return remaining;
+    }
+
+    TickType_t waited = xTaskGetTickCount() - datagram_started;
+    TickType_t limit  = pdMS_TO_TICKS(LOG_UDP_FLUSH_MS);
+
+    return (waited >= limit) ? 0 : (limit - waited);
+}
+
+bool log_udp_idle(void) {
+    return datagram_length == 0;
+}
+
+void log_udp_resolver_task_execute(void *pvParameters) {
+    global_structures_st *global_structures = (global_structures_st *)pvParameters;
+    TickType_t retry                        = pdMS_TO_TICKS(LOG_UDP_BACKOFF_MIN_MS);
+    char name[LOG_UDP_HOST_MAXIMUM_LENGTH];
+
+    if ((global_structures == NULL) || (global_structures->global_events.firmware_event_group == NULL) ||
+        (log_udp_initialize() != KERNEL_SUCCESS)) {
+        logger_print(ERR, TAG, "Failed to start the log resolver");
+        vTaskDelete(NULL);
+    }
+
+    resolver_task = xTaskGetCurrentTaskHandle();
+
+    while (1) {
+        xEventGroupWaitBits(global_structures->global_events.firmware_event_group, STA_GOT_IP, pdFALSE, pdTRUE, portMAX_DELAY);
+
+        xSemaphoreTake(destination_mutex, portMAX_DELAY);
+        strcpy(name, host);
+        xSemaphoreGive(destination_mutex);
+
+        uint32_t resolved = resolve(name);
+        TickType_t wait   = pdMS_TO_TICKS(LOG_UDP_RESOLVE_INTERVAL_MS);
+
+        if (resolved != 0) {
+            atomic_store_explicit(&address, resolved, memory_order_relaxed);
+            retry = pdMS_TO_TICKS(LOG_UDP_BACKOFF_MIN_MS);
+        } else {
+            logger_print(WARN, TAG, "Failed to resolve log host %s", name);
+            wait  = retry;
+            retry = (retry < pdMS_TO_TICKS(LOG_UDP_BACKOFF_MAX_MS / 2)) ? (retry * 2) : pdMS_TO_TICKS(LOG_UDP_BACKOFF_MAX_MS);
+        }
+
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+/**
+ * @file log_udp.h
+ * @brief UDP transport of the logger.
+ *
+ * Log lines, or binary records with the UDP_BINARY output, are packed into
+ * datagrams of up to LOG_UDP_DATAGRAM_SIZE bytes, sent through one
+ * non-blocking socket when full or LOG_UDP_FLUSH_MS after their first line.
+ * The destination host is resolved by the low-priority log resolver task,
+ * never by the logger task, and resolved again every
+ * LOG_UDP_RESOLVE_INTERVAL_MS. After a failed send, the datagram is kept and
+ * sent again once a backoff, doubling up to LOG_UDP_BACKOFF_MAX_MS, runs out;
+ * the logger writes to the serial console meanwhile.
+ *
+ * Only the logger task sends; the destination may be changed from any task.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "kernel/error/error_num.h"
+#include "kernel/inter_task_communication/inter_task_communication.h"
+#include "kernel/tasks/tasks_definition.h"
+
+#ifndef LOGGER_UDP_HOST
+#define LOGGER_UDP_HOST "logs5.papertrailapp.com"  ///< Default log host; `-DLOGGER_UDP_HOST=\"192.168.1.10\"` for a local listener.
+#endif
+
+#ifndef LOGGER_UDP_PORT
+#define LOGGER_UDP_PORT (20770)  ///< Default log port; test/tools/udp_listener.py listens on 5657.
+#endif
+
+#define LOG_UDP_HOST_MAXIMUM_LENGTH (64)                 ///< Longest host name, terminator included.
+#define LOG_UDP_DATAGRAM_SIZE (1400)                     ///< Largest datagram payload, below the 1472 bytes an Ethernet MTU leaves.
+#define LOG_UDP_FLUSH_MS (250)                           ///< Longest time a line waits in a partly filled datagram.
+#define LOG_UDP_RESOLVE_INTERVAL_MS (10 * 60 * 1000)     ///< Time between two resolutions of the host.
+#define LOG_UDP_BACKOFF_MIN_MS (1000)                    ///< First wait after a failure.
+#define LOG_UDP_BACKOFF_MAX_MS (60 * 1000)               ///< Longest wait after repeated failures.
+
+/**
+ * @brief Creates the lock of the destination; called by logger_initialize().
+ *
+ * @return KERNEL_SUCCESS on success, KERNEL_ERROR_MUTEX_INIT_FAIL if the mutex cannot be created.
+ */
+kernel_error_st log_udp_initialize(void);
+
+/**
+ * @brief Changes the host and port logs are sent to.
+ *
+ * The new host is resolved by the log resolver task; until then, logs go to
+ * the serial console.
+ *
+ * @param host Host name or dotted IPv4 address, copied.
+ * @param port UDP port.
+ * @return KERNEL_SUCCESS on success, KERNEL_ERROR_NULL if host is NULL,
+ *         KERNEL_ERROR_STRING_OVERFLOW if the host is longer than LOG_UDP_HOST_MAXIMUM_LENGTH - 1,
+ *         KERNEL_ERROR_FAILED_TO_LOCK if log_udp_initialize() was not called.
+ */
+kernel_error_st log_udp_set_destination(const char *host, uint16_t port);
+
+/**
+ * @brief Whether the host is resolved and no backoff is running.
+ */
+bool log_udp_available(void);
+
+/**
+ * @brief Adds data to the pending datagram, sending the datagram first if the data does not fit.
+ *
+ * @param data   Line or binary record; lines carry their own newline.
+ * @param length Size of the data in bytes, at most LOG_UDP_DATAGRAM_SIZE.
+ * @return KERNEL_SUCCESS once queued, KERNEL_ERROR_INVALID_SIZE if the data is larger
+ *         than a datagram, KERNEL_ERROR_FAIL if the pending datagram could not be sent;
+ *         it is kept for the next attempt and the data is not queued.
+ */
+kernel_error_st log_udp_append(const void *data, size_t length);
+
+/**
+ * @brief Sends the pending datagram if it waited LOG_UDP_FLUSH_MS.
+ */
+void log_udp_poll(void);
+
+/**
+ * @brief Ticks until the pending datagram is due, backoff included; portMAX_DELAY if there is none or the host is not resolved.
+ */
+TickType_t log_udp_time_to_flush(void);
+
+/**
+ * @brief Whether no datagram is pending.
+ */
+bool log_udp_idle(void);
+
+/**
+ * @brief Task resolving the log host.
+ *
+ * Waits for the station to get an IP address, resolves the host, then
+ * sleeps LOG_UDP_RESOLVE_INTERVAL_MS, or a backoff after a failure, unless
+ * log_udp_set_destination() wakes it.
+ *
+ * @param pvParameters Pointer to the global structures.
+ */
+void log_udp_resolver_task_execute(void *pvParameters);
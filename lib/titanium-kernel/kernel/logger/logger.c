@@ -1,54 +1,76 @@
-#include <arpa/inet.h>
-#include <netdb.h>
-#include <netinet/in.h>
-#include <sys/socket.h>
+#include <stdatomic.h>
 
 #include "logger.h"
 
+#include "kernel/logger/log_codec.h"
+#include "kernel/logger/log_ring.h"
+#include "kernel/logger/log_udp.h"
+#include "kernel/tasks/manager/task_handler.h"
+
 #define LOGGER_MAX_MSG_HEADER_LEN (64)                                               ///< Message Header 128 bytes
 #define LOGGER_MAX_MSG_BODY_LEN (256)                                                ///< Message Body 896 bytes
 #define LOGGER_MAX_PACKET_LEN (LOGGER_MAX_MSG_HEADER_LEN + LOGGER_MAX_MSG_BODY_LEN)  ///< Maximum Packet 1024 bytes
-#define LOGGER_UDP_HOST "logs5.papertrailapp.com"                                    ///< Papertrail hostname
-#define LOGGER_UDP_PORT (20770)                                                      ///< Papertrail port
+#define LOGGER_TAG_LEVELS (16)                                                       ///< Tags whose level may differ from the default
+#define LOGGER_RATE_LIMIT_TAGS (32)                                                  ///< Tags the rate limiter tracks; a power of two
+#define LOGGER_RATE_LIMIT_MESSAGES (20)                                              ///< Messages a tag may log per window
+#define LOGGER_RATE_LIMIT_WINDOW_MS (10000)                                          ///< Length of a rate limit window
 
-static log_output_et _log_output                = SERIAL;                   ///< Log output channel (serial or UDP).
-static release_mode_et _release_mode            = RELEASE_MODE_PRODUCTION;  ///< Current release mode of the system.
-static global_structures_st* _global_structures = NULL;                     ///< Pointer to the global configuration structure.
-static SemaphoreHandle_t logger_mutex           = NULL;                     ///< Mutex used for ensuring thread safety during UDP packet send operations.
-static struct sockaddr_in dest_addr             = {0};                      ///< Destination address structure for the UDP server.
-static int sock                                 = -1;                       ///< UDP socket descriptor used for sending data.
+_Static_assert((LOGGER_RATE_LIMIT_TAGS & (LOGGER_RATE_LIMIT_TAGS - 1)) == 0, "LOGGER_RATE_LIMIT_TAGS must be a power of two");
 
 /**
- * @brief Sends a UDP packet to the specified destination.
- *
- * This function sends the provided packet to the destination address using the
- * previously opened UDP socket. The function ensures thread safety by using a
- * semaphore to prevent concurrent access to the socket. If the packet or the socket
- * is invalid, the function returns an error.
+ * @brief One record of the log ring, formatted or deferred.
  *
- * @param packet The packet to send.
- * @return ESP_OK on success, ESP_FAIL or other error codes on failure.
+ * A deferred record keeps its format and raw arguments; the drain task
+ * formats it.
  */
-static kernel_error_st send_udp_packet(const char* packet) {
-    if (sock < 0) {
-        return KERNEL_ERROR_FAIL;
-    }
+typedef struct log_record_s {
+    log_level_et level;    ///< Severity of the record.
+    const char* tag;       ///< Tag of the record; tags have static storage.
+    const char* format;    ///< Format of a deferred record, NULL for a formatted one.
+    TaskHandle_t task;     ///< Task that logged the record.
+    uint32_t timestamp;    ///< Milliseconds since boot.
+    uint8_t argc;          ///< Arguments of a deferred record.
+    union {
+        char body[LOGGER_MAX_MSG_BODY_LEN];  ///< Formatted message body.
+        uint32_t args[LOG_CODEC_MAX_ARGS];   ///< Raw arguments of a deferred record.
+    };
+} log_record_st;
 
-    if (packet == NULL) {
-        return KERNEL_ERROR_INVALID_ARG;
-    }
+/**
+ * @brief Least severe level logged for one tag.
+ */
+typedef struct tag_level_s {
+    const char* tag;   ///< Tag, with static storage.
+    uint8_t severity;  ///< LOGGER_SEVERITY() of the least severe level logged.
+} tag_level_st;
 
-    if (logger_mutex && xSemaphoreTake(logger_mutex, portMAX_DELAY)) {
-        int sent = sendto(sock, packet, strlen(packet), 0, (struct sockaddr*)&dest_addr, sizeof(dest_addr));
-        xSemaphoreGive(logger_mutex);
+/**
+ * @brief Rate limiter state of one tag.
+ *
+ * Producers update the atomic fields without locking; `reported_window` is
+ * only touched by the drain task.
+ */
+typedef struct tag_rate_s {
+    atomic_uintptr_t tag;      ///< Address of the tag, 0 while the entry is free.
+    atomic_uint window;        ///< Window the count belongs to.
+    atomic_uint count;         ///< Messages logged in the window.
+    atomic_uint suppressed;    ///< Messages suppressed and not reported yet.
+    uint32_t reported_window;  ///< Window of the last summary.
+} tag_rate_st;
 
-        if (sent < 0) {
-            return KERNEL_ERROR_FAIL;
-        }
-    }
+static log_output_et _log_output                = SERIAL;                   ///< Log output channel (serial or UDP).
+static global_structures_st* _global_structures = NULL;                     ///< Pointer to the global configuration structure.
+static SemaphoreHandle_t logger_mutex           = NULL;                     ///< Mutex used for ensuring thread safety during serial writes and level changes.
 
-    return KERNEL_SUCCESS;
-}
+static log_ring_st log_ring;                       ///< Slots of the records waiting for the drain task.
+static log_record_st log_records[LOG_RING_SLOTS];  ///< Records, indexed by log_ring_slot().
+static TaskHandle_t drain_task = NULL;             ///< Drain task handle, NULL until it runs.
+
+static tag_level_st tag_levels[LOGGER_TAG_LEVELS];            ///< Levels set apart from the default, by tag.
+static atomic_uint tag_level_count   = 0;                     ///< Entries of tag_levels in use.
+static uint8_t default_severity      = LOGGER_SEVERITY(INFO);  ///< LOGGER_SEVERITY() of the least severe level logged by default.
+static atomic_uint filter_generation = 1;                     ///< Bumped on every level change, invalidates call site caches.
+static tag_rate_st tag_rates[LOGGER_RATE_LIMIT_TAGS];         ///< Rate limiter entries, open addressing on the tag address.
 
 /**
  * @brief Sends a log message to the serial console.
@@ -86,41 +108,14 @@ static bool is_station_connected(void) {
 }
 
 /**
- * @brief Opens a UDP socket and resolves the destination hostname to an IP address.
- *
- * This function initializes a UDP socket for logging, resolving the provided hostname
- * dynamically to support non-static IPs (e.g., Papertrail servers). If the hostname
- * resolution or socket creation fails, it returns an error.
+ * @brief Whether a record may go to UDP now.
  *
- * @return ESP_OK on success, ESP_FAIL on failure.
+ * Only the drain task sends over the network, so a caller logging before
+ * the drain task starts never waits on the socket; the host must also be
+ * resolved and no send backoff running.
  */
-static kernel_error_st open_udp_socket(void) {
-    struct addrinfo hints = {0}, *res;
-    hints.ai_family       = AF_INET;
-    hints.ai_socktype     = SOCK_DGRAM;
-
-    // Resolve hostname to IP
-    if (getaddrinfo(LOGGER_UDP_HOST, NULL, &hints, &res) != 0) {
-        return KERNEL_ERROR_FAIL;
-    }
-
-    if (res == NULL) {
-        return KERNEL_ERROR_NO_MEM;
-    }
-
-    struct sockaddr_in* addr = (struct sockaddr_in*)res->ai_addr;
-    dest_addr.sin_addr       = addr->sin_addr;
-    dest_addr.sin_family     = AF_INET;
-    dest_addr.sin_port       = htons(LOGGER_UDP_PORT);
-
-    freeaddrinfo(res);
-
-    sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
-    if (sock < 0) {
-        return KERNEL_ERROR_SOCK_CREATE_FAIL;
-    }
-
-    return KERNEL_SUCCESS;
+static bool udp_ready(void) {
+    return (drain_task != NULL) && (xTaskGetCurrentTaskHandle() == drain_task) && is_station_connected() && log_udp_available();
 }
 
 /**
@@ -145,24 +140,273 @@ static kernel_error_st logger_send_message(const char* level, const char* tag, c
         return ESP_ERR_INVALID_ARG;
     }
 
-    int message_size = snprintf(final_message, sizeof(final_message), "%s %s: %s", level, tag, message);
-    if (message_size >= LOGGER_MAX_MSG_BODY_LEN) {
+    int message_size = snprintf(final_message, sizeof(final_message), "%s %s: %s\n", level, tag, message);
+    if ((message_size - 1) >= LOGGER_MAX_MSG_BODY_LEN) {  // The newline does not count against the limit
         return ESP_ERR_INVALID_SIZE;
     }
 
-    if (!is_station_connected() || _log_output == SERIAL) {
-        return send_serial_packet(final_message);
+    if ((_log_output == UDP) && udp_ready() && (log_udp_append(final_message, (size_t)message_size) == KERNEL_SUCCESS)) {
+        return KERNEL_SUCCESS;
+    }
+
+    final_message[message_size - 1] = '\0';
+    return send_serial_packet(final_message);
+}
+
+/**
+ * @brief Maps a log level to the prefix printed in front of the tag.
+ *
+ * @return The prefix, or NULL for an unknown level.
+ */
+static const char* level_prefix(log_level_et log_level) {
+    switch (log_level) {
+        case INFO:
+            return "[INFO]";
+        case WARN:
+            return "[WARN]";
+        case ERR:
+            return "[ERROR]";
+        case DEBUG:
+            return "[DEBUG]";
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief Adds a record to the pending UDP datagram as a binary record, see log_codec.h.
+ *
+ * @return KERNEL_SUCCESS once queued, an error code if the record must go
+ *         through the text output instead.
+ */
+static kernel_error_st send_binary_record(const log_record_st* record) {
+    uint8_t packet[LOG_CODEC_HEADER_SIZE + LOGGER_MAX_MSG_BODY_LEN];
+    size_t length = 0;
+    int task      = task_handler_find_task(record->task);
+
+    log_codec_header_st header = {
+        .level     = (uint8_t)record->level,
+        .task      = ((task >= 0) && (task < LOG_CODEC_TASK_UNKNOWN)) ? (uint8_t)task : LOG_CODEC_TASK_UNKNOWN,
+        .timestamp = record->timestamp,
+        .format    = (uint32_t)(uintptr_t)record->format,
+        .tag       = (uint32_t)(uintptr_t)record->tag,
+    };
+
+    kernel_error_st err;
+    if (record->format != NULL) {
+        err = log_codec_encode(packet, sizeof(packet), &header, record->args, record->argc * sizeof(uint32_t), &length);
+    } else {
+        err = log_codec_encode(packet, sizeof(packet), &header, record->body, strnlen(record->body, sizeof(record->body) - 1), &length);
+    }
+
+    if (err != KERNEL_SUCCESS) {
+        return err;
     }
 
-    esp_err_t result = send_udp_packet(final_message);
+    return log_udp_append(packet, length);
+}
+
+/**
+ * @brief Sends a record to the configured output, formatting it first if it is deferred.
+ */
+static void send_record(const log_record_st* record) {
+    if ((_log_output == UDP_BINARY) && udp_ready() && (send_binary_record(record) == KERNEL_SUCCESS)) {
+        return;
+    }
+
+    if (record->format == NULL) {
+        logger_send_message(level_prefix(record->level), record->tag, record->body);
+        return;
+    }
+
+    char message_body[LOGGER_MAX_MSG_BODY_LEN];
+    log_codec_format(message_body, sizeof(message_body), record->format, record->args, record->argc);
+    logger_send_message(level_prefix(record->level), record->tag, message_body);
+}
+
+/**
+ * @brief Fills the fields every record carries.
+ */
+static void stamp_record(log_record_st* record, log_level_et log_level, const char* tag) {
+    record->level     = log_level;
+    record->tag       = tag;
+    record->task      = xTaskGetCurrentTaskHandle();
+    record->timestamp = (uint32_t)pdTICKS_TO_MS(xTaskGetTickCount());
+}
+
+/**
+ * @brief Returns the LOGGER_SEVERITY() of the least severe level logged for a tag.
+ *
+ * Tags are matched by address first, so the common case never compares
+ * strings; with no level set per tag, this is a single load.
+ */
+static uint8_t tag_severity(const char* tag) {
+    uint32_t count = atomic_load_explicit(&tag_level_count, memory_order_acquire);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if ((tag_levels[i].tag == tag) || (strcmp(tag_levels[i].tag, tag) == 0)) {
+            return tag_levels[i].severity;
+        }
+    }
+
+    return default_severity;
+}
+
+/**
+ * @brief Current rate limit window.
+ */
+static uint32_t rate_limit_window(void) {
+    return (uint32_t)(pdTICKS_TO_MS(xTaskGetTickCount()) / LOGGER_RATE_LIMIT_WINDOW_MS);
+}
+
+/**
+ * @brief Counts a message against its tag's budget.
+ *
+ * Each tag may log LOGGER_RATE_LIMIT_MESSAGES messages per window; the rest
+ * are counted and summarised by the drain task. If every entry is taken by
+ * other tags, the message is let through.
+ *
+ * @return true if the message may be logged.
+ */
+static bool rate_limit_allow(const char* tag) {
+    uintptr_t key   = (uintptr_t)tag;
+    uint32_t window = rate_limit_window();
+    uint32_t index  = (uint32_t)(key >> 2);
+
+    for (uint32_t probe = 0; probe < LOGGER_RATE_LIMIT_TAGS; probe++, index++) {
+        tag_rate_st* rate = &tag_rates[index & (LOGGER_RATE_LIMIT_TAGS - 1)];
+        uintptr_t owner   = atomic_load_explicit(&rate->tag, memory_order_relaxed);
+
+        if (owner == 0) {
+            if (atomic_compare_exchange_strong_explicit(&rate->tag, &owner, key, memory_order_relaxed, memory_order_relaxed)) {
+                owner = key;
+            }
+        }
+
+        if (owner != key) {
+            continue;
+        }
+
+        uint32_t last = atomic_load_explicit(&rate->window, memory_order_relaxed);
+        if ((last != window) &&
+            atomic_compare_exchange_strong_explicit(&rate->window, &last, window, memory_order_relaxed, memory_order_relaxed)) {
+            atomic_store_explicit(&rate->count, 0, memory_order_relaxed);
+        }
 
-    if (result != ESP_OK) {
-        if (open_udp_socket() != ESP_OK) {
-            return send_serial_packet(final_message);
+        if (atomic_fetch_add_explicit(&rate->count, 1, memory_order_relaxed) < LOGGER_RATE_LIMIT_MESSAGES) {
+            return true;
         }
+
+        atomic_fetch_add_explicit(&rate->suppressed, 1, memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Whether a message passes the level filter and the rate limiter, checked before formatting.
+ */
+static bool message_allowed(log_level_et log_level, const char* tag) {
+    if (LOGGER_SEVERITY(log_level) < tag_severity(tag)) {
+        return false;
+    }
+
+    return rate_limit_allow(tag);
+}
+
+/**
+ * @brief Reserves the ring slot of the next record without blocking.
+ *
+ * Only WARN and ERR records may take the last LOG_RING_RESERVED_SLOTS slots.
+ *
+ * @param log_level Level of the record.
+ * @param position  Ring position of the reserved slot.
+ * @return Pointer to the slot, or NULL if the record must be dropped; the drop is counted.
+ */
+static log_record_st* ring_reserve(log_level_et log_level, uint32_t* position) {
+    if (!log_ring_reserve(&log_ring, (log_level != INFO) && (log_level != DEBUG), position)) {
+        return NULL;
     }
 
-    return send_udp_packet(final_message);
+    return &log_records[log_ring_slot(*position)];
+}
+
+/**
+ * @brief Hands a filled slot to the drain task and wakes it.
+ */
+static void ring_commit(uint32_t position) {
+    log_ring_commit(&log_ring, position);
+
+    TaskHandle_t task = drain_task;
+    if (task != NULL) {
+        xTaskNotifyGive(task);
+    }
+}
+
+/**
+ * @brief Sends every committed record, in order, and frees its slot.
+ *
+ * Only the drain task calls this. A record reserved but not yet committed
+ * stops the pass; the next notification resumes it.
+ */
+static void ring_drain(void) {
+    uint32_t position = 0;
+
+    while (log_ring_peek(&log_ring, &position)) {
+        send_record(&log_records[log_ring_slot(position)]);
+        log_ring_release(&log_ring, position);
+    }
+}
+
+/**
+ * @brief Reports the records dropped since the last report.
+ *
+ * @param reported Dropped count at the last report, updated.
+ */
+static void report_dropped_records(uint32_t* reported) {
+    uint32_t dropped = log_ring_dropped(&log_ring);
+
+    if (dropped == *reported) {
+        return;
+    }
+
+    log_record_st record = {0};
+    stamp_record(&record, WARN, "Logger");
+    record.format  = "%lu log messages dropped";
+    record.args[0] = dropped - *reported;
+    record.argc    = 1;
+    send_record(&record);
+    *reported = dropped;
+}
+
+/**
+ * @brief Reports, at most once per window and tag, the messages the rate limiter suppressed.
+ */
+static void report_suppressed_messages(void) {
+    uint32_t window = rate_limit_window();
+
+    for (uint32_t i = 0; i < LOGGER_RATE_LIMIT_TAGS; i++) {
+        tag_rate_st* rate = &tag_rates[i];
+        uintptr_t tag     = atomic_load_explicit(&rate->tag, memory_order_relaxed);
+
+        if ((tag == 0) || (rate->reported_window == window)) {
+            continue;
+        }
+
+        uint32_t suppressed = atomic_exchange_explicit(&rate->suppressed, 0, memory_order_relaxed);
+        if (suppressed == 0) {
+            continue;
+        }
+
+        log_record_st record = {0};
+        stamp_record(&record, WARN, (const char*)tag);
+        record.format  = "%lu messages suppressed by the rate limit";
+        record.args[0] = suppressed;
+        record.argc    = 1;
+        send_record(&record);
+        rate->reported_window = window;
+    }
 }
 
 /**
@@ -183,14 +427,17 @@ static kernel_error_st logger_send_message(const char* level, const char* tag, c
  *         KERNEL_ERROR_MUTEX_INIT_FAIL if mutex creation fails.
  */
 kernel_error_st logger_initialize(release_mode_et release_mode, log_output_et log_output, global_structures_st* global_structures) {
-    _release_mode = release_mode;
-    _log_output   = log_output;
+    _log_output = log_output;
 
     if (global_structures == NULL) {
         return KERNEL_ERROR_INVALID_ARG;
     }
 
     _global_structures = global_structures;
+    default_severity   = (release_mode == RELEASE_MODE_DEBUG) ? LOGGER_SEVERITY(DEBUG) : LOGGER_SEVERITY(INFO);
+    atomic_fetch_add_explicit(&filter_generation, 1, memory_order_release);
+
+    log_ring_init(&log_ring);
 
     if (logger_mutex == NULL) {
         logger_mutex = xSemaphoreCreateMutex();
@@ -200,58 +447,206 @@ kernel_error_st logger_initialize(release_mode_et release_mode, log_output_et lo
         return KERNEL_ERROR_MUTEX_INIT_FAIL;
     }
 
+    if ((log_output == UDP) || (log_output == UDP_BINARY)) {
+        return log_udp_initialize();
+    }
+
     return KERNEL_SUCCESS;
 }
 
 /**
  * @brief Prints a formatted log message based on the log level.
  *
- * This function formats a log message and sends it to the appropriate destination (UDP or serial)
- * based on the log level (INFO, WARN, ERROR, DEBUG). The message is first validated for size and
- * checked for proper initialization before being processed and sent.
+ * Once the drain task runs, the message is formatted straight into a slot of
+ * the log ring and the call returns without waiting for serial or network
+ * I/O. If the ring has no slot for it, the message is dropped and counted.
+ * Before the drain task starts, messages are sent synchronously.
  *
  * @param log_level The severity level of the log message (INFO, WARN, ERROR, DEBUG).
  * @param tag The tag identifying the source of the log message.
  * @param format A format string for the log message.
  * @param ... Variable arguments corresponding to the format string.
  *
- * @return ESP_OK on success, ESP_FAIL if initialization or arguments are invalid,
- *         ESP_ERR_INVALID_SIZE if the message size exceeds the limit,
- *         ESP_ERR_INVALID_ARG if an invalid log level is provided.
+ * @return KERNEL_SUCCESS on success or if a DEBUG message is filtered out,
+ *         ESP_FAIL if the logger is not initialized or the tag is NULL,
+ *         KERNEL_ERROR_INVALID_ARG if an invalid log level is provided,
+ *         KERNEL_ERROR_QUEUE_FULL if the message was dropped.
  */
 kernel_error_st logger_print(log_level_et log_level, const char* tag, const char* format, ...) {
     if ((!tag) || (!_global_structures) || !_global_structures->global_events.firmware_event_group) {
         return ESP_FAIL;
     }
 
+    if (level_prefix(log_level) == NULL) {
+        return KERNEL_ERROR_INVALID_ARG;
+    }
+
+    if (!message_allowed(log_level, tag)) {
+        return KERNEL_SUCCESS;
+    }
+
     va_list args;
+
+    if (drain_task == NULL) {
+        log_record_st record = {0};
+        stamp_record(&record, log_level, tag);
+        va_start(args, format);
+        vsnprintf(record.body, sizeof(record.body), format, args);
+        va_end(args);
+
+        send_record(&record);
+        return KERNEL_SUCCESS;
+    }
+
+    uint32_t position     = 0;
+    log_record_st* record = ring_reserve(log_level, &position);
+    if (record == NULL) {
+        return KERNEL_ERROR_QUEUE_FULL;
+    }
+
+    stamp_record(record, log_level, tag);
+    record->format = NULL;
     va_start(args, format);
-    char message_body[LOGGER_MAX_MSG_BODY_LEN] = {0};
-    int body_size                              = vsnprintf(message_body, sizeof(message_body), format, args);
+    vsnprintf(record->body, sizeof(record->body), format, args);
     va_end(args);
 
-    if (body_size > LOGGER_MAX_MSG_BODY_LEN) {
+    ring_commit(position);
+
+    return KERNEL_SUCCESS;
+}
+
+kernel_error_st logger_print_deferred(log_level_et log_level, const char* tag, const char* format, const uint32_t* args, uint8_t argc) {
+    if ((!tag) || (!format) || (!_global_structures) || !_global_structures->global_events.firmware_event_group) {
+        return ESP_FAIL;
+    }
+
+    if ((level_prefix(log_level) == NULL) || ((args == NULL) && (argc > 0))) {
+        return KERNEL_ERROR_INVALID_ARG;
+    }
+
+    if (argc > LOG_CODEC_MAX_ARGS) {
         return KERNEL_ERROR_INVALID_SIZE;
     }
 
-    switch (log_level) {
-        case INFO:
-            logger_send_message("[INFO]", tag, message_body);
-            break;
-        case WARN:
-            logger_send_message("[WARN]", tag, message_body);
-            break;
-        case ERR:
-            logger_send_message("[ERROR]", tag, message_body);
-            break;
-        case DEBUG:
-            if (_release_mode == RELEASE_MODE_DEBUG) {
-                logger_send_message("[DEBUG]", tag, message_body);
-            }
-            break;
-        default:
-            return KERNEL_ERROR_INVALID_ARG;
+    if (!message_allowed(log_level, tag)) {
+        return KERNEL_SUCCESS;
+    }
+
+    log_record_st local;
+    log_record_st* record = &local;
+    uint32_t position     = 0;
+
+    if (drain_task != NULL) {
+        record = ring_reserve(log_level, &position);
+        if (record == NULL) {
+            return KERNEL_ERROR_QUEUE_FULL;
+        }
+    }
+
+    stamp_record(record, log_level, tag);
+    record->format = format;
+    record->argc   = argc;
+    if (argc > 0) {
+        memcpy(record->args, args, argc * sizeof(uint32_t));
+    }
+
+    if (record == &local) {
+        send_record(record);
+    } else {
+        ring_commit(position);
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+bool logger_is_enabled(uint32_t* site, log_level_et log_level, const char* tag) {
+    uint32_t generation = atomic_load_explicit(&filter_generation, memory_order_acquire) << 1;
+    uint32_t cached     = *site;
+
+    if ((cached & ~1U) == generation) {
+        return (cached & 1U) != 0;
+    }
+
+    bool enabled = (tag != NULL) && (LOGGER_SEVERITY(log_level) >= tag_severity(tag));
+    *site        = generation | (enabled ? 1U : 0U);
+    return enabled;
+}
+
+kernel_error_st logger_set_tag_level(const char* tag, log_level_et log_level) {
+    if (level_prefix(log_level) == NULL) {
+        return KERNEL_ERROR_INVALID_ARG;
+    }
+
+    uint8_t severity = LOGGER_SEVERITY(log_level);
+
+    if (tag == NULL) {
+        default_severity = severity;
+        atomic_fetch_add_explicit(&filter_generation, 1, memory_order_release);
+        return KERNEL_SUCCESS;
+    }
+
+    if ((logger_mutex == NULL) || (xSemaphoreTake(logger_mutex, portMAX_DELAY) != pdTRUE)) {
+        return KERNEL_ERROR_FAILED_TO_LOCK;
+    }
+
+    kernel_error_st err = KERNEL_SUCCESS;
+    uint32_t count      = atomic_load_explicit(&tag_level_count, memory_order_relaxed);
+    uint32_t i          = 0;
+
+    while ((i < count) && (strcmp(tag_levels[i].tag, tag) != 0)) {
+        i++;
+    }
+
+    if (i < count) {
+        tag_levels[i].severity = severity;
+    } else if (count < LOGGER_TAG_LEVELS) {
+        tag_levels[count].tag      = tag;
+        tag_levels[count].severity = severity;
+        atomic_store_explicit(&tag_level_count, count + 1, memory_order_release);
+    } else {
+        err = KERNEL_ERROR_NO_MEM;
+    }
+
+    xSemaphoreGive(logger_mutex);
+    atomic_fetch_add_explicit(&filter_generation, 1, memory_order_release);
+
+    return err;
+}
+
+uint32_t logger_get_dropped_count(void) {
+    return log_ring_dropped(&log_ring);
+}
+
+kernel_error_st logger_flush(TickType_t timeout) {
+    TickType_t start = xTaskGetTickCount();
+
+    while ((drain_task != NULL) &&
+           (!log_ring_is_empty(&log_ring) || !log_udp_idle())) {
+        if ((xTaskGetTickCount() - start) >= timeout) {
+            return KERNEL_ERROR_TIMEOUT;
+        }
+        vTaskDelay(1);
     }
 
     return KERNEL_SUCCESS;
 }
+
+void logger_task_execute(void* pvParameters) {
+    (void)pvParameters;
+    uint32_t reported = 0;
+
+    drain_task = xTaskGetCurrentTaskHandle();
+
+    while (1) {
+        TickType_t wait = log_udp_time_to_flush();
+        if (wait > pdMS_TO_TICKS(LOGGER_TASK_DELAY)) {
+            wait = pdMS_TO_TICKS(LOGGER_TASK_DELAY);
+        }
+
+        ulTaskNotifyTake(pdTRUE, wait);
+        ring_drain();
+        report_dropped_records(&reported);
+        report_suppressed_messages();
+        log_udp_poll();
+    }
+}
@@ -3,6 +3,7 @@
 
 #include "kernel/error/error_num.h"
 #include "kernel/inter_task_communication/inter_task_communication.h"
+#include "kernel/tasks/tasks_definition.h"
 
 /**
  * @file logger.h
@@ -12,8 +13,14 @@
  * sending log messages with different log levels (INFO, WARN, ERR, DEBUG).
  * The logger supports both serial and UDP logging, and the implementation
  * ensures that the appropriate logging method is used based on network status.
+ *
+ * Producers never wait for the output: messages go through a lock-free ring
+ * that the low-priority logger task drains to serial or UDP. When the ring is
+ * full the new message is dropped and counted.
  */
 
+#define LOGGER_FLUSH_TIMEOUT_MS (500)  ///< Longest wait for queued messages before a restart.
+
 /**
  * @enum log_output_e
  * @brief Enumeration of log output channels.
@@ -21,10 +28,12 @@
  * Defines the available output channels for log messages:
  * - SERIAL: Logs sent through the serial port.
  * - UDP: Logs transmitted over the network to a PaperTrail server.
+ * - UDP_BINARY: Binary records (see log_codec.h) decoded on the host.
  */
 typedef enum log_output_e {
     SERIAL = 0, /**< Output log messages to the serial console. */
     UDP,        /**< Output log messages to a UDP server. */
+    UDP_BINARY, /**< Output binary log records to a UDP server. */
 } log_output_et;
 
 typedef enum release_mode_e {
@@ -49,25 +58,158 @@ typedef enum log_level_e {
     DEBUG,    /**< Debug messages */
 } log_level_et;
 
+/**
+ * @brief Severity rank of a log level, DEBUG lowest and ERR highest.
+ */
+#define LOGGER_SEVERITY(log_level) ((log_level) == DEBUG ? 0 : ((log_level) == INFO ? 1 : ((log_level) == WARN ? 2 : 3)))
+
+#ifndef LOGGER_COMPILE_LEVEL
+#define LOGGER_COMPILE_LEVEL DEBUG  ///< Least severe level compiled in, e.g. `-DLOGGER_COMPILE_LEVEL=INFO` in build_flags.
+#endif
+
+/**
+ * @brief Whether a level is compiled in, see LOGGER_COMPILE_LEVEL.
+ */
+#define LOGGER_COMPILED(log_level) (LOGGER_SEVERITY(log_level) >= LOGGER_SEVERITY(LOGGER_COMPILE_LEVEL))
+
 kernel_error_st logger_initialize(release_mode_et release_mode, log_output_et log_output, global_structures_st* global_structures);
 
 /**
  * @brief Prints a log message with a specified log level.
  *
- * This function formats the log message and sends it to the appropriate
- * logging mechanism based on the log level (INFO, WARN, ERR, DEBUG).
- * The message will be routed through serial or UDP, depending on the network
- * initialization state and connectivity.
+ * This function formats the log message and queues it for the logger task,
+ * which routes it through serial or UDP, depending on the network
+ * initialization state and connectivity. The call does not block: if the
+ * log ring is full the message is dropped. INFO and DEBUG messages are also
+ * dropped while only the slots kept for WARN and ERR messages are free.
+ * Until the logger task runs, messages are sent synchronously.
+ *
+ * Each tag may log a fixed number of messages per rate limit window; the
+ * logger task reports how many were suppressed beyond that.
  *
  * @param log_level The severity level of the log message (INFO, WARN, ERR, DEBUG).
- * @param tag A tag identifying the source of the log message.
+ * @param tag A tag identifying the source of the log message; it must have
+ *            static storage, since it is printed after the call returns.
  * @param format A format string for the log message, similar to printf.
  * @param ... Additional arguments to be inserted into the format string.
  *
- * @return ESP_OK on success, ESP_ERR_INVALID_ARG if invalid arguments are provided,
- *         ESP_ERR_INVALID_SIZE if the log message exceeds the size limit, or
- *         other error codes based on the underlying send function.
+ * @return KERNEL_SUCCESS on success, KERNEL_ERROR_INVALID_ARG if invalid arguments are provided,
+ *         KERNEL_ERROR_QUEUE_FULL if the message was dropped.
+ *
+ * @note The level filter and the rate limiter run before formatting, but the
+ *       arguments are still evaluated; LOGGER_PRINT() skips them too.
  */
 kernel_error_st logger_print(log_level_et log_level, const char* tag, const char* format, ...);
 
+/**
+ * @brief Checks the level filter for one call site, caching the answer.
+ *
+ * The answer is kept in `site` until the next logger_set_tag_level(), so
+ * a call site that is filtered out costs a load and a compare.
+ *
+ * @param site      Cache of the call site, a zero-initialized static.
+ * @param log_level Level of the call site.
+ * @param tag       Tag of the call site.
+ * @return true if the message would be logged.
+ */
+bool logger_is_enabled(uint32_t* site, log_level_et log_level, const char* tag);
+
+/**
+ * @brief Logs a message if its level is compiled in and enabled for its tag.
+ *
+ * Levels below LOGGER_COMPILE_LEVEL are removed by the compiler, arguments
+ * included. Otherwise the per-tag level is checked, through a per call site
+ * cache, before the arguments are evaluated.
+ */
+#define LOGGER_PRINT(log_level, tag, ...)                                   \
+    do {                                                                    \
+        if (LOGGER_COMPILED(log_level)) {                                   \
+            static uint32_t logger_site = 0;                                \
+            if (logger_is_enabled(&logger_site, (log_level), (tag))) {      \
+                logger_print((log_level), (tag), __VA_ARGS__);              \
+            }                                                               \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief Sets the least severe level logged for a tag.
+ *
+ * Every tag logs INFO and above by default, and DEBUG too in
+ * RELEASE_MODE_DEBUG. Messages below the level are dropped before their
+ * arguments are formatted.
+ *
+ * @param tag       Tag to configure, with static storage, or NULL for the default level.
+ * @param log_level Least severe level logged.
+ * @return KERNEL_SUCCESS on success, KERNEL_ERROR_INVALID_ARG for an unknown level,
+ *         KERNEL_ERROR_FAILED_TO_LOCK if the logger is not initialized,
+ *         KERNEL_ERROR_NO_MEM if too many tags have their own level.
+ */
+kernel_error_st logger_set_tag_level(const char* tag, log_level_et log_level);
+
+/**
+ * @brief Queues a log message whose formatting is deferred.
+ *
+ * Only the format address and the raw arguments are stored, so the caller
+ * pays for no formatting at all; the logger task formats the message, or
+ * the host decoder does with the UDP_BINARY output. The format may only use
+ * integer conversions (see log_codec.h) and must have static storage.
+ * Prefer the LOGGER_PRINT_DEFERRED() macro, which packs the arguments.
+ *
+ * @param log_level The severity level of the log message (INFO, WARN, ERR, DEBUG).
+ * @param tag       A tag identifying the source of the log message, with static storage.
+ * @param format    A string literal format for the log message.
+ * @param args      Arguments of the format, converted to 32 bits.
+ * @param argc      Number of arguments, at most LOG_CODEC_MAX_ARGS.
+ *
+ * @return KERNEL_SUCCESS on success, KERNEL_ERROR_INVALID_ARG if invalid arguments are provided,
+ *         KERNEL_ERROR_INVALID_SIZE if there are too many arguments,
+ *         KERNEL_ERROR_QUEUE_FULL if the message was dropped.
+ */
+kernel_error_st logger_print_deferred(log_level_et log_level, const char* tag, const char* format, const uint32_t* args, uint8_t argc);
+
+/**
+ * @brief Logs a message with integer arguments without formatting it on the caller's task.
+ *
+ * Each argument is converted to uint32_t, so pointers are rejected at
+ * compile time; floating-point values would be truncated and belong in
+ * logger_print(). Usable from C sources only.
+ *
+ * Example: `LOGGER_PRINT_DEFERRED(ERR, TAG, "Failed to read sensor at index %d: error %d", i, err);`
+ */
+#define LOGGER_PRINT_DEFERRED(log_level, tag, format, ...)                                                  \
+    (LOGGER_COMPILED(log_level)                                                                             \
+         ? logger_print_deferred((log_level),                                                               \
+                                 (tag),                                                                     \
+                                 (format),                                                                  \
+                                 (const uint32_t[]){0, ##__VA_ARGS__} + 1,                                  \
+                                 (uint8_t)((sizeof((const uint32_t[]){0, ##__VA_ARGS__}) / sizeof(uint32_t)) - 1)) \
+         : KERNEL_SUCCESS)
+
+/**
+ * @brief Returns how many messages were dropped because the log ring was full.
+ */
+uint32_t logger_get_dropped_count(void);
+
+/**
+ * @brief Waits until the logger task has sent every queued message.
+ *
+ * Used before a restart so the messages explaining it are not lost.
+ *
+ * @param timeout Longest wait, in ticks.
+ * @return KERNEL_SUCCESS once the ring is empty or if the logger task does not run,
+ *         KERNEL_ERROR_TIMEOUT if messages are still queued after `timeout`.
+ */
+kernel_error_st logger_flush(TickType_t timeout);
+
+/**
+ * @brief Task draining the log ring to the serial or UDP output.
+ *
+ * Sleeps until a producer queues a message, or LOGGER_TASK_DELAY at most,
+ * then sends every queued message and reports how many were dropped since
+ * the last pass.
+ *
+ * @param pvParameters Unused.
+ */
+void logger_task_execute(void* pvParameters);
+
 #endif  // LOGGER_H
@@ -125,7 +125,7 @@ static esp_err_t post_uri_wifi_credentials(httpd_req_t* req) {
         return KERNEL_ERROR_STA_PASSWORD_TOO_LONG;
     }
 
-    logger_print(DEBUG, TAG, "SSID: %s, Password: %s", cred.ssid, cred.password);
+    LOGGER_PRINT(DEBUG, TAG, "SSID: %s, Password: %s", cred.ssid, cred.password);
 
     cred.ssid[ssid_len + 1]         = '\0';
     cred.password[password_len + 1] = '\0';
@@ -2,6 +2,7 @@
  * @file
  * @brief MQTT client task implementation for managing MQTT connection and publishing sensor data.
  */
+#include "esp_timer.h"
 #include "mqtt_client.h"
 
 #include "kernel/inter_task_communication/inter_task_communication.h"
@@ -24,11 +25,114 @@ static bool is_mqtt_connected                   = false;        ///< MQTT connec
 static bool is_waiting_for_connection           = false;        ///<
 static bool need_resubscribe                    = false;        ///<
 static mqtt_bridge_st mqtt_bridge               = {0};          ///< Pointer to the MQTT bridge structure.
+static TaskHandle_t mqtt_task_handle            = NULL;         ///< Handle of the MQTT task, target of event notifications.
 
-static char publish_payload[MQTT_MAXIMUM_PAYLOAD_LENGTH] = {0};
-static char publish_topic[MQTT_MAXIMUM_TOPIC_LENGTH]     = {0};
-static char subscribe_payload[256]                       = {0};
-static char subscribe_topic[MQTT_MAXIMUM_TOPIC_LENGTH]   = {0};
+/**
+ * @brief Notification bit raised by the MQTT event handler on connection-state changes.
+ *
+ * Bits below it are owned by the bridge, one per publish topic (see MAX_MQTT_TOPICS).
+ */
+#define MQTT_NOTIFY_CONNECTION_BIT (1UL << 31)
+
+static const TickType_t MQTT_CONNECTION_WAIT    = pdMS_TO_TICKS(1000);   ///< Wait while (re)connecting or waiting for prerequisites, keeps the retry/timeout timers ticking.
+static const TickType_t MQTT_IDLE_WAIT          = pdMS_TO_TICKS(10000);  ///< Wait while fully connected and idle, only guards against missed Wi-Fi changes.
+static const TickType_t MQTT_OUTBOX_BACKOFF_MIN = pdMS_TO_TICKS(50);     ///< First wait once the outbox goes above its high watermark.
+static const TickType_t MQTT_OUTBOX_BACKOFF_MAX = pdMS_TO_TICKS(1600);   ///< Upper bound of the outbox backoff.
+static const int MQTT_OUTBOX_HIGH_WATERMARK     = 8 * 1024;              ///< Outbox size, in bytes, above which bulk publishing backs off.
+static const int MQTT_OUTBOX_CLASS_HEADROOM     = 4 * 1024;              ///< Extra outbox bytes each higher priority class may use before backing off.
+static const int64_t MQTT_LATENCY_REPORT_US     = 60 * 1000 * 1000;      ///< Interval between per-class publish latency reports.
+
+/**
+ * @brief Outcome of a publish pass.
+ */
+typedef enum publish_status_e {
+    PUBLISH_IDLE,     ///< Every topic was drained.
+    PUBLISH_PENDING,  ///< At least one topic spent its budget and may still hold data.
+    PUBLISH_BACKOFF,  ///< The outbox is filling, publishing must pause.
+} publish_status_et;
+
+/**
+ * @brief Publish latency statistics of one priority class.
+ *
+ * Latency is measured from the wakeup that observed a topic's data notification
+ * to the moment its message is handed to the MQTT client.
+ */
+typedef struct publish_latency_s {
+    uint32_t count;     ///< Messages published in the current report interval.
+    int64_t total_us;   ///< Sum of latencies in the current report interval.
+    int64_t max_us;     ///< Largest latency in the current report interval.
+} publish_latency_st;
+
+/**
+ * @brief Payload copy and memory statistics of the publish path.
+ *
+ * Payloads are serialized once, in place, into the publish buffer and handed
+ * to the client with their exact length. The client then copies them into its
+ * own buffer, in chunks when larger than it, and QoS > 0 messages are copied
+ * once more into the outbox until acknowledged.
+ */
+typedef struct publish_memory_s {
+    uint32_t messages;          ///< Messages published in the current report interval.
+    uint32_t client_copies;     ///< Payload copies made by the client for those messages.
+    uint32_t large_payloads;    ///< Messages that needed a buffer larger than MQTT_MAXIMUM_PAYLOAD_LENGTH.
+    size_t peak_payload;        ///< Largest payload published, in bytes.
+    int peak_outbox;            ///< Largest outbox size observed after a publish, in bytes.
+} publish_memory_st;
+
+/**
+ * @brief State of the inbound message being reassembled.
+ */
+typedef enum subscribe_assembly_state_e {
+    SUBSCRIBE_ASSEMBLY_IDLE,        ///< No fragmented message in progress.
+    SUBSCRIBE_ASSEMBLY_RECEIVING,   ///< Fragments of an accepted message are being collected.
+    SUBSCRIBE_ASSEMBLY_SKIPPING,    ///< Remaining fragments of a dropped message are ignored.
+} subscribe_assembly_state_et;
+
+/**
+ * @brief Reassembly of an inbound message delivered in several MQTT_EVENT_DATA events.
+ *
+ * The client delivers the fragments of one message back to back, from its own
+ * task, and only the first one carries the topic. Fragments are collected in
+ * the static subscribe buffer, or in a heap buffer when the topic accepts
+ * payloads larger than it.
+ */
+typedef struct subscribe_assembly_s {
+    subscribe_assembly_state_et state;  ///< Reassembly state.
+    mqtt_buffer_st topic;               ///< Topic of the message, copied from the first fragment.
+    mqtt_buffer_st payload;             ///< Reassembly buffer; `length` counts the bytes received so far.
+    size_t total_length;                ///< Full payload length announced by the first fragment.
+} subscribe_assembly_st;
+
+/**
+ * @brief Inbound message statistics, cumulative since boot.
+ */
+typedef struct subscribe_stats_s {
+    uint32_t messages;    ///< Messages handed to the bridge.
+    uint32_t fragmented;  ///< Messages received in more than one fragment.
+    uint32_t oversized;   ///< Messages dropped for exceeding the payload limit of their topic.
+    uint32_t dropped;     ///< Messages dropped otherwise (unknown topic, lost fragment, no memory).
+} subscribe_stats_st;
+
+static size_t class_next_topic[MQTT_PRIORITY_COUNT]              = {0};  ///< Topic served first within each class on the next pick (round-robin).
+static TickType_t outbox_backoff                                 = 0;    ///< Current outbox backoff, 0 when not backing off.
+static int64_t topic_pending_since[MAX_MQTT_TOPICS]              = {0};  ///< Time the next unpublished message of each topic started waiting (notification or previous publish), 0 if none.
+static publish_latency_st publish_latencies[MQTT_PRIORITY_COUNT] = {0};  ///< Per-class publish latency statistics.
+static int64_t last_latency_report                               = 0;    ///< Time of the last latency report.
+static publish_memory_st publish_memory                          = {0};  ///< Copy and memory statistics of the current report interval.
+static subscribe_stats_st subscribe_stats                        = {0};  ///< Inbound message statistics.
+static subscribe_stats_st subscribe_stats_reported               = {0};  ///< Inbound statistics at the last report.
+
+static char publish_payload[MQTT_MAXIMUM_PAYLOAD_LENGTH]   = {0};
+static char publish_topic[MQTT_MAXIMUM_TOPIC_LENGTH]       = {0};
+static char subscribe_payload[MQTT_MAXIMUM_PAYLOAD_LENGTH] = {0};
+static char subscribe_topic[MQTT_MAXIMUM_TOPIC_LENGTH]     = {0};
+static char assembly_topic[MQTT_MAXIMUM_TOPIC_LENGTH]      = {0};
+
+static subscribe_assembly_st subscribe_assembly = {
+    .state   = SUBSCRIBE_ASSEMBLY_IDLE,
+    .topic   = {.buffer = assembly_topic, .size = sizeof(assembly_topic)},
+    .payload = {.buffer = subscribe_payload, .size = sizeof(subscribe_payload)},
+};
 
 /**
  * @brief Subscribes to all configured MQTT topics based on their direction.
@@ -42,7 +146,18 @@ static char subscribe_topic[MQTT_MAXIMUM_TOPIC_LENGTH]   = {0};
  */
 static kernel_error_st subscribe(void);
 
-static kernel_error_st handle_event_data(char* topic, char* data, size_t data_length);
+static kernel_error_st handle_event_data(esp_mqtt_event_handle_t event);
+
+static void abort_subscribe_assembly(void);
+
+/**
+ * @brief Wakes the MQTT task so it re-evaluates the connection state.
+ */
+static void notify_connection_change(void) {
+    if (mqtt_task_handle != NULL) {
+        xTaskNotify(mqtt_task_handle, MQTT_NOTIFY_CONNECTION_BIT, eSetBits);
+    }
+}
 
 /**
  * @brief Handles MQTT events triggered by the client.
@@ -69,19 +184,22 @@ static void mqtt_event_handler(void* arg, esp_event_base_t base, int32_t event_i
             is_mqtt_connected         = true;
             is_waiting_for_connection = false;
             need_resubscribe          = true;
+            notify_connection_change();
             break;
 
         case MQTT_EVENT_DISCONNECTED:
             logger_print(INFO, TAG, "MQTT_EVENT_DISCONNECTED");
             is_mqtt_connected         = false;
             is_waiting_for_connection = false;
+            abort_subscribe_assembly();
+            notify_connection_change();
             break;
 
         case MQTT_EVENT_DATA:
-            logger_print(INFO, TAG, "MQTT_EVENT_DATA: Topic=%.*s, Data=%.*s",
+            LOGGER_PRINT(DEBUG, TAG, "MQTT_EVENT_DATA: Topic=%.*s, %d/%d bytes at offset %d",
                          event->topic_len, event->topic,
-                         event->data_len, event->data);
-            handle_event_data(event->topic, event->data, event->data_len);
+                         event->data_len, event->total_data_len, event->current_data_offset);
+            handle_event_data(event);
             break;
 
         case MQTT_EVENT_ERROR:
@@ -90,7 +208,7 @@ static void mqtt_event_handler(void* arg, esp_event_base_t base, int32_t event_i
             break;
 
         default:
-            logger_print(DEBUG, TAG, "MQTT event: %d", event->event_id);
+            LOGGER_PRINT_DEFERRED(DEBUG, TAG, "MQTT event: %d", event->event_id);
             break;
     }
 }
@@ -130,53 +248,399 @@ static void stop_mqtt_client(void) {
 }
 
 /**
- * @brief Publishes all available MQTT messages for registered topics.
+ * @brief Returns the effective drain budget of a topic.
  *
- * This function iterates through all topics registered in the MQTT bridge,
- * and attempts to fetch and publish any available messages marked for publishing.
+ * Falls back to the MQTT_DEFAULT_PUBLISH_BUDGET_* values when the bridge does
+ * not provide per-topic budgets.
  *
- * For each topic:
- * - If the queue is empty or direction is not `PUBLISH`, it is skipped.
- * - If serialization or publishing fails, an error is logged, and the loop continues.
- * - On success, the message is sent using `esp_mqtt_client_publish()`.
+ * @param[in] mqtt_index Index of the topic in the bridge.
+ * @return The drain budget to apply for this wakeup.
+ */
+static mqtt_publish_budget_st get_publish_budget(uint8_t mqtt_index) {
+    mqtt_publish_budget_st budget = {
+        .max_messages = MQTT_DEFAULT_PUBLISH_BUDGET_MESSAGES,
+        .max_bytes    = MQTT_DEFAULT_PUBLISH_BUDGET_BYTES,
+    };
+
+    if (mqtt_bridge.get_publish_budget != NULL) {
+        mqtt_bridge.get_publish_budget(mqtt_index, &budget);
+    }
+
+    return budget;
+}
+
+/**
+ * @brief Returns the priority class of a topic.
+ *
+ * @param[in] mqtt_index Index of the topic in the bridge.
+ * @return The topic class, or MQTT_PRIORITY_BULK when the bridge does not provide one.
+ */
+static mqtt_priority_et get_publish_priority(uint8_t mqtt_index) {
+    if (mqtt_bridge.get_publish_priority == NULL) {
+        return MQTT_PRIORITY_BULK;
+    }
+
+    mqtt_priority_et priority = mqtt_bridge.get_publish_priority(mqtt_index);
+
+    return (priority < MQTT_PRIORITY_COUNT) ? priority : MQTT_PRIORITY_BULK;
+}
+
+/**
+ * @brief Checks whether the MQTT outbox is too full for a priority class.
+ *
+ * Each class may use MQTT_OUTBOX_CLASS_HEADROOM more bytes than the class
+ * below it, starting from MQTT_OUTBOX_HIGH_WATERMARK for MQTT_PRIORITY_BULK,
+ * so background and bulk traffic back off first and leave room for
+ * interactive traffic.
+ *
+ * @param[in] priority Priority class about to publish.
+ * @return true if publishing for this class should back off until the outbox drains.
+ */
+static bool is_outbox_filling(mqtt_priority_et priority) {
+    int limit = MQTT_OUTBOX_HIGH_WATERMARK + (((int)priority - (int)MQTT_PRIORITY_BULK) * MQTT_OUTBOX_CLASS_HEADROOM);
+
+    return esp_mqtt_client_get_outbox_size(mqtt_client) > limit;
+}
+
+/**
+ * @brief Grows the publish payload buffer for a message larger than MQTT_MAXIMUM_PAYLOAD_LENGTH.
+ *
+ * Reserve hook of the publish payload buffer. The larger buffer comes from the
+ * FreeRTOS heap and lives only until the message is handed to the client (see
+ * release_publish_payload()); the client writes it out in chunks of its own
+ * buffer size, so the static publish buffer stays sized for the common case.
+ *
+ * @param[in,out] payload Payload buffer to grow; its content is not preserved.
+ * @param[in]     size    Required size in bytes.
+ *
+ * @return KERNEL_SUCCESS on success.
+ * @return KERNEL_ERROR_BUFFER_TOO_SHORT if `size` exceeds MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH.
+ * @return KERNEL_ERROR_NO_MEM if the heap cannot provide the buffer.
+ */
+static kernel_error_st reserve_publish_payload(mqtt_buffer_st* payload, size_t size) {
+    if (size <= payload->size) {
+        return KERNEL_SUCCESS;
+    }
+
+    if (size > MQTT_MAXIMUM_CHUNKED_PAYLOAD_LENGTH) {
+        return KERNEL_ERROR_BUFFER_TOO_SHORT;
+    }
+
+    char* large_payload = pvPortMalloc(size);
+    if (large_payload == NULL) {
+        logger_print(WARN, TAG, "No memory for a %u byte payload", (unsigned)size);
+        return KERNEL_ERROR_NO_MEM;
+    }
+
+    if (payload->buffer != publish_payload) {
+        vPortFree(payload->buffer);
+    }
+
+    payload->buffer = large_payload;
+    payload->size   = size;
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Returns the publish payload buffer to the static buffer, freeing a grown one.
+ *
+ * @param[in,out] payload Payload buffer used for the last message.
+ */
+static void release_publish_payload(mqtt_buffer_st* payload) {
+    if (payload->buffer != publish_payload) {
+        vPortFree(payload->buffer);
+        payload->buffer = publish_payload;
+        payload->size   = sizeof(publish_payload);
+    }
+}
+
+/**
+ * @brief Records the copies and memory used to publish one message.
+ *
+ * @param[in] payload Published payload buffer.
+ * @param[in] qos     QoS of the message.
+ */
+static void record_publish_memory(const mqtt_buffer_st* payload, qos_et qos) {
+    publish_memory.messages++;
+    publish_memory.client_copies += (qos > QOS_0) ? 2 : 1;
+
+    if (payload->buffer != publish_payload) {
+        publish_memory.large_payloads++;
+    }
+
+    if (payload->length > publish_memory.peak_payload) {
+        publish_memory.peak_payload = payload->length;
+    }
+
+    int outbox_size = esp_mqtt_client_get_outbox_size(mqtt_client);
+    if (outbox_size > publish_memory.peak_outbox) {
+        publish_memory.peak_outbox = outbox_size;
+    }
+}
+
+/**
+ * @brief Marks topics whose data notification was just received as pending.
+ *
+ * @param[in] notified_bits Notification value returned by xTaskNotifyWait().
+ */
+static void mark_pending_topics(uint32_t notified_bits) {
+    int64_t now = esp_timer_get_time();
+
+    for (size_t i = 0; i < MAX_MQTT_TOPICS; i++) {
+        if ((notified_bits & (1UL << i)) && (topic_pending_since[i] == 0)) {
+            topic_pending_since[i] = now;
+        }
+    }
+}
+
+/**
+ * @brief Records the publish latency of a topic in its class statistics.
+ *
+ * The pending mark is re-armed to the publish time, so the next message of a
+ * backlog is measured from when it reached the head of the queue rather than
+ * from the notification of the first one.
+ *
+ * @param[in] mqtt_index Index of the published topic.
+ * @param[in] priority   Priority class of the topic.
+ */
+static void record_publish_latency(size_t mqtt_index, mqtt_priority_et priority) {
+    if (topic_pending_since[mqtt_index] == 0) {
+        return;
+    }
+
+    int64_t now                     = esp_timer_get_time();
+    int64_t latency_us              = now - topic_pending_since[mqtt_index];
+    publish_latency_st* stats       = &publish_latencies[priority];
+    topic_pending_since[mqtt_index] = now;
+
+    stats->count++;
+    stats->total_us += latency_us;
+    if (latency_us > stats->max_us) {
+        stats->max_us = latency_us;
+    }
+}
+
+/**
+ * @brief Logs and resets the per-class publish latency and the publish memory statistics.
+ *
+ * The cumulative inbound statistics are logged too, when they changed.
+ *
+ * Called on every loop iteration, only reports once per MQTT_LATENCY_REPORT_US.
+ */
+static void report_publish_latency(void) {
+    int64_t now = esp_timer_get_time();
+
+    if ((now - last_latency_report) < MQTT_LATENCY_REPORT_US) {
+        return;
+    }
+
+    last_latency_report = now;
+
+    for (size_t priority = 0; priority < MQTT_PRIORITY_COUNT; priority++) {
+        publish_latency_st* stats = &publish_latencies[priority];
+
+        if (stats->count == 0) {
+            continue;
+        }
+
+        logger_print(INFO, TAG, "Publish latency class %d: %lu msgs, avg %lld us, max %lld us",
+                     priority,
+                     (unsigned long)stats->count,
+                     stats->total_us / stats->count,
+                     stats->max_us);
+
+        *stats = (publish_latency_st){0};
+    }
+
+    if (publish_memory.messages > 0) {
+        logger_print(INFO, TAG, "Publish memory: %lu msgs, %lu client copies, %lu large, peak payload %u B, peak outbox %d B",
+                     (unsigned long)publish_memory.messages,
+                     (unsigned long)publish_memory.client_copies,
+                     (unsigned long)publish_memory.large_payloads,
+                     (unsigned)publish_memory.peak_payload,
+                     publish_memory.peak_outbox);
+
+        publish_memory = (publish_memory_st){0};
+    }
+
+    if (memcmp(&subscribe_stats, &subscribe_stats_reported, sizeof(subscribe_stats)) != 0) {
+        subscribe_stats_reported = subscribe_stats;
+        logger_print(INFO, TAG, "Inbound: %lu msgs, %lu fragmented, %lu oversized, %lu dropped",
+                     (unsigned long)subscribe_stats_reported.messages,
+                     (unsigned long)subscribe_stats_reported.fragmented,
+                     (unsigned long)subscribe_stats_reported.oversized,
+                     (unsigned long)subscribe_stats_reported.dropped);
+    }
+}
+
+/**
+ * @brief Fetches and publishes the next message of a class.
  *
- * The function does **not return early** on errors — it continues through all topics,
- * ensuring that a failure on one topic does not block others.
+ * Scans the topics of `priority` round-robin, starting after the last topic
+ * served in that class, and publishes the first available message. Topics that
+ * spent their budget are skipped; topics found empty clear their pending mark.
  *
- * @note This function assumes that the payload and topic buffers are properly written
- * and null-terminated by the bridge's fetch function and serializer.
+ * @param[in]     priority       Priority class to serve.
+ * @param[in]     topic_count    Number of topics in the bridge.
+ * @param[in]     priorities     Class of each topic.
+ * @param[in,out] spent_topics   Bitmask of topics that spent their budget.
+ * @param[in,out] sent_messages  Messages published by each topic in this pass.
+ * @param[in,out] sent_bytes     Payload bytes published by each topic in this pass.
+ * @param[in]     budgets        Drain budget of each topic.
  *
- * @warning No internal delays are used — if calling this rapidly, consider rate-limiting externally.
+ * @return PUBLISH_PENDING if a message was handled, PUBLISH_IDLE if the class has
+ *         nothing to send, PUBLISH_BACKOFF if the outbox is too full for the class.
  */
-static void publish(void) {
+static publish_status_et publish_next_in_class(mqtt_priority_et priority,
+                                               size_t topic_count,
+                                               const mqtt_priority_et* priorities,
+                                               uint32_t* spent_topics,
+                                               uint16_t* sent_messages,
+                                               size_t* sent_bytes,
+                                               const mqtt_publish_budget_st* budgets) {
     qos_et qos = QOS_0;
 
     mqtt_buffer_st mqtt_buffer_payload = {
-        .buffer = publish_payload,
-        .size   = sizeof(publish_payload)};
+        .buffer  = publish_payload,
+        .size    = sizeof(publish_payload),
+        .reserve = reserve_publish_payload};
     mqtt_buffer_st mqtt_buffer_topic = {
         .buffer = publish_topic,
         .size   = sizeof(publish_topic)};
 
-    for (size_t i = 0; i < mqtt_bridge.get_topics_count(); i++) {
+    for (size_t n = 0; n < topic_count; n++) {
+        size_t i = (class_next_topic[priority] + n) % topic_count;
+
+        if ((priorities[i] != priority) || (*spent_topics & (1UL << i))) {
+            continue;
+        }
+
+        if (is_outbox_filling(priority)) {
+            return PUBLISH_BACKOFF;
+        }
+
         kernel_error_st err = mqtt_bridge.fetch_publish_data(i, &mqtt_buffer_topic, &mqtt_buffer_payload, &qos);
 
         if ((err == KERNEL_ERROR_EMPTY_QUEUE) || (err == KERNEL_ERROR_MQTT_INVALID_DATA_DIRECTION)) {
+            topic_pending_since[i] = 0;
             continue;
         }
 
+        class_next_topic[priority] = (i + 1) % topic_count;
+        sent_messages[i]++;
+
         if (err != KERNEL_SUCCESS) {
             logger_print(ERR, TAG, "Failed to publish to topic %s - %d", publish_topic, err);
-            continue;
+        } else {
+            size_t payload_length = mqtt_buffer_payload.length;
+
+            int msg_id = esp_mqtt_client_publish(mqtt_client, publish_topic, mqtt_buffer_payload.buffer, payload_length, qos, 0);
+            if (msg_id < 0) {
+                logger_print(ERR, TAG, "Failed to publish MQTT message (topic=%s, qos=%d)", publish_topic, qos);
+            } else {
+                LOGGER_PRINT(DEBUG, TAG, "Published to topic %s, msg_id=%d", publish_topic, msg_id);
+                record_publish_latency(i, priority);
+                record_publish_memory(&mqtt_buffer_payload, qos);
+            }
+
+            sent_bytes[i] += payload_length;
         }
 
-        int msg_id = esp_mqtt_client_publish(mqtt_client, publish_topic, publish_payload, 0, qos, 0);
-        if (msg_id < 0) {
-            logger_print(ERR, TAG, "Failed to publish MQTT message (topic=%s, qos=%d)", publish_topic, qos);
-        } else {
-            logger_print(DEBUG, TAG, "Published to topic %s, msg_id=%d", publish_topic, msg_id);
+        release_publish_payload(&mqtt_buffer_payload);
+
+        if ((sent_messages[i] >= budgets[i].max_messages) || (sent_bytes[i] >= budgets[i].max_bytes)) {
+            *spent_topics |= (1UL << i);
         }
+
+        return PUBLISH_PENDING;
     }
+
+    return PUBLISH_IDLE;
+}
+
+/**
+ * @brief Publishes queued MQTT messages for registered topics by priority class.
+ *
+ * Every message is picked from the highest priority class that has data, so
+ * a command response queued behind a backlog of sensor reports goes out next.
+ * Within a class, topics are served round-robin, one message at a time. A topic
+ * leaves the pass once it spent its drain budget (messages or payload bytes),
+ * and the pass ends when no class has anything left to send.
+ *
+ * For each topic:
+ * - If the queue is empty or direction is not `PUBLISH`, it is skipped.
+ * - If serialization or publishing fails, an error is logged, and the pass continues.
+ * - On success, the message is sent using `esp_mqtt_client_publish()`.
+ *
+ * Publishing stops early when the MQTT outbox is too full for the class being
+ * served (see is_outbox_filling()).
+ *
+ * @note The topic buffer must be null-terminated by the bridge's fetch function; the
+ * payload may be binary and is published using the length reported by the bridge.
+ *
+ * @return PUBLISH_IDLE if every topic was drained, PUBLISH_PENDING if a topic spent
+ *         its budget and may still hold data, PUBLISH_BACKOFF if the outbox is filling.
+ */
+static publish_status_et publish(void) {
+    size_t topic_count = mqtt_bridge.get_topics_count();
+    if (topic_count > MAX_MQTT_TOPICS) {
+        topic_count = MAX_MQTT_TOPICS;
+    }
+
+    mqtt_publish_budget_st budgets[MAX_MQTT_TOPICS] = {0};
+    mqtt_priority_et priorities[MAX_MQTT_TOPICS]    = {0};
+    uint16_t sent_messages[MAX_MQTT_TOPICS]          = {0};
+    size_t sent_bytes[MAX_MQTT_TOPICS]               = {0};
+    uint32_t spent_topics                            = 0;
+
+    for (size_t i = 0; i < topic_count; i++) {
+        budgets[i]    = get_publish_budget(i);
+        priorities[i] = get_publish_priority(i);
+    }
+
+    while (1) {
+        publish_status_et status = PUBLISH_IDLE;
+
+        for (int priority = MQTT_PRIORITY_COUNT - 1; priority >= 0; priority--) {
+            status = publish_next_in_class((mqtt_priority_et)priority,
+                                           topic_count,
+                                           priorities,
+                                           &spent_topics,
+                                           sent_messages,
+                                           sent_bytes,
+                                           budgets);
+            if (status != PUBLISH_IDLE) {
+                break;
+            }
+        }
+
+        if (status == PUBLISH_BACKOFF) {
+            return PUBLISH_BACKOFF;
+        }
+
+        if (status == PUBLISH_IDLE) {
+            return (spent_topics != 0) ? PUBLISH_PENDING : PUBLISH_IDLE;
+        }
+    }
+}
+
+/**
+ * @brief Computes the next wait while the outbox is filling.
+ *
+ * Doubles the backoff on every call, starting at MQTT_OUTBOX_BACKOFF_MIN and
+ * capped at MQTT_OUTBOX_BACKOFF_MAX. The backoff is reset once a publish
+ * pass completes without hitting the watermark.
+ *
+ * @return Ticks to wait before publishing again.
+ */
+static TickType_t next_outbox_backoff(void) {
+    outbox_backoff = (outbox_backoff == 0) ? MQTT_OUTBOX_BACKOFF_MIN : (outbox_backoff * 2);
+    if (outbox_backoff > MQTT_OUTBOX_BACKOFF_MAX) {
+        outbox_backoff = MQTT_OUTBOX_BACKOFF_MAX;
+    }
+
+    return outbox_backoff;
 }
 
 /**
@@ -213,31 +677,191 @@ static kernel_error_st subscribe(void) {
             return KERNEL_ERROR_MQTT_SUBSCRIBE;
         }
 
-        logger_print(DEBUG, TAG, "Subscribed to topic %s, msg_id=%d", mqtt_buffer_topic.buffer, msg_id);
+        LOGGER_PRINT(DEBUG, TAG, "Subscribed to topic %s, msg_id=%d", mqtt_buffer_topic.buffer, msg_id);
     }
 
     return KERNEL_SUCCESS;
 }
 
-static kernel_error_st handle_event_data(char* topic, char* data, size_t data_length) {
-    if ((topic == NULL) || (data == NULL)) {
+/**
+ * @brief Returns the reassembly buffer to the static buffer, freeing a heap one, and goes idle.
+ */
+static void release_subscribe_assembly(void) {
+    if (subscribe_assembly.payload.buffer != subscribe_payload) {
+        vPortFree(subscribe_assembly.payload.buffer);
+        subscribe_assembly.payload.buffer = subscribe_payload;
+        subscribe_assembly.payload.size   = sizeof(subscribe_payload);
+    }
+
+    subscribe_assembly.payload.length = 0;
+    subscribe_assembly.total_length   = 0;
+    subscribe_assembly.state          = SUBSCRIBE_ASSEMBLY_IDLE;
+}
+
+/**
+ * @brief Drops the message being reassembled, if any.
+ *
+ * Called when a fragment is lost and on disconnection, since the client does
+ * not resume a partially delivered message.
+ */
+static void abort_subscribe_assembly(void) {
+    if (subscribe_assembly.state == SUBSCRIBE_ASSEMBLY_RECEIVING) {
+        subscribe_stats.dropped++;
+        logger_print(WARN, TAG, "Dropped incomplete message on %.*s, %u/%u bytes",
+                     (int)subscribe_assembly.topic.length, subscribe_assembly.topic.buffer,
+                     (unsigned)subscribe_assembly.payload.length, (unsigned)subscribe_assembly.total_length);
+    }
+
+    release_subscribe_assembly();
+}
+
+/**
+ * @brief Hands a complete inbound message to the bridge.
+ *
+ * The payload is parsed by the bridge during the call, so `payload` must
+ * stay valid until it returns.
+ */
+static kernel_error_st dispatch_event_data(const mqtt_buffer_st* topic, mqtt_buffer_st* payload) {
+    subscribe_stats.messages++;
+
+    return mqtt_bridge.handle_event_data(topic, payload);
+}
+
+/**
+ * @brief Accepts or rejects a new inbound message from its first fragment.
+ *
+ * Checks the announced length against the payload limit of the topic. A
+ * message that fits in one fragment is dispatched straight from the client
+ * buffer, without copy. Otherwise the topic is saved and a reassembly buffer
+ * of the announced length is prepared.
+ *
+ * @return KERNEL_SUCCESS if the message was dispatched or reassembly started.
+ * @return KERNEL_ERROR_MQTT_INVALID_TOPIC if the topic is unknown or too long.
+ * @return KERNEL_ERROR_INVALID_SIZE if the message exceeds the topic payload limit.
+ * @return KERNEL_ERROR_NO_MEM if no reassembly buffer is available.
+ * @return Error from the bridge handler otherwise.
+ */
+static kernel_error_st begin_event_data(esp_mqtt_event_handle_t event) {
+    mqtt_buffer_st topic = {
+        .buffer = event->topic,
+        .size   = (size_t)event->topic_len,
+        .length = (size_t)event->topic_len,
+    };
+    size_t total_length = (size_t)event->total_data_len;
+    size_t max_length   = MQTT_MAXIMUM_PAYLOAD_LENGTH;
+
+    if ((event->topic == NULL) || (topic.length >= subscribe_assembly.topic.size)) {
+        subscribe_stats.dropped++;
+        return KERNEL_ERROR_MQTT_INVALID_TOPIC;
+    }
+
+    if (mqtt_bridge.get_payload_limit != NULL) {
+        kernel_error_st err = mqtt_bridge.get_payload_limit(&topic, &max_length);
+        if (err != KERNEL_SUCCESS) {
+            subscribe_stats.dropped++;
+            logger_print(WARN, TAG, "Dropped message on unknown topic %.*s", (int)topic.length, topic.buffer);
+            return err;
+        }
+    }
+
+    if ((total_length == 0) || (total_length > max_length)) {
+        subscribe_stats.oversized++;
+        logger_print(WARN, TAG, "Dropped %u byte message on %.*s, limit is %u",
+                     (unsigned)total_length, (int)topic.length, topic.buffer, (unsigned)max_length);
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
+    if ((size_t)event->data_len == total_length) {
+        mqtt_buffer_st payload = {
+            .buffer = event->data,
+            .size   = total_length,
+            .length = total_length,
+        };
+
+        return dispatch_event_data(&topic, &payload);
+    }
+
+    if (total_length > subscribe_assembly.payload.size) {
+        char* large_payload = pvPortMalloc(total_length);
+        if (large_payload == NULL) {
+            subscribe_stats.dropped++;
+            logger_print(WARN, TAG, "No memory to reassemble a %u byte message", (unsigned)total_length);
+            return KERNEL_ERROR_NO_MEM;
+        }
+
+        subscribe_assembly.payload.buffer = large_payload;
+        subscribe_assembly.payload.size   = total_length;
+    }
+
+    memcpy(subscribe_assembly.topic.buffer, topic.buffer, topic.length);
+    subscribe_assembly.topic.length = topic.length;
+    subscribe_assembly.total_length = total_length;
+    subscribe_assembly.state        = SUBSCRIBE_ASSEMBLY_RECEIVING;
+    subscribe_stats.fragmented++;
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Handles one MQTT_EVENT_DATA, reassembling fragmented messages.
+ *
+ * The first fragment (offset 0) starts a message; later fragments must
+ * continue it at the expected offset, otherwise the message is dropped and its
+ * remaining fragments are skipped. Complete messages are handed to the bridge.
+ *
+ * @param[in] event MQTT data event.
+ *
+ * @return KERNEL_SUCCESS on success, or while a message is still incomplete.
+ * @return Error from the first fragment checks or the bridge handler otherwise.
+ */
+static kernel_error_st handle_event_data(esp_mqtt_event_handle_t event) {
+    if ((event == NULL) || (event->data == NULL) || (event->data_len < 0)) {
         return KERNEL_ERROR_NULL;
     }
 
-    if (data_length == 0 || data_length >= MQTT_MAXIMUM_PAYLOAD_LENGTH) {
-        logger_print(ERR, TAG, "Invalid data length %zu, max allowed is %d", data_length, MQTT_MAXIMUM_PAYLOAD_LENGTH);
+    size_t offset = (size_t)event->current_data_offset;
+    size_t length = (size_t)event->data_len;
+    bool is_last  = (offset + length) >= (size_t)event->total_data_len;
+
+    if (offset == 0) {
+        abort_subscribe_assembly();
+
+        kernel_error_st err = begin_event_data(event);
+        if (subscribe_assembly.state != SUBSCRIBE_ASSEMBLY_RECEIVING) {
+            if ((err != KERNEL_SUCCESS) && !is_last) {
+                subscribe_assembly.state = SUBSCRIBE_ASSEMBLY_SKIPPING;
+            }
+            return err;
+        }
+    } else if (subscribe_assembly.state == SUBSCRIBE_ASSEMBLY_SKIPPING) {
+        if (is_last) {
+            release_subscribe_assembly();
+        }
+        return KERNEL_SUCCESS;
+    } else if ((subscribe_assembly.state != SUBSCRIBE_ASSEMBLY_RECEIVING) ||
+               (offset != subscribe_assembly.payload.length) ||
+               ((size_t)event->total_data_len != subscribe_assembly.total_length) ||
+               ((offset + length) > subscribe_assembly.total_length)) {
+        logger_print(WARN, TAG, "Unexpected fragment at offset %u", (unsigned)offset);
+        if (subscribe_assembly.state != SUBSCRIBE_ASSEMBLY_RECEIVING) {
+            subscribe_stats.dropped++;
+        }
+        abort_subscribe_assembly();
+        subscribe_assembly.state = is_last ? SUBSCRIBE_ASSEMBLY_IDLE : SUBSCRIBE_ASSEMBLY_SKIPPING;
         return KERNEL_ERROR_INVALID_SIZE;
     }
 
-    memcpy(subscribe_payload, data, data_length);
-    subscribe_payload[data_length] = '\0';
+    memcpy(&subscribe_assembly.payload.buffer[offset], event->data, length);
+    subscribe_assembly.payload.length += length;
 
-    mqtt_buffer_st mqtt_buffer = {
-        .buffer = subscribe_payload,
-        .size   = (data_length + 1),
-    };
+    if (subscribe_assembly.payload.length < subscribe_assembly.total_length) {
+        return KERNEL_SUCCESS;
+    }
+
+    kernel_error_st err = dispatch_event_data(&subscribe_assembly.topic, &subscribe_assembly.payload);
+    release_subscribe_assembly();
 
-    return mqtt_bridge.handle_event_data(topic, &mqtt_buffer);
+    return err;
 }
 
 /**
@@ -307,14 +931,22 @@ static kernel_error_st mqtt_client_task_initialize(void) {
 /**
  * @brief Main MQTT execution task.
  *
- * Manages the MQTT connection and periodically checks for new sensor data
- * to publish. It ensures the client is started and stopped based on Wi-Fi
- * connection status.
+ * Manages the MQTT connection and publishes queued data. The task blocks on
+ * its notification value: the bridge sets one bit per publish topic when data
+ * is enqueued and the event handler sets MQTT_NOTIFY_CONNECTION_BIT on
+ * connection changes, so both are served from the same wait with no polling.
+ * Each wakeup publishes by priority class within the per-topic drain budget
+ * and loops again without blocking while topics still hold data; when the
+ * MQTT outbox fills, publishing backs off exponentially. Per-class publish
+ * latency is logged periodically.
+ * While connecting, the wait is bounded so the retry and timeout timers keep
+ * running; the client is started and stopped based on Wi-Fi connection status.
  *
  * @param[in] pvParameters User-defined parameters (not used).
  */
 void mqtt_client_task_execute(void* pvParameters) {
     _global_structures = (global_structures_st*)pvParameters;
+    mqtt_task_handle   = xTaskGetCurrentTaskHandle();
 
     if ((mqtt_client_task_initialize() != KERNEL_SUCCESS) || validate_global_structure(_global_structures)) {
         logger_print(ERR, TAG, "Failed to initialize MQTT task");
@@ -326,10 +958,21 @@ void mqtt_client_task_execute(void* pvParameters) {
         vTaskDelay(pdMS_TO_TICKS(500));
     }
 
+    TickType_t idle_wait = MQTT_IDLE_WAIT;
+    if ((mqtt_bridge.set_publish_notify == NULL) || (mqtt_bridge.set_publish_notify(mqtt_task_handle) != KERNEL_SUCCESS)) {
+        logger_print(WARN, TAG, "Publish notifications unavailable, falling back to periodic polling");
+        idle_wait = MQTT_CONNECTION_WAIT;
+    }
+
     TickType_t last_connect_attempt = 0;
     TickType_t waiting_since        = 0;
+    TickType_t wait_ticks           = 0;
 
     while (1) {
+        uint32_t notified_bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &notified_bits, wait_ticks);
+        mark_pending_topics(notified_bits);
+
         EventBits_t firmware_event_bits = xEventGroupGetBits(
             _global_structures->global_events.firmware_event_group);
 
@@ -348,7 +991,7 @@ void mqtt_client_task_execute(void* pvParameters) {
 
         if (!is_mqtt_connected && !is_waiting_for_connection) {
             if (is_wifi_connected && (now - last_connect_attempt > pdMS_TO_TICKS(5000))) {
-                logger_print(DEBUG, TAG, "Trying to start MQTT client...");
+                LOGGER_PRINT(DEBUG, TAG, "Trying to start MQTT client...");
                 start_mqtt_client();
                 waiting_since = now;
             }
@@ -359,20 +1002,35 @@ void mqtt_client_task_execute(void* pvParameters) {
                 logger_print(WARN, TAG, "MQTT connect timeout, restarting client...");
                 stop_mqtt_client();
             } else {
-                logger_print(DEBUG, TAG, "Connect timeout expired but client already connected, ignoring timeout");
+                LOGGER_PRINT(DEBUG, TAG, "Connect timeout expired but client already connected, ignoring timeout");
             }
             last_connect_attempt = now;
         }
 
         if (is_mqtt_connected && !is_wifi_connected) {
-            logger_print(DEBUG, TAG, "Stopping MQTT client due to Wi-Fi disconnection...");
+            LOGGER_PRINT(DEBUG, TAG, "Stopping MQTT client due to Wi-Fi disconnection...");
             stop_mqtt_client();
         }
 
+        wait_ticks = MQTT_CONNECTION_WAIT;
+
         if (is_mqtt_connected && is_wifi_connected && is_time_synced) {
-            publish();
+            switch (publish()) {
+                case PUBLISH_PENDING:
+                    outbox_backoff = 0;
+                    wait_ticks     = 0;
+                    break;
+                case PUBLISH_BACKOFF:
+                    wait_ticks = next_outbox_backoff();
+                    LOGGER_PRINT(DEBUG, TAG, "MQTT outbox filling, backing off for %lu ticks", (unsigned long)wait_ticks);
+                    break;
+                default:
+                    outbox_backoff = 0;
+                    wait_ticks     = idle_wait;
+                    break;
+            }
         }
 
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        report_publish_latency();
     }
 }
\ No newline at end of file
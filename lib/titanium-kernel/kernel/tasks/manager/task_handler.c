@@ -162,3 +162,26 @@ UBaseType_t task_handler_get_highwater(size_t index) {
 const char *task_handler_get_task_name(size_t index) {
     return enqued_task_list[index]->name;
 }
+
+/**
+ * @brief Find the index of a task from its FreeRTOS handle.
+ *
+ * Only compares handles, so it is safe to call with the handle of a task
+ * that has since been deleted.
+ *
+ * @param handle FreeRTOS handle of the task.
+ * @return Index of the task in the enqueued task list, or -1 if it is not there.
+ */
+int task_handler_find_task(TaskHandle_t handle) {
+    if (handle == NULL) {
+        return -1;
+    }
+
+    for (int i = 0; i < enqueued_task_index; i++) {
+        if (enqued_task_list[i]->handle == handle) {
+            return i;
+        }
+    }
+
+    return -1;
+}
@@ -91,3 +91,14 @@ UBaseType_t task_handler_get_highwater(size_t index);
  * @return Pointer to the task name string (read-only).
  */
 const char *task_handler_get_task_name(size_t index);
+
+/**
+ * @brief Find the index of a task from its FreeRTOS handle.
+ *
+ * Only compares handles, so it is safe to call with the handle of a task
+ * that has since been deleted.
+ *
+ * @param handle FreeRTOS handle of the task.
+ * @return Index of the task in the enqueued task list, or -1 if it is not there.
+ */
+int task_handler_find_task(TaskHandle_t handle);
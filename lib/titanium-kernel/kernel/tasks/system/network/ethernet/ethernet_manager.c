@@ -63,7 +63,7 @@ void ethernet_manager_handle_events(int32_t event_id, void* event_data) {
             logger_print(INFO, TAG, "Ethernet interface stopped.");
             break;
         default:
-            logger_print(DEBUG, TAG, "Received unknown Ethernet event ID: %d", event_id);
+            LOGGER_PRINT(DEBUG, TAG, "Received unknown Ethernet event ID: %d", event_id);
             break;
     }
 }
@@ -82,12 +82,12 @@ void ethernet_manager_sta_got_ip(void* event_data) {
     ip_event_got_ip_t* event           = (ip_event_got_ip_t*)event_data;
     const esp_netif_ip_info_t* ip_info = &event->ip_info;
 
-    logger_print(DEBUG, TAG, "Ethernet Got IP Address");
-    logger_print(DEBUG, TAG, "-----------------------");
-    logger_print(DEBUG, TAG, "IP: " IPSTR, IP2STR(&ip_info->ip));
-    logger_print(DEBUG, TAG, "MASK: " IPSTR, IP2STR(&ip_info->netmask));
-    logger_print(DEBUG, TAG, "GW: " IPSTR, IP2STR(&ip_info->gw));
-    logger_print(DEBUG, TAG, "-----------------------");
+    LOGGER_PRINT(DEBUG, TAG, "Ethernet Got IP Address");
+    LOGGER_PRINT(DEBUG, TAG, "-----------------------");
+    LOGGER_PRINT(DEBUG, TAG, "IP: " IPSTR, IP2STR(&ip_info->ip));
+    LOGGER_PRINT(DEBUG, TAG, "MASK: " IPSTR, IP2STR(&ip_info->netmask));
+    LOGGER_PRINT(DEBUG, TAG, "GW: " IPSTR, IP2STR(&ip_info->gw));
+    LOGGER_PRINT(DEBUG, TAG, "-----------------------");
 
     is_ethernet_ip_set = true;
 }
@@ -206,7 +206,7 @@ void network_task_execute(void* pvParameters) {
 
     while (1) {
         if (xQueueReceive(cred_queue, &cred, pdMS_TO_TICKS(100)) == pdPASS) {
-            logger_print(DEBUG, TAG, "SSID: %s, Password: %s", cred.ssid, cred.password);
+            LOGGER_PRINT(DEBUG, TAG, "SSID: %s, Password: %s", cred.ssid, cred.password);
             wifi_manager_set_credentials(cred.ssid, cred.password);
         }
 
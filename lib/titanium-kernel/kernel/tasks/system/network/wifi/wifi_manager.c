@@ -315,7 +315,7 @@ kernel_error_st wifi_manager_set_credentials(const char* ssid, const char* passw
         return KERNEL_ERROR_STA_CREDENTIALS;
     }
 
-    logger_print(DEBUG, TAG, "Wi-Fi credentials set: SSID='%s'", ssid_buf);
+    LOGGER_PRINT(DEBUG, TAG, "Wi-Fi credentials set: SSID='%s'", ssid_buf);
 
     return KERNEL_SUCCESS;
 }
@@ -457,7 +457,7 @@ void wifi_manager_wifi_event_handler(int32_t event_id, void* event_data) {
             break;
         }
         default:
-            logger_print(DEBUG, TAG, "Unhandled Wi-Fi event: %d", event_id);
+            LOGGER_PRINT(DEBUG, TAG, "Unhandled Wi-Fi event: %d", event_id);
             break;
     }
 }
@@ -527,7 +527,7 @@ void wifi_manager_sta_got_ip(int32_t event_id, void* event_data) {
     }
 
     if (!ssid_changed && !pwd_changed) {
-        logger_print(DEBUG, TAG, "Credentials unchanged, NVS update skipped");
+        LOGGER_PRINT(DEBUG, TAG, "Credentials unchanged, NVS update skipped");
     }
 
     wifi_status_set_sta(true);
@@ -555,13 +555,13 @@ void wifi_manager_manage_connection() {
     }
 
     if (connection_retry_counter < MAX_RECONNECT_ATTEMPTS) {
-        logger_print(DEBUG, TAG, "Reconnecting to the STA (Attempt %d of %d)...",
+        LOGGER_PRINT(DEBUG, TAG, "Reconnecting to the STA (Attempt %d of %d)...",
                      connection_retry_counter + 1,
                      MAX_RECONNECT_ATTEMPTS);
 
         esp_err_t err = ESP_ERROR_CHECK_WITHOUT_ABORT(esp_wifi_connect());
         if (err == ESP_OK) {
-            logger_print(DEBUG, TAG, "Connection attempt initiated.");
+            LOGGER_PRINT(DEBUG, TAG, "Connection attempt initiated.");
             connection_retry_counter++;
         } else {
             logger_print(ERR, TAG, "Reconnect attempt failed: %s", esp_err_to_name(err));
@@ -80,13 +80,13 @@ void sntp_task_execute(void *pvParameters) {
         vTaskDelete(NULL);
     }
 
-    logger_print(DEBUG, TAG, "Waiting for Wi-Fi connection...");
+    LOGGER_PRINT(DEBUG, TAG, "Waiting for Wi-Fi connection...");
     
     
     while (1) {
         EventBits_t firmware_event_bits = xEventGroupGetBits(_global_structures->global_events.firmware_event_group);
         if (firmware_event_bits & STA_GOT_IP) {
-            logger_print(DEBUG, TAG, "Trying to synchronize time...");
+            LOGGER_PRINT(DEBUG, TAG, "Trying to synchronize time...");
             sntp_task_sync_time_obtain_time();
         }
 
@@ -17,6 +17,8 @@
  * - **MQTT Task**: Manages MQTT client operations, including connecting
  *   to the broker, subscribing, and publishing messages.
  * - **SNTP Task**: Synchronizes the system time with an SNTP server.
+ * - **Logger Task**: Sends queued log messages to the serial or UDP output.
+ * - **Log Resolver Task**: Resolves the UDP log host off the logging path.
  *
  * Note: Modify the priorities and stack sizes as needed based on the
  * task execution requirements and system constraints.
@@ -55,4 +57,15 @@
 #define SNTP_TASK_NAME "SNTP Task"
 #define SNTP_TASK_DELAY 1000  // Delay in milliseconds
 
+// Logger Task configuration
+#define LOGGER_TASK_PRIORITY 1
+#define LOGGER_TASK_STACK_SIZE (2048 * 2)
+#define LOGGER_TASK_NAME "Logger Task"
+#define LOGGER_TASK_DELAY 100  // Delay in milliseconds
+
+// Log Resolver Task configuration
+#define LOG_RESOLVER_TASK_PRIORITY 1
+#define LOG_RESOLVER_TASK_STACK_SIZE (2048 + 1024)
+#define LOG_RESOLVER_TASK_NAME "Log Resolver Task"
+
 #endif /* TASK_DEFINITION_H */
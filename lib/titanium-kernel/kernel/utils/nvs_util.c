@@ -123,6 +123,113 @@ kernel_error_st nvs_util_load_str(const char *nvs_namespace, const char *key, ch
     return KERNEL_SUCCESS;
 }
 
+/**
+ * @brief Save a binary blob into NVS.
+ *
+ * The blob is written and committed in one open/commit/close cycle, so a
+ * whole structure costs a single flash commit.
+ *
+ * @param nvs_namespace  The NVS namespace.
+ * @param key            The key under which to store the blob.
+ * @param value          The data to store.
+ * @param size           Size of the data in bytes.
+ *
+ * @return KERNEL_SUCCESS on success,
+ *         KERNEL_ERROR_NULL if any input is NULL,
+ *         KERNEL_ERROR_INVALID_SIZE if size is 0,
+ *         KERNEL_ERROR_NVS_NOT_INITIALIZED if NVS is not initialized,
+ *         KERNEL_ERROR_NVS_OPEN or KERNEL_ERROR_NVS_SAVE on failure.
+ */
+kernel_error_st nvs_util_save_blob(const char *nvs_namespace, const char *key, const void *value, size_t size) {
+    nvs_handle_t handle;
+
+    if (nvs_namespace == NULL || key == NULL || value == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (!is_nvs_initialized) {
+        return KERNEL_ERROR_NVS_NOT_INITIALIZED;
+    }
+
+    if (size == 0) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
+    esp_err_t result = nvs_open(nvs_namespace, NVS_READWRITE, &handle);
+    if (result != ESP_OK) {
+        return KERNEL_ERROR_NVS_OPEN;
+    }
+
+    result = nvs_set_blob(handle, key, value, size);
+    if (result == ESP_OK) {
+        result = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (result != ESP_OK) {
+        return KERNEL_ERROR_NVS_SAVE;
+    }
+
+    return KERNEL_SUCCESS;
+}
+
+/**
+ * @brief Load a binary blob from NVS into a user-provided buffer.
+ *
+ * @param nvs_namespace  The NVS namespace.
+ * @param key            The key of the stored blob.
+ * @param out_value      Buffer to store the blob.
+ * @param size           In: capacity of the buffer in bytes. Out: size of the stored blob.
+ *
+ * @return KERNEL_SUCCESS on success,
+ *         KERNEL_ERROR_NULL or KERNEL_ERROR_INVALID_SIZE for invalid arguments,
+ *         KERNEL_ERROR_INVALID_SIZE if the stored blob does not fit the buffer,
+ *         KERNEL_ERROR_NVS_NOT_INITIALIZED if NVS is not initialized,
+ *         KERNEL_ERROR_NVS_NOT_FOUND if the key does not exist,
+ *         KERNEL_ERROR_NVS_OPEN or KERNEL_ERROR_NVS_LOAD on failure.
+ */
+kernel_error_st nvs_util_load_blob(const char *nvs_namespace, const char *key, void *out_value, size_t *size) {
+    nvs_handle_t handle;
+
+    if (nvs_namespace == NULL || key == NULL || out_value == NULL || size == NULL) {
+        return KERNEL_ERROR_NULL;
+    }
+
+    if (!is_nvs_initialized) {
+        return KERNEL_ERROR_NVS_NOT_INITIALIZED;
+    }
+
+    if (*size == 0) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
+    esp_err_t result = nvs_open(nvs_namespace, NVS_READONLY, &handle);
+    if (result == ESP_ERR_NVS_NOT_FOUND) {
+        return KERNEL_ERROR_NVS_NOT_FOUND;  // Namespace never written
+    }
+    if (result != ESP_OK) {
+        return KERNEL_ERROR_NVS_OPEN;
+    }
+
+    size_t capacity = *size;
+    result          = nvs_get_blob(handle, key, out_value, size);
+    nvs_close(handle);
+
+    if (result == ESP_ERR_NVS_NOT_FOUND) {
+        return KERNEL_ERROR_NVS_NOT_FOUND;
+    }
+
+    if (result == ESP_ERR_NVS_INVALID_LENGTH || *size > capacity) {
+        return KERNEL_ERROR_INVALID_SIZE;
+    }
+
+    if (result != ESP_OK) {
+        return KERNEL_ERROR_NVS_LOAD;
+    }
+
+    return KERNEL_SUCCESS;
+}
+
 /**
  * @brief Erase a single key from the NVS.
  *
@@ -47,6 +47,42 @@ kernel_error_st nvs_util_save_str(const char *nvs_namespace, const char *key, co
  */
 kernel_error_st nvs_util_load_str(const char *nvs_namespace, const char *key, char *out_value, size_t max_len);
 
+/**
+ * @brief Save a binary blob into NVS.
+ *
+ * The blob is written and committed in one open/commit/close cycle, so a
+ * whole structure costs a single flash commit.
+ *
+ * @param nvs_namespace  The NVS namespace.
+ * @param key            The key under which to store the blob.
+ * @param value          The data to store.
+ * @param size           Size of the data in bytes.
+ *
+ * @return KERNEL_SUCCESS on success,
+ *         KERNEL_ERROR_NULL if any input is NULL,
+ *         KERNEL_ERROR_INVALID_SIZE if size is 0,
+ *         KERNEL_ERROR_NVS_NOT_INITIALIZED if NVS is not initialized,
+ *         KERNEL_ERROR_NVS_OPEN or KERNEL_ERROR_NVS_SAVE on failure.
+ */
+kernel_error_st nvs_util_save_blob(const char *nvs_namespace, const char *key, const void *value, size_t size);
+
+/**
+ * @brief Load a binary blob from NVS into a user-provided buffer.
+ *
+ * @param nvs_namespace  The NVS namespace.
+ * @param key            The key of the stored blob.
+ * @param out_value      Buffer to store the blob.
+ * @param size           In: capacity of the buffer in bytes. Out: size of the stored blob.
+ *
+ * @return KERNEL_SUCCESS on success,
+ *         KERNEL_ERROR_NULL or KERNEL_ERROR_INVALID_SIZE for invalid arguments,
+ *         KERNEL_ERROR_INVALID_SIZE if the stored blob does not fit the buffer,
+ *         KERNEL_ERROR_NVS_NOT_INITIALIZED if NVS is not initialized,
+ *         KERNEL_ERROR_NVS_NOT_FOUND if the key does not exist,
+ *         KERNEL_ERROR_NVS_OPEN or KERNEL_ERROR_NVS_LOAD on failure.
+ */
+kernel_error_st nvs_util_load_blob(const char *nvs_namespace, const char *key, void *out_value, size_t *size);
+
 /**
  * @brief Erase a single key from the NVS.
  *
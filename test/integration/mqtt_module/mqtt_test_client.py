@@ -10,17 +10,27 @@ class MqttTestClient:
         self.client.connect(broker, port, 60)
         self.client.loop_start()
         self._messages = {}
+        self._binary_topics = set()
         self.client.on_message = self._on_message
 
     def _on_message(self, client, userdata, msg):
-        payload = json.loads(msg.payload.decode())
         topic = msg.topic
+        if topic in self._binary_topics:
+            payload = msg.payload
+        else:
+            payload = json.loads(msg.payload.decode())
         if topic not in self._messages:
             self._messages[topic] = []
         self._messages[topic].append(payload)
 
-    def subscribe(self, topic):
-        self.client.subscribe(topic)
+    def subscribe(self, topic, qos=0, binary=False):
+        """
+        Subscribes to a topic. Messages of a binary topic are kept as bytes
+        instead of being decoded as JSON.
+        """
+        if binary:
+            self._binary_topics.add(topic)
+        self.client.subscribe(topic, qos)
         time.sleep(0.2)  # ensure subscription is active
 
     def publish(self, topic, payload):
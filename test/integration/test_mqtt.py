@@ -4,6 +4,7 @@ import math
 import os
 import pytest
 import random
+import struct
 import time
 
 from mqtt_module import MqttTestClient
@@ -301,6 +302,291 @@ def test_calibration_command_invalid_offset():
     finally:
         mqtt_client.stop()
 
+@pytest.mark.high
+def test_calibration_command_pipelined():
+    """
+    Validates that pipelined calibration commands are matched by correlation ID.
+
+    Steps:
+    1. Send a window of calibration commands, each with its own "id", without
+       waiting for the responses.
+    2. Collect one response per command.
+    3. Confirm that every id is answered once, with command_status=0 and the
+       parameters of the command that carried it.
+    """
+    logging.info(test_calibration_command_pipelined.__doc__)
+
+    topic_req = f"iocloud/request/{_DEVICE_ID}/command"
+    topic_resp = f"iocloud/response/{_DEVICE_ID}/command"
+    window = 8
+
+    with open(os.path.join(_THIS_PATH, "templates", "default_calibration_command.json"), "r") as f:
+        template = json.load(f)
+
+    mqtt_client = MqttTestClient()
+    try:
+        mqtt_client.subscribe(topic_resp)
+        mqtt_client.clear_message_list(topic_resp)
+
+        expected = {}
+        first_id = random.randint(1, 1_000_000)
+        for i in range(window):
+            command = json.loads(json.dumps(template))
+            command["id"] = first_id + i
+            command["params"]["sensor_id"] = i % 4
+            command["params"]["gain"] = round(1.0 + (i / 100), 2)
+            command["params"]["offset"] = 0.0
+            expected[command["id"]] = command["params"]
+            mqtt_client.publish(topic_req, command)
+
+        for _ in range(window):
+            message = mqtt_client.wait_for_message(topic_resp, timeout=25)
+            logging.debug(f"Pipelined response: {message}")
+
+            assert message["command_status"] == 0
+            params = expected.pop(message["id"])
+            assert message["sensor_id"] == params["sensor_id"]
+            assert math.isclose(message["gain"], params["gain"], rel_tol=1e-2)
+
+        assert not expected, f"Unanswered ids: {sorted(expected)}"
+
+        # Restore the calibration of the sensors used above.
+        for sensor_id in range(4):
+            send_and_validate_calibration(mqtt_client, sensor_id=sensor_id, gain=1.0, offset=0.0)
+    finally:
+        mqtt_client.stop()
+
+
+@pytest.mark.high
+def test_calibration_command_batch():
+    """
+    Validates that a calibration batch is applied atomically with one response.
+
+    Steps:
+    1. Send a batch calibrating every sensor and confirm one response with
+       command_status=0 and one item status of 0 per sensor.
+    2. Read the calibration back with the system info command.
+    3. Send a batch with a repeated sensor and confirm command_status=-2, the
+       repeated item reported -2 and the others -6 (not applied).
+    4. Confirm the calibration from step 1 is unchanged, then restore it.
+    """
+    logging.info(test_calibration_command_batch.__doc__)
+
+    topic_req = f"iocloud/request/{_DEVICE_ID}/command"
+    topic_resp = f"iocloud/response/{_DEVICE_ID}/command"
+    num_of_sensors = 26
+
+    def send_batch(mqtt_client, calibrations, correlation_id):
+        command = {"command": 3, "id": correlation_id, "params": {"calibrations": calibrations}}
+        mqtt_client.clear_message_list(topic_resp)
+        mqtt_client.publish(topic_req, command)
+        message = mqtt_client.wait_for_message(topic_resp, timeout=25)
+        if message is None:
+            raise TimeoutError("No message received within the timeout period.")
+        logging.debug(f"Batch response: {message}")
+
+        assert message["command_index"] == 3
+        assert message["id"] == correlation_id
+        assert len(message["item_status"]) == len(calibrations)
+        return message
+
+    mqtt_client = MqttTestClient()
+    try:
+        mqtt_client.subscribe(topic_resp)
+
+        batch = [
+            {"sensor_id": i, "gain": round(1.0 + (i / 100), 2), "offset": round(i / 10, 1)}
+            for i in range(num_of_sensors)
+        ]
+        message = send_batch(mqtt_client, batch, random.randint(1, 1_000_000))
+        assert message["command_status"] == 0
+        assert message["item_status"] == [0] * num_of_sensors
+
+        system_info = send_and_validate_system_info(mqtt_client, "root", "root")
+        for item in batch:
+            sensor = system_info["sensors"][item["sensor_id"]]
+            assert math.isclose(sensor["gain"], item["gain"], rel_tol=1e-2)
+            assert math.isclose(sensor["offset"], item["offset"], abs_tol=1e-2)
+
+        rejected = [
+            {"sensor_id": 0, "gain": 5.0, "offset": 5.0},
+            {"sensor_id": 0, "gain": 6.0, "offset": 6.0},
+            {"sensor_id": 1, "gain": 7.0, "offset": 7.0},
+        ]
+        message = send_batch(mqtt_client, rejected, random.randint(1, 1_000_000))
+        assert message["command_status"] == -2
+        assert message["item_status"] == [-6, -2, -6]
+
+        system_info = send_and_validate_system_info(mqtt_client, "root", "root")
+        for item in batch[:2]:
+            sensor = system_info["sensors"][item["sensor_id"]]
+            assert math.isclose(sensor["gain"], item["gain"], rel_tol=1e-2)
+
+        # Restore the default calibration of every sensor.
+        restore = [{"sensor_id": i, "gain": 1.0, "offset": 0.0} for i in range(num_of_sensors)]
+        message = send_batch(mqtt_client, restore, random.randint(1, 1_000_000))
+        assert message["command_status"] == 0
+    finally:
+        mqtt_client.stop()
+
+
+@pytest.mark.high
+def test_get_history_command():
+    """
+    Validates that a history request is acknowledged on the command topic.
+
+    Steps:
+    1. Request the last hour of logged data and confirm a header-only response
+       with command_status=0 and the request id.
+    2. Send a negative offset and confirm command_status=-1.
+    3. Send an empty range (from after to) to cancel the stream of step 1.
+
+    The chunks themselves are checked by test_get_history_stream.
+    """
+    logging.info(test_get_history_command.__doc__)
+
+    topic_req = f"iocloud/request/{_DEVICE_ID}/command"
+    topic_resp = f"iocloud/response/{_DEVICE_ID}/command"
+
+    def send_get_history(mqtt_client, start, end, offset, correlation_id):
+        command = {"command": 4, "id": correlation_id, "params": {"from": start, "to": end, "offset": offset}}
+        mqtt_client.clear_message_list(topic_resp)
+        mqtt_client.publish(topic_req, command)
+        message = mqtt_client.wait_for_message(topic_resp, timeout=25)
+        if message is None:
+            raise TimeoutError("No message received within the timeout period.")
+        logging.debug(f"History response: {message}")
+
+        assert message["command_index"] == 4
+        assert message["id"] == correlation_id
+        return message
+
+    mqtt_client = MqttTestClient()
+    try:
+        mqtt_client.subscribe(topic_resp)
+        now = int(time.time())
+
+        message = send_get_history(mqtt_client, now - 3600, now, 0, random.randint(1, 1_000_000))
+        assert message["command_status"] == 0
+
+        message = send_get_history(mqtt_client, now - 3600, now, -1, random.randint(1, 1_000_000))
+        assert message["command_status"] == -1
+
+        message = send_get_history(mqtt_client, now, now - 1, 0, random.randint(1, 1_000_000))
+        assert message["command_status"] == 0
+    finally:
+        mqtt_client.stop()
+
+
+_HISTORY_CHUNK_HEADER = struct.Struct("<4sBBBBII")
+_HISTORY_CHUNK_LAST = 0x01
+_HISTORY_CHUNK_ABORTED = 0x02
+
+
+def receive_history_stream(mqtt_client, topic, correlation_id, ignored_ids=()):
+    """
+    Collects the chunks of one history stream, up to the chunk with the LAST
+    flag, and checks their headers.
+
+    Chunks of the streams in `ignored_ids`, which a new request replaced, may
+    still arrive and are skipped.
+
+    Returns:
+        list of (sequence, [record bytes]) in arrival order.
+    """
+    chunks = []
+    while True:
+        data = mqtt_client.wait_for_message(topic, timeout=60)
+        assert len(data) >= _HISTORY_CHUNK_HEADER.size, f"Chunk too short: {len(data)} bytes"
+
+        magic, version, flags, num_of_sensors, count, request_id, sequence = _HISTORY_CHUNK_HEADER.unpack_from(data)
+        if request_id in ignored_ids:
+            continue
+
+        logging.debug(f"History chunk {sequence}: {count} records, flags {flags}")
+        assert magic == b"VXLC"
+        assert version == 2
+        assert request_id == correlation_id
+        assert not (flags & _HISTORY_CHUNK_ABORTED), f"Stream aborted at chunk {sequence}"
+
+        record_size = 12 + 4 * num_of_sensors
+        assert len(data) == _HISTORY_CHUNK_HEADER.size + count * record_size
+        records = [
+            data[_HISTORY_CHUNK_HEADER.size + i * record_size : _HISTORY_CHUNK_HEADER.size + (i + 1) * record_size]
+            for i in range(count)
+        ]
+        chunks.append((sequence, records))
+
+        if flags & _HISTORY_CHUNK_LAST:
+            return chunks
+
+
+@pytest.mark.high
+def test_get_history_stream():
+    """
+    Validates the chunks of a history stream and its resumption.
+
+    Steps:
+    1. Request the last ten minutes of logged data and collect the chunks on
+       the history topic up to the one with the LAST flag.
+    2. Confirm every chunk carries the request id, the sequence numbers run
+       from 0 without gaps, and the record timestamps lie in the range in
+       ascending order.
+    3. Request the same range with offset=k and confirm the stream resumes
+       at chunk k with the same records.
+    """
+    logging.info(test_get_history_stream.__doc__)
+
+    topic_req = f"iocloud/request/{_DEVICE_ID}/command"
+    topic_resp = f"iocloud/response/{_DEVICE_ID}/command"
+    topic_history = f"iocloud/response/{_DEVICE_ID}/history"
+
+    def request_history(mqtt_client, start, end, offset, correlation_id):
+        command = {"command": 4, "id": correlation_id, "params": {"from": start, "to": end, "offset": offset}}
+        mqtt_client.publish(topic_req, command)
+        message = mqtt_client.wait_for_message(topic_resp, timeout=25)
+        logging.debug(f"History response: {message}")
+
+        assert message["command_index"] == 4
+        assert message["id"] == correlation_id
+        assert message["command_status"] == 0
+
+    mqtt_client = MqttTestClient()
+    try:
+        mqtt_client.subscribe(topic_resp)
+        mqtt_client.subscribe(topic_history, qos=1, binary=True)
+        time.sleep(2)  # let chunks of an earlier stream drain
+        mqtt_client.clear_message_list()
+
+        # Fixed bounds, in the past, so both requests select the same records.
+        end = int(time.time()) - 60
+        start = end - 600
+
+        first_id = random.randint(1, 1_000_000)
+        request_history(mqtt_client, start, end, 0, first_id)
+        chunks = receive_history_stream(mqtt_client, topic_history, first_id)
+
+        assert [sequence for sequence, _ in chunks] == list(range(len(chunks)))
+
+        timestamps = [struct.unpack_from("<q", record)[0] for _, records in chunks for record in records]
+        assert timestamps, "No records logged in the requested range"
+        assert all(start <= t <= end for t in timestamps)
+        assert timestamps == sorted(timestamps)
+
+        if len(chunks) < 2:
+            pytest.skip("The range fits one chunk, resumption cannot be checked")
+
+        resume_at = len(chunks) // 2
+        resumed_id = first_id + 1
+        request_history(mqtt_client, start, end, resume_at, resumed_id)
+        resumed = receive_history_stream(mqtt_client, topic_history, resumed_id, ignored_ids=(first_id,))
+
+        assert [sequence for sequence, _ in resumed] == list(range(resume_at, len(chunks)))
+        assert [records for _, records in resumed] == [records for _, records in chunks[resume_at:]]
+    finally:
+        mqtt_client.stop()
+
+
 @pytest.mark.high
 def test_system_info_command_single():
     """
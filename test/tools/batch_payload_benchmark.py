@@ -0,0 +1,94 @@
+"""
+Host benchmark for batched sensor-report payloads.
+
+Builds the sensor/report payloads exactly as the firmware serializes them
+(single report vs. batched reports sharing one header) and prints the
+bytes on the wire per sample, including the MQTT PUBLISH fixed header,
+the topic string and a per-packet TCP/IP overhead, for increasing batch sizes.
+
+Usage:
+    python batch_payload_benchmark.py [--sensors 26] [--max-batch 8] [--payload-limit 2048] [--link-overhead 40]
+"""
+
+import argparse
+import json
+import random
+
+DEVICE_ID = "1C69209DB778"
+TOPIC = f"iocloud/response/{DEVICE_ID}/sensor/report"
+REPORT_PERIOD_S = 5
+
+
+def firmware_value(value):
+    """Same rounding as serialize_data_report(): two decimals."""
+    return int(value * 100 + 0.5) / 100.0
+
+
+def sensor_array(sensors):
+    return [{"value": firmware_value(v), "active": a} for v, a in sensors]
+
+
+def single_payload(report):
+    doc = {"timestamp": report["timestamp"], "sensors": sensor_array(report["sensors"])}
+    return json.dumps(doc, separators=(",", ":"))
+
+
+def batch_payload(reports):
+    base = reports[0]["timestamp"]
+    doc = {
+        "timestamp": base,
+        "samples": [
+            {"dt": r["timestamp"] - base, "sensors": sensor_array(r["sensors"])}
+            for r in reports
+        ],
+    }
+    return json.dumps(doc, separators=(",", ":"))
+
+
+def mqtt_publish_size(payload_length, link_overhead, topic=TOPIC):
+    """Size of a QoS 0 PUBLISH packet: link overhead + fixed header + topic + payload."""
+    remaining = 2 + len(topic) + payload_length
+    length_bytes = 1
+    while remaining >= 128 ** length_bytes:
+        length_bytes += 1
+    return link_overhead + 1 + length_bytes + remaining
+
+
+def make_reports(count, num_sensors):
+    rng = random.Random(1234)
+    start = 1751898180
+    return [
+        {
+            "timestamp": start + i * REPORT_PERIOD_S,
+            "sensors": [(rng.uniform(-40.0, 120.0), rng.randint(0, 1)) for _ in range(num_sensors)],
+        }
+        for i in range(count)
+    ]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--sensors", type=int, default=26, help="sensors per report (NUM_OF_SENSORS)")
+    parser.add_argument("--max-batch", type=int, default=8, help="largest batch size to evaluate")
+    parser.add_argument("--payload-limit", type=int, default=2048, help="MQTT_MAXIMUM_PAYLOAD_LENGTH")
+    parser.add_argument("--link-overhead", type=int, default=40, help="TCP/IPv4 header bytes per PUBLISH")
+    args = parser.parse_args()
+
+    reports = make_reports(args.max_batch, args.sensors)
+
+    single_wire = sum(mqtt_publish_size(len(single_payload(r)), args.link_overhead) for r in reports) / len(reports)
+    print(f"Topic: {TOPIC}")
+    print(f"Single report: {single_wire:.1f} bytes/sample on the wire\n")
+    print(f"{'N':>3} {'payload':>8} {'wire':>8} {'bytes/sample':>13} {'saving':>8} {'fits':>5}")
+
+    for n in range(1, args.max_batch + 1):
+        payload = batch_payload(reports[:n])
+        wire = mqtt_publish_size(len(payload), args.link_overhead)
+        per_sample = wire / n
+        saving = 100.0 * (1.0 - per_sample / single_wire)
+        fits = "yes" if len(payload) < args.payload_limit else "no"
+        print(f"{n:>3} {len(payload):>8} {wire:>8} {per_sample:>13.1f} {saving:>7.1f}% {fits:>5}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,195 @@
+/**
+ * Host benchmark: streaming JSON writer vs. the former ArduinoJson DOM path.
+ *
+ * Serializes the same device and health reports with the ArduinoJson code
+ * previously used by serializer_handlers.cc and with the streaming writer
+ * (app/iot/json_writer.cc) that replaced it, checks that both outputs are
+ * byte-identical, then prints encode time and the static RAM of the removed
+ * serialize document.
+ *
+ * Build and run from the repository root:
+ *   g++ -O2 -std=gnu++17 -Ilib/titanium-kernel -Ilib/titanium-app \
+ *       test/tools/json_writer_benchmark.cpp lib/titanium-app/app/iot/json_writer.cc -o json_writer_benchmark
+ *   ./json_writer_benchmark
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "app/iot/json_writer.h"
+#include "app/sensor_manager/sensor_types.h"
+#include "app/third_party/json_handler.h"
+
+static constexpr int ITERATIONS         = 20000;
+static constexpr int PARITY_REPORTS     = 100000;
+static constexpr size_t PAYLOAD_LENGTH  = 2048;  // MQTT_MAXIMUM_PAYLOAD_LENGTH
+static constexpr int NUM_OF_TASKS       = 8;
+static constexpr size_t TASK_NAME_SIZE  = 16;
+static constexpr size_t SERIALIZE_DOC   = 3072;  // former MAXIMUM_SERIALIZE_DOC_SIZE
+
+static StaticJsonDocument<SERIALIZE_DOC> serialize_doc;
+
+struct device_report_t {
+    int64_t timestamp;
+    sensor_report_st sensors[NUM_OF_SENSORS];
+    uint8_t num_of_sensors;
+};
+
+struct health_report_t {
+    uint8_t num_of_tasks;
+    struct {
+        char task_name[TASK_NAME_SIZE];
+        uint32_t high_water_mark;
+    } task_health[NUM_OF_TASKS];
+};
+
+static size_t dom_device_report(const device_report_t &report, char *out, size_t size) {
+    serialize_doc.clear();
+    serialize_doc["timestamp"] = report.timestamp;
+
+    JsonArray sensors = serialize_doc.createNestedArray("sensors");
+    for (int i = 0; i < report.num_of_sensors; i++) {
+        JsonObject sensor = sensors.createNestedObject();
+        sensor["value"]   = (int)(report.sensors[i].value * 100 + 0.5) / 100.00f;
+        sensor["active"]  = report.sensors[i].active;
+    }
+
+    return serializeJson(serialize_doc, out, size);
+}
+
+static size_t writer_device_report(const device_report_t &report, char *out, size_t size) {
+    json_writer_st writer;
+    json_writer_begin(&writer, out, size);
+
+    json_writer_object_begin(&writer);
+    json_writer_key(&writer, "timestamp");
+    json_writer_int(&writer, report.timestamp);
+    json_writer_key(&writer, "sensors");
+    json_writer_array_begin(&writer);
+    for (int i = 0; i < report.num_of_sensors; i++) {
+        json_writer_object_begin(&writer);
+        json_writer_key(&writer, "value");
+        json_writer_fixed2(&writer, (int32_t)(report.sensors[i].value * 100 + 0.5));
+        json_writer_key(&writer, "active");
+        json_writer_bool(&writer, report.sensors[i].active);
+        json_writer_object_end(&writer);
+    }
+    json_writer_array_end(&writer);
+    json_writer_object_end(&writer);
+
+    return json_writer_end(&writer);
+}
+
+static size_t dom_health_report(const health_report_t &report, char *out, size_t size) {
+    serialize_doc.clear();
+    serialize_doc["num_of_tasks"] = report.num_of_tasks;
+
+    JsonArray tasks = serialize_doc.createNestedArray("tasks");
+    for (int i = 0; i < report.num_of_tasks; i++) {
+        JsonObject task         = tasks.createNestedObject();
+        task["name"]            = report.task_health[i].task_name;
+        task["high_water_mark"] = report.task_health[i].high_water_mark;
+    }
+
+    return serializeJson(serialize_doc, out, size);
+}
+
+static size_t writer_health_report(const health_report_t &report, char *out, size_t size) {
+    json_writer_st writer;
+    json_writer_begin(&writer, out, size);
+
+    json_writer_object_begin(&writer);
+    json_writer_key(&writer, "num_of_tasks");
+    json_writer_uint(&writer, report.num_of_tasks);
+    json_writer_key(&writer, "tasks");
+    json_writer_array_begin(&writer);
+    for (int i = 0; i < report.num_of_tasks; i++) {
+        json_writer_object_begin(&writer);
+        json_writer_key(&writer, "name");
+        json_writer_string(&writer, report.task_health[i].task_name);
+        json_writer_key(&writer, "high_water_mark");
+        json_writer_uint(&writer, report.task_health[i].high_water_mark);
+        json_writer_object_end(&writer);
+    }
+    json_writer_array_end(&writer);
+    json_writer_object_end(&writer);
+
+    return json_writer_end(&writer);
+}
+
+static void random_device_report(std::mt19937 &rng, device_report_t &report) {
+    std::uniform_real_distribution<float> value(-40.0f, 1200.0f);
+
+    report.timestamp      = 1751898180 + (rng() % 100000);
+    report.num_of_sensors = NUM_OF_SENSORS;
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        report.sensors[i].value  = value(rng);
+        report.sensors[i].active = (rng() & 1) != 0;
+    }
+}
+
+template <typename F>
+static double time_ns(F &&encode) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        encode();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+int main() {
+    static char dom_buffer[PAYLOAD_LENGTH];
+    static char writer_buffer[PAYLOAD_LENGTH];
+    std::mt19937 rng(1234);
+
+    device_report_t device_report{};
+    int mismatches = 0;
+    for (int n = 0; n < PARITY_REPORTS; n++) {
+        random_device_report(rng, device_report);
+        size_t dom_size    = dom_device_report(device_report, dom_buffer, sizeof(dom_buffer));
+        size_t writer_size = writer_device_report(device_report, writer_buffer, sizeof(writer_buffer));
+        if ((dom_size != writer_size) || (memcmp(dom_buffer, writer_buffer, dom_size) != 0)) {
+            if (mismatches++ == 0) {
+                printf("mismatch:\n  dom:    %s\n  writer: %s\n", dom_buffer, writer_buffer);
+            }
+        }
+    }
+
+    health_report_t health_report{};
+    const char *task_names[NUM_OF_TASKS] = {"MQTT Task", "Sensor Task", "Network Task", "SD Card Task",
+                                            "Command Task", "Health Task", "Log \"Task\"", "SNTP\tTask"};
+    health_report.num_of_tasks = NUM_OF_TASKS;
+    for (int i = 0; i < NUM_OF_TASKS; i++) {
+        snprintf(health_report.task_health[i].task_name, TASK_NAME_SIZE, "%s", task_names[i]);
+        health_report.task_health[i].high_water_mark = 128 + (i * 97);
+    }
+    size_t dom_health    = dom_health_report(health_report, dom_buffer, sizeof(dom_buffer));
+    size_t writer_health = writer_health_report(health_report, writer_buffer, sizeof(writer_buffer));
+    if ((dom_health != writer_health) || (memcmp(dom_buffer, writer_buffer, dom_health) != 0)) {
+        printf("health mismatch:\n  dom:    %s\n  writer: %s\n", dom_buffer, writer_buffer);
+        mismatches++;
+    }
+
+    printf("Parity: %d device reports + 1 health report, %d mismatches\n\n", PARITY_REPORTS, mismatches);
+
+    volatile size_t sink = 0;
+    size_t device_size   = dom_device_report(device_report, dom_buffer, sizeof(dom_buffer));
+
+    double dom_device_ns    = time_ns([&] { sink = sink + dom_device_report(device_report, dom_buffer, sizeof(dom_buffer)); });
+    double writer_device_ns = time_ns([&] { sink = sink + writer_device_report(device_report, writer_buffer, sizeof(writer_buffer)); });
+    double dom_health_ns    = time_ns([&] { sink = sink + dom_health_report(health_report, dom_buffer, sizeof(dom_buffer)); });
+    double writer_health_ns = time_ns([&] { sink = sink + writer_health_report(health_report, writer_buffer, sizeof(writer_buffer)); });
+
+    printf("%-28s %8s %12s %12s %8s\n", "payload", "bytes", "DOM ns", "writer ns", "speedup");
+    printf("%-28s %8zu %12.0f %12.0f %7.1fx\n", "device report (26 sensors)", device_size, dom_device_ns, writer_device_ns,
+           dom_device_ns / writer_device_ns);
+    printf("%-28s %8zu %12.0f %12.0f %7.1fx\n", "health report (8 tasks)", dom_health, dom_health_ns, writer_health_ns,
+           dom_health_ns / writer_health_ns);
+    printf("\n.bss freed: %zu bytes (StaticJsonDocument<%zu>); writer state on the stack: %zu bytes\n",
+           sizeof(serialize_doc), SERIALIZE_DOC, sizeof(json_writer_st));
+
+    return mismatches == 0 ? 0 : 1;
+}
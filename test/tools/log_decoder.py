@@ -0,0 +1,176 @@
+"""
+Host decoder for binary log records (kernel/logger/log_codec.h).
+
+With the UDP_BINARY log output the firmware sends each message as a binary
+record holding the addresses of its format and tag strings, a timestamp, a
+task index and the raw 32-bit arguments. This tool reads the strings from
+the firmware ELF and prints the messages as the serial output would:
+
+    [    123456 ms] [ERROR] task 4 Sensor Manager: Failed to read sensor at index 2: error 1030
+
+Usage:
+    python log_decoder.py --elf .pio/build/<env>/firmware.elf [--port 5657]
+    python log_decoder.py --elf .pio/build/<env>/firmware.elf --file capture.bin
+"""
+
+import argparse
+import re
+import socket
+import struct
+import sys
+
+LOG_CODEC_MAGIC = 0xA5
+LOG_CODEC_TASK_UNKNOWN = 0xFF
+HEADER = struct.Struct("<BBBBIII")
+LEVELS = {0: "[INFO]", 1: "[WARN]", 2: "[ERROR]", 3: "[DEBUG]"}
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+CONVERSION = re.compile(r"%(?P<spec>[-+ #0-9.]*)(?P<length>[hlzt]*)(?P<conversion>[a-zA-Z%]?)")
+
+
+class LogDecodeError(ValueError):
+    pass
+
+
+class ElfStrings:
+    """Reads NUL-terminated strings at their load address from the allocated sections of an ELF."""
+
+    def __init__(self, path):
+        with open(path, "rb") as elf:
+            self.data = elf.read()
+
+        if self.data[:4] != b"\x7fELF":
+            raise LogDecodeError(f"{path} is not an ELF file")
+
+        is_64 = self.data[4] == 2
+        endian = "<" if self.data[5] == 1 else ">"
+        if is_64:
+            shoff, = struct.unpack_from(endian + "Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x3A)
+            section = struct.Struct(endian + "IIQQQQIIQQ")
+        else:
+            shoff, = struct.unpack_from(endian + "I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x2E)
+            section = struct.Struct(endian + "IIIIIIIIII")
+
+        self.sections = []
+        for i in range(shnum):
+            _name, sh_type, flags, addr, offset, size, *_ = section.unpack_from(self.data, shoff + i * shentsize)
+            if sh_type == SHT_PROGBITS and (flags & SHF_ALLOC) and size > 0:
+                self.sections.append((addr, offset, size))
+
+    def string(self, address):
+        for addr, offset, size in self.sections:
+            if addr <= address < addr + size:
+                start = offset + (address - addr)
+                end = self.data.find(b"\0", start, offset + size)
+                if end < 0:
+                    end = offset + size
+                return self.data[start:end].decode("utf-8", errors="replace")
+        return f"<0x{address:08x}>"
+
+
+def format_deferred(fmt, args):
+    """Formats a deferred message as log_codec_format() does on the device."""
+    remaining = list(args)
+
+    def convert(match):
+        conversion = match.group("conversion")
+        if match.group(0) == "%%":
+            return "%"
+        if conversion not in "diuxXoc" or not conversion or "ll" in match.group("length") or not remaining:
+            return match.group(0)
+
+        value = remaining.pop(0)
+        length = match.group("length")
+        if "hh" in length:
+            value &= 0xFF
+        elif "h" in length:
+            value &= 0xFFFF
+
+        if conversion in "di":
+            bits = 8 if "hh" in length else 16 if "h" in length else 32
+            if value >= 1 << (bits - 1):
+                value -= 1 << bits
+            conversion = "d"
+        elif conversion == "u":
+            conversion = "d"
+        elif conversion == "c":
+            value = chr(value & 0xFF)
+
+        return ("%" + match.group("spec") + conversion) % value
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode(buffer, strings):
+    """Yields the messages of a buffer holding one or more records."""
+    offset = 0
+    while offset < len(buffer):
+        if len(buffer) - offset < HEADER.size:
+            raise LogDecodeError("record shorter than header")
+
+        magic, level, task, length, timestamp, fmt, tag = HEADER.unpack_from(buffer, offset)
+        if magic != LOG_CODEC_MAGIC:
+            raise LogDecodeError(f"bad magic 0x{magic:02x} at offset {offset}")
+
+        payload = buffer[offset + HEADER.size:offset + HEADER.size + length]
+        if len(payload) != length:
+            raise LogDecodeError("truncated payload")
+        offset += HEADER.size + length
+
+        if fmt == 0:
+            text = payload.decode("utf-8", errors="replace")
+        else:
+            args = struct.unpack(f"<{length // 4}I", payload[:length - length % 4])
+            text = format_deferred(strings.string(fmt), args)
+
+        task_name = "-" if task == LOG_CODEC_TASK_UNKNOWN else str(task)
+        yield (f"[{timestamp:>10} ms] {LEVELS.get(level, f'[{level}]')} task {task_name} "
+               f"{strings.string(tag)}: {text}")
+
+
+def print_records(buffer, strings):
+    try:
+        for line in decode(buffer, strings):
+            print(line)
+    except LogDecodeError as e:
+        print(f"undecodable datagram: {e}", file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--elf", required=True, help="firmware ELF the device runs")
+    parser.add_argument("--port", type=int, default=5657, help="UDP port to listen on")
+    parser.add_argument("--file", help="decode records from a file instead of listening")
+    args = parser.parse_args()
+
+    strings = ElfStrings(args.elf)
+
+    if args.file:
+        with open(args.file, "rb") as capture:
+            print_records(capture.read(), strings)
+        return
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("0.0.0.0", args.port))
+    sock.settimeout(1.0)
+    print(f"Listening on {args.port}...")
+
+    try:
+        while True:
+            try:
+                data, _addr = sock.recvfrom(2048)
+            except socket.timeout:
+                continue
+            print_records(data, strings)
+    except KeyboardInterrupt:
+        print(f"\nStopped listening on {args.port}...")
+    finally:
+        sock.close()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,230 @@
+/**
+ * Host stress test of the logger ring (kernel/logger/log_ring.c).
+ *
+ * Checks, single-threaded, that a reserved but uncommitted slot holds back
+ * the records after it and that INFO and DEBUG records (not urgent) stop at
+ * LOG_RING_SLOTS - LOG_RING_RESERVED_SLOTS while WARN and ERR records fill
+ * the ring. Then runs several producer threads, some urgent, against one
+ * consumer that drains with pauses so the ring fills up, and checks that no
+ * committed record is lost or seen twice, that each producer's records come
+ * out in the order it logged them, that every refused reservation is
+ * counted as dropped, and that urgent producers are refused less often.
+ *
+ * Build and run from the repository root:
+ *   gcc -O2 -std=gnu17 -pthread -Ilib/titanium-kernel \
+ *       lib/titanium-kernel/kernel/logger/log_ring.c test/tools/log_ring_stress.c -o log_ring_stress
+ *   ./log_ring_stress [records per producer]
+ */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kernel/logger/log_ring.h"
+
+#define PRODUCERS 8          ///< Producer threads; the first URGENT_PRODUCERS are urgent.
+#define URGENT_PRODUCERS 2   ///< Producers logging WARN and ERR records.
+#define DEFAULT_RECORDS 200000
+
+typedef struct record_s {
+    uint32_t producer;
+    uint32_t number;
+} record_t;
+
+static log_ring_st ring;
+static record_t records[LOG_RING_SLOTS];
+
+static uint32_t records_per_producer = DEFAULT_RECORDS;
+static uint8_t *committed[PRODUCERS];  ///< Per producer: 1 for each record number that was committed.
+static uint8_t *received[PRODUCERS];   ///< Per producer: times the consumer saw each record number.
+static uint32_t refused[PRODUCERS];    ///< Per producer: reservations refused.
+static atomic_uint producers_done = 0;
+static int failures               = 0;
+
+#define CHECK(condition, ...)                 \
+    do {                                      \
+        if (!(condition)) {                   \
+            printf("FAIL: " __VA_ARGS__);     \
+            printf("\n");                     \
+            failures++;                       \
+        }                                     \
+    } while (0)
+
+static void check_uncommitted_slot(void) {
+    uint32_t first, second, position;
+
+    log_ring_init(&ring);
+    log_ring_reserve(&ring, false, &first);
+    log_ring_reserve(&ring, false, &second);
+    log_ring_commit(&ring, second);
+
+    CHECK(!log_ring_peek(&ring, &position), "a record after an uncommitted slot was taken");
+
+    log_ring_commit(&ring, first);
+    CHECK(log_ring_peek(&ring, &position) && (position == first), "the first record did not come out first");
+    log_ring_release(&ring, position);
+    CHECK(log_ring_peek(&ring, &position) && (position == second), "the second record did not follow");
+    log_ring_release(&ring, position);
+    CHECK(log_ring_is_empty(&ring) && !log_ring_peek(&ring, &position), "the ring is not empty after draining");
+}
+
+static void check_reserved_slots(void) {
+    uint32_t position;
+    uint32_t taken = 0;
+
+    log_ring_init(&ring);
+    while (log_ring_reserve(&ring, false, &position)) {
+        log_ring_commit(&ring, position);
+        taken++;
+    }
+    CHECK(taken == (LOG_RING_SLOTS - LOG_RING_RESERVED_SLOTS), "INFO took %u slots, expected %u", taken,
+          LOG_RING_SLOTS - LOG_RING_RESERVED_SLOTS);
+
+    uint32_t urgent = 0;
+    while (log_ring_reserve(&ring, true, &position)) {
+        log_ring_commit(&ring, position);
+        urgent++;
+    }
+    CHECK(urgent == LOG_RING_RESERVED_SLOTS, "WARN took %u reserved slots, expected %u", urgent, LOG_RING_RESERVED_SLOTS);
+    CHECK(log_ring_dropped(&ring) == 2, "%u drops counted, expected 2", log_ring_dropped(&ring));
+
+    /* One slot freed: still within the reserve, so only an urgent record gets it */
+    log_ring_peek(&ring, &position);
+    log_ring_release(&ring, position);
+    CHECK(!log_ring_reserve(&ring, false, &position), "INFO took a reserved slot");
+    CHECK(log_ring_reserve(&ring, true, &position), "WARN did not get the freed slot");
+    CHECK(log_ring_dropped(&ring) == 3, "%u drops counted, expected 3", log_ring_dropped(&ring));
+}
+
+static void *producer(void *arg) {
+    uint32_t id     = (uint32_t)(uintptr_t)arg;
+    bool is_urgent  = id < URGENT_PRODUCERS;
+    uint32_t number = 0;
+
+    for (uint32_t n = 0; n < records_per_producer; n++) {
+        uint32_t position;
+        if (!log_ring_reserve(&ring, is_urgent, &position)) {
+            refused[id]++;
+            sched_yield();
+            continue;
+        }
+
+        records[log_ring_slot(position)] = (record_t){id, number};
+        committed[id][number]            = 1;
+        number++;
+        log_ring_commit(&ring, position);
+    }
+
+    atomic_fetch_add(&producers_done, 1);
+    return NULL;
+}
+
+static void *consumer(void *arg) {
+    (void)arg;
+    uint32_t next[PRODUCERS] = {0};
+    uint32_t pass            = 0;
+
+    for (;;) {
+        bool done = atomic_load(&producers_done) == PRODUCERS;
+        uint32_t position;
+
+        while (log_ring_peek(&ring, &position)) {
+            record_t record = records[log_ring_slot(position)];
+            log_ring_release(&ring, position);
+
+            if (record.producer >= PRODUCERS) {
+                CHECK(0, "record from unknown producer %u", record.producer);
+                continue;
+            }
+            if (record.number < records_per_producer) {
+                received[record.producer][record.number]++;
+            }
+            CHECK(record.number == next[record.producer], "producer %u: record %u after %u", record.producer, record.number,
+                  next[record.producer]);
+            next[record.producer] = record.number + 1;
+        }
+
+        if (done && log_ring_is_empty(&ring)) {
+            return NULL;
+        }
+
+        /* Let the ring fill up now and then so the drop and reserve paths run */
+        if ((++pass % 256) == 0) {
+            for (int i = 0; i < 20; i++) {
+                sched_yield();
+            }
+        }
+    }
+}
+
+static void run_stress(void) {
+    pthread_t producers[PRODUCERS], drain;
+
+    log_ring_init(&ring);
+    for (uint32_t i = 0; i < PRODUCERS; i++) {
+        committed[i] = calloc(records_per_producer, 1);
+        received[i]  = calloc(records_per_producer, 1);
+    }
+
+    pthread_create(&drain, NULL, consumer, NULL);
+    for (uint32_t i = 0; i < PRODUCERS; i++) {
+        pthread_create(&producers[i], NULL, producer, (void *)(uintptr_t)i);
+    }
+    for (uint32_t i = 0; i < PRODUCERS; i++) {
+        pthread_join(producers[i], NULL);
+    }
+    pthread_join(drain, NULL);
+
+    uint64_t total_committed = 0, total_refused = 0, urgent_refused = 0;
+    for (uint32_t i = 0; i < PRODUCERS; i++) {
+        uint32_t lost = 0, duplicated = 0, phantom = 0, count = 0;
+        for (uint32_t n = 0; n < records_per_producer; n++) {
+            count += committed[i][n];
+            lost += committed[i][n] && (received[i][n] == 0);
+            duplicated += received[i][n] > 1;
+            phantom += !committed[i][n] && (received[i][n] != 0);
+        }
+        CHECK((lost == 0) && (duplicated == 0) && (phantom == 0), "producer %u: %u lost, %u duplicated, %u never committed",
+              i, lost, duplicated, phantom);
+
+        CHECK(count == (records_per_producer - refused[i]), "producer %u: %u records committed, %u refused", i, count, refused[i]);
+
+        total_committed += count;
+        total_refused += refused[i];
+        if (i < URGENT_PRODUCERS) {
+            urgent_refused += refused[i];
+        }
+        free(committed[i]);
+        free(received[i]);
+    }
+
+    CHECK(total_refused == log_ring_dropped(&ring), "%llu reservations refused, %u drops counted",
+          (unsigned long long)total_refused, log_ring_dropped(&ring));
+    CHECK(total_refused > 0, "the ring never filled up, the drop path did not run");
+
+    /* The reserve only refuses INFO and DEBUG, so urgent producers must be refused less often */
+    uint64_t other_refused = total_refused - urgent_refused;
+    CHECK((other_refused == 0) || ((urgent_refused * (PRODUCERS - URGENT_PRODUCERS)) < (other_refused * URGENT_PRODUCERS)),
+          "urgent producers were refused as often as the others");
+
+    printf("Stress: %d producers (%d urgent), %llu records committed, %llu dropped (%llu urgent)\n", PRODUCERS,
+           URGENT_PRODUCERS, (unsigned long long)total_committed, (unsigned long long)total_refused,
+           (unsigned long long)urgent_refused);
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        records_per_producer = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+    if (records_per_producer == 0) {
+        records_per_producer = DEFAULT_RECORDS;
+    }
+
+    check_uncommitted_slot();
+    check_reserved_slots();
+    run_stress();
+
+    printf("%d failures\n", failures);
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/**
+ * Host benchmark: packed binary sensor reports vs. the ArduinoJson path.
+ *
+ * Encodes the same device reports with the firmware packed encoder
+ * (app/iot/packed_report_codec.c) and with the ArduinoJson code used by
+ * serialize_data_report(), then prints payload size and encode time.
+ *
+ * Build and run from the repository root:
+ *   gcc -O2 -c -Ilib/titanium-kernel -Ilib/titanium-app lib/titanium-app/app/iot/packed_report_codec.c
+ *   g++ -O2 -std=gnu++17 -Ilib/titanium-kernel -Ilib/titanium-app \
+ *       test/tools/packed_benchmark.cpp packed_report_codec.o -o packed_benchmark
+ *   ./packed_benchmark
+ *
+ * Pass --dump to print one packed payload as hex next to its JSON, to check
+ * the reference decoder (test/tools/packed_report_decoder.py --hex ...).
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include "app/iot/packed_report_codec.h"
+#include "app/third_party/json_handler.h"
+
+static constexpr int ITERATIONS        = 20000;
+static constexpr size_t PAYLOAD_LENGTH = 2048;  // MQTT_MAXIMUM_PAYLOAD_LENGTH
+static constexpr uint32_t TIMESTAMP    = 1751898180;
+
+static StaticJsonDocument<3072> serialize_doc;
+
+struct report_t {
+    uint32_t timestamp;
+    sensor_report_st sensors[NUM_OF_SENSORS];
+};
+
+/* Mirrors serialize_data_report() in serializer_handlers.cc. */
+static size_t encode_json(const report_t &report, char *out, size_t size) {
+    serialize_doc.clear();
+    serialize_doc["timestamp"] = report.timestamp;
+
+    JsonArray sensors = serialize_doc.createNestedArray("sensors");
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        JsonObject sensor = sensors.createNestedObject();
+        sensor["value"]   = (int)(report.sensors[i].value * 100 + 0.5) / 100.00f;
+        sensor["active"]  = report.sensors[i].active;
+    }
+
+    return serializeJson(serialize_doc, out, size);
+}
+
+static size_t encode_packed(const report_t *reports, size_t count, uint8_t *out, size_t size) {
+    packed_report_writer_st writer = {};
+    packed_report_begin(&writer, out, size);
+
+    for (size_t i = 0; i < count; i++) {
+        if (packed_report_add(&writer, reports[i].timestamp, reports[i].sensors, NUM_OF_SENSORS) != KERNEL_SUCCESS) {
+            break;
+        }
+    }
+
+    return packed_report_end(&writer);
+}
+
+template <typename F>
+static double time_ns(F &&encode) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        encode();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+int main(int argc, char **argv) {
+    static report_t reports[16];
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> value(-40.0f, 120.0f);
+
+    for (size_t r = 0; r < 16; r++) {
+        reports[r].timestamp = TIMESTAMP + (r * 5);
+        for (int i = 0; i < NUM_OF_SENSORS; i++) {
+            reports[r].sensors[i].value  = value(rng);
+            reports[r].sensors[i].active = (rng() & 1) != 0;
+        }
+    }
+
+    static char json_buffer[PAYLOAD_LENGTH];
+    static uint8_t packed_buffer[PAYLOAD_LENGTH];
+    volatile size_t sink = 0;
+
+    size_t json_size   = encode_json(reports[0], json_buffer, sizeof(json_buffer));
+    size_t packed_size = encode_packed(reports, 1, packed_buffer, sizeof(packed_buffer));
+
+    double json_ns   = time_ns([&] { sink = sink + encode_json(reports[0], json_buffer, sizeof(json_buffer)); });
+    double packed_ns = time_ns([&] { sink = sink + encode_packed(reports, 1, packed_buffer, sizeof(packed_buffer)); });
+
+    printf("Sensors per report: %d\n\n", NUM_OF_SENSORS);
+    printf("%-22s %10s %12s\n", "encoder", "bytes", "ns/encode");
+    printf("%-22s %10zu %12.0f\n", "ArduinoJson", json_size, json_ns);
+    printf("%-22s %10zu %12.0f\n", "packed (1 sample)", packed_size, packed_ns);
+
+    size_t max_samples = (PAYLOAD_LENGTH - PACKED_REPORT_HEADER_SIZE) / packed_report_sample_size(NUM_OF_SENSORS);
+    if (max_samples > 16) {
+        max_samples = 16;
+    }
+    size_t batch_size = encode_packed(reports, max_samples, packed_buffer, sizeof(packed_buffer));
+    double batch_ns   = time_ns([&] { sink = sink + encode_packed(reports, max_samples, packed_buffer, sizeof(packed_buffer)); });
+
+    printf("packed (%2zu samples)    %10zu %12.0f  (%.1f bytes/sample)\n",
+           max_samples, batch_size, batch_ns, (double)batch_size / max_samples);
+    printf("\nSize ratio JSON/packed: %.1fx\n", (double)json_size / packed_size);
+
+    if ((argc > 1) && (strcmp(argv[1], "--dump") == 0)) {
+        packed_size = encode_packed(reports, 1, packed_buffer, sizeof(packed_buffer));
+        printf("\nJSON: %.*s\nhex:  ", (int)json_size, json_buffer);
+        for (size_t i = 0; i < packed_size; i++) {
+            printf("%02x", packed_buffer[i]);
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
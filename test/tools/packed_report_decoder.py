@@ -0,0 +1,112 @@
+"""
+Reference decoder for the packed binary sensor-report layout.
+
+Decodes payloads published by topics configured with
+MQTT_PAYLOAD_FORMAT_PACKED (see lib/titanium-app/app/iot/packed_report_codec.h)
+into the same structure as the JSON serializer:
+
+    single sample : {"timestamp": t, "sensors": [{"value": v, "active": a}, ...]}
+    several       : {"timestamp": t, "samples": [{"dt": s, "sensors": [...]}, ...]}
+
+Usage:
+    python packed_report_decoder.py <payload.bin>
+    python packed_report_decoder.py --hex 0101...
+    python packed_report_decoder.py --mqtt [--broker broker.hivemq.com]
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+PACKED_REPORT_VERSION = 1
+PACKED_REPORT_VALUE_SCALE = 100
+HEADER = struct.Struct("<BBBBI")
+
+
+class PackedReportError(ValueError):
+    pass
+
+
+def decode(payload):
+    if len(payload) < HEADER.size:
+        raise PackedReportError("payload shorter than header")
+
+    version, num_of_samples, num_of_sensors, _reserved, base_timestamp = HEADER.unpack_from(payload, 0)
+    if version != PACKED_REPORT_VERSION:
+        raise PackedReportError(f"unsupported version {version}")
+
+    mask_size = (num_of_sensors + 7) // 8
+    sample_size = 2 + mask_size + 4 * num_of_sensors
+    expected = HEADER.size + num_of_samples * sample_size
+    if len(payload) != expected:
+        raise PackedReportError(f"expected {expected} bytes, got {len(payload)}")
+
+    samples = []
+    offset = HEADER.size
+    for _ in range(num_of_samples):
+        (dt,) = struct.unpack_from("<H", payload, offset)
+        offset += 2
+        mask = payload[offset:offset + mask_size]
+        offset += mask_size
+        values = struct.unpack_from(f"<{num_of_sensors}i", payload, offset)
+        offset += 4 * num_of_sensors
+
+        sensors = [
+            {
+                "value": values[i] / PACKED_REPORT_VALUE_SCALE,
+                "active": bool(mask[i // 8] & (1 << (i % 8))),
+            }
+            for i in range(num_of_sensors)
+        ]
+        samples.append({"dt": dt, "sensors": sensors})
+
+    if num_of_samples == 1:
+        return {"timestamp": base_timestamp, "sensors": samples[0]["sensors"]}
+
+    return {"timestamp": base_timestamp, "samples": samples}
+
+
+def listen(broker, port, topic):
+    import paho.mqtt.client as mqtt
+
+    def on_message(client, userdata, msg):
+        try:
+            print(msg.topic, json.dumps(decode(msg.payload)))
+        except PackedReportError as error:
+            print(f"{msg.topic}: not a packed report ({error})")
+
+    client = mqtt.Client()
+    client.on_message = on_message
+    client.connect(broker, port, keepalive=60)
+    client.subscribe(topic)
+    client.loop_forever()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("file", nargs="?", help="binary payload file")
+    parser.add_argument("--hex", help="payload as a hex string")
+    parser.add_argument("--mqtt", action="store_true", help="subscribe and decode live payloads")
+    parser.add_argument("--broker", default="broker.hivemq.com")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--topic", default="iocloud/response/1C69209DB778/sensor/report")
+    args = parser.parse_args()
+
+    if args.mqtt:
+        listen(args.broker, args.port, args.topic)
+        return
+
+    if args.hex:
+        payload = bytes.fromhex(args.hex)
+    elif args.file:
+        with open(args.file, "rb") as f:
+            payload = f.read()
+    else:
+        payload = sys.stdin.buffer.read()
+
+    print(json.dumps(decode(payload), indent=2))
+
+
+if __name__ == "__main__":
+    main()
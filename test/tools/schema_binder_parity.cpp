@@ -0,0 +1,577 @@
+/**
+ * Host parity test and benchmark: one-pass schema binder vs. the former DOM path.
+ *
+ * Parses the same command payloads with the ArduinoJson + validate_json_schema()
+ * code previously used by serializer_handlers.cc and with schema_bind_command()
+ * (app/iot/schemas/schema_binder.cc) that replaced it, extended with the
+ * optional correlation ID (`id`, checked with `is<uint32_t>()`) and the
+ * calibration batch (each element validated with the CMD_SET_CALIBRATION
+ * schema after the item count is checked) and the history request, whose
+ * 64-bit timestamps are checked with `is<int64_t>()`. For every
+ * payload both paths must return the same error, send the same error response
+ * and, on success, produce the same correlation ID and a byte-identical
+ * command payload. The corpus holds hand
+ * written cases plus generated and mutated payloads (key order, duplicates,
+ * escapes, quoting, numbers, nesting, truncation, byte flips).
+ *
+ * Payloads on which the DOM path runs out of document memory are skipped: the
+ * host slot size differs from the ESP32, so capacity errors are not comparable.
+ * The binder needs no document and accepts them.
+ *
+ * Build and run from the repository root:
+ *   g++ -O2 -std=gnu++17 -Ilib/titanium-kernel -Ilib/titanium-app -Ilib/titanium-app/app/iot/schemas \
+ *       test/tools/schema_binder_parity.cpp lib/titanium-app/app/iot/schemas/schema_binder.cc \
+ *       lib/titanium-app/app/iot/schemas/schema_validator.cc -o schema_binder_parity
+ *   ./schema_binder_parity
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "app/third_party/json_handler.h"
+#include "kernel/error/error_num.h"
+
+#include "schema_validator.h"
+
+static constexpr int ITERATIONS      = 200000;
+static constexpr int GENERATED_CASES = 200000;
+static constexpr int CMD_SET_CALIBRATION = 1;  // command_index_et
+static constexpr int CMD_GET_SYSTEM_INFO = 2;
+static constexpr int CMD_SET_CALIBRATION_BATCH = 3;
+static constexpr int CMD_GET_HISTORY = 4;
+static constexpr size_t CALIBRATION_BATCH_MAXIMUM_ITEMS = 26;  // NUM_OF_SENSORS
+
+/* Mirrors of app_extern_types.h, which cannot be included on the host */
+struct cmd_set_calibration_st {
+    int32_t sensor_index;
+    float gain;
+    float offset;
+};
+
+struct cmd_get_system_info_st {
+    char user[32];
+    char password[32];
+};
+
+struct cmd_set_calibration_batch_st {
+    uint8_t num_of_items;
+    cmd_set_calibration_st items[CALIBRATION_BATCH_MAXIMUM_ITEMS];
+};
+
+struct cmd_get_history_st {
+    int64_t from;
+    int64_t to;
+    int32_t offset;
+};
+
+union command_payload_u {
+    cmd_set_calibration_st set_calibration;
+    cmd_get_system_info_st cmd_get_system_info;
+    cmd_set_calibration_batch_st set_calibration_batch;
+    cmd_get_history_st get_history;
+};
+
+#include "commands_schema.h"
+#include "schema_binder.h"
+
+CMD_SET_CALIBRATION_FIELDS(JSON_BINDING_CHECK)
+CMD_GET_SYSTEM_INFO_FIELDS(JSON_BINDING_CHECK)
+CMD_SET_CALIBRATION_BATCH_FIELDS(JSON_BINDING_CHECK, JSON_BINDING_ARRAY_CHECK)
+CMD_GET_HISTORY_FIELDS(JSON_BINDING_CHECK)
+
+static const json_binding_t set_calibration_binding[] = {CMD_SET_CALIBRATION_FIELDS(JSON_BINDING_FIELD)};
+static const json_binding_t get_system_info_binding[] = {CMD_GET_SYSTEM_INFO_FIELDS(JSON_BINDING_FIELD)};
+static const json_array_binding_t set_calibration_items =
+    JSON_ARRAY_BINDING(cmd_set_calibration_batch_st, items, num_of_items, set_calibration_binding);
+static const json_binding_t set_calibration_batch_binding[] = {
+    CMD_SET_CALIBRATION_BATCH_FIELDS(JSON_BINDING_FIELD, JSON_BINDING_ARRAY)};
+static const json_binding_t get_history_binding[] = {CMD_GET_HISTORY_FIELDS(JSON_BINDING_FIELD)};
+
+static const json_command_binding_t command_bindings[] = {
+    {CMD_SET_CALIBRATION, set_calibration_binding, sizeof(set_calibration_binding) / sizeof(json_binding_t)},
+    {CMD_GET_SYSTEM_INFO, get_system_info_binding, sizeof(get_system_info_binding) / sizeof(json_binding_t)},
+    {CMD_SET_CALIBRATION_BATCH, set_calibration_batch_binding, sizeof(set_calibration_batch_binding) / sizeof(json_binding_t)},
+    {CMD_GET_HISTORY, get_history_binding, sizeof(get_history_binding) / sizeof(json_binding_t)},
+};
+
+/*
+ * Former MAXIMUM_DESERIALIZE_DOC_SIZE (512) held 32 slots of 16 bytes on the ESP32.
+ * Enlarged so a full calibration batch (4 slots per item) can be compared too.
+ */
+static StaticJsonDocument<JSON_ARRAY_SIZE(160)> deserialize_doc;
+
+struct outcome_t {
+    kernel_error_st result;
+    int response;  // command index of the error response sent, -1 for none
+    uint32_t correlation_id;
+    command_payload_u payload;
+    bool no_memory;
+};
+
+/* The former deserialize_command() and its per-command handlers, with the queue send stubbed out */
+static outcome_t dom_command(char *buffer, size_t buffer_size) {
+    outcome_t out{};
+    out.response = -1;
+
+    deserialize_doc.clear();
+    DeserializationError error = deserializeJson(deserialize_doc, buffer, buffer_size);
+    if (error) {
+        out.no_memory = (error == DeserializationError::NoMemory);
+        out.result    = KERNEL_ERROR_DESERIALIZE_JSON;
+        return out;
+    }
+
+    if (!deserialize_doc.containsKey("command")) {
+        out.result = KERNEL_ERROR_MISSING_FIELD;
+        return out;
+    }
+
+    if (!deserialize_doc["command"].is<int>()) {
+        out.result = KERNEL_ERROR_INVALID_TYPE;
+        return out;
+    }
+
+    if (deserialize_doc.containsKey("id")) {
+        if (!deserialize_doc["id"].is<uint32_t>()) {
+            out.result = KERNEL_ERROR_INVALID_TYPE;
+            return out;
+        }
+        out.correlation_id = deserialize_doc["id"];
+    }
+
+    int command_index = deserialize_doc["command"];
+    if (!deserialize_doc.containsKey("params")) {
+        out.result = KERNEL_ERROR_MISSING_FIELD;
+        return out;
+    }
+    JsonObject params = deserialize_doc["params"];
+
+    switch (command_index) {
+        case CMD_SET_CALIBRATION: {
+            out.result = validate_json_schema(params, get_calibration_schema,
+                                              sizeof(get_calibration_schema) / sizeof(json_field_t));
+            if (out.result != KERNEL_SUCCESS) {
+                out.response = CMD_SET_CALIBRATION;
+                return out;
+            }
+            out.payload.set_calibration.sensor_index = params["sensor_id"];
+            out.payload.set_calibration.gain         = params["gain"];
+            out.payload.set_calibration.offset       = params["offset"];
+            break;
+        }
+        case CMD_GET_SYSTEM_INFO: {
+            out.result = validate_json_schema(params, get_system_info_schema,
+                                              sizeof(get_system_info_schema) / sizeof(json_field_t));
+            if (out.result != KERNEL_SUCCESS) {
+                out.response = CMD_GET_SYSTEM_INFO;
+                return out;
+            }
+            cmd_get_system_info_st &info = out.payload.cmd_get_system_info;
+            const char *user_src         = params["user"];
+            const char *password_src     = params["password"];
+            if ((size_t)snprintf(info.user, sizeof(info.user), "%s", user_src) >= sizeof(info.user)) {
+                out.result = KERNEL_ERROR_INVALID_SIZE;
+                return out;
+            }
+            if ((size_t)snprintf(info.password, sizeof(info.password), "%s", password_src) >= sizeof(info.password)) {
+                out.result = KERNEL_ERROR_INVALID_SIZE;
+                return out;
+            }
+            break;
+        }
+        case CMD_SET_CALIBRATION_BATCH: {
+            out.result = validate_json_schema(params, set_calibration_batch_schema,
+                                              sizeof(set_calibration_batch_schema) / sizeof(json_field_t));
+            if (out.result != KERNEL_SUCCESS) {
+                out.response = CMD_SET_CALIBRATION_BATCH;
+                return out;
+            }
+            JsonArray items = params["calibrations"];
+            if (items.size() > CALIBRATION_BATCH_MAXIMUM_ITEMS) {
+                out.result = KERNEL_ERROR_INVALID_SIZE;
+                return out;
+            }
+            cmd_set_calibration_batch_st &batch = out.payload.set_calibration_batch;
+            for (JsonVariant item : items) {
+                if (!item.is<JsonObject>()) {
+                    out.result   = KERNEL_ERROR_INVALID_TYPE;
+                    out.response = CMD_SET_CALIBRATION_BATCH;
+                    return out;
+                }
+                JsonObject element = item;
+                out.result = validate_json_schema(element, get_calibration_schema,
+                                                  sizeof(get_calibration_schema) / sizeof(json_field_t));
+                if (out.result != KERNEL_SUCCESS) {
+                    out.response = CMD_SET_CALIBRATION_BATCH;
+                    return out;
+                }
+                cmd_set_calibration_st &calibration = batch.items[batch.num_of_items++];
+                calibration.sensor_index            = element["sensor_id"];
+                calibration.gain                    = element["gain"];
+                calibration.offset                  = element["offset"];
+            }
+            break;
+        }
+        case CMD_GET_HISTORY: {
+            out.result = validate_json_schema(params, get_history_schema, sizeof(get_history_schema) / sizeof(json_field_t));
+            if (out.result != KERNEL_SUCCESS) {
+                out.response = CMD_GET_HISTORY;
+                return out;
+            }
+            out.payload.get_history.from   = params["from"];
+            out.payload.get_history.to     = params["to"];
+            out.payload.get_history.offset = params["offset"];
+            break;
+        }
+        default:
+            out.result = KERNEL_ERROR_INVALID_COMMAND;
+    }
+
+    return out;
+}
+
+/* The new deserialize_command(), with the queue send stubbed out */
+static outcome_t binder_command(const char *buffer, size_t buffer_size) {
+    outcome_t out{};
+    out.response = -1;
+
+    int32_t command_index = 0;
+    bool params_rejected  = false;
+    out.result = schema_bind_command(buffer, buffer_size, command_bindings,
+                                     sizeof(command_bindings) / sizeof(json_command_binding_t), &command_index,
+                                     &out.correlation_id, &out.payload, sizeof(out.payload), &params_rejected);
+    if (params_rejected) {
+        out.response = command_index;
+    }
+    return out;
+}
+
+static const char *hand_cases[] = {
+    R"({"command":1,"params":{"sensor_id":3,"gain":1.5,"offset":-0.25}})",
+    R"({"params":{"sensor_id":3,"gain":1.5,"offset":-0.25},"command":1})",
+    R"({"command":2,"params":{"user":"root","password":"root"}})",
+    R"({"params":{"password":"p","user":"u"},"command":2})",
+    R"({"command":1,"params":{"sensor_id":-1,"gain":2,"offset":0}})",
+    R"({"command":1,"params":{"sensor_id":1.0,"gain":2,"offset":0}})",
+    R"({"command":1,"params":{"sensor_id":2147483648,"gain":2,"offset":0}})",
+    R"({"command":1,"params":{"sensor_id":-2147483648,"gain":1e39,"offset":-1e-50}})",
+    R"({"command":1,"params":{"sensor_id":1,"gain":"2","offset":0}})",
+    R"({"command":1,"params":{"sensor_id":1,"offset":0}})",
+    R"({"command":1,"params":{"gain":true,"offset":0}})",
+    R"({"command":1,"params":[1,2,3]})",
+    R"({"command":1,"params":null})",
+    R"({"command":1})",
+    R"({"params":{}})",
+    R"({"command":"1","params":{}})",
+    R"({"command":1.5,"params":{}})",
+    R"({"command":0,"params":{}})",
+    R"({"command":7,"params":{}})",
+    R"({"command":4294967297,"params":{}})",
+    R"({"command":2,"params":{"user":"0123456789012345678901234567890","password":"x"}})",
+    R"({"command":2,"params":{"user":"01234567890123456789012345678901","password":"x"}})",
+    R"({"command":2,"params":{"user":"a\u0000b","password":"😀é"}})",
+    R"({"command":2,"params":{"user":"\"\\\/\b\f\n\r\t","password":"x"}})",
+    R"({"command":2,"params":{"user":"\'","password":"x"}})",
+    R"({'command':2,'params':{'user':'a"b',password:"x"}})",
+    R"({command:1,params:{sensor_id:1,gain:2,offset:3}})",
+    R"({"command":1,"command":2,"params":{"user":"u","password":"p"}})",
+    R"({"command":1,"id":42,"params":{"sensor_id":3,"gain":1.5,"offset":-0.25}})",
+    R"({"id":4294967295,"params":{"user":"u","password":"p"},"command":2})",
+    R"({"command":2,"id":4294967296,"params":{"user":"u","password":"p"}})",
+    R"({"command":2,"id":-1,"params":{"user":"u","password":"p"}})",
+    R"({"command":2,"id":-0,"params":{"user":"u","password":"p"}})",
+    R"({"command":2,"id":1.0,"params":{"user":"u","password":"p"}})",
+    R"({"command":2,"id":"7","params":{"user":"u","password":"p"}})",
+    R"({"command":2,"id":7,"id":null,"params":{"user":"u","password":"p"}})",
+    R"({"command":2,"id":null,"params":{"user":"u","password":"p"}})",
+    R"({"command":9,"id":"x","params":{}})",
+    R"({"command":1,"id":5,"params":{"sensor_id":"3"}})",
+    R"({"command":2,"command":null,"params":{"user":"u","password":"p"},"params":null})",
+    R"({"command":2,"params":{"user":"u","password":"p"},"params" :  null })",
+    R"({"command":2,"params":{"user":"u","password":"p","user":null}})",
+    R"({"command":2,"params":{"user":null,"password":"p"}})",
+    R"({"command":1,"params":{"sensor_id":1,"sensor_id":2,"gain":2,"offset":3}})",
+    R"({"command":1,"params":{"sensor_id":1,"gain":2,"offset":3,"extra":{"a":[1,{"b":null}]}}})",
+    R"(  {  "command" : 1 , "params" : { "sensor_id" : 1 , "gain" : 2 , "offset" : 3 } }  trailing)",
+    R"({"command":1,"params":{"sensor_id":1,"gain":2,"offset":3},})",
+    R"({"command":1,"params":{"sensor_id":1,"gain":2,"offset":3})",
+    R"({"command":1,"params":{"sensor_id":1,"gain":-,"offset":3}})",
+    R"({"command":1,"params":{"sensor_id":1,"gain":1e,"offset":3}})",
+    R"({"command":1,"params":{"sensor_id":1,"gain":.5,"offset":+3}})",
+    R"({"command":1,"params":{"sensor_id":1,"gain":NaN,"offset":3}})",
+    R"({"command":1,"params":{"sensor_id":1,"gain":[[[[[[[[[[1]]]]]]]]]],"offset":3}})",
+    R"({"command":3,"id":9,"params":{"calibrations":[{"sensor_id":0,"gain":1.5,"offset":-0.25},{"sensor_id":25,"gain":2,"offset":0}]}})",
+    R"({"command":3,"params":{"calibrations":[]}})",
+    R"({"command":3,"params":{"calibrations":[ { "sensor_id" : 1 , "gain" : 2 , "offset" : 3 } , {"offset":1,"gain":1,"sensor_id":2} ]}})",
+    R"({"command":3,"params":{"calibrations":{"sensor_id":1,"gain":2,"offset":3}}})",
+    R"({"command":3,"params":{"calibrations":null}})",
+    R"({"command":3,"params":{}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":1,"gain":2,"offset":3},null]}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":1,"gain":2},{"sensor_id":"x","gain":2,"offset":3}]}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":"x","gain":2,"offset":3},{"sensor_id":1,"gain":2}]}})",
+    R"({"command":3,"params":{"calibrations":[5,{"sensor_id":1}]}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":1,"gain":2,"offset":3,"sensor_id":null}]}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":1,"gain":2,"offset":3}],"calibrations":null}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":1,"gain":2,"offset":3}],"calibrations":[{"sensor_id":2,"gain":4,"offset":5}]}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":1,"gain":2,"offset":3}],"calibrations":7}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":1,"gain":2,"offset":3,"extra":[1,{"a":[]}]}]}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":1,"gain":2,"offset":3},]}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":1,"gain":[[[[[[[1]]]]]]],"offset":3}]}})",
+    R"({"command":3,"params":{"calibrations":[{"sensor_id":1,"gain":[[[[[[1]]]]]],"offset":3}]}})",
+    R"({"params":{"calibrations":[{"sensor_id":1,"gain":2,"offset":3}]},"command":3})",
+    R"({"command":4,"id":11,"params":{"from":1751898180,"to":1751984580,"offset":0}})",
+    R"({"command":4,"params":{"from":2147483648,"to":4102444800,"offset":3}})",
+    R"({"command":4,"params":{"from":-4102444800,"to":9223372036854775807,"offset":2147483647}})",
+    R"({"command":4,"params":{"from":-9223372036854775808,"to":0,"offset":0}})",
+    R"({"command":4,"params":{"from":0,"to":9223372036854775808,"offset":0}})",
+    R"({"command":4,"params":{"from":-9223372036854775809,"to":0,"offset":0}})",
+    R"({"command":4,"params":{"from":0,"to":4102444800,"offset":2147483648}})",
+    R"({"command":4,"params":{"from":0,"to":4102444800.0,"offset":0}})",
+    R"({"command":4,"params":{"from":0,"to":"4102444800","offset":0}})",
+    R"({"command":4,"params":{"to":4102444800,"offset":0}})",
+    R"(1)",
+    R"([])",
+    R"("x")",
+    R"()",
+    R"({)",
+};
+
+static std::string random_number(std::mt19937 &rng) {
+    static const char *numbers[] = {"0",      "1",           "-1",        "2",          "3",     "1.5",    "-0.25",
+                                    "1e3",    "1E-3",        "2147483647", "-2147483648", "2147483648",
+                                    "1e39",   "-1e-39",      "3.4028235e38", "0.1",   "12345678901234567890",
+                                    "-0",     "00",          "1.",        "--1",        "1e+2",  "0x10",
+                                    "4102444800", "-4102444800", "9223372036854775807", "9223372036854775808",
+                                    "-9223372036854775808", "-9223372036854775809"};
+    return numbers[rng() % (sizeof(numbers) / sizeof(numbers[0]))];
+}
+
+static std::string random_string(std::mt19937 &rng) {
+    static const char *pieces[] = {"a", "root", "\\n", "\\\"", "\\u00e9", "\\u0000", "\\ud83d\\ude00", "\\uZZZZ",
+                                   "0123456789", "x y", "\\q", "\\/"};
+    std::string text;
+    int count = rng() % 8;
+    for (int i = 0; i < count; i++) {
+        text += pieces[rng() % (sizeof(pieces) / sizeof(pieces[0]))];
+    }
+    return ((rng() % 8) == 0) ? "'" + text + "'" : "\"" + text + "\"";
+}
+
+static std::string random_value(std::mt19937 &rng, int depth) {
+    switch (rng() % 9) {
+        case 0:
+        case 1:
+        case 2:
+            return random_number(rng);
+        case 3:
+        case 4:
+            return random_string(rng);
+        case 5:
+            return (rng() & 1) ? "true" : "false";
+        case 6:
+            return "null";
+        case 7:
+            return (depth < 3) ? "[" + random_value(rng, depth + 1) + "," + random_value(rng, depth + 1) + "]" : "[]";
+        default:
+            return (depth < 3) ? "{\"k\":" + random_value(rng, depth + 1) + "}" : "{}";
+    }
+}
+
+static std::string random_key(std::mt19937 &rng, const char *key) {
+    switch (rng() % 10) {
+        case 0:
+            return std::string("'") + key + "'";
+        case 1:
+            return key;
+        default:
+            return std::string("\"") + key + "\"";
+    }
+}
+
+static std::string random_params(std::mt19937 &rng, int command);
+
+static std::string random_batch(std::mt19937 &rng) {
+    /* Mostly small batches, sometimes around the item limit */
+    int count = ((rng() % 4) == 0) ? (24 + (rng() % 5)) : (rng() % 4);
+
+    std::string items = "[";
+    for (int i = 0; i < count; i++) {
+        if (i != 0) {
+            items += ",";
+        }
+        if ((rng() % 6) == 0) {
+            items += random_value(rng, 2);
+        } else if ((rng() % 3) == 0) {
+            items += random_params(rng, CMD_SET_CALIBRATION);
+        } else {
+            items += "{\"sensor_id\":" + std::to_string(rng() % 30) + ",\"gain\":" + random_number(rng) + ",\"offset\":" +
+                     random_number(rng) + "}";
+        }
+    }
+    items += "]";
+
+    std::string params = "{" + random_key(rng, "calibrations") + ":" + (((rng() % 8) == 0) ? random_value(rng, 1) : items);
+    if ((rng() % 6) == 0) {
+        params += "," + random_key(rng, "calibrations") + ":" + (((rng() % 2) == 0) ? std::string("null") : random_value(rng, 1));
+    }
+    return params + "}";
+}
+
+static std::string random_params(std::mt19937 &rng, int command) {
+    static const char *calibration_keys[] = {"sensor_id", "gain", "offset", "extra"};
+    static const char *system_info_keys[] = {"user", "password", "extra"};
+    static const char *history_keys[]     = {"from", "to", "offset", "extra"};
+    const char **keys = (command == CMD_GET_SYSTEM_INFO) ? system_info_keys
+                        : (command == CMD_GET_HISTORY)   ? history_keys
+                                                         : calibration_keys;
+    size_t num_keys   = (command == CMD_GET_SYSTEM_INFO) ? 3 : 4;
+    bool strings      = (command == CMD_GET_SYSTEM_INFO);
+
+    std::string params = "{";
+    int count          = rng() % 6;
+    for (int i = 0; i < count; i++) {
+        if (i != 0) {
+            params += (rng() % 4 == 0) ? " , " : ",";
+        }
+        params += random_key(rng, keys[rng() % num_keys]) + ":";
+        if ((rng() % 3) != 0) {
+            params += strings ? random_string(rng) : random_number(rng);
+        } else {
+            params += random_value(rng, 1);
+        }
+    }
+    return params + "}";
+}
+
+static std::string random_payload(std::mt19937 &rng) {
+    int command          = 1 + (rng() % 4);
+    std::string command_ = random_key(rng, "command") + ":" + (((rng() % 8) == 0) ? random_value(rng, 1) : std::to_string(command));
+    std::string params   = random_key(rng, "params") + ":" +
+                         (((rng() % 10) == 0)                     ? random_value(rng, 1)
+                          : (command == CMD_SET_CALIBRATION_BATCH) ? random_batch(rng)
+                                                                   : random_params(rng, command));
+    if ((rng() % 3) == 0) {
+        params = random_key(rng, "id") + ":" + (((rng() % 4) == 0) ? random_value(rng, 1) : std::to_string(rng())) + "," + params;
+    }
+
+    std::string payload;
+    switch (rng() % 7) {
+        case 0:
+            payload = "{" + params + "," + command_ + "}";
+            break;
+        case 1:
+            payload = "{" + command_ + "}";
+            break;
+        case 2:
+            payload = "{" + command_ + "," + params + "," + command_ + "}";
+            break;
+        case 3:
+            payload = "{" + command_ + "," + params + "," + random_key(rng, "params") + ": " + random_value(rng, 1) + "}";
+            break;
+        default:
+            payload = "{" + command_ + "," + params + "}";
+    }
+
+    /* Mutations: truncation and byte flips */
+    switch (rng() % 8) {
+        case 0:
+            payload.resize(rng() % (payload.size() + 1));
+            break;
+        case 1:
+            payload[rng() % payload.size()] = "{}[]\":,'\\ 0a\x00"[rng() % 14];
+            break;
+        default:
+            break;
+    }
+    return payload;
+}
+
+template <typename F>
+static double time_ns(F &&parse) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        parse();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+int main() {
+    std::vector<std::string> corpus(std::begin(hand_cases), std::end(hand_cases));
+    std::mt19937 rng(1234);
+    for (int n = 0; n < GENERATED_CASES; n++) {
+        corpus.push_back(random_payload(rng));
+    }
+
+    int mismatches = 0;
+    int skipped    = 0;
+    int accepted   = 0;
+    std::vector<char> scratch;
+    for (const std::string &payload : corpus) {
+        scratch.assign(payload.begin(), payload.end());
+        outcome_t dom = dom_command(scratch.data(), scratch.size());
+        if (dom.no_memory) {
+            skipped++;
+            continue;
+        }
+
+        outcome_t binder = binder_command(payload.data(), payload.size());
+        bool same_success = (dom.correlation_id == binder.correlation_id) &&
+                            (memcmp(&dom.payload, &binder.payload, sizeof(dom.payload)) == 0);
+        if ((dom.result != binder.result) || (dom.response != binder.response) ||
+            ((dom.result == KERNEL_SUCCESS) && !same_success)) {
+            if (mismatches++ < 10) {
+                printf("mismatch: %s\n  dom:    error %d, response %d\n  binder: error %d, response %d\n",
+                       payload.c_str(), dom.result, dom.response, binder.result, binder.response);
+            }
+        }
+        accepted += (dom.result == KERNEL_SUCCESS);
+    }
+
+    printf("Parity: %zu payloads (%d accepted, %d skipped on DOM NoMemory), %d mismatches\n\n", corpus.size(),
+           accepted, skipped, mismatches);
+
+    const std::string calibration = R"({"command":1,"params":{"sensor_id":3,"gain":1.5,"offset":-0.25}})";
+    const std::string system_info = R"({"command":2,"params":{"user":"root","password":"secret"}})";
+    std::string batch             = R"({"command":3,"params":{"calibrations":[)";
+    for (size_t i = 0; i < CALIBRATION_BATCH_MAXIMUM_ITEMS; i++) {
+        batch += ((i != 0) ? "," : "") + std::string(R"({"sensor_id":)") + std::to_string(i) + R"(,"gain":1.5,"offset":-0.25})";
+    }
+    batch += "]}}";
+
+    volatile int sink = 0;
+    auto dom_ns       = [&](const std::string &payload) {
+        return time_ns([&] {
+            scratch.assign(payload.begin(), payload.end());
+            sink = sink + dom_command(scratch.data(), scratch.size()).result;
+        });
+    };
+    auto binder_ns = [&](const std::string &payload) {
+        return time_ns([&] {
+            scratch.assign(payload.begin(), payload.end());
+            sink = sink + binder_command(scratch.data(), scratch.size()).result;
+        });
+    };
+
+    double dom_calibration_ns    = dom_ns(calibration);
+    double binder_calibration_ns = binder_ns(calibration);
+    double dom_system_ns         = dom_ns(system_info);
+    double binder_system_ns      = binder_ns(system_info);
+    double dom_batch_ns          = dom_ns(batch);
+    double binder_batch_ns       = binder_ns(batch);
+
+    printf("%-22s %8s %12s %12s %8s\n", "payload", "bytes", "DOM ns", "binder ns", "speedup");
+    printf("%-22s %8zu %12.0f %12.0f %7.1fx\n", "set_calibration", calibration.size(), dom_calibration_ns,
+           binder_calibration_ns, dom_calibration_ns / binder_calibration_ns);
+    printf("%-22s %8zu %12.0f %12.0f %7.1fx\n", "get_system_info", system_info.size(), dom_system_ns,
+           binder_system_ns, dom_system_ns / binder_system_ns);
+    printf("%-22s %8zu %12.0f %12.0f %7.1fx\n", "set_calibration_batch", batch.size(), dom_batch_ns, binder_batch_ns,
+           dom_batch_ns / binder_batch_ns);
+    printf("\n.bss freed: 512 bytes (StaticJsonDocument<512>)\n");
+
+    return mismatches == 0 ? 0 : 1;
+}
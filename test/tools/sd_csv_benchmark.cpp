@@ -0,0 +1,232 @@
+/**
+ * Host benchmark: fixed-point CSV formatter vs. the former snprintf path.
+ *
+ * Formats the same device reports with the snprintf code previously used by
+ * device_report_to_csv() in sd_card_manager.c and with the formatter
+ * (app/sd_card_manager/sd_csv_format.c) that replaced it, checks that both
+ * lines are byte-identical, then prints format time per report. The parity
+ * check also sweeps float bit patterns, ties and out-of-range values one
+ * sensor at a time.
+ *
+ * Build and run from the repository root:
+ *   gcc -O2 -c -Ilib/titanium-kernel -Ilib/titanium-app lib/titanium-app/app/sd_card_manager/sd_csv_format.c
+ *   g++ -O2 -std=gnu++17 -Ilib/titanium-kernel -Ilib/titanium-app \
+ *       test/tools/sd_csv_benchmark.cpp sd_csv_format.o -o sd_csv_benchmark
+ *   ./sd_csv_benchmark
+ */
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include "app/sd_card_manager/sd_csv_format.h"
+
+static constexpr int ITERATIONS        = 20000;
+static constexpr int PARITY_REPORTS    = 100000;
+static constexpr uint32_t SWEEP_STRIDE = 9973;  // prime, covers every exponent
+static constexpr size_t LINE_SIZE      = 512;   // FILE_BUFFER_SIZE
+
+struct device_report_t {
+    int64_t timestamp;
+    sensor_report_st sensors[NUM_OF_SENSORS];
+    uint8_t num_of_sensors;
+};
+
+/* Mirrors the former device_report_to_csv() in sd_card_manager.c. */
+static int snprintf_report(const device_report_t &report, char *out, size_t size) {
+    int written   = 0;
+    int remaining = (int)size;
+
+    int length = snprintf(out + written, remaining, "%lld,", (long long)report.timestamp);
+    if (length < 0 || length >= remaining) {
+        return -1;
+    }
+    written += length;
+    remaining -= length;
+
+    for (uint8_t i = 0; i < report.num_of_sensors; i++) {
+        length = snprintf(out + written,
+                          remaining,
+                          "%.2f,%d,%d,",
+                          report.sensors[i].value,
+                          (uint8_t)report.sensors[i].sensor_type,
+                          report.sensors[i].active ? 1 : 0);
+        if (length < 0 || length >= remaining) {
+            return -1;
+        }
+        written += length;
+        remaining -= length;
+    }
+
+    length = snprintf(out + written, remaining, "%d\n", report.num_of_sensors);
+    if (length < 0 || length >= remaining) {
+        return -1;
+    }
+
+    return written + length;
+}
+
+static int format_report(const device_report_t &report, char *out, size_t size) {
+    size_t length = 0;
+    if (sd_csv_format_record(report.timestamp, report.sensors, report.num_of_sensors, out, size, &length) !=
+        KERNEL_SUCCESS) {
+        return -1;
+    }
+
+    return (int)length;
+}
+
+static bool same_line(const device_report_t &report) {
+    char expected[LINE_SIZE];
+    char actual[LINE_SIZE];
+
+    int expected_length = snprintf_report(report, expected, sizeof(expected));
+    int actual_length   = format_report(report, actual, sizeof(actual));
+
+    if ((expected_length == actual_length) &&
+        ((expected_length < 0) || (memcmp(expected, actual, (size_t)expected_length) == 0))) {
+        return true;
+    }
+
+    printf("MISMATCH\n  snprintf: %.*s\n  fixed:    %.*s\n",
+           (expected_length < 0) ? 0 : expected_length,
+           expected,
+           (actual_length < 0) ? 0 : actual_length,
+           actual);
+    return false;
+}
+
+static void random_report(std::mt19937 &rng, device_report_t &report) {
+    std::uniform_real_distribution<float> value(-50.0f, 5000.0f);
+    std::uniform_int_distribution<int> type(0, 4);
+
+    report.timestamp      = 1751898180 + (int64_t)(rng() % 1000000);
+    report.num_of_sensors = NUM_OF_SENSORS;
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        report.sensors[i].value       = value(rng);
+        report.sensors[i].sensor_type = (sensor_type_et)type(rng);
+        report.sensors[i].active      = (rng() & 1) != 0;
+    }
+}
+
+static bool check_value(float value) {
+    device_report_t report = {};
+    report.timestamp         = 1751898180;
+    report.num_of_sensors    = 1;
+    report.sensors[0].value  = value;
+    report.sensors[0].active = true;
+    return same_line(report);
+}
+
+static bool check_parity(std::mt19937 &rng) {
+    device_report_t report;
+    for (int n = 0; n < PARITY_REPORTS; n++) {
+        random_report(rng, report);
+        if (!same_line(report)) {
+            return false;
+        }
+    }
+
+    /* Float bit patterns across every exponent, both signs */
+    for (uint64_t bits = 0; bits <= UINT32_MAX; bits += SWEEP_STRIDE) {
+        uint32_t pattern = (uint32_t)bits;
+        float value;
+        memcpy(&value, &pattern, sizeof(value));
+        if (!check_value(value)) {
+            return false;
+        }
+    }
+
+    /* Exact ties of the third decimal round to even, plus edges */
+    const float edges[] = {0.125f,
+                           0.375f,
+                           2.5e-3f,
+                           -0.001f,
+                           -0.0f,
+                           0.005f,
+                           9999999.0f,
+                           10000000.0f,
+                           -10000000.0f,
+                           16777216.0f,
+                           std::numeric_limits<float>::max(),
+                           std::numeric_limits<float>::lowest(),
+                           std::numeric_limits<float>::denorm_min(),
+                           std::numeric_limits<float>::infinity(),
+                           -std::numeric_limits<float>::infinity(),
+                           std::numeric_limits<float>::quiet_NaN()};
+    for (float value : edges) {
+        if (!check_value(value)) {
+            return false;
+        }
+    }
+    for (int hundredths = -100000; hundredths <= 100000; hundredths++) {
+        if (!check_value(hundredths / 100.0f) || !check_value(hundredths / 1000.0f)) {
+            return false;
+        }
+    }
+
+    /* Extreme timestamps and a line that does not fit */
+    report.timestamp = std::numeric_limits<int64_t>::min();
+    if (!same_line(report)) {
+        return false;
+    }
+    report.timestamp = std::numeric_limits<int64_t>::max();
+    if (!same_line(report)) {
+        return false;
+    }
+
+    char small[64];
+    size_t length = 0;
+    if (sd_csv_format_record(0, report.sensors, NUM_OF_SENSORS, small, sizeof(small), &length) !=
+        KERNEL_ERROR_BUFFER_TOO_SHORT) {
+        printf("MISMATCH\n  a full line fits in %zu bytes\n", sizeof(small));
+        return false;
+    }
+
+    return true;
+}
+
+template <typename F>
+static double time_ns(const device_report_t *reports, int count, F format) {
+    char out[LINE_SIZE];
+    volatile int sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < ITERATIONS; n++) {
+        sink = sink + format(reports[n % count], out, sizeof(out));
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+int main() {
+    std::mt19937 rng(42);
+
+    if (!check_parity(rng)) {
+        return 1;
+    }
+    printf("parity: %d random reports, float sweep and edge values byte-identical\n", PARITY_REPORTS);
+
+    static device_report_t reports[64];
+    for (device_report_t &report : reports) {
+        random_report(rng, report);
+    }
+
+    char line[LINE_SIZE];
+    int line_length = format_report(reports[0], line, sizeof(line));
+
+    double snprintf_ns = time_ns(reports, 64, snprintf_report);
+    double fixed_ns    = time_ns(reports, 64, format_report);
+
+    printf("%d sensors, line of %d bytes\n", NUM_OF_SENSORS, line_length);
+    printf("%-10s %10s\n", "path", "ns/report");
+    printf("%-10s %10.0f\n", "snprintf", snprintf_ns);
+    printf("%-10s %10.0f\n", "fixed", fixed_ns);
+    printf("speedup: %.1fx\n", snprintf_ns / fixed_ns);
+
+    return 0;
+}
@@ -0,0 +1,444 @@
+/**
+ * Host exporter: binary SD card log segments (log<number>.bin) to the CSV
+ * format of the former text log.
+ *
+ * Decodes each segment with the firmware codec
+ * (app/sd_card_manager/sd_log_codec.c), skipping blocks whose CRC does not
+ * match, and prints one CSV line per record:
+ * timestamp,value1,type1,active1,...,num_of_sensors. Segments are exported in
+ * the order given. A time range is located with the time index of the
+ * segment (log<number>.idx, next to it) by a binary search over its entries
+ * and one seek into the log; without an index, the search runs over the log
+ * blocks themselves. Invalid blocks after the last valid one are the unused
+ * preallocated space of the segment and are not reported.
+ *
+ * Build and run from the repository root:
+ *   gcc -O2 -c -Ilib/titanium-kernel -Ilib/titanium-app lib/titanium-app/app/sd_card_manager/sd_log_codec.c
+ *   g++ -O2 -std=gnu++17 -Ilib/titanium-kernel -Ilib/titanium-app \
+ *       test/tools/sd_log_export.cpp sd_log_codec.o -o sd_log_export
+ *   ./sd_log_export log00001.bin [log00002.bin ...] [--no-index] [--from UNIX] [--to UNIX] > venax.csv
+ *
+ * Pass --self-test to encode a synthetic preallocated segment, export ranges
+ * of it and check the output and the CRC checks, and to check the conversion
+ * of NaN, infinite and out-of-range values.
+ */
+#include <algorithm>
+#include <cfloat>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <strings.h>
+#include <vector>
+
+#include "app/sd_card_manager/sd_log_codec.h"
+
+struct index_entry_t {
+    int64_t timestamp;
+    uint32_t block;
+};
+
+struct export_stats_t {
+    size_t records     = 0;
+    size_t bad_blocks  = 0;
+    size_t bad_entries = 0;
+};
+
+static bool read_block(FILE *log, uint32_t block_number, uint8_t *block) {
+    return (fseek(log, (long)block_number * SD_LOG_BLOCK_SIZE, SEEK_SET) == 0) &&
+           (fread(block, 1, SD_LOG_BLOCK_SIZE, log) == SD_LOG_BLOCK_SIZE);
+}
+
+static uint32_t count_blocks(FILE *log) {
+    fseek(log, 0, SEEK_END);
+    long size = ftell(log);
+
+    return (size > 0) ? (uint32_t)(size / SD_LOG_BLOCK_SIZE) : 0;
+}
+
+static std::vector<index_entry_t> load_index(const char *path, export_stats_t &stats) {
+    std::vector<index_entry_t> entries;
+
+    FILE *index = fopen(path, "rb");
+    if (index == NULL) {
+        fprintf(stderr, "warning: cannot open index %s, searching the log\n", path);
+        return entries;
+    }
+
+    uint8_t raw[SD_LOG_INDEX_ENTRY_SIZE];
+    while (fread(raw, 1, sizeof(raw), index) == sizeof(raw)) {
+        index_entry_t entry;
+        if (sd_log_index_decode(raw, &entry.timestamp, &entry.block) != KERNEL_SUCCESS) {
+            stats.bad_entries++;
+            continue;
+        }
+        entries.push_back(entry);
+    }
+    fclose(index);
+
+    return entries;
+}
+
+/**
+ * First timestamp of a valid, non-empty block, or false.
+ */
+static bool block_start_time(FILE *log, uint32_t file_id, uint32_t block_number, int64_t *timestamp) {
+    uint8_t block[SD_LOG_BLOCK_SIZE];
+    uint8_t count = 0;
+    sd_log_record_st record;
+
+    if (!read_block(log, block_number, block) || (sd_log_block_check(block, file_id, NULL, &count) != KERNEL_SUCCESS) ||
+        (count == 0) || (sd_log_block_record(block, 0, &record) != KERNEL_SUCCESS)) {
+        return false;
+    }
+
+    *timestamp = record.timestamp;
+    return true;
+}
+
+/**
+ * Block from which records at or after `from` are read.
+ */
+static uint32_t find_start_block(FILE *log, uint32_t file_id, uint32_t num_blocks, const std::vector<index_entry_t> &index,
+                                 int64_t from) {
+    if (!index.empty()) {
+        /* Last entry starting at or before `from` */
+        auto it = std::upper_bound(index.begin(), index.end(), from,
+                                   [](int64_t value, const index_entry_t &entry) { return value < entry.timestamp; });
+        if (it == index.begin()) {
+            return 1;
+        }
+        uint32_t block = std::prev(it)->block;
+        return (block < num_blocks) ? block : 1;
+    }
+
+    /* No index: binary search over the first record of each block, invalid blocks are skipped */
+    uint32_t low = 1, high = num_blocks;
+    while (low + 1 < high) {
+        uint32_t middle = low + (high - low) / 2;
+        uint32_t probe  = middle;
+        int64_t timestamp = 0;
+        while ((probe < high) && !block_start_time(log, file_id, probe, &timestamp)) {
+            probe++;
+        }
+        if ((probe < high) && (timestamp <= from)) {
+            low = probe;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+static void print_record(FILE *out, const sd_log_record_st &record, const sd_log_header_st &header) {
+    fprintf(out, "%" PRId64 ",", record.timestamp);
+    for (int i = 0; i < header.num_of_sensors; i++) {
+        int32_t value = record.values[i];
+        if (value == SD_LOG_VALUE_NAN) {
+            fprintf(out, "nan,%d,%d,", header.sensor_types[i], (record.active_mask >> i) & 1);
+            continue;
+        }
+        uint32_t magnitude = (value < 0) ? (uint32_t)(-(int64_t)value) : (uint32_t)value;
+        fprintf(out, "%s%" PRIu32 ".%02" PRIu32 ",%d,%d,", (value < 0) ? "-" : "", magnitude / SD_LOG_VALUE_SCALE,
+                magnitude % SD_LOG_VALUE_SCALE, header.sensor_types[i], (record.active_mask >> i) & 1);
+    }
+    fprintf(out, "%d\n", header.num_of_sensors);
+}
+
+static int export_log(const char *log_path, const char *index_path, int64_t from, int64_t to, FILE *out, export_stats_t &stats) {
+    FILE *log = fopen(log_path, "rb");
+    if (log == NULL) {
+        fprintf(stderr, "error: cannot open %s\n", log_path);
+        return 1;
+    }
+
+    uint8_t block[SD_LOG_BLOCK_SIZE];
+    sd_log_header_st header;
+    kernel_error_st err = read_block(log, 0, block) ? sd_log_header_decode(block, &header) : KERNEL_ERROR_FORMAT;
+    if (err != KERNEL_SUCCESS) {
+        fprintf(stderr, "error: %s has no valid header (0x%x)\n", log_path, err);
+        fclose(log);
+        return 1;
+    }
+
+    std::vector<index_entry_t> index;
+    if (index_path != NULL) {
+        index = load_index(index_path, stats);
+    }
+
+    /* Invalid blocks only count as corrupted once a valid block follows them */
+    size_t invalid_run  = 0;
+    uint32_t num_blocks = count_blocks(log);
+    for (uint32_t b = find_start_block(log, header.file_id, num_blocks, index, from); b < num_blocks; b++) {
+        uint8_t count         = 0;
+        uint32_t block_number = 0;
+        if (!read_block(log, b, block) || (sd_log_block_check(block, header.file_id, &block_number, &count) != KERNEL_SUCCESS) ||
+            (block_number != b)) {
+            invalid_run++;
+            continue;
+        }
+        stats.bad_blocks += invalid_run;
+        invalid_run = 0;
+
+        for (uint8_t r = 0; r < count; r++) {
+            sd_log_record_st record;
+            sd_log_block_record(block, r, &record);
+            if (record.timestamp > to) {
+                fclose(log);
+                return 0;
+            }
+            if (record.timestamp >= from) {
+                print_record(out, record, header);
+                stats.records++;
+            }
+        }
+    }
+
+    fclose(log);
+    return 0;
+}
+
+/* ---------------------------------------------------------------- self-test */
+
+static constexpr int SELF_TEST_RECORDS = 1000;
+static constexpr int64_t SELF_TEST_T0  = 1751898180;
+
+static constexpr uint32_t SELF_TEST_FILE_ID     = 0x5eed1234;
+static constexpr uint32_t SELF_TEST_SEGMENT_BLOCKS = 512;
+
+static void write_self_test_log(const char *log_path, const char *index_path, std::vector<std::string> &expected) {
+    FILE *log   = fopen(log_path, "wb");
+    FILE *index = fopen(index_path, "wb");
+
+    sd_log_header_st header = {SELF_TEST_FILE_ID, NUM_OF_SENSORS, 4, {0}};
+    for (int i = 0; i < NUM_OF_SENSORS; i++) {
+        header.sensor_types[i] = (uint8_t)(i % SENSOR_TYPE_UNDEFINED);
+    }
+
+    uint8_t block[SD_LOG_BLOCK_SIZE];
+    sd_log_header_encode(block, &header);
+    fwrite(block, 1, sizeof(block), log);
+
+    uint32_t block_number = 0;
+    for (int n = 0; n < SELF_TEST_RECORDS; n++) {
+        sensor_report_st sensors[NUM_OF_SENSORS];
+        for (int i = 0; i < NUM_OF_SENSORS; i++) {
+            sensors[i].value       = (float)((n * 37 + i * 101) % 200000 - 50000) / 100.0f;
+            sensors[i].active      = ((n + i) % 3) != 0;
+            sensors[i].sensor_type = (sensor_type_et)header.sensor_types[i];
+        }
+
+        sd_log_record_st record;
+        sd_log_record_from_report(&record, SELF_TEST_T0 + 5 * n, sensors, NUM_OF_SENSORS);
+
+        if ((n % SD_LOG_RECORDS_PER_BLOCK) == 0) {
+            if (n != 0) {
+                sd_log_block_seal(block, header.file_id);
+                fwrite(block, 1, sizeof(block), log);
+            }
+            sd_log_block_begin(block, ++block_number);
+            if (((block_number - 1) % header.index_interval) == 0) {
+                uint8_t entry[SD_LOG_INDEX_ENTRY_SIZE];
+                sd_log_index_encode(entry, record.timestamp, block_number);
+                fwrite(entry, 1, sizeof(entry), index);
+            }
+        }
+        sd_log_block_add(block, &record);
+
+        char line[1024];
+        FILE *mem = fmemopen(line, sizeof(line), "w");
+        print_record(mem, record, header);
+        fclose(mem);
+        expected.push_back(line);
+    }
+    sd_log_block_seal(block, header.file_id);
+    fwrite(block, 1, sizeof(block), log);
+
+    /* Preallocated space: a stale block of a deleted segment at the next position, then garbage */
+    sd_log_record_st stale;
+    sd_log_block_record(block, 0, &stale);
+    sd_log_block_begin(block, ++block_number);
+    sd_log_block_add(block, &stale);
+    sd_log_block_seal(block, header.file_id ^ 1);
+    fwrite(block, 1, sizeof(block), log);
+    for (uint32_t b = block_number + 1; b < SELF_TEST_SEGMENT_BLOCKS; b++) {
+        for (size_t i = 0; i < sizeof(block); i++) {
+            block[i] = (uint8_t)((b * 131) + (i * 7));
+        }
+        fwrite(block, 1, sizeof(block), log);
+    }
+
+    fclose(log);
+    fclose(index);
+}
+
+static bool check_range(const char *log_path, const char *index_path, const std::vector<std::string> &expected, int first, int last) {
+    char *text  = NULL;
+    size_t size = 0;
+    FILE *out   = open_memstream(&text, &size);
+    export_stats_t stats;
+
+    export_log(log_path, index_path, SELF_TEST_T0 + 5 * first, SELF_TEST_T0 + 5 * last, out, stats);
+    fclose(out);
+
+    std::string want;
+    for (int n = first; n <= last; n++) {
+        want += expected[n];
+    }
+
+    bool ok = (want == std::string(text, size)) && (stats.bad_blocks == 0);
+    free(text);
+    return ok;
+}
+
+/**
+ * Values the fixed-point conversion must saturate or mark, rather than
+ * overflow, with the value each must store.
+ */
+static int check_value_limits(void) {
+    const struct {
+        float value;
+        int32_t stored;
+    } cases[] = {
+        {NAN, SD_LOG_VALUE_NAN},
+        {-NAN, SD_LOG_VALUE_NAN},
+        {INFINITY, INT32_MAX},
+        {-INFINITY, -INT32_MAX},
+        {FLT_MAX, INT32_MAX},
+        {-FLT_MAX, -INT32_MAX},
+        {2.2e7f, INT32_MAX},
+        {-2.2e7f, -INT32_MAX},
+        {2.0e7f, 2000000000},
+        {-2.0e7f, -2000000000},
+        {-0.004f, 0},
+        {-0.006f, -1},
+        {12.345f, 1235},
+    };
+    int failures = 0;
+
+    for (const auto &c : cases) {
+        sensor_report_st sensor = {};
+        sensor.value            = c.value;
+        sd_log_record_st record;
+        sd_log_record_from_report(&record, SELF_TEST_T0, &sensor, 1);
+
+        if (record.values[0] != c.stored) {
+            printf("value %g: FAIL (stored %" PRId32 ", expected %" PRId32 ")\n", (double)c.value, record.values[0], c.stored);
+            failures++;
+        }
+    }
+
+    if (!std::isnan(sd_log_value_decode(SD_LOG_VALUE_NAN)) || (sd_log_value_decode(-1234) != -12.34f)) {
+        printf("value decode: FAIL\n");
+        failures++;
+    }
+
+    return failures;
+}
+
+static int self_test(void) {
+    const char *log_path   = "sd_log_self_test.bin";
+    const char *index_path = "sd_log_self_test.idx";
+    std::vector<std::string> expected;
+    int failures = 0;
+
+    failures += check_value_limits();
+    write_self_test_log(log_path, index_path, expected);
+
+    const int ranges[][2] = {{0, SELF_TEST_RECORDS - 1}, {0, 0}, {3, 4}, {17, 250}, {511, 777}, {SELF_TEST_RECORDS - 1, SELF_TEST_RECORDS - 1}};
+    for (const auto &range : ranges) {
+        if (!check_range(log_path, index_path, expected, range[0], range[1])) {
+            printf("range %d..%d with index: FAIL\n", range[0], range[1]);
+            failures++;
+        }
+        if (!check_range(log_path, NULL, expected, range[0], range[1])) {
+            printf("range %d..%d without index: FAIL\n", range[0], range[1]);
+            failures++;
+        }
+    }
+
+    /* A flipped byte must invalidate exactly its block */
+    FILE *log = fopen(log_path, "r+b");
+    fseek(log, 5 * SD_LOG_BLOCK_SIZE + 100, SEEK_SET);
+    int byte = fgetc(log);
+    fseek(log, 5 * SD_LOG_BLOCK_SIZE + 100, SEEK_SET);
+    fputc(byte ^ 0x10, log);
+    fclose(log);
+
+    export_stats_t stats;
+    FILE *sink = fopen("/dev/null", "w");
+    export_log(log_path, index_path, INT64_MIN, INT64_MAX, sink, stats);
+    fclose(sink);
+    if ((stats.bad_blocks != 1) || (stats.records != (size_t)(SELF_TEST_RECORDS - SD_LOG_RECORDS_PER_BLOCK))) {
+        printf("corrupted block: FAIL (%zu bad blocks, %zu records)\n", stats.bad_blocks, stats.records);
+        failures++;
+    }
+
+    remove(log_path);
+    remove(index_path);
+
+    long csv_bytes = 0;
+    for (const auto &line : expected) {
+        csv_bytes += (long)line.size();
+    }
+    long binary_bytes = (long)SD_LOG_BLOCK_SIZE * (1 + (SELF_TEST_RECORDS + SD_LOG_RECORDS_PER_BLOCK - 1) / SD_LOG_RECORDS_PER_BLOCK);
+
+    printf("Self-test: %d records, %d records/block, CSV %ld bytes, binary %ld bytes (%.1fx), %d failures\n", SELF_TEST_RECORDS,
+           SD_LOG_RECORDS_PER_BLOCK, csv_bytes, binary_bytes, (double)csv_bytes / binary_bytes, failures);
+
+    return (failures == 0) ? 0 : 1;
+}
+
+/**
+ * Path of the time index of a segment: the .bin extension replaced by .idx.
+ */
+static std::string index_path_of(const std::string &log_path) {
+    size_t dot = log_path.rfind('.');
+    if ((dot == std::string::npos) || (strcasecmp(log_path.c_str() + dot, ".bin") != 0)) {
+        return std::string();
+    }
+
+    return log_path.substr(0, dot) + ((log_path[dot + 1] == 'B') ? ".IDX" : ".idx");
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> log_paths;
+    bool use_index = true;
+    int64_t from   = INT64_MIN;
+    int64_t to     = INT64_MAX;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--self-test") == 0) {
+            return self_test();
+        } else if (strcmp(argv[i], "--no-index") == 0) {
+            use_index = false;
+        } else if ((strcmp(argv[i], "--from") == 0) && (i + 1 < argc)) {
+            from = strtoll(argv[++i], NULL, 10);
+        } else if ((strcmp(argv[i], "--to") == 0) && (i + 1 < argc)) {
+            to = strtoll(argv[++i], NULL, 10);
+        } else {
+            log_paths.push_back(argv[i]);
+        }
+    }
+
+    if (log_paths.empty()) {
+        fprintf(stderr, "usage: %s log00001.bin [log00002.bin ...] [--no-index] [--from UNIX] [--to UNIX]\n", argv[0]);
+        return 2;
+    }
+
+    export_stats_t stats;
+    int ret = 0;
+    for (const auto &log_path : log_paths) {
+        std::string index_path = use_index ? index_path_of(log_path) : std::string();
+        if (export_log(log_path.c_str(), index_path.empty() ? NULL : index_path.c_str(), from, to, stdout, stats) != 0) {
+            ret = 1;
+        }
+    }
+    fprintf(stderr, "%zu records exported, %zu corrupted blocks skipped, %zu corrupted index entries\n", stats.records,
+            stats.bad_blocks, stats.bad_entries);
+
+    return ret;
+}
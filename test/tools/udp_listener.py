@@ -1,7 +1,25 @@
+"""
+Local stand-in for the UDP log host.
+
+The firmware packs several log lines into each datagram; every line is
+printed on its own. Point a build at this listener with:
+
+    build_flags = -DLOGGER_UDP_HOST=\\"192.168.1.10\\" -DLOGGER_UDP_PORT=5657
+
+or at runtime with log_udp_set_destination().
+
+Usage:
+    python udp_listener.py [--port 5657]
+"""
+
+import argparse
 import socket
 
 UDP_IP = "0.0.0.0"  # Listen on all interfaces
-UDP_PORT = 5657
+
+parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+parser.add_argument("--port", type=int, default=5657, help="UDP port to listen on")
+UDP_PORT = parser.parse_args().port
 
 sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
 sock.bind((UDP_IP, UDP_PORT))
@@ -12,8 +30,9 @@ print(f"Listening on {UDP_PORT}...")
 try:
     while True:
         try:
-            data, addr = sock.recvfrom(1024)
-            print(f"Received from {addr}: {data.decode()}")
+            data, addr = sock.recvfrom(2048)
+            for line in data.decode(errors="replace").splitlines():
+                print(f"Received from {addr}: {line}")
         except socket.timeout:
             continue  # Avoids blocking indefinitely
 except KeyboardInterrupt: